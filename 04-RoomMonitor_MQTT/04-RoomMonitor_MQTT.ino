@@ -4,78 +4,212 @@
 */
 
 #include "src/config.h"
+#include "src/boot_profiler.h"
 #include "src/data_model.h"
 #include "src/display_service.h"
+#include "src/instrumentation.h"
+#include "src/logger.h"
 #include "src/mqtt_manager.h"
+#include "src/power_manager.h"
+#include "src/rate_controller.h"
+#include "src/rolling_stats.h"
 #include "src/sensor_service.h"
+#include "src/task_scheduler.h"
 #include "src/wifi_manager.h"
 
 namespace {
-uint32_t g_last_publish_ms = 0UL;
-uint32_t g_last_display_ms = 0UL;
-SensorData g_last_data = {};
-bool g_has_data = false;
+uint32_t g_logged_seq = 0UL;
+uint8_t g_publish_task = TASK_SCHEDULER_INVALID_ID;
+uint32_t g_publish_period_ms = RoomMonitorConfig::PUBLISH_INTERVAL_MS;
 constexpr uint32_t SERIAL_WAIT_TIMEOUT_MS = 2000UL;
+
+void SampleTask() {
+  ScopedTimer timer(INSTRUMENT_SECTION_SENSOR);
+  if (RoomMonitorConfig::LOW_POWER_ENABLED) {
+    (void)SensorService_SampleAllDue();
+  } else {
+    (void)SensorService_Sample();
+  }
+  // The publish period only moves when a channel changes rate.
+  if (RoomMonitorConfig::ADAPTIVE_RATE_ENABLED) {
+    const uint32_t publish_period_ms = RateController_PublishIntervalMs();
+    if ((publish_period_ms != g_publish_period_ms) &&
+        TaskScheduler_SetPeriod(g_publish_task, publish_period_ms, millis())) {
+      g_publish_period_ms = publish_period_ms;
+    }
+  }
 }
 
-void setup() {
-  Serial.begin(RoomMonitorConfig::SERIAL_BAUD_RATE);
-  const uint32_t serial_wait_start = millis();
-  while (!Serial && ((millis() - serial_wait_start) < SERIAL_WAIT_TIMEOUT_MS)) {
-    ;  // Avoid blocking forever when no serial monitor is attached.
+// Consumers read the sensor snapshot on their own cadence; serial output
+// is skipped while its sequence number is unchanged.
+void SensorTask() {
+  const SensorSnapshot* snapshot = SensorService_GetSnapshot();
+  if (snapshot->valid_mask == 0U) {
+    Log<LOG_LEVEL_WARN> warning;
+    warning.println("Sensor read failed, keep last values");
+    return;
+  }
+  BootProfiler_Mark(BOOT_MILESTONE_SENSOR_READY);
+  // Stats stay on the task cadence so their time buckets see every interval.
+  if (RoomMonitorConfig::ROLLING_STATS_ENABLED) {
+    RollingStats_Add(&snapshot->data, millis());
+  }
+  if (snapshot->seq == g_logged_seq) {
+    return;
   }
+  g_logged_seq = snapshot->seq;
 
-  SensorService_Init();
-  DisplayService_Init();
-  DisplayService_ShowBootText();
-  delay(RoomMonitorConfig::DISPLAY_BOOT_HOLD_MS);
-  WifiManager_Init();
-  MqttManager_Init();
+  const SensorData& data = snapshot->data;
+  Log<LOG_LEVEL_INFO> logger;
+  logger.print("Temperature(C): ");
+  logger.println(data.temperature_c);
+  logger.print("Humidity(%): ");
+  logger.println(data.humidity_pct);
+  logger.print("Pressure(hPa): ");
+  logger.println(data.pressure_hpa);
+  logger.print("Soil1(%): ");
+  logger.println(data.soil1_pct);
+  logger.print("Soil2(%): ");
+  logger.println(data.soil2_pct);
+  if (data.stale_mask != 0U) {
+    Log<LOG_LEVEL_WARN> warning;
+    warning.print("Stale sensor fields mask: ");
+    warning.println(data.stale_mask, BIN);
+  }
+}
 
-  // Try to switch to dashboard immediately after boot screen.
-  SensorData initial_data = {};
-  if (SensorService_Read(&initial_data)) {
-    g_last_data = initial_data;
+void ShowDashboard(const SensorSnapshot* snapshot) {
+  DisplayService_ShowData(snapshot);
+  BootProfiler_Mark(BOOT_MILESTONE_FIRST_FRAME);
+}
+
+void DisplayTask() {
+  ScopedTimer timer(INSTRUMENT_SECTION_DISPLAY);
+  const SensorSnapshot* snapshot = SensorService_GetSnapshot();
+  if ((snapshot->valid_mask != 0U) && PowerManager_IsDisplayAwake()) {
+    ShowDashboard(snapshot);
   }
-  g_has_data = true;
-  g_last_display_ms = millis();
-  DisplayService_ShowData(&g_last_data);
 }
 
-void loop() {
-  const uint32_t now = millis();
-  if ((now - g_last_display_ms) >= RoomMonitorConfig::DISPLAY_REFRESH_MS) {
-    g_last_display_ms = now;
-
-    SensorData data = {};
-    if (SensorService_Read(&data)) {
-      g_last_data = data;
-      g_has_data = true;
-      Serial.print("Temperature(C): ");
-      Serial.println(data.temperature_c);
-      Serial.print("Humidity(%): ");
-      Serial.println(data.humidity_pct);
-      Serial.print("Pressure(hPa): ");
-      Serial.println(data.pressure_hpa);
-      Serial.print("Soil1(%): ");
-      Serial.println(data.soil1_pct);
-      Serial.print("Soil2(%): ");
-      Serial.println(data.soil2_pct);
-    } else {
-      Serial.println("Sensor read failed, keep last values");
-    }
+void PublishTask() {
+  ScopedTimer timer(INSTRUMENT_SECTION_PUBLISH);
+  const SensorSnapshot* snapshot = SensorService_GetSnapshot();
+  if (snapshot->valid_mask != 0U) {
+    (void)MqttManager_PublishData(&snapshot->data);
+  }
+}
+
+void MqttServiceTask() {
+  ScopedTimer timer(INSTRUMENT_SECTION_MQTT);
+  const bool online = MqttManager_EnsureConnected();
+  MqttManager_Loop();
+  // The first state goes out as soon as the link is up rather than at the
+  // publish task's (jittered) phase.
+  if (RoomMonitorConfig::FAST_BOOT_ENABLED && online && !BootProfiler_IsMarked(BOOT_MILESTONE_FIRST_PUBLISH)) {
+    PublishTask();
+  }
+}
+
+void PowerTask() {
+  PowerManager_Service(millis());
+}
+
+void RollingStatsTask() {
+  (void)MqttManager_PublishStats();
+}
+
+void DiagnosticsTask() {
+  (void)MqttManager_PublishDiagnostics();
+}
+
+void StatsTask() {
+  TaskScheduler_PrintStats(Logger_GetStream());
+}
+
+// One loop() pass without the idle sleep, so the loop timer only sees
+// work. Returns whether a task ran.
+bool RunLoopWork() {
+  ScopedTimer timer(INSTRUMENT_SECTION_LOOP);
+  Instrumentation_CountLoop();
+  Logger_Drain();
+  return TaskScheduler_RunOnce(millis());
+}
 
-    if (g_has_data) {
-      DisplayService_ShowData(&g_last_data);
+void RegisterTasks() {
+  using namespace RoomMonitorConfig;
+  const uint32_t sample_interval_ms = LOW_POWER_ENABLED ? LOW_POWER_SAMPLE_INTERVAL_MS : SENSOR_SAMPLE_INTERVAL_MS;
+  const uint32_t mqtt_interval_ms = LOW_POWER_ENABLED ? LOW_POWER_MQTT_SERVICE_INTERVAL_MS : MQTT_SERVICE_INTERVAL_MS;
+  (void)TaskScheduler_Add("sample", SampleTask, sample_interval_ms, TASK_SAMPLE_PHASE_MS, TASK_SAMPLE_DEADLINE_MS);
+  (void)TaskScheduler_Add("sensor", SensorTask, DISPLAY_REFRESH_MS, TASK_SENSOR_PHASE_MS, TASK_SENSOR_DEADLINE_MS);
+  (void)TaskScheduler_Add("display", DisplayTask, DISPLAY_REFRESH_MS, TASK_DISPLAY_PHASE_MS, TASK_DISPLAY_DEADLINE_MS);
+  // random() is seeded from the MAC in MqttManager_Init, so each monitor
+  // on a shared broker publishes at its own offset within the interval.
+  const uint32_t publish_phase_ms =
+      TASK_PUBLISH_PHASE_MS +
+      (MQTT_FLEET_JITTER_ENABLED ? static_cast<uint32_t>(random(static_cast<long>(PUBLISH_INTERVAL_MS))) : 0UL);
+  g_publish_task =
+      TaskScheduler_Add("publish", PublishTask, PUBLISH_INTERVAL_MS, publish_phase_ms, TASK_PUBLISH_DEADLINE_MS);
+  (void)TaskScheduler_Add("mqtt", MqttServiceTask, mqtt_interval_ms, TASK_MQTT_PHASE_MS, TASK_MQTT_DEADLINE_MS);
+  (void)TaskScheduler_Add("power", PowerTask, POWER_TASK_INTERVAL_MS, TASK_POWER_PHASE_MS, 0UL);
+  if (ROLLING_STATS_ENABLED) {
+    (void)TaskScheduler_Add(
+        "rstats", RollingStatsTask, ROLLING_STATS_PUBLISH_INTERVAL_MS / SENSOR_FIELD_COUNT, TASK_ROLLING_STATS_PHASE_MS, 0UL);
+  }
+  if (INSTRUMENTATION_ENABLED) {
+    (void)TaskScheduler_Add(
+        "diag", DiagnosticsTask, DIAGNOSTICS_PUBLISH_INTERVAL_MS, TASK_DIAGNOSTICS_PHASE_MS, 0UL);
+  }
+  if (TASK_STATS_PRINT_ENABLED) {
+    (void)TaskScheduler_Add("stats", StatsTask, TASK_STATS_PRINT_INTERVAL_MS, TASK_STATS_PRINT_INTERVAL_MS, 0UL);
+  }
+}
+}  // namespace
+
+void setup() {
+  using namespace RoomMonitorConfig;
+  Serial.begin(SERIAL_BAUD_RATE);
+  if (!FAST_BOOT_ENABLED || FAST_BOOT_SERIAL_WAIT) {
+    const uint32_t serial_wait_start = millis();
+    while (!Serial && ((millis() - serial_wait_start) < SERIAL_WAIT_TIMEOUT_MS)) {
+      ;  // Avoid blocking forever when no serial monitor is attached.
     }
   }
 
-  if (g_has_data && ((now - g_last_publish_ms) >= RoomMonitorConfig::PUBLISH_INTERVAL_MS)) {
-    g_last_publish_ms = now;
-    (void)MqttManager_PublishData(&g_last_data);
+  // Fast boot: the NINA module associates while the carrier and sensors
+  // come up.
+  if (FAST_BOOT_ENABLED) {
+    WifiManager_Init();
+    WifiManager_Begin();
   }
+  SensorService_Init();
+  const SensorSnapshot* snapshot = SensorService_GetSnapshot();
+  if (snapshot->valid_mask != 0U) {
+    BootProfiler_Mark(BOOT_MILESTONE_SENSOR_READY);
+  }
+  DisplayService_Init();
+  // With data already in hand fast boot goes straight to the dashboard.
+  if (!FAST_BOOT_ENABLED || (snapshot->valid_mask == 0U)) {
+    DisplayService_ShowBootText();
+  }
+  if (!FAST_BOOT_ENABLED) {
+    delay(DISPLAY_BOOT_HOLD_MS);
+    WifiManager_Init();
+  }
+  MqttManager_Init();
+  PowerManager_Init(millis());
 
-  (void)MqttManager_EnsureConnected();
-  MqttManager_Loop();
+  // Switch to the dashboard as soon as there is data; otherwise the
+  // display task does once the first channel reads.
+  if (snapshot->valid_mask != 0U) {
+    ShowDashboard(snapshot);
+  }
+
+  RegisterTasks();
+  TaskScheduler_Start(millis());
 }
 
+void loop() {
+  if (!RunLoopWork()) {
+    PowerManager_Idle(TaskScheduler_MsUntilNextRelease(millis()));
+  }
+}
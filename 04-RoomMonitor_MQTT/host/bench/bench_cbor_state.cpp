@@ -0,0 +1,180 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <PubSubClient.h>
+
+#include <chrono>
+#include <type_traits>
+
+#include "boot_profiler.h"
+#include "cbor_writer.h"
+#include "config.h"
+#include "hal.h"
+#include "host_cbor.h"
+#include "instrumentation.h"
+#include "logger.h"
+#include "mqtt_lite_client.h"
+#include "mqtt_manager.h"
+#include "power_manager.h"
+#include "rate_controller.h"
+#include "rolling_stats.h"
+#include "telemetry_buffer.h"
+#include "text_format.h"
+#include "wifi_manager.h"
+
+// The same snapshot three ways: per-topic text values, the batched JSON
+// document and the CBOR map on TOPIC_STATE_BIN. Reports payload and
+// PUBLISH packet bytes per snapshot and host encode time for each. The
+// encoders are MqttManager's own, from a copy of mqtt_manager.cpp in a
+// namespace (they live in its anonymous namespace). Host nanoseconds are
+// only a ratio.
+
+namespace firmware {
+#include "mqtt_manager.cpp"
+}  // namespace firmware
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FULL_SNAPSHOTS = 1000000UL;
+constexpr uint32_t QUICK_SNAPSHOTS = 10000UL;
+
+typedef char StateValues[firmware::METRIC_COUNT][firmware::STATE_PAYLOAD_CAPACITY];
+
+const char* const STATE_TOPICS[firmware::METRIC_COUNT] = {
+    TOPIC_TEMP_STATE, TOPIC_HUM_STATE, TOPIC_PRESSURE_STATE, TOPIC_SOIL1_STATE, TOPIC_SOIL2_STATE};
+
+volatile size_t g_sink = 0U;
+
+SensorData MakeSnapshot(const uint32_t index) {
+  SensorData data = {};
+  data.temperature_c = 18.0F + (static_cast<float>(index % 1000UL) * 0.013F);
+  data.humidity_pct = 35.0F + (static_cast<float>(index % 400UL) * 0.07F);
+  data.pressure_hpa = 990.0F + (static_cast<float>(index % 700UL) * 0.05F);
+  data.soil1_pct = static_cast<uint8_t>(index % 101UL);
+  data.soil2_pct = static_cast<uint8_t>((index * 7UL) % 101UL);
+  data.stale_mask = static_cast<uint8_t>((index % 97UL == 0UL) ? 0x10U : 0U);
+  return data;
+}
+
+// QoS 0 PUBLISH: fixed header, remaining length, topic length, topic,
+// payload.
+size_t PublishBytes(const char* topic, const size_t payload_bytes) {
+  const size_t remaining = 2U + strlen(topic) + payload_bytes;
+  size_t length_bytes = 1U;
+  for (size_t rest = remaining >> 7; rest > 0U; rest >>= 7) {
+    length_bytes++;
+  }
+  return 1U + length_bytes + remaining;
+}
+
+struct Form {
+  const char* name;
+  size_t (*encode)(const SensorData& data, uint32_t index, size_t* wire_bytes);
+};
+
+size_t EncodeText(const SensorData& data, uint32_t, size_t* wire_bytes) {
+  StateValues values;
+  if (!firmware::FormatStateValues(&data, values)) {
+    return 0U;
+  }
+  size_t payload_bytes = 0U;
+  *wire_bytes = 0U;
+  for (uint8_t i = 0U; i < firmware::METRIC_COUNT; i++) {
+    const size_t length = strlen(values[i]);
+    payload_bytes += length;
+    *wire_bytes += PublishBytes(STATE_TOPICS[i], length);
+  }
+  return payload_bytes;
+}
+
+size_t EncodeJson(const SensorData& data, uint32_t, size_t* wire_bytes) {
+  StateValues values;
+  char payload[MQTT_STATE_JSON_CAPACITY];
+  if (!firmware::FormatStateValues(&data, values) ||
+      !firmware::BuildStateJson(payload, sizeof(payload), values, nullptr)) {
+    return 0U;
+  }
+  const size_t length = strlen(payload);
+  *wire_bytes = PublishBytes(TOPIC_STATE, length);
+  return length;
+}
+
+size_t EncodeCbor(const SensorData& data, const uint32_t index, size_t* wire_bytes) {
+  uint8_t payload[MQTT_STATE_CBOR_CAPACITY];
+  const size_t length = firmware::EncodeBinaryState(&data, index, payload, sizeof(payload));
+  g_sink = g_sink + payload[0];
+  *wire_bytes = PublishBytes(TOPIC_STATE_BIN, length);
+  return length;
+}
+
+const Form FORMS[] = {
+    {"text x5 topics", EncodeText},
+    {"batched JSON", EncodeJson},
+    {"CBOR state/bin", EncodeCbor},
+};
+
+struct FormCost {
+  double payload_bytes;
+  double wire_bytes;
+  double ns;
+};
+
+FormCost Measure(const Form& form, const uint32_t snapshots) {
+  uint64_t payload_bytes = 0U;
+  uint64_t wire_bytes = 0U;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t index = 0UL; index < snapshots; index++) {
+    size_t wire = 0U;
+    payload_bytes += form.encode(MakeSnapshot(index), index, &wire);
+    wire_bytes += wire;
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  return FormCost{static_cast<double>(payload_bytes) / snapshots, static_cast<double>(wire_bytes) / snapshots, ns / snapshots};
+}
+
+// Every CBOR payload must decode back to its snapshot.
+uint32_t CountCborMismatches(const uint32_t snapshots) {
+  uint32_t mismatches = 0UL;
+  for (uint32_t index = 0UL; index < snapshots; index++) {
+    const SensorData data = MakeSnapshot(index);
+    uint8_t payload[MQTT_STATE_CBOR_CAPACITY];
+    const size_t length = firmware::EncodeBinaryState(&data, index, payload, sizeof(payload));
+    HostBinaryState state = {};
+    const bool same = HostCbor_DecodeState(payload, length, &state) && (state.sequence == index) &&
+                      (state.data.soil1_pct == data.soil1_pct) && (state.data.soil2_pct == data.soil2_pct) &&
+                      (state.data.stale_mask == data.stale_mask) &&
+                      (fabsf(state.data.temperature_c - data.temperature_c) <= 0.0051F) &&
+                      (fabsf(state.data.humidity_pct - data.humidity_pct) <= 0.0051F) &&
+                      (fabsf(state.data.pressure_hpa - data.pressure_hpa) <= 0.051F);
+    mismatches += same ? 0UL : 1UL;
+  }
+  return mismatches;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const uint32_t snapshots = quick ? QUICK_SNAPSHOTS : FULL_SNAPSHOTS;
+
+  printf("state snapshot encodings over %u snapshots\n", snapshots);
+  printf("  %-16s %10s %10s %12s\n", "form", "payload B", "wire B", "encode ns");
+  FormCost costs[sizeof(FORMS) / sizeof(FORMS[0])];
+  for (size_t i = 0U; i < (sizeof(FORMS) / sizeof(FORMS[0])); i++) {
+    costs[i] = Measure(FORMS[i], snapshots);
+    printf("  %-16s %10.1f %10.1f %12.1f\n", FORMS[i].name, costs[i].payload_bytes, costs[i].wire_bytes, costs[i].ns);
+  }
+  const uint32_t mismatches = CountCborMismatches(snapshots);
+  printf("  CBOR decode mismatches: %u\n", mismatches);
+
+  const FormCost& json = costs[1];
+  const FormCost& cbor = costs[2];
+  const bool ok = (mismatches == 0UL) && (cbor.payload_bytes > 0.0) && (cbor.payload_bytes < json.payload_bytes) &&
+                  (cbor.payload_bytes <= MQTT_STATE_CBOR_CAPACITY);
+  if (!ok) {
+    printf("FAIL: CBOR payloads failed to decode or were not smaller than JSON\n");
+  }
+  return ok ? 0 : 1;
+}
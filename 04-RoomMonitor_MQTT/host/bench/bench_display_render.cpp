@@ -0,0 +1,312 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "config.h"
+#include "data_model.h"
+#include "display_profiler.h"
+#include "display_service.h"
+#include "fakes/host_clock.h"
+#include "hal.h"
+#include "hal_host.h"
+#include "logger.h"
+#include "readout_font.h"
+#include "rolling_stats.h"
+#include "trig_table.h"
+
+// Dashboard render cost over a scripted room: N frames, one per
+// DISPLAY_REFRESH_MS, through the recording HostDisplay. Reports the full
+// redraw and the incremental frames per profiler section and per panel
+// primitive, with the largest calls of the full frame, for the cached
+// static layer and for the direct-draw fallback. --ppm=<dir> also dumps
+// every frame as <dir>/{cached,direct}_frame_NNNN.ppm for diffing.
+//
+// DISPLAY_PROFILER_ENABLED is a compile-time switch, so the bench renders
+// with its own copy of display_service.cpp whose profiler hooks are swapped
+// by the preprocessor for ones that label the recorded calls. Its headers
+// are already included above and stay out of the namespace.
+
+namespace profiled {
+const char* const SECTION_NAMES[DISPLAY_SECTION_COUNT] = {
+    "clear", "static", "needle", "heartbeat", "gauge_text", "panel_text", "stats_band"};
+
+Adafruit_GFX* RecordingProfiler_Wrap(Adafruit_GFX* target) {
+  return target;
+}
+
+void RecordingProfiler_SetSection(const DisplayProfileSection section) {
+  HostHal_GetDisplay()->SetSection(SECTION_NAMES[section]);
+}
+
+void RecordingProfiler_BeginFrame() {
+  RecordingProfiler_SetSection(DISPLAY_SECTION_CLEAR);
+}
+
+void RecordingProfiler_EndFrame() {
+  HostHal_GetDisplay()->SetSection(nullptr);
+}
+
+#define DisplayProfiler_Wrap RecordingProfiler_Wrap
+#define DisplayProfiler_SetSection RecordingProfiler_SetSection
+#define DisplayProfiler_BeginFrame RecordingProfiler_BeginFrame
+#define DisplayProfiler_EndFrame RecordingProfiler_EndFrame
+#include "display_service.cpp"
+#undef DisplayProfiler_Wrap
+#undef DisplayProfiler_SetSection
+#undef DisplayProfiler_BeginFrame
+#undef DisplayProfiler_EndFrame
+}  // namespace profiled
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FULL_FRAMES = 600UL;
+constexpr uint32_t QUICK_FRAMES = 60UL;
+constexpr size_t LARGEST_CALLS = 5U;
+constexpr float TWO_PI = 6.2831853F;
+// A canvas limit too small for the static band forces the direct draw.
+constexpr size_t NO_CANVAS_BYTES = 64U;
+
+struct RenderMode {
+  const char* name;
+  size_t canvas_limit_bytes;
+};
+
+const RenderMode RENDER_MODES[] = {
+    {"cached static layer", 0U},
+    {"direct draw", NO_CANVAS_BYTES},
+};
+
+struct Cost {
+  uint32_t calls;
+  uint64_t pixels;
+  uint64_t spi_bytes;
+  uint64_t busy_us;
+};
+
+struct NamedCost {
+  const char* name;
+  Cost cost;
+};
+
+// Costs keyed by the recorded name, in first-seen order.
+typedef std::vector<NamedCost> CostTable;
+
+HostDisplay* Display() {
+  return HostHal_GetDisplay();
+}
+
+void AddCall(Cost* cost, const HostDisplayCall& call) {
+  cost->calls++;
+  cost->pixels += call.pixels;
+  cost->spi_bytes += call.spi_bytes;
+  cost->busy_us += call.busy_us;
+}
+
+Cost* Find(CostTable* table, const char* name) {
+  const char* key = (name != nullptr) ? name : "(none)";
+  for (NamedCost& entry : *table) {
+    if (strcmp(entry.name, key) == 0) {
+      return &entry.cost;
+    }
+  }
+  table->push_back(NamedCost{key, Cost{}});
+  return &table->back().cost;
+}
+
+// A room over ten minutes, at the readout resolutions: heating ramps the
+// temperature, a window opens and shuts on the humidity, and the soil dries
+// a percent at a time. The snapshot only advances when a value moves.
+SensorSnapshot ScriptedSnapshot(const uint32_t frame, const SensorSnapshot& previous) {
+  const float minutes = static_cast<float>(frame) / 60.0F;
+  SensorSnapshot snapshot = previous;
+  snapshot.valid_mask = static_cast<uint8_t>((1U << SENSOR_FIELD_COUNT) - 1U);
+  SensorData& data = snapshot.data;
+  data.temperature_c = roundf((19.5F + (0.25F * minutes) + (0.3F * sinf(TWO_PI * minutes / 3.0F))) * 10.0F) / 10.0F;
+  data.humidity_pct = roundf(46.0F + (((minutes > 4.0F) && (minutes < 6.0F)) ? -8.0F : 0.0F));
+  data.pressure_hpa = roundf((1012.0F - (0.2F * minutes)) * 10.0F) / 10.0F;
+  data.soil1_pct = static_cast<uint8_t>(52U - (frame / 150UL));
+  data.soil2_pct = static_cast<uint8_t>(38U - (frame / 240UL));
+  if ((frame == 0UL) || (memcmp(&data, &previous.data, sizeof(data)) != 0)) {
+    snapshot.seq = previous.seq + 1UL;
+  }
+  return snapshot;
+}
+
+struct ModeReport {
+  CostTable full_sections;
+  CostTable full_primitives;
+  CostTable sections;    // incremental frames
+  CostTable primitives;  // incremental frames
+  std::vector<HostDisplayCall> largest;
+  Cost full;
+  Cost incremental;
+  uint64_t worst_frame_us;
+  bool consistent;
+};
+
+void KeepLargest(std::vector<HostDisplayCall>* largest, const HostDisplayCall& call) {
+  largest->push_back(call);
+  for (size_t i = largest->size() - 1U; i > 0U; i--) {
+    if ((*largest)[i].spi_bytes <= (*largest)[i - 1U].spi_bytes) {
+      break;
+    }
+    const HostDisplayCall swap = (*largest)[i];
+    (*largest)[i] = (*largest)[i - 1U];
+    (*largest)[i - 1U] = swap;
+  }
+  if (largest->size() > LARGEST_CALLS) {
+    largest->pop_back();
+  }
+}
+
+bool DumpFrame(const char* ppm_dir, const RenderMode& mode, const uint32_t frame) {
+  if (ppm_dir == nullptr) {
+    return true;
+  }
+  char path[256];
+  const int length = snprintf(path,
+                              sizeof(path),
+                              "%s/%s_frame_%04u.ppm",
+                              ppm_dir,
+                              (mode.canvas_limit_bytes == 0U) ? "cached" : "direct",
+                              static_cast<unsigned>(frame));
+  return (length > 0) && (static_cast<size_t>(length) < sizeof(path)) && Display()->WritePpm(path);
+}
+
+bool RenderFrames(const RenderMode& mode, const uint32_t frames, const char* ppm_dir, ModeReport* report) {
+  HostHal_Reset();
+  HostClock_SetReadTickUs(0U);
+  Display()->SetChargeClock(false);
+  HostGfx_SetCanvasLimitBytes(mode.canvas_limit_bytes);
+  profiled::DisplayService_Init();
+  profiled::DisplayService_ShowBootText();
+  Display()->SetRecording(true);
+
+  bool dumped = true;
+  SensorSnapshot snapshot = {};
+  for (uint32_t frame = 0UL; frame < frames; frame++) {
+    snapshot = ScriptedSnapshot(frame, snapshot);
+    Display()->ClearCalls();
+    Display()->ResetStats();
+    profiled::DisplayService_ShowData(&snapshot);
+
+    Cost frame_cost = {};
+    for (const HostDisplayCall& call : Display()->GetCalls()) {
+      AddCall(&frame_cost, call);
+      if (frame == 0UL) {
+        AddCall(Find(&report->full_sections, call.section), call);
+        AddCall(Find(&report->full_primitives, call.primitive), call);
+        KeepLargest(&report->largest, call);
+      } else {
+        AddCall(Find(&report->sections, call.section), call);
+        AddCall(Find(&report->primitives, call.primitive), call);
+      }
+    }
+    // The recording must add up to what the panel was charged.
+    const HostDisplayStats& stats = Display()->GetStats();
+    report->consistent = report->consistent && (frame_cost.pixels == stats.pixels) &&
+                         (frame_cost.spi_bytes == stats.spi_bytes) && (frame_cost.busy_us == stats.busy_us);
+    if (frame == 0UL) {
+      report->full = frame_cost;
+    } else {
+      report->incremental.calls += frame_cost.calls;
+      report->incremental.pixels += frame_cost.pixels;
+      report->incremental.spi_bytes += frame_cost.spi_bytes;
+      report->incremental.busy_us += frame_cost.busy_us;
+      report->worst_frame_us =
+          (frame_cost.busy_us > report->worst_frame_us) ? frame_cost.busy_us : report->worst_frame_us;
+    }
+    dumped = DumpFrame(ppm_dir, mode, frame) && dumped;
+    HostClock_AdvanceMs(DISPLAY_REFRESH_MS);
+  }
+  return dumped;
+}
+
+void PrintCost(const char* name, const Cost& cost, const uint32_t frames) {
+  printf("    %-14s %9.1f %10.1f %11.1f %9.1f\n",
+         name,
+         static_cast<double>(cost.calls) / frames,
+         static_cast<double>(cost.pixels) / frames,
+         static_cast<double>(cost.spi_bytes) / frames,
+         static_cast<double>(cost.busy_us) / frames);
+}
+
+void PrintTable(const char* heading, const CostTable& table, const uint32_t frames) {
+  printf("    %-14s %9s %10s %11s %9s\n", heading, "calls", "pixels", "spi bytes", "spi us");
+  for (const NamedCost& entry : table) {
+    PrintCost(entry.name, entry.cost, frames);
+  }
+}
+
+void PrintReport(const RenderMode& mode, const ModeReport& report, const uint32_t frames) {
+  const uint32_t incremental_frames = frames - 1UL;
+  printf("  %s\n", mode.name);
+  printf("   full redraw: %u calls, %llu px, %llu SPI bytes, %llu us\n",
+         report.full.calls,
+         static_cast<unsigned long long>(report.full.pixels),
+         static_cast<unsigned long long>(report.full.spi_bytes),
+         static_cast<unsigned long long>(report.full.busy_us));
+  PrintTable("section", report.full_sections, 1UL);
+  PrintTable("primitive", report.full_primitives, 1UL);
+  printf("    largest calls:\n");
+  for (const HostDisplayCall& call : report.largest) {
+    printf("      %-10s %-14s (%d,%d) %dx%d #%04X: %u px, %u SPI bytes\n",
+           call.section,
+           call.primitive,
+           call.x,
+           call.y,
+           call.w,
+           call.h,
+           call.color,
+           call.pixels,
+           call.spi_bytes);
+  }
+  printf("   incremental, per frame over %u frames (worst %llu us):\n",
+         incremental_frames,
+         static_cast<unsigned long long>(report.worst_frame_us));
+  PrintTable("section", report.sections, incremental_frames);
+  PrintTable("primitive", report.primitives, incremental_frames);
+  PrintCost("total", report.incremental, incremental_frames);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint32_t frames = FULL_FRAMES;
+  const char* ppm_dir = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--quick") == 0) {
+      frames = QUICK_FRAMES;
+    } else if (strncmp(argv[i], "--frames=", 9U) == 0) {
+      frames = static_cast<uint32_t>(strtoul(argv[i] + 9, nullptr, 10));
+    } else if (strncmp(argv[i], "--ppm=", 6U) == 0) {
+      ppm_dir = argv[i] + 6;
+    }
+  }
+  if (frames < 2UL) {
+    printf("usage: %s [--quick] [--frames=N (N >= 2)] [--ppm=<dir>]\n", argv[0]);
+    return 2;
+  }
+
+  printf("dashboard render over %u frames, %u ms apart\n", frames, DISPLAY_REFRESH_MS);
+  bool ok = true;
+  for (const RenderMode& mode : RENDER_MODES) {
+    ModeReport report = {};
+    report.consistent = true;
+    const bool dumped = RenderFrames(mode, frames, ppm_dir, &report);
+    PrintReport(mode, report, frames);
+    if (!dumped) {
+      printf("FAIL: could not write the frame dumps to %s\n", ppm_dir);
+    }
+    if (!report.consistent) {
+      printf("FAIL: recorded calls do not add up to the panel's counters\n");
+    }
+    // Incremental frames must stay well under a full redraw.
+    ok = ok && dumped && report.consistent &&
+         ((report.incremental.spi_bytes / (frames - 1UL)) < report.full.spi_bytes);
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+
+// A fleet of monitors on one broker: every device boots at the same moment
+// (power restored), runs, sees the broker restart, and reconnects. Reports
+// connect and discovery completion times, the broker's message rate and
+// the publish latency of a broker that handles one message at a time,
+// with and without the MAC-seeded fleet jitter, as the fleet grows.
+//
+// Module state is global, so each device runs the whole sketch in its own
+// forked child with its own MAC and association delay, and logs its
+// broker traffic to a shared file. Devices only meet at the broker, so
+// merging the logs gives the broker's view. The broker model is open
+// loop: its queueing delay does not slow the devices down. Without jitter
+// is the same firmware with random() pinned to 0.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+const uint32_t FULL_FLEET_SIZES[] = {1UL, 10UL, 100UL, 1000UL};
+const uint32_t QUICK_FLEET_SIZES[] = {1UL, 8UL, 32UL};
+constexpr uint32_t RESTART_AT_MS = 2UL * 60UL * 1000UL;
+constexpr uint32_t BROKER_DOWN_MS = 30UL * 1000UL;
+constexpr uint32_t RUN_MS = 5UL * 60UL * 1000UL;
+constexpr uint32_t CONNECT_TIMEOUT_MS = 90UL * 1000UL;
+// Association spread across the fleet after a power cut.
+constexpr uint32_t ASSOCIATE_MIN_MS = 1500UL;
+constexpr uint32_t ASSOCIATE_SPREAD_MS = 2000UL;
+// A small Home Assistant host: about 2000 messages a second.
+constexpr uint32_t BROKER_SERVICE_US = 500UL;
+constexpr uint32_t RATE_WINDOW_MS = 100UL;
+constexpr size_t CLIENT_ID_BYTES = 32U;
+
+struct DeviceSummary {
+  uint32_t device;
+  uint32_t connect_ms;       // boot to the first CONNACK
+  uint32_t discovered_ms;    // boot to the last discovery config
+  uint32_t reconnect_ms;     // broker back to the next CONNACK
+  uint32_t rediscovered_ms;  // broker back to the last discovery config
+  uint32_t publishes;
+  char client_id[CLIENT_ID_BYTES];
+};
+
+struct Publish {
+  uint32_t sent_ms;
+};
+
+struct FleetReport {
+  std::vector<DeviceSummary> devices;
+  std::vector<Publish> publishes;
+};
+
+uint32_t Mix(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7FEB352DUL;
+  x ^= x >> 15;
+  x *= 0x846CA68BUL;
+  x ^= x >> 16;
+  return x;
+}
+
+bool IsDiscovery(const std::string& topic) {
+  return (topic.size() > 7U) && (topic.compare(topic.size() - 7U, 7U, "/config") == 0);
+}
+
+// Last discovery config at or after `from_ms`, relative to it.
+uint32_t LastDiscovery(const std::vector<HostMqttMessage>& messages, const uint32_t from_ms) {
+  uint32_t last_ms = from_ms;
+  for (const HostMqttMessage& message : messages) {
+    if ((message.received_ms >= from_ms) && IsDiscovery(message.topic)) {
+      last_ms = std::max(last_ms, message.received_ms);
+    }
+  }
+  return last_ms - from_ms;
+}
+
+// One device from power-on to the end of the run, logged to `log`.
+bool RunDevice(const uint32_t device, const bool jitter, FILE* log) {
+  HostSketch_Reset();
+  HostRandom_SetZero(!jitter);
+  // Locally administered MACs, one per device.
+  const uint8_t mac[MAC_ADDRESS_LENGTH] = {0x02U,
+                                           0x00U,
+                                           0x00U,
+                                           static_cast<uint8_t>(device >> 16),
+                                           static_cast<uint8_t>(device >> 8),
+                                           static_cast<uint8_t>(device)};
+  HostHal_SetMacAddress(mac);
+  HostHal_SetWifiAssociateMs(ASSOCIATE_MIN_MS + (Mix(device + 1UL) % ASSOCIATE_SPREAD_MS));
+  HostSketch_Setup();
+
+  HostBroker* broker = HostHal_GetBroker();
+  DeviceSummary summary = {};
+  summary.device = device;
+  if (!HostSketch_RunUntil([broker]() { return broker->GetConnectCount() > 0U; }, CONNECT_TIMEOUT_MS)) {
+    return false;
+  }
+  summary.connect_ms = millis();
+  strncpy(summary.client_id, broker->GetClientId().c_str(), CLIENT_ID_BYTES - 1U);
+  HostSketch_RunFor(RESTART_AT_MS - millis());
+  summary.discovered_ms = LastDiscovery(broker->GetMessages(), 0UL);
+
+  broker->DropSession();
+  HostHal_SetTransportRefused(true);
+  HostSketch_RunFor(BROKER_DOWN_MS);
+  HostHal_SetTransportRefused(false);
+  const uint32_t back_ms = millis();
+  if (!HostSketch_RunUntil([broker]() { return broker->GetConnectCount() > 1U; }, CONNECT_TIMEOUT_MS)) {
+    return false;
+  }
+  summary.reconnect_ms = millis() - back_ms;
+  HostSketch_RunFor(RUN_MS - millis());
+  summary.rediscovered_ms = LastDiscovery(broker->GetMessages(), back_ms);
+
+  const std::vector<HostMqttMessage>& messages = broker->GetMessages();
+  summary.publishes = static_cast<uint32_t>(messages.size());
+  bool written = fwrite(&summary, sizeof(summary), 1U, log) == 1U;
+  for (const HostMqttMessage& message : messages) {
+    const Publish publish = {message.received_ms};
+    written = written && (fwrite(&publish, sizeof(publish), 1U, log) == 1U);
+  }
+  return (fflush(log) == 0) && written;
+}
+
+bool RunFleet(const uint32_t size, const bool jitter, FleetReport* report) {
+  FILE* log = tmpfile();
+  if (log == nullptr) {
+    return false;
+  }
+  bool ok = true;
+  for (uint32_t device = 0UL; ok && (device < size); device++) {
+    ok = HostSketch_RunIsolated([device, jitter, log]() { return RunDevice(device, jitter, log); });
+  }
+  rewind(log);
+  DeviceSummary summary = {};
+  while (ok && (fread(&summary, sizeof(summary), 1U, log) == 1U)) {
+    report->devices.push_back(summary);
+    const size_t first = report->publishes.size();
+    report->publishes.resize(first + summary.publishes);
+    ok = fread(&report->publishes[first], sizeof(Publish), summary.publishes, log) == summary.publishes;
+  }
+  fclose(log);
+  return ok && (report->devices.size() == size);
+}
+
+// Nearest rank.
+uint32_t Percentile(std::vector<uint32_t> values, const uint32_t percent) {
+  if (values.empty()) {
+    return 0UL;
+  }
+  std::sort(values.begin(), values.end());
+  const size_t rank = ((values.size() * percent) + 99U) / 100U;
+  return values[(rank > 0U) ? (rank - 1U) : 0U];
+}
+
+template <typename Field>
+std::vector<uint32_t> Collect(const std::vector<DeviceSummary>& devices, Field field) {
+  std::vector<uint32_t> values;
+  for (const DeviceSummary& device : devices) {
+    values.push_back(device.*field);
+  }
+  return values;
+}
+
+struct BrokerLoad {
+  uint32_t peak_per_s;
+  double mean_per_s;
+  std::vector<uint32_t> latency_us;
+};
+
+// FIFO broker serving one message per BROKER_SERVICE_US.
+BrokerLoad ModelBroker(std::vector<Publish> publishes) {
+  std::sort(publishes.begin(), publishes.end(), [](const Publish& a, const Publish& b) {
+    return a.sent_ms < b.sent_ms;
+  });
+  BrokerLoad load = {};
+  uint64_t free_us = 0U;
+  size_t window_start = 0U;
+  uint32_t peak_in_window = 0UL;
+  for (size_t i = 0U; i < publishes.size(); i++) {
+    const uint64_t arrival_us = static_cast<uint64_t>(publishes[i].sent_ms) * 1000U;
+    free_us = std::max(free_us, arrival_us) + BROKER_SERVICE_US;
+    load.latency_us.push_back(static_cast<uint32_t>(free_us - arrival_us));
+    while ((publishes[i].sent_ms - publishes[window_start].sent_ms) >= RATE_WINDOW_MS) {
+      window_start++;
+    }
+    peak_in_window = std::max(peak_in_window, static_cast<uint32_t>(i + 1U - window_start));
+  }
+  load.peak_per_s = peak_in_window * (1000UL / RATE_WINDOW_MS);
+  load.mean_per_s = (static_cast<double>(publishes.size()) * 1000.0) / RUN_MS;
+  return load;
+}
+
+bool ClientIdsUnique(const std::vector<DeviceSummary>& devices) {
+  std::set<std::string> ids;
+  for (const DeviceSummary& device : devices) {
+    ids.insert(device.client_id);
+  }
+  return ids.size() == devices.size();
+}
+
+void PrintHeader() {
+  printf("  %6s %-6s %13s %13s %13s %13s %8s %8s %19s\n",
+         "fleet",
+         "jitter",
+         "connect",
+         "discovered",
+         "reconnect",
+         "rediscovered",
+         "peak",
+         "mean",
+         "latency p50/p99/max");
+  printf("  %6s %-6s %13s %13s %13s %13s %8s %8s %19s\n",
+         "",
+         "",
+         "p50/max s",
+         "p50/max s",
+         "p50/max s",
+         "p50/max s",
+         "msg/s",
+         "msg/s",
+         "ms");
+}
+
+void PrintSpread(const std::vector<uint32_t>& values_ms) {
+  printf(" %6.1f/%6.1f", Percentile(values_ms, 50U) / 1000.0, Percentile(values_ms, 100U) / 1000.0);
+}
+
+void PrintFleet(const uint32_t size, const bool jitter, const FleetReport& report, const BrokerLoad& load) {
+  printf("  %6u %-6s", size, jitter ? "on" : "off");
+  PrintSpread(Collect(report.devices, &DeviceSummary::connect_ms));
+  PrintSpread(Collect(report.devices, &DeviceSummary::discovered_ms));
+  PrintSpread(Collect(report.devices, &DeviceSummary::reconnect_ms));
+  PrintSpread(Collect(report.devices, &DeviceSummary::rediscovered_ms));
+  printf(" %8u %8.1f %6.1f/%5.1f/%6.1f\n",
+         load.peak_per_s,
+         load.mean_per_s,
+         Percentile(load.latency_us, 50U) / 1000.0,
+         Percentile(load.latency_us, 99U) / 1000.0,
+         Percentile(load.latency_us, 100U) / 1000.0);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const std::vector<uint32_t> sizes = quick ? std::vector<uint32_t>(std::begin(QUICK_FLEET_SIZES), std::end(QUICK_FLEET_SIZES))
+                                            : std::vector<uint32_t>(std::begin(FULL_FLEET_SIZES), std::end(FULL_FLEET_SIZES));
+
+  printf("fleet on one broker: power-on together, broker restart at %u s for %u s, %u s run\n",
+         RESTART_AT_MS / 1000U,
+         BROKER_DOWN_MS / 1000U,
+         RUN_MS / 1000U);
+  printf("broker model: one message per %u us\n", BROKER_SERVICE_US);
+  PrintHeader();
+  bool ok = true;
+  for (const uint32_t size : sizes) {
+    uint32_t peak_per_s[2] = {};
+    for (const bool jitter : {false, true}) {
+      FleetReport report;
+      if (!RunFleet(size, jitter, &report)) {
+        printf("FAIL: a device of a %u-device fleet did not connect or reconnect\n", size);
+        return 1;
+      }
+      const BrokerLoad load = ModelBroker(report.publishes);
+      PrintFleet(size, jitter, report, load);
+      peak_per_s[jitter ? 1 : 0] = load.peak_per_s;
+      if (!ClientIdsUnique(report.devices)) {
+        printf("FAIL: client IDs collide in a %u-device fleet\n", size);
+        ok = false;
+      }
+    }
+    // Jitter must flatten the burst once there is a fleet to spread.
+    if ((size > 1UL) && (peak_per_s[1] >= peak_per_s[0])) {
+      printf("FAIL: jitter did not lower the peak rate of a %u-device fleet\n", size);
+      ok = false;
+    }
+  }
+  return ok ? 0 : 1;
+}
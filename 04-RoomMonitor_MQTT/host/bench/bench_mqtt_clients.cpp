@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <PubSubClient.h>
+
+#include <chrono>
+
+#include "config.h"
+#include "data_model.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "mqtt_lite_client.h"
+
+// The same state cycle published through PubSubClient (QoS 0, full topic
+// on every message) and MqttLiteClient (QoS 1 with topic aliases), each to
+// its own in-process broker: bytes on the wire in both directions and
+// messages per second of host time. Every cycle is the five state topics,
+// serviced on the MQTT cadence as the sketch does.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FULL_CYCLES = 20000UL;
+constexpr uint32_t QUICK_CYCLES = 500UL;
+
+constexpr uint8_t STATE_COUNT = SENSOR_FIELD_COUNT;
+const char* const STATE_TOPICS[STATE_COUNT] = {
+    TOPIC_TEMP_STATE, TOPIC_HUM_STATE, TOPIC_PRESSURE_STATE, TOPIC_SOIL1_STATE, TOPIC_SOIL2_STATE};
+
+struct ClientRun {
+  const char* name;
+  uint32_t messages;
+  uint32_t bytes_in;   // client to broker
+  uint32_t bytes_out;  // broker to client
+  uint32_t unacked;
+  double seconds;
+};
+
+// Values move a little every cycle, as in a live room.
+void FormatState(const uint8_t metric, const uint32_t cycle, char* out, const size_t size) {
+  static const float BASE[STATE_COUNT] = {21.0F, 45.0F, 1013.0F, 38.0F, 52.0F};
+  (void)snprintf(out, size, "%.1f", BASE[metric] + (static_cast<float>(cycle % 20UL) / 10.0F));
+}
+
+template <typename MqttClientType>
+ClientRun Run(const char* name, MqttClientType* client, HostBroker* broker, const uint32_t cycles) {
+  ClientRun run = {name, 0UL, 0UL, 0UL, 0UL, 0.0};
+  client->setBufferSize(MQTT_BUFFER_SIZE_BYTES);
+  client->setServer(MQTT_SERVER, MQTT_PORT);
+  if (!client->connect("bench_clients")) {
+    return run;
+  }
+  const uint32_t connect_in = broker->GetBytesIn();
+  const uint32_t connect_out = broker->GetBytesOut();
+
+  char payload[16];
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t cycle = 0UL; cycle < cycles; cycle++) {
+    for (uint8_t metric = 0U; metric < STATE_COUNT; metric++) {
+      FormatState(metric, cycle, payload, sizeof(payload));
+      (void)client->publish(STATE_TOPICS[metric], payload, true);
+    }
+    HostClock_AdvanceMs(MQTT_SERVICE_INTERVAL_MS);
+    (void)client->loop();
+  }
+  run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  run.messages = static_cast<uint32_t>(broker->GetMessages().size());
+  run.bytes_in = broker->GetBytesIn() - connect_in;
+  run.bytes_out = broker->GetBytesOut() - connect_out;
+  return run;
+}
+
+ClientRun RunPubSubClient(const uint32_t cycles) {
+  HostHal_Reset();
+  HostBroker broker;
+  HostTransportClient transport(&broker);
+  PubSubClient client(transport);
+  return Run("PubSubClient", &client, &broker, cycles);
+}
+
+ClientRun RunLiteClient(const uint32_t cycles) {
+  HostHal_Reset();
+  HostBroker broker;
+  broker.Config().topic_alias_maximum = MQTT_LITE_TOPIC_ALIAS_SLOTS;
+  HostTransportClient transport(&broker);
+  MqttLiteClient client;
+  client.setClient(transport);
+  ClientRun run = Run("MqttLiteClient", &client, &broker, cycles);
+  run.unacked = client.unackedCount() + client.inFlightCount();
+  return run;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const uint32_t cycles = quick ? QUICK_CYCLES : FULL_CYCLES;
+  const uint32_t expected = cycles * STATE_COUNT;
+
+  const ClientRun runs[] = {RunPubSubClient(cycles), RunLiteClient(cycles)};
+  printf("%u cycles of %u state topics, session setup excluded\n", cycles, STATE_COUNT);
+  printf("  %-15s %9s %10s %10s %8s %8s %12s\n", "client", "messages", "bytes in", "bytes out", "B/msg", "unacked",
+         "messages/s");
+  bool ok = true;
+  for (const ClientRun& run : runs) {
+    const double per_message = (run.messages > 0UL) ? static_cast<double>(run.bytes_in) / run.messages : 0.0;
+    const double rate = (run.seconds > 0.0) ? run.messages / run.seconds : 0.0;
+    printf("  %-15s %9u %10u %10u %8.1f %8u %12.0f\n",
+           run.name,
+           run.messages,
+           run.bytes_in,
+           run.bytes_out,
+           per_message,
+           run.unacked,
+           rate);
+    if (run.messages != expected) {
+      printf("FAIL: %s delivered %u of %u messages\n", run.name, run.messages, expected);
+      ok = false;
+    }
+  }
+  if (runs[1].unacked != 0UL) {
+    printf("FAIL: MqttLiteClient left %u messages unacknowledged\n", runs[1].unacked);
+    ok = false;
+  }
+  // Aliases must more than pay for the QoS 1 packet identifiers.
+  if (runs[1].bytes_in >= runs[0].bytes_in) {
+    printf("FAIL: MqttLiteClient sent no fewer bytes than PubSubClient\n");
+    ok = false;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "boot_profiler.h"
+#include "config.h"
+#include "data_model.h"
+#include "display_service.h"
+#include "fakes/host_clock.h"
+#include "hal.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+#include "instrumentation.h"
+#include "logger.h"
+#include "mqtt_manager.h"
+#include "power_manager.h"
+#include "rate_controller.h"
+#include "rolling_stats.h"
+#include "sensor_service.h"
+#include "task_scheduler.h"
+#include "wifi_manager.h"
+
+// The whole sketch through a simulated day, always on and in low-power
+// mode, with and without someone glancing at the panel: average supply
+// current from power_manager's per-state estimate, checked against an
+// independent integration of the states the fakes saw (MCU idle sleeps,
+// panel asleep, radio joining, associated or in power-save), and what that
+// means for a battery.
+//
+// LOW_POWER_ENABLED is a constexpr, so the low-power device is its own
+// copy of power_manager.cpp and the sketch with the flag name swapped by
+// the preprocessor for one that is on. Their headers are included above
+// and stay out of the namespace. Each device runs in a forked child, since
+// the other modules' state is global.
+
+namespace RoomMonitorConfig {
+constexpr bool HOST_LOW_POWER_ON = true;
+}  // namespace RoomMonitorConfig
+
+#define LOW_POWER_ENABLED HOST_LOW_POWER_ON
+namespace low_power {
+#include "power_manager.cpp"
+#include HOST_SKETCH_PATH
+}  // namespace low_power
+#undef LOW_POWER_ENABLED
+
+void setup();
+void loop();
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t HOUR_MS = 60UL * 60UL * 1000UL;
+constexpr uint32_t FULL_RUN_MS = 24UL * HOUR_MS;
+constexpr uint32_t QUICK_RUN_MS = 2UL * HOUR_MS;
+// Installed at 07:00; people are about for the first 16 hours and touch
+// the carrier pads for a second every 15 minutes.
+constexpr uint32_t WAKING_MS = 16UL * HOUR_MS;
+constexpr uint32_t GLANCE_PERIOD_MS = 15UL * 60UL * 1000UL;
+constexpr uint32_t GLANCE_HOLD_MS = 1000UL;
+constexpr uint32_t CHUNK_MS = 250UL;
+constexpr uint32_t BATTERY_MAH = 2000UL;
+// The firmware samples the radio state once per power task; the model
+// sees it every loop pass.
+constexpr double MAX_ESTIMATE_ERROR = 0.01;
+
+struct Device {
+  void (*setup)();
+  void (*loop)();
+  uint32_t (*average_ua)();
+  // An always-on loop() spins until the next release; the host skips
+  // that gap instead of polling. A low-power loop() idles through it.
+  bool skip_gaps;
+};
+
+const Device ALWAYS_ON = {setup, loop, PowerManager_AverageCurrentUa, true};
+const Device LOW_POWER = {low_power::setup, low_power::loop, low_power::PowerManager_AverageCurrentUa, false};
+
+struct Scenario {
+  const char* name;
+  const Device* device;
+  bool glances;
+};
+
+const Scenario SCENARIOS[] = {
+    {"always on", &ALWAYS_ON, false},
+    {"low power, untouched", &LOW_POWER, false},
+    {"low power, glances", &LOW_POWER, true},
+};
+constexpr uint8_t SCENARIO_COUNT = sizeof(SCENARIOS) / sizeof(SCENARIOS[0]);
+
+struct DayReport {
+  uint32_t firmware_ua;
+  double model_ua;
+  double idle_share;
+  double panel_share;
+  double associated_share;
+  uint32_t messages;
+};
+
+// The model's own integration, in uA x us.
+struct Model {
+  double charge;
+  uint64_t elapsed_us;
+  uint64_t idle_us;
+  uint64_t panel_us;
+  uint64_t associated_us;
+};
+
+uint32_t RadioUa() {
+  if (!Hal_WifiIsConnected()) {
+    return POWER_RADIO_JOIN_UA;
+  }
+  return HostHal_IsWifiLowPower() ? POWER_RADIO_SAVE_UA : POWER_RADIO_ACTIVE_UA;
+}
+
+// One loop() pass, plus any skipped gap, charged at the states the pass
+// left behind. Each idle sleep ends on a millisecond boundary.
+void Step(const Device& device, Model* model) {
+  const uint64_t start_us = HostClock_NowUs();
+  const uint32_t sleeps_before = HostHal_GetIdleSleeps();
+  device.loop();
+  const uint32_t gap_ms = device.skip_gaps ? TaskScheduler_MsUntilNextRelease(millis()) : 0UL;
+  if (gap_ms > 0UL) {
+    HostClock_AdvanceMs(gap_ms);
+  }
+
+  const uint64_t elapsed_us = HostClock_NowUs() - start_us;
+  uint64_t idle_us = static_cast<uint64_t>(HostHal_GetIdleSleeps() - sleeps_before) * 1000U;
+  idle_us = (idle_us < elapsed_us) ? idle_us : elapsed_us;
+  const bool panel_on = !HostHal_GetDisplay()->IsAsleep();
+  const bool associated = Hal_WifiIsConnected();
+  model->charge += static_cast<double>(elapsed_us - idle_us) * POWER_MCU_ACTIVE_UA;
+  model->charge += static_cast<double>(idle_us) * POWER_MCU_IDLE_UA;
+  model->charge += static_cast<double>(elapsed_us) * (panel_on ? POWER_DISPLAY_ON_UA : POWER_DISPLAY_SLEEP_UA);
+  model->charge += static_cast<double>(elapsed_us) * RadioUa();
+  model->elapsed_us += elapsed_us;
+  model->idle_us += idle_us;
+  model->panel_us += panel_on ? elapsed_us : 0U;
+  model->associated_us += associated ? elapsed_us : 0U;
+}
+
+bool IsGlancing(const uint32_t now_ms) {
+  return ((now_ms % (24UL * HOUR_MS)) < WAKING_MS) && ((now_ms % GLANCE_PERIOD_MS) < GLANCE_HOLD_MS);
+}
+
+bool RunDay(const Scenario& scenario, const uint32_t run_ms, FILE* out) {
+  HostSketch_Reset();
+  const Device& device = *scenario.device;
+  device.setup();
+
+  Model model = {};
+  const uint32_t start_ms = millis();
+  while ((millis() - start_ms) < run_ms) {
+    HostHal_SetTouch(scenario.glances && IsGlancing(millis() - start_ms));
+    const uint32_t chunk_start_ms = millis();
+    while ((millis() - chunk_start_ms) < CHUNK_MS) {
+      Step(device, &model);
+    }
+  }
+
+  const double elapsed_us = static_cast<double>(model.elapsed_us);
+  const DayReport report = {device.average_ua(),
+                            model.charge / elapsed_us,
+                            model.idle_us / elapsed_us,
+                            model.panel_us / elapsed_us,
+                            model.associated_us / elapsed_us,
+                            static_cast<uint32_t>(HostHal_GetBroker()->GetMessages().size())};
+  return (fwrite(&report, sizeof(report), 1U, out) == 1U) && (fflush(out) == 0);
+}
+
+double BatteryDays(const double average_ua) {
+  return (average_ua > 0.0) ? ((BATTERY_MAH * 1000.0) / average_ua) / 24.0 : 0.0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const uint32_t run_ms = quick ? QUICK_RUN_MS : FULL_RUN_MS;
+
+  FILE* out = tmpfile();
+  if (out == nullptr) {
+    return 1;
+  }
+  for (const Scenario& scenario : SCENARIOS) {
+    if (!HostSketch_RunIsolated([&scenario, run_ms, out]() { return RunDay(scenario, run_ms, out); })) {
+      printf("FAIL: %s did not finish its day\n", scenario.name);
+      return 1;
+    }
+  }
+  rewind(out);
+  std::vector<DayReport> reports(SCENARIO_COUNT);
+  const bool read = fread(reports.data(), sizeof(DayReport), SCENARIO_COUNT, out) == SCENARIO_COUNT;
+  fclose(out);
+  if (!read) {
+    return 1;
+  }
+
+  printf("simulated %u h from 07:00, glances every %u min for %u h, %u mAh battery\n",
+         run_ms / HOUR_MS,
+         GLANCE_PERIOD_MS / 60000U,
+         WAKING_MS / HOUR_MS,
+         BATTERY_MAH);
+  printf("  %-22s %9s %9s %7s %7s %7s %8s %8s\n",
+         "scenario",
+         "firmware",
+         "model",
+         "idle",
+         "panel",
+         "assoc",
+         "msgs",
+         "battery");
+  printf("  %-22s %9s %9s %7s %7s %7s %8s %8s\n", "", "mA", "mA", "%", "%", "%", "", "days");
+  bool ok = true;
+  for (uint8_t i = 0U; i < SCENARIO_COUNT; i++) {
+    const DayReport& report = reports[i];
+    printf("  %-22s %9.2f %9.2f %7.1f %7.1f %7.1f %8u %8.1f\n",
+           SCENARIOS[i].name,
+           report.firmware_ua / 1000.0,
+           report.model_ua / 1000.0,
+           report.idle_share * 100.0,
+           report.panel_share * 100.0,
+           report.associated_share * 100.0,
+           report.messages,
+           BatteryDays(report.firmware_ua));
+    const double error = (report.firmware_ua - report.model_ua) / report.model_ua;
+    if ((error > MAX_ESTIMATE_ERROR) || (error < -MAX_ESTIMATE_ERROR)) {
+      printf("FAIL: %s: the firmware estimate is %.1f %% off the model\n", SCENARIOS[i].name, error * 100.0);
+      ok = false;
+    }
+    if (report.messages == 0UL) {
+      printf("FAIL: %s never reached the broker\n", SCENARIOS[i].name);
+      ok = false;
+    }
+  }
+  // Sleeping must pay off, and glances can only cost.
+  if ((reports[1].firmware_ua >= reports[0].firmware_ua) || (reports[2].firmware_ua < reports[1].firmware_ua)) {
+    printf("FAIL: low-power mode does not order below always-on\n");
+    ok = false;
+  }
+  return ok ? 0 : 1;
+}
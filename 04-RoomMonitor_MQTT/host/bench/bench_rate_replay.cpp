@@ -0,0 +1,278 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "boot_profiler.h"
+#include "config.h"
+#include "data_model.h"
+#include "display_service.h"
+#include "fakes/host_clock.h"
+#include "hal.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+#include "instrumentation.h"
+#include "logger.h"
+#include "mqtt_manager.h"
+#include "power_manager.h"
+#include "rate_controller.h"
+#include "rolling_stats.h"
+#include "sensor_service.h"
+#include "task_scheduler.h"
+#include "wifi_manager.h"
+
+// Replays a room with a few sudden events through the sketch at the fixed
+// rates and with the adaptive rate controller: state messages sent, the
+// range the publish interval moved over, and how long after each event's
+// onset the broker first saw a value at least half way to the new level.
+//
+// ADAPTIVE_RATE_ENABLED is a constexpr, so the adaptive device is its own
+// copy of rate_controller.cpp, sensor_service.cpp (which paces the
+// channels by it) and the sketch, with the flag name swapped by the
+// preprocessor for one that is on. The controller's functions are renamed
+// too, as argument-dependent lookup would also find the global ones.
+// Their headers are included above and stay out of the namespace. Each
+// device runs in a forked child, since the other modules' state is global.
+
+namespace RoomMonitorConfig {
+constexpr bool HOST_ADAPTIVE_RATE_ON = true;
+}  // namespace RoomMonitorConfig
+
+#define ADAPTIVE_RATE_ENABLED HOST_ADAPTIVE_RATE_ON
+#define RateController_Observe AdaptiveRate_Observe
+#define RateController_ScalePeriod AdaptiveRate_ScalePeriod
+#define RateController_PublishIntervalMs AdaptiveRate_PublishIntervalMs
+#define RateController_SampleIntervalMs AdaptiveRate_SampleIntervalMs
+namespace adaptive {
+#include "rate_controller.cpp"
+#include "sensor_service.cpp"
+#include HOST_SKETCH_PATH
+}  // namespace adaptive
+#undef RateController_SampleIntervalMs
+#undef RateController_PublishIntervalMs
+#undef RateController_ScalePeriod
+#undef RateController_Observe
+#undef ADAPTIVE_RATE_ENABLED
+
+void setup();
+void loop();
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t MINUTE_MS = 60UL * 1000UL;
+constexpr uint32_t FULL_RUN_MS = 6UL * 60UL * MINUTE_MS;
+constexpr uint32_t QUICK_RUN_MS = 80UL * MINUTE_MS;
+// Each event ramps to its new level over RAMP_MS, holds for HOLD_MS and
+// ramps back.
+constexpr uint32_t RAMP_MS = 30UL * 1000UL;
+constexpr uint32_t HOLD_MS = 15UL * MINUTE_MS;
+
+struct RoomEvent {
+  const char* name;
+  HostSensor sensor;
+  const char* topic;
+  float level;   // in the published unit
+  float change;  // in the published unit
+  uint32_t period_ms;
+};
+
+const RoomEvent EVENTS[] = {
+    {"window opened", HOST_SENSOR_TEMPERATURE, TOPIC_TEMP_STATE, 21.0F, -2.0F, SENSOR_TEMP_PERIOD_MS},
+    {"shower", HOST_SENSOR_HUMIDITY, TOPIC_HUM_STATE, 45.0F, 15.0F, SENSOR_HUM_PERIOD_MS},
+    {"plant watered", HOST_SENSOR_SOIL1, TOPIC_SOIL1_STATE, 30.0F, 30.0F, SENSOR_SOIL_PERIOD_MS},
+};
+constexpr uint8_t EVENT_COUNT = sizeof(EVENTS) / sizeof(EVENTS[0]);
+
+const char* const STATE_TOPICS[SENSOR_FIELD_COUNT] = {
+    TOPIC_TEMP_STATE, TOPIC_HUM_STATE, TOPIC_PRESSURE_STATE, TOPIC_SOIL1_STATE, TOPIC_SOIL2_STATE};
+
+struct Device {
+  const char* name;
+  void (*setup)();
+  void (*loop)();
+  uint32_t (*publish_interval_ms)();
+};
+
+const Device FIXED = {"fixed rate", setup, loop, RateController_PublishIntervalMs};
+const Device ADAPTIVE = {"adaptive", adaptive::setup, adaptive::loop, adaptive::AdaptiveRate_PublishIntervalMs};
+
+struct ReplayReport {
+  uint32_t messages;
+  uint32_t shortest_publish_ms;
+  uint32_t longest_publish_ms;
+  uint32_t latency_ms[EVENT_COUNT];  // UINT32_MAX when never seen
+};
+
+// Deterministic noise in [-amplitude, amplitude] keyed by time and channel.
+float Noise(const uint32_t now_ms, const uint32_t channel, const float amplitude) {
+  uint32_t x = (now_ms * 2654435761UL) ^ (channel * 40503UL);
+  x ^= x >> 13;
+  x *= 1274126177UL;
+  x ^= x >> 16;
+  return amplitude * ((static_cast<float>(x & 0xFFFFUL) / 32767.5F) - 1.0F);
+}
+
+// Events spread evenly over the run, after the sketch's first publishes.
+uint32_t OnsetMs(const uint8_t event, const uint32_t run_ms) {
+  return ((event + 1UL) * run_ms) / (EVENT_COUNT + 1UL);
+}
+
+// Share of the event's change present at `now_ms`: a trapezoid.
+float EventShare(const uint32_t now_ms, const uint32_t onset_ms) {
+  if (now_ms < onset_ms) {
+    return 0.0F;
+  }
+  const uint32_t since_ms = now_ms - onset_ms;
+  if (since_ms < RAMP_MS) {
+    return static_cast<float>(since_ms) / RAMP_MS;
+  }
+  if (since_ms < (RAMP_MS + HOLD_MS)) {
+    return 1.0F;
+  }
+  const uint32_t back_ms = since_ms - (RAMP_MS + HOLD_MS);
+  return (back_ms < RAMP_MS) ? (1.0F - (static_cast<float>(back_ms) / RAMP_MS)) : 0.0F;
+}
+
+// Moisture percentage to the raw ADC counts the probe reports.
+float SoilRaw(const float percent) {
+  return static_cast<float>(SOIL_ADC_MAX) * (1.0F - (percent / 100.0F));
+}
+
+void InstallRoom(const uint32_t run_ms) {
+  for (uint8_t i = 0U; i < EVENT_COUNT; i++) {
+    const RoomEvent& event = EVENTS[i];
+    const uint32_t onset_ms = OnsetMs(i, run_ms);
+    HostHal_SetSensorScript(event.sensor, [&event, onset_ms](uint32_t now_ms) {
+      const float value = event.level + (event.change * EventShare(now_ms, onset_ms));
+      return (event.sensor == HOST_SENSOR_SOIL1) ? SoilRaw(value) + Noise(now_ms, event.sensor, 4.0F)
+                                                 : value + Noise(now_ms, event.sensor, 0.04F);
+    });
+  }
+  HostHal_SetSensorScript(HOST_SENSOR_PRESSURE,
+                          [](uint32_t now_ms) { return 1013.0F + Noise(now_ms, HOST_SENSOR_PRESSURE, 0.1F); });
+  HostHal_SetSensorScript(HOST_SENSOR_SOIL2,
+                          [](uint32_t now_ms) { return SoilRaw(50.0F) + Noise(now_ms, HOST_SENSOR_SOIL2, 4.0F); });
+}
+
+bool IsStateTopic(const std::string& topic) {
+  for (const char* state_topic : STATE_TOPICS) {
+    if (topic == state_topic) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// First value on the event's topic at least half way to the new level.
+uint32_t DetectionLatencyMs(const RoomEvent& event, const uint32_t onset_ms) {
+  const float threshold = event.level + (0.5F * event.change);
+  for (const HostMqttMessage& message : HostHal_GetBroker()->GetMessages()) {
+    if ((message.received_ms < onset_ms) || (message.topic != event.topic)) {
+      continue;
+    }
+    const float value = strtof(message.payload.c_str(), nullptr);
+    if ((event.change < 0.0F) ? (value <= threshold) : (value >= threshold)) {
+      return message.received_ms - onset_ms;
+    }
+  }
+  return UINT32_MAX;
+}
+
+// Runs the device until `run_ms`; gaps between task releases are skipped.
+bool Replay(const Device& device, const uint32_t run_ms, FILE* out) {
+  HostSketch_Reset();
+  InstallRoom(run_ms);
+  device.setup();
+  ReplayReport report = {0UL, UINT32_MAX, 0UL, {}};
+  while (millis() < run_ms) {
+    device.loop();
+    const uint32_t publish_ms = device.publish_interval_ms();
+    report.shortest_publish_ms = (publish_ms < report.shortest_publish_ms) ? publish_ms : report.shortest_publish_ms;
+    report.longest_publish_ms = (publish_ms > report.longest_publish_ms) ? publish_ms : report.longest_publish_ms;
+    const uint32_t idle_ms = TaskScheduler_MsUntilNextRelease(millis());
+    if (idle_ms > 0UL) {
+      HostClock_AdvanceMs(idle_ms);
+    }
+  }
+
+  for (const HostMqttMessage& message : HostHal_GetBroker()->GetMessages()) {
+    report.messages += IsStateTopic(message.topic) ? 1UL : 0UL;
+  }
+  for (uint8_t i = 0U; i < EVENT_COUNT; i++) {
+    report.latency_ms[i] = DetectionLatencyMs(EVENTS[i], OnsetMs(i, run_ms));
+  }
+  return (fwrite(&report, sizeof(report), 1U, out) == 1U) && (fflush(out) == 0);
+}
+
+void PrintLatency(const uint32_t latency_ms) {
+  if (latency_ms == UINT32_MAX) {
+    printf(" %13s", "missed");
+  } else {
+    printf(" %11.1f s", latency_ms / 1000.0);
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const uint32_t run_ms = quick ? QUICK_RUN_MS : FULL_RUN_MS;
+
+  const Device* const devices[] = {&FIXED, &ADAPTIVE};
+  ReplayReport reports[2] = {};
+  FILE* out = tmpfile();
+  if (out == nullptr) {
+    return 1;
+  }
+  for (uint8_t i = 0U; i < 2U; i++) {
+    const Device& device = *devices[i];
+    if (!HostSketch_RunIsolated([&device, run_ms, out]() { return Replay(device, run_ms, out); })) {
+      printf("FAIL: %s did not finish the replay\n", device.name);
+      return 1;
+    }
+  }
+  rewind(out);
+  const bool read = fread(reports, sizeof(ReplayReport), 2U, out) == 2U;
+  fclose(out);
+  if (!read) {
+    return 1;
+  }
+
+  printf("replay of %u min, events ramping over %u s, state messages and time to half the change\n",
+         run_ms / MINUTE_MS,
+         RAMP_MS / 1000U);
+  printf("  %-12s %9s %14s", "device", "messages", "publish every");
+  for (const RoomEvent& event : EVENTS) {
+    printf(" %13s", event.name);
+  }
+  printf("\n");
+  bool ok = true;
+  for (uint8_t i = 0U; i < 2U; i++) {
+    printf("  %-12s %9u %6.1f-%5.1f s",
+           devices[i]->name,
+           reports[i].messages,
+           reports[i].shortest_publish_ms / 1000.0,
+           reports[i].longest_publish_ms / 1000.0);
+    for (uint8_t e = 0U; e < EVENT_COUNT; e++) {
+      PrintLatency(reports[i].latency_ms[e]);
+      ok = ok && (reports[i].latency_ms[e] != UINT32_MAX);
+    }
+    printf("\n");
+  }
+  if (!ok) {
+    printf("FAIL: an event never reached the broker\n");
+    return 1;
+  }
+  // A quiet channel has backed off, so the event's first sample can come
+  // up to one backed-off period later; after that it runs fastest.
+  for (uint8_t e = 0U; e < EVENT_COUNT; e++) {
+    const uint32_t backed_off_ms = EVENTS[e].period_ms << ADAPTIVE_RATE_SLOW_SHIFT;
+    if (reports[1].latency_ms[e] > (reports[0].latency_ms[e] + backed_off_ms)) {
+      printf("FAIL: %s is detected later with the adaptive rate\n", EVENTS[e].name);
+      ok = false;
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "config.h"
+#include "data_model.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+
+// Report-by-exception over a day of room data: state publishes per metric
+// against the fixed-rate baseline (every metric every PUBLISH_INTERVAL_MS),
+// and the longest silence per metric against its MQTT_MAX_SILENCE_*_MS.
+// The day is a scripted stand-in for a recording: a diurnal temperature
+// swing with a thermostat cycling the heating in the morning and evening,
+// a shower humidity spike,
+// a pressure front, two pots drying out after a morning watering, and
+// sensor noise on top.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FULL_DURATION_MS = 24UL * 60UL * 60UL * 1000UL;
+constexpr uint32_t QUICK_DURATION_MS = 2UL * 60UL * 60UL * 1000UL;
+constexpr float TWO_PI = 6.2831853F;
+constexpr float HOUR_MS = 3600000.0F;
+
+constexpr uint8_t METRIC_COUNT = SENSOR_FIELD_COUNT;
+const char* const STATE_TOPICS[METRIC_COUNT] = {
+    TOPIC_TEMP_STATE, TOPIC_HUM_STATE, TOPIC_PRESSURE_STATE, TOPIC_SOIL1_STATE, TOPIC_SOIL2_STATE};
+const char* const METRIC_NAMES[METRIC_COUNT] = {"temperature", "humidity", "pressure", "soil1", "soil2"};
+const uint32_t MAX_SILENCE_MS[METRIC_COUNT] = {MQTT_MAX_SILENCE_TEMP_MS,
+                                               MQTT_MAX_SILENCE_HUM_MS,
+                                               MQTT_MAX_SILENCE_PRESSURE_MS,
+                                               MQTT_MAX_SILENCE_SOIL_MS,
+                                               MQTT_MAX_SILENCE_SOIL_MS};
+
+struct MetricReport {
+  uint32_t publishes;
+  uint32_t keepalives;
+  uint32_t longest_gap_ms;
+  uint32_t last_ms;
+};
+
+// Deterministic noise in [-amplitude, amplitude] keyed by time and channel.
+float Noise(const uint32_t now_ms, const uint32_t channel, const float amplitude) {
+  uint32_t x = (now_ms * 2654435761UL) ^ (channel * 40503UL);
+  x ^= x >> 13;
+  x *= 1274126177UL;
+  x ^= x >> 16;
+  return amplitude * ((static_cast<float>(x & 0xFFFFUL) / 32767.5F) - 1.0F);
+}
+
+float Hours(const uint32_t now_ms) {
+  return static_cast<float>(now_ms) / HOUR_MS;
+}
+
+// Smooth bump of the given height centred on centre_h, width_h wide.
+float Bump(const float hours, const float centre_h, const float width_h, const float height) {
+  const float x = (hours - centre_h) / width_h;
+  return height * expf(-(x * x));
+}
+
+// Thermostat hysteresis while the heating is on (06-09 and 17-22): a
+// triangle of amplitude_c every 30 minutes.
+float HeatingCycle(const float hours, const float amplitude_c) {
+  const bool heating = ((hours >= 6.0F) && (hours < 9.0F)) || ((hours >= 17.0F) && (hours < 22.0F));
+  if (!heating) {
+    return 0.0F;
+  }
+  const float phase = fmodf(hours * 2.0F, 1.0F);
+  return amplitude_c * ((phase < 0.5F) ? (2.0F * phase) : (2.0F - (2.0F * phase)));
+}
+
+// Moisture percentage to the raw ADC counts the probe reports.
+float SoilRaw(const float percent) {
+  return static_cast<float>(SOIL_ADC_MAX) * (1.0F - (percent / 100.0F));
+}
+
+// Pot watered at 07:00, drying by drying_pct_per_h.
+float SoilPercent(const float hours, const float watered_pct, const float drying_pct_per_h) {
+  const float since_h = fmodf(hours + 17.0F, 24.0F);
+  return watered_pct - (drying_pct_per_h * since_h);
+}
+
+void InstallRecordedDay() {
+  HostHal_SetSensorScript(HOST_SENSOR_TEMPERATURE, [](uint32_t now_ms) {
+    const float hours = Hours(now_ms);
+    return 20.0F + (1.5F * sinf(TWO_PI * (hours - 9.0F) / 24.0F)) + HeatingCycle(hours, 0.6F) +
+           Noise(now_ms, 0U, 0.04F);
+  });
+  HostHal_SetSensorScript(HOST_SENSOR_HUMIDITY, [](uint32_t now_ms) {
+    const float hours = Hours(now_ms);
+    return 48.0F - (4.0F * sinf(TWO_PI * (hours - 9.0F) / 24.0F)) + Bump(hours, 7.5F, 0.15F, 15.0F) +
+           Noise(now_ms, 1U, 0.3F);
+  });
+  HostHal_SetSensorScript(HOST_SENSOR_PRESSURE, [](uint32_t now_ms) {
+    const float hours = Hours(now_ms);
+    return 1014.0F - (6.0F / (1.0F + expf(-(hours - 14.0F)))) + Noise(now_ms, 2U, 0.1F);
+  });
+  HostHal_SetSensorScript(HOST_SENSOR_SOIL1, [](uint32_t now_ms) {
+    return SoilRaw(SoilPercent(Hours(now_ms), 65.0F, 0.6F)) + Noise(now_ms, 3U, 4.0F);
+  });
+  HostHal_SetSensorScript(HOST_SENSOR_SOIL2, [](uint32_t now_ms) {
+    return SoilRaw(SoilPercent(Hours(now_ms), 55.0F, 1.2F)) + Noise(now_ms, 4U, 4.0F);
+  });
+}
+
+int FindMetric(const std::string& topic) {
+  for (uint8_t i = 0U; i < METRIC_COUNT; i++) {
+    if (topic == STATE_TOPICS[i]) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool RunDay(const uint32_t duration_ms) {
+  HostSketch_Reset();
+  InstallRecordedDay();
+  HostSketch_Setup();
+  HostBroker* broker = HostHal_GetBroker();
+  if (!HostSketch_RunUntil([broker]() { return broker->GetRetained(TOPIC_SOIL2_STATE) != nullptr; }, 60000UL)) {
+    return false;
+  }
+  broker->ClearMessages();
+  const uint32_t start_ms = millis();
+  HostSketch_RunFor(duration_ms);
+
+  MetricReport reports[METRIC_COUNT] = {};
+  for (uint8_t i = 0U; i < METRIC_COUNT; i++) {
+    reports[i].last_ms = start_ms;
+  }
+  for (const HostMqttMessage& message : broker->GetMessages()) {
+    const int metric = FindMetric(message.topic);
+    if (metric < 0) {
+      continue;
+    }
+    MetricReport& report = reports[metric];
+    const uint32_t gap_ms = message.received_ms - report.last_ms;
+    report.longest_gap_ms = (gap_ms > report.longest_gap_ms) ? gap_ms : report.longest_gap_ms;
+    report.keepalives += (gap_ms >= MAX_SILENCE_MS[metric]) ? 1UL : 0UL;
+    report.last_ms = message.received_ms;
+    report.publishes++;
+  }
+
+  const uint32_t fixed_rate = duration_ms / PUBLISH_INTERVAL_MS;
+  uint32_t total = 0UL;
+  uint32_t keepalives = 0UL;
+  bool ok = true;
+  printf("  %-12s %9s %9s %10s %9s %12s %12s\n",
+         "metric",
+         "fixed",
+         "sent",
+         "keepalive",
+         "saved",
+         "longest gap",
+         "max silence");
+  for (uint8_t i = 0U; i < METRIC_COUNT; i++) {
+    const MetricReport& report = reports[i];
+    const uint32_t tail_ms = (start_ms + duration_ms) - report.last_ms;
+    const uint32_t longest_gap_ms = (tail_ms > report.longest_gap_ms) ? tail_ms : report.longest_gap_ms;
+    printf("  %-12s %9u %9u %10u %8.1f%% %10u s %10u s\n",
+           METRIC_NAMES[i],
+           fixed_rate,
+           report.publishes,
+           report.keepalives,
+           100.0 * (1.0 - (static_cast<double>(report.publishes) / fixed_rate)),
+           longest_gap_ms / 1000U,
+           MAX_SILENCE_MS[i] / 1000U);
+    // The keepalive goes out on the first publish tick after the limit.
+    ok = ok && (longest_gap_ms <= (MAX_SILENCE_MS[i] + PUBLISH_INTERVAL_MS));
+    total += report.publishes;
+    keepalives += report.keepalives;
+  }
+  const uint32_t fixed_total = fixed_rate * METRIC_COUNT;
+  printf("  %-12s %9u %9u %10u %8.1f%%\n",
+         "total",
+         fixed_total,
+         total,
+         keepalives,
+         100.0 * (1.0 - (static_cast<double>(total) / fixed_total)));
+  return ok && (total < fixed_total);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const uint32_t duration_ms = quick ? QUICK_DURATION_MS : FULL_DURATION_MS;
+
+  printf("state publishes over %u h of simulated room data\n", static_cast<unsigned>(duration_ms / 3600000UL));
+  const bool ok = RunDay(duration_ms);
+  if (!ok) {
+    printf("FAIL: a metric stayed silent too long or nothing was saved\n");
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "config.h"
+#include "data_model.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "rolling_stats.h"
+
+// Memory and time budget of the rolling statistics: the table sizes
+// against ROLLING_STATS_MEMORY_BUDGET_BYTES, the cost of the once-a-second
+// Add() early and after a full day (constant time, so the two should
+// match), and of a Get() per window. The module is compiled here in its
+// own namespace so its private tables can be measured; its headers are
+// included above and stay out of it. Host nanoseconds are only a ratio
+// against the same calls on the target.
+
+namespace stats {
+#include "rolling_stats.cpp"
+}  // namespace stats
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FULL_RUN_MS = 26UL * 60UL * 60UL * 1000UL;
+constexpr uint32_t QUICK_RUN_MS = 2UL * 60UL * 60UL * 1000UL;
+constexpr uint32_t WARMUP_SAMPLES = 600UL;
+constexpr uint32_t QUERY_ROUNDS = 20000UL;
+const char* const WINDOW_NAMES[STATS_WINDOW_COUNT] = {"1 min", "1 h", "24 h"};
+
+volatile float g_sink = 0.0F;
+
+SensorData Room(const uint32_t ms) {
+  SensorData data = {};
+  data.temperature_c = 21.0F + (0.5F * sinf(ms / 600000.0F));
+  data.humidity_pct = 45.0F + (5.0F * sinf(ms / 900000.0F));
+  data.pressure_hpa = 1013.0F + cosf(ms / 3600000.0F);
+  data.soil1_pct = static_cast<uint8_t>(40U + ((ms / 60000UL) % 7UL));
+  data.soil2_pct = 55U;
+  return data;
+}
+
+// Host ns per Add() over `samples` one-second steps.
+double TimeAdds(const uint32_t samples) {
+  uint64_t total_ns = 0U;
+  for (uint32_t i = 0UL; i < samples; i++) {
+    HostClock_AdvanceMs(DISPLAY_REFRESH_MS);
+    const SensorData data = Room(millis());
+    const auto begin = std::chrono::steady_clock::now();
+    stats::RollingStats_Add(&data, millis());
+    total_ns += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+  }
+  return static_cast<double>(total_ns) / samples;
+}
+
+double TimeGets(const StatsWindow window) {
+  StatsSummary summary = {};
+  const auto begin = std::chrono::steady_clock::now();
+  for (uint32_t i = 0UL; i < QUERY_ROUNDS; i++) {
+    (void)stats::RollingStats_Get(static_cast<SensorField>(i % SENSOR_FIELD_COUNT), window, &summary);
+    g_sink = g_sink + summary.trend_per_hour;
+  }
+  const uint64_t total_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+  return static_cast<double>(total_ns) / QUERY_ROUNDS;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const uint32_t run_ms = quick ? QUICK_RUN_MS : FULL_RUN_MS;
+
+  printf("rolling statistics: %u fields x %u windows x %u buckets\n",
+         static_cast<unsigned>(SENSOR_FIELD_COUNT),
+         static_cast<unsigned>(STATS_WINDOW_COUNT),
+         static_cast<unsigned>(ROLLING_STATS_BUCKETS));
+  printf("  bucket %u B, window ring %u B, tables %u B of a %u B budget (%u B spare)\n",
+         static_cast<unsigned>(sizeof(stats::StatsBucket)),
+         static_cast<unsigned>(sizeof(stats::WindowRing)),
+         static_cast<unsigned>(sizeof(stats::g_rings)),
+         static_cast<unsigned>(ROLLING_STATS_MEMORY_BUDGET_BYTES),
+         static_cast<unsigned>(ROLLING_STATS_MEMORY_BUDGET_BYTES - sizeof(stats::g_rings)));
+
+  HostHal_Reset();
+  const double early_ns = TimeAdds(WARMUP_SAMPLES);
+  const uint32_t remaining = (run_ms / DISPLAY_REFRESH_MS) - (2UL * WARMUP_SAMPLES);
+  (void)TimeAdds(remaining);
+  const double late_ns = TimeAdds(WARMUP_SAMPLES);
+  printf("  Add() per sensor task run: %.0f ns in the first %u s, %.0f ns after %u h (host)\n",
+         early_ns,
+         WARMUP_SAMPLES,
+         late_ns,
+         run_ms / 3600000U);
+  for (uint8_t window = 0U; window < STATS_WINDOW_COUNT; window++) {
+    printf("  Get() %-5s: %.0f ns per field (host)\n", WINDOW_NAMES[window], TimeGets(static_cast<StatsWindow>(window)));
+  }
+  return 0;
+}
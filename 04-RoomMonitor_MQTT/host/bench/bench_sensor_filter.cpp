@@ -0,0 +1,218 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <memory>
+#include <random>
+
+#include "config.h"
+#include "data_model.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "sensor_service.h"
+
+// Synthetic noisy signals through the sampling pipeline (ADC burst
+// oversampling, median-of-N, fixed-point EMA): noise reduction on a steady
+// room, step-response latency, and the cost of a SensorService_Sample()
+// call. Noise is Gaussian with occasional one-read spikes; the snapshot is
+// compared with the noise-free signal once a second. Host nanoseconds are
+// only a ratio against the same loop on the target.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FULL_STEADY_MS = 30UL * 60UL * 1000UL;
+constexpr uint32_t QUICK_STEADY_MS = 3UL * 60UL * 1000UL;
+constexpr uint32_t SETTLE_MS = 60000UL;
+constexpr uint32_t STEP_WINDOW_MS = 60000UL;
+constexpr uint32_t CHECK_INTERVAL_MS = 1000UL;
+constexpr float SPIKE_PROBABILITY = 0.01F;
+
+// Metric-unit view of a channel, so soil compares in percent.
+struct Channel {
+  const char* name;
+  HostSensor sensor;
+  float base;         // script units
+  float step;         // script units
+  float noise_sigma;  // script units
+  float spike;        // script units
+  float to_metric;    // script units to SensorData units
+  float metric_offset;
+  uint32_t period_ms;
+};
+
+// Soil raw counts fall as moisture rises: percent = 100 - raw / 10.23.
+constexpr float SOIL_PCT_PER_COUNT = -100.0F / static_cast<float>(SOIL_ADC_MAX);
+
+const Channel CHANNELS[] = {
+    {"temperature", HOST_SENSOR_TEMPERATURE, 21.0F, 2.0F, 0.15F, 3.0F, 1.0F, 0.0F, SENSOR_TEMP_PERIOD_MS},
+    {"humidity", HOST_SENSOR_HUMIDITY, 45.0F, 10.0F, 1.5F, 20.0F, 1.0F, 0.0F, SENSOR_HUM_PERIOD_MS},
+    {"pressure", HOST_SENSOR_PRESSURE, 1010.0F, 4.0F, 0.3F, 8.0F, 1.0F, 0.0F, SENSOR_PRESSURE_PERIOD_MS},
+    {"soil1", HOST_SENSOR_SOIL1, 600.0F, -200.0F, 25.0F, 300.0F, SOIL_PCT_PER_COUNT, 100.0F, SENSOR_SOIL_PERIOD_MS},
+};
+constexpr uint8_t CHANNEL_COUNT = sizeof(CHANNELS) / sizeof(CHANNELS[0]);
+
+struct ChannelResult {
+  double raw_sq;
+  double filtered_sq;
+  uint32_t raw_count;
+  uint32_t filtered_count;
+  uint32_t half_ms;  // to 50 % of the step
+  uint32_t most_ms;  // to 90 % of the step
+};
+
+uint32_t g_step_at_ms = UINT32_MAX;
+ChannelResult g_results[CHANNEL_COUNT];
+
+float MetricOf(const Channel& channel, const float script_value) {
+  return channel.metric_offset + (channel.to_metric * script_value);
+}
+
+float Truth(const Channel& channel, const uint32_t now_ms) {
+  return channel.base + ((now_ms >= g_step_at_ms) ? channel.step : 0.0F);
+}
+
+float Snapshot(const SensorData& data, const uint8_t index) {
+  switch (CHANNELS[index].sensor) {
+    case HOST_SENSOR_TEMPERATURE:
+      return data.temperature_c;
+    case HOST_SENSOR_HUMIDITY:
+      return data.humidity_pct;
+    case HOST_SENSOR_PRESSURE:
+      return data.pressure_hpa;
+    default:
+      return static_cast<float>(data.soil1_pct);
+  }
+}
+
+void InstallNoisyScripts() {
+  for (uint8_t i = 0U; i < CHANNEL_COUNT; i++) {
+    std::shared_ptr<std::mt19937> rng = std::make_shared<std::mt19937>(1234U + i);
+    HostHal_SetSensorScript(CHANNELS[i].sensor, [i, rng](uint32_t now_ms) {
+      const Channel& channel = CHANNELS[i];
+      std::normal_distribution<float> noise(0.0F, channel.noise_sigma);
+      std::uniform_real_distribution<float> chance(0.0F, 1.0F);
+      float value = Truth(channel, now_ms) + noise(*rng);
+      if (chance(*rng) < SPIKE_PROBABILITY) {
+        value += channel.spike;
+      }
+      // Raw error in metric units, for the "before" column.
+      if (now_ms < g_step_at_ms) {
+        const double error = MetricOf(channel, value) - MetricOf(channel, Truth(channel, now_ms));
+        g_results[i].raw_sq += error * error;
+        g_results[i].raw_count++;
+      }
+      return value;
+    });
+  }
+}
+
+// Runs the sample task for `duration_ms`; returns host ns spent in it.
+uint64_t SampleFor(const uint32_t duration_ms, uint32_t* calls, void (*each_second)(uint32_t now_ms)) {
+  uint64_t total_ns = 0U;
+  uint32_t next_check_ms = millis() + CHECK_INTERVAL_MS;
+  const uint32_t start_ms = millis();
+  while ((millis() - start_ms) < duration_ms) {
+    HostClock_AdvanceMs(SENSOR_SAMPLE_INTERVAL_MS);
+    const auto begin = std::chrono::steady_clock::now();
+    (void)SensorService_Sample();
+    total_ns += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+    (*calls)++;
+    if ((each_second != nullptr) && (static_cast<int32_t>(millis() - next_check_ms) >= 0L)) {
+      each_second(millis());
+      next_check_ms += CHECK_INTERVAL_MS;
+    }
+  }
+  return total_ns;
+}
+
+void CheckSteady(const uint32_t now_ms) {
+  const SensorData& data = SensorService_GetSnapshot()->data;
+  for (uint8_t i = 0U; i < CHANNEL_COUNT; i++) {
+    const double error = Snapshot(data, i) - MetricOf(CHANNELS[i], Truth(CHANNELS[i], now_ms));
+    g_results[i].filtered_sq += error * error;
+    g_results[i].filtered_count++;
+  }
+}
+
+void CheckStep(const uint32_t now_ms) {
+  const SensorData& data = SensorService_GetSnapshot()->data;
+  for (uint8_t i = 0U; i < CHANNEL_COUNT; i++) {
+    const Channel& channel = CHANNELS[i];
+    const float before = MetricOf(channel, channel.base);
+    const float progress = (Snapshot(data, i) - before) / (MetricOf(channel, channel.base + channel.step) - before);
+    if ((g_results[i].half_ms == 0UL) && (progress >= 0.5F)) {
+      g_results[i].half_ms = now_ms - g_step_at_ms;
+    }
+    if ((g_results[i].most_ms == 0UL) && (progress >= 0.9F)) {
+      g_results[i].most_ms = now_ms - g_step_at_ms;
+    }
+  }
+}
+
+uint32_t TotalReads() {
+  uint32_t reads = 0UL;
+  for (uint8_t sensor = 0U; sensor < HOST_SENSOR_COUNT; sensor++) {
+    reads += HostHal_GetSensorReads(static_cast<HostSensor>(sensor));
+  }
+  return reads;
+}
+
+double Rms(const double sum_sq, const uint32_t count) {
+  return (count > 0UL) ? sqrt(sum_sq / count) : 0.0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const uint32_t steady_ms = quick ? QUICK_STEADY_MS : FULL_STEADY_MS;
+
+  HostHal_Reset();
+  InstallNoisyScripts();
+  SensorService_Init();
+
+  uint32_t calls = 0UL;
+  (void)SampleFor(SETTLE_MS, &calls, nullptr);
+  for (ChannelResult& result : g_results) {
+    result = ChannelResult{};
+  }
+  calls = 0UL;
+  const uint32_t reads_before = TotalReads();
+  uint64_t sample_ns = SampleFor(steady_ms, &calls, CheckSteady);
+
+  g_step_at_ms = millis();
+  sample_ns += SampleFor(STEP_WINDOW_MS, &calls, CheckStep);
+
+  const uint32_t reads = TotalReads() - reads_before;
+
+  printf("sensor pipeline over %u s of noisy room, then a step\n", static_cast<unsigned>(steady_ms / 1000UL));
+  printf("  %-12s %8s %10s %10s %8s %8s %8s\n", "channel", "period", "raw rms", "filt rms", "gain", "t50", "t90");
+  bool ok = true;
+  for (uint8_t i = 0U; i < CHANNEL_COUNT; i++) {
+    const ChannelResult& result = g_results[i];
+    const double raw = Rms(result.raw_sq, result.raw_count);
+    const double filtered = Rms(result.filtered_sq, result.filtered_count);
+    printf("  %-12s %6u ms %10.3f %10.3f %7.1fx %6.1f s %6.1f s\n",
+           CHANNELS[i].name,
+           CHANNELS[i].period_ms,
+           raw,
+           filtered,
+           (filtered > 0.0) ? (raw / filtered) : 0.0,
+           result.half_ms / 1000.0,
+           result.most_ms / 1000.0);
+    // Quieter than a raw read, and the step shows up within a few periods.
+    ok = ok && (filtered < raw) && (result.most_ms > 0UL) &&
+         (result.half_ms <= (SENSOR_FILTER_MAX_DELAY_MS + (2UL * CHANNELS[i].period_ms)));
+  }
+  printf("  %u Sample() calls, %u sensor reads: %.0f ns per call, %.0f ns per read (host)\n",
+         calls,
+         reads,
+         static_cast<double>(sample_ns) / calls,
+         static_cast<double>(sample_ns) / reads);
+  if (!ok) {
+    printf("FAIL: a channel is no quieter than its raw reads or too slow to follow a step\n");
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <PubSubClient.h>
+
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "data_model.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+
+// Packets and bytes on the wire for the state topics: per-topic mode as the
+// sketch publishes it, and batched mode (one JSON object on TOPIC_STATE).
+// MQTT_BATCHED_STATE is a compile-time switch, so the batched side replays
+// the per-topic run: every cycle the sketch published becomes one
+// BuildStateJson() document carrying all five current values, sent with
+// PubSubClient to a second broker stand-in.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FULL_DURATION_MS = 60UL * 60UL * 1000UL;
+constexpr uint32_t QUICK_DURATION_MS = 2UL * 60UL * 1000UL;
+// Publishes of one PublishData() call land within this window.
+constexpr uint32_t CYCLE_WINDOW_MS = 50UL;
+constexpr float TWO_PI = 6.2831853F;
+
+constexpr uint8_t METRIC_COUNT = SENSOR_FIELD_COUNT;
+const char* const STATE_TOPICS[METRIC_COUNT] = {
+    TOPIC_TEMP_STATE, TOPIC_HUM_STATE, TOPIC_PRESSURE_STATE, TOPIC_SOIL1_STATE, TOPIC_SOIL2_STATE};
+const char* const JSON_KEYS[METRIC_COUNT] = {"temperature", "humidity", "pressure", "soil1", "soil2"};
+
+struct Scenario {
+  const char* name;
+  void (*install)();
+};
+
+struct ModeCost {
+  uint32_t publishes;
+  uint32_t bytes;
+};
+
+void InstallSteadyRoom() {}
+
+// Slow daily-style drift: a few publishes per metric per hour.
+void InstallDriftingRoom() {
+  HostHal_SetSensorScript(HOST_SENSOR_TEMPERATURE, [](uint32_t now_ms) {
+    return 21.0F + (1.5F * sinf(TWO_PI * static_cast<float>(now_ms) / 3600000.0F));
+  });
+  HostHal_SetSensorScript(HOST_SENSOR_HUMIDITY, [](uint32_t now_ms) {
+    return 45.0F + (5.0F * sinf(TWO_PI * static_cast<float>(now_ms) / 2700000.0F));
+  });
+  HostHal_SetSensorScript(HOST_SENSOR_SOIL1, [](uint32_t now_ms) {
+    return 300.0F + (static_cast<float>(now_ms) / 20000.0F);
+  });
+}
+
+// Every metric crosses its deadband every publish interval: the case the
+// batch exists for.
+void InstallBusyRoom() {
+  const auto square = [](uint32_t now_ms) { return static_cast<float>((now_ms / PUBLISH_INTERVAL_MS) % 2UL); };
+  HostHal_SetSensorScript(HOST_SENSOR_TEMPERATURE, [square](uint32_t now_ms) { return 21.0F + square(now_ms); });
+  HostHal_SetSensorScript(HOST_SENSOR_HUMIDITY, [square](uint32_t now_ms) { return 45.0F + (5.0F * square(now_ms)); });
+  HostHal_SetSensorScript(HOST_SENSOR_PRESSURE, [square](uint32_t now_ms) { return 1010.0F + (3.0F * square(now_ms)); });
+  HostHal_SetSensorScript(HOST_SENSOR_SOIL1, [square](uint32_t now_ms) { return 300.0F + (200.0F * square(now_ms)); });
+  HostHal_SetSensorScript(HOST_SENSOR_SOIL2, [square](uint32_t now_ms) { return 600.0F - (200.0F * square(now_ms)); });
+}
+
+const Scenario SCENARIOS[] = {
+    {"steady", InstallSteadyRoom},
+    {"drifting", InstallDriftingRoom},
+    {"busy", InstallBusyRoom},
+};
+
+int FindMetric(const std::string& topic) {
+  for (uint8_t i = 0U; i < METRIC_COUNT; i++) {
+    if (topic == STATE_TOPICS[i]) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+std::string BuildStateJson(const std::string* values) {
+  std::string json = "{";
+  for (uint8_t i = 0U; i < METRIC_COUNT; i++) {
+    json += (i == 0U) ? "\"" : ",\"";
+    json += JSON_KEYS[i];
+    json += "\":";
+    json += values[i];
+  }
+  return json + "}";
+}
+
+ModeCost ReplayBatched(const std::vector<HostMqttMessage>& messages) {
+  HostBroker broker;
+  HostTransportClient transport(&broker);
+  PubSubClient client(transport);
+  client.setBufferSize(MQTT_BUFFER_SIZE_BYTES);
+  client.setServer(MQTT_SERVER, MQTT_PORT);
+  if (!client.connect("bench_batched")) {
+    return ModeCost{};
+  }
+
+  std::string values[METRIC_COUNT];
+  size_t index = 0U;
+  while (index < messages.size()) {
+    const uint32_t cycle_ms = messages[index].received_ms;
+    while ((index < messages.size()) && ((messages[index].received_ms - cycle_ms) <= CYCLE_WINDOW_MS)) {
+      values[FindMetric(messages[index].topic)] = messages[index].payload;
+      index++;
+    }
+    (void)client.publish(TOPIC_STATE, BuildStateJson(values).c_str(), true);
+  }
+
+  ModeCost cost = {};
+  for (const HostMqttMessage& message : broker.GetMessages()) {
+    cost.publishes++;
+    cost.bytes += message.wire_bytes;
+  }
+  return cost;
+}
+
+bool RunScenario(const Scenario& scenario, const uint32_t duration_ms) {
+  HostSketch_Reset();
+  scenario.install();
+  HostSketch_Setup();
+  HostBroker* broker = HostHal_GetBroker();
+  if (!HostSketch_RunUntil([broker]() { return broker->GetRetained(TOPIC_SOIL2_STATE) != nullptr; }, 60000UL)) {
+    return false;
+  }
+  broker->ClearMessages();
+  HostSketch_RunFor(duration_ms);
+
+  std::vector<HostMqttMessage> state_messages;
+  ModeCost per_topic = {};
+  for (const HostMqttMessage& message : broker->GetMessages()) {
+    if (FindMetric(message.topic) >= 0) {
+      state_messages.push_back(message);
+      per_topic.publishes++;
+      per_topic.bytes += message.wire_bytes;
+    }
+  }
+  const ModeCost batched = ReplayBatched(state_messages);
+  printf("  %-9s %-9s %9u %9u\n", scenario.name, "per-topic", per_topic.publishes, per_topic.bytes);
+  printf("  %-9s %-9s %9u %9u\n", "", "batched", batched.publishes, batched.bytes);
+  return (per_topic.publishes == 0UL) || (batched.publishes > 0UL);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const uint32_t duration_ms = quick ? QUICK_DURATION_MS : FULL_DURATION_MS;
+
+  printf("state publishes over %u s of simulated time\n", static_cast<unsigned>(duration_ms / 1000UL));
+  printf("  %-9s %-9s %9s %9s\n", "room", "mode", "packets", "bytes");
+  bool all_ok = true;
+  for (const Scenario& scenario : SCENARIOS) {
+    // Each room boots its own device.
+    all_ok = HostSketch_RunIsolated([&scenario, duration_ms]() { return RunScenario(scenario, duration_ms); }) && all_ok;
+  }
+  return all_ok ? 0 : 1;
+}
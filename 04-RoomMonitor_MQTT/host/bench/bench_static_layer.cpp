@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "config.h"
+#include "display_service.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "logger.h"
+
+// Full dashboard redraws with the static layer replayed from the span cache
+// and drawn with the GFX primitives (the fallback when Init cannot get the
+// band canvas). Simulated time is the SPI transfer estimate of HostDisplay;
+// host time covers rasterisation on the desktop CPU only.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FULL_FRAMES = 2000UL;
+constexpr uint32_t QUICK_FRAMES = 20UL;
+
+struct FrameCost {
+  uint64_t calls;
+  uint64_t pixels;
+  uint64_t spi_bytes;
+  uint64_t busy_us;
+  double host_ns;
+};
+
+SensorSnapshot MakeSnapshot(const uint32_t frame) {
+  SensorSnapshot snapshot = {};
+  snapshot.seq = frame + 1UL;
+  snapshot.valid_mask = static_cast<uint8_t>((1U << SENSOR_FIELD_COUNT) - 1U);
+  snapshot.data.temperature_c = 21.0F + (0.1F * static_cast<float>(frame % 20UL));
+  snapshot.data.humidity_pct = 45.0F;
+  snapshot.data.pressure_hpa = 1012.0F;
+  snapshot.data.soil1_pct = 40U;
+  snapshot.data.soil2_pct = 60U;
+  return snapshot;
+}
+
+void PrintInitLog() {
+  for (uint8_t i = 0U; i < 30U; i++) {
+    Logger_Drain();
+    HostClock_AdvanceMs(100UL);
+  }
+  const std::string log = HostSerial_TakeOutput();
+  const char* line = strstr(log.c_str(), "Static layer");
+  if (line != nullptr) {
+    printf("  %.*s\n", static_cast<int>(strcspn(line, "\r\n")), line);
+  }
+}
+
+FrameCost MeasureFullFrames(const uint32_t frames) {
+  HostDisplay* display = HostHal_GetDisplay();
+  FrameCost total = {};
+  for (uint32_t frame = 0UL; frame < frames; frame++) {
+    HostClock_AdvanceMs(DISPLAY_REFRESH_MS);
+    const SensorSnapshot snapshot = MakeSnapshot(frame);
+    DisplayService_ShowBootText();
+    display->ResetStats();
+    const auto start = std::chrono::steady_clock::now();
+    DisplayService_ShowData(&snapshot);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    total.host_ns += static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    total.calls += display->GetStats().calls;
+    total.pixels += display->GetStats().pixels;
+    total.spi_bytes += display->GetStats().spi_bytes;
+    total.busy_us += display->GetStats().busy_us;
+  }
+  return total;
+}
+
+void PrintCost(const char* name, const FrameCost& cost, const uint32_t frames) {
+  printf("  %-10s %8llu %8llu %10llu %10llu %10.0f\n",
+         name,
+         static_cast<unsigned long long>(cost.calls / frames),
+         static_cast<unsigned long long>(cost.pixels / frames),
+         static_cast<unsigned long long>(cost.spi_bytes / frames),
+         static_cast<unsigned long long>(cost.busy_us / frames),
+         cost.host_ns / frames);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const uint32_t frames = quick ? QUICK_FRAMES : FULL_FRAMES;
+
+  HostHal_Reset();
+  HostClock_SetReadTickUs(0U);
+  printf("full dashboard redraw, %u frames\n", frames);
+
+  DisplayService_Init();
+  PrintInitLog();
+  const FrameCost cached = MeasureFullFrames(frames);
+
+  HostGfx_SetCanvasLimitBytes(64U);
+  DisplayService_Init();
+  PrintInitLog();
+  const FrameCost direct = MeasureFullFrames(frames);
+
+  printf("  %-10s %8s %8s %10s %10s %10s\n", "static", "calls", "pixels", "spi_bytes", "sim_us", "host_ns");
+  PrintCost("cached", cached, frames);
+  PrintCost("direct", direct, frames);
+  printf("  saved      %7.1f%% of simulated frame time\n",
+         100.0 * (1.0 - (static_cast<double>(cached.busy_us) / static_cast<double>(direct.busy_us))));
+  return (cached.busy_us < direct.busy_us) ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "config.h"
+#include "fakes/host_heap.h"
+#include "text_format.h"
+
+// One publish cycle's worth of state payloads (three floats, two soil
+// percentages) formatted by TextFormat into a static buffer, and the way
+// the old path did it: String(value, decimals) per field, i.e. dtostrf into
+// a heap block owned by the String. Host nanoseconds are only a ratio.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FULL_CYCLES = 1000000UL;
+constexpr uint32_t QUICK_CYCLES = 10000UL;
+constexpr size_t PAYLOAD_CAPACITY = 16U;
+constexpr uint8_t FIELDS = 5U;
+
+struct Sample {
+  float temperature_c;
+  float humidity_pct;
+  float pressure_hpa;
+  uint32_t soil1_pct;
+  uint32_t soil2_pct;
+};
+
+volatile size_t g_sink = 0U;
+char g_payloads[FIELDS][PAYLOAD_CAPACITY];
+
+Sample MakeSample(const uint32_t cycle) {
+  Sample sample = {};
+  sample.temperature_c = 18.0F + (static_cast<float>(cycle % 1000UL) * 0.013F);
+  sample.humidity_pct = 35.0F + (static_cast<float>(cycle % 400UL) * 0.07F);
+  sample.pressure_hpa = 990.0F + (static_cast<float>(cycle % 700UL) * 0.05F);
+  sample.soil1_pct = cycle % 101UL;
+  sample.soil2_pct = (cycle * 7UL) % 101UL;
+  return sample;
+}
+
+size_t TextFormatCycle(const Sample& sample) {
+  size_t total = 0U;
+  total += TextFormat_Float(g_payloads[0], PAYLOAD_CAPACITY, sample.temperature_c, FLOAT_DECIMALS);
+  total += TextFormat_Float(g_payloads[1], PAYLOAD_CAPACITY, sample.humidity_pct, FLOAT_DECIMALS);
+  total += TextFormat_Float(g_payloads[2], PAYLOAD_CAPACITY, sample.pressure_hpa, FLOAT_DECIMALS);
+  total += TextFormat_Unsigned(g_payloads[3], PAYLOAD_CAPACITY, sample.soil1_pct);
+  total += TextFormat_Unsigned(g_payloads[4], PAYLOAD_CAPACITY, sample.soil2_pct);
+  return total;
+}
+
+// String(value, decimals): a heap block sized for the digits, filled by
+// dtostrf (sprintf on the SAMD core), released when the String goes away.
+size_t HeapString(const char* format, const int decimals, const double value) {
+  char* text = static_cast<char*>(malloc(PAYLOAD_CAPACITY));
+  if (text == nullptr) {
+    return 0U;
+  }
+  const int length = (decimals >= 0) ? snprintf(text, PAYLOAD_CAPACITY, format, decimals, value)
+                                     : snprintf(text, PAYLOAD_CAPACITY, format, static_cast<unsigned>(value));
+  g_sink = g_sink + static_cast<size_t>(text[0]);
+  free(text);
+  return (length > 0) ? static_cast<size_t>(length) : 0U;
+}
+
+size_t StringCycle(const Sample& sample) {
+  size_t total = 0U;
+  total += HeapString("%.*f", FLOAT_DECIMALS, sample.temperature_c);
+  total += HeapString("%.*f", FLOAT_DECIMALS, sample.humidity_pct);
+  total += HeapString("%.*f", FLOAT_DECIMALS, sample.pressure_hpa);
+  total += HeapString("%u", -1, sample.soil1_pct);
+  total += HeapString("%u", -1, sample.soil2_pct);
+  return total;
+}
+
+struct CycleCost {
+  double ns;
+  uint32_t allocations;
+};
+
+template <typename Cycle>
+CycleCost Measure(Cycle cycle_fn, const uint32_t cycles) {
+  HostHeap_StartCounting();
+  g_sink = g_sink + cycle_fn(MakeSample(0UL));
+  const uint32_t allocations = HostHeap_StopCounting();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t cycle = 0UL; cycle < cycles; cycle++) {
+    g_sink = g_sink + cycle_fn(MakeSample(cycle));
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  return CycleCost{ns / cycles, allocations};
+}
+
+struct TextCheck {
+  uint32_t ties;
+  uint32_t mismatches;
+};
+
+bool IsExactTie(const float value) {
+  const double scaled = static_cast<double>(value) * 10.0;
+  return (scaled - floor(scaled)) == 0.5;
+}
+
+void CheckValue(const float value, const char* text, TextCheck* check) {
+  char expected[PAYLOAD_CAPACITY];
+  snprintf(expected, sizeof(expected), "%.*f", FLOAT_DECIMALS, static_cast<double>(value));
+  if (strcmp(expected, text) == 0) {
+    return;
+  }
+  if (IsExactTie(value)) {
+    check->ties++;
+  } else {
+    check->mismatches++;
+  }
+}
+
+// The two paths have to produce the same text to be comparable. Exact
+// binary ties are the documented exception (away from zero vs to even).
+TextCheck CheckText(const uint32_t cycles) {
+  TextCheck check = {};
+  for (uint32_t cycle = 0UL; cycle < cycles; cycle++) {
+    const Sample sample = MakeSample(cycle);
+    (void)TextFormatCycle(sample);
+    CheckValue(sample.temperature_c, g_payloads[0], &check);
+    CheckValue(sample.humidity_pct, g_payloads[1], &check);
+    CheckValue(sample.pressure_hpa, g_payloads[2], &check);
+  }
+  return check;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const uint32_t cycles = quick ? QUICK_CYCLES : FULL_CYCLES;
+
+  const CycleCost text_format = Measure(TextFormatCycle, cycles);
+  const CycleCost heap_string = Measure(StringCycle, cycles);
+  const TextCheck check = CheckText(quick ? 1000UL : 100000UL);
+
+  printf("state payload formatting, %u publish cycles of %u fields\n", cycles, FIELDS);
+  printf("  %-12s %10s %12s\n", "path", "ns/cycle", "allocs/cycle");
+  printf("  %-12s %10.1f %12u\n", "TextFormat", text_format.ns, text_format.allocations);
+  printf("  %-12s %10.1f %12u\n", "String", heap_string.ns, heap_string.allocations);
+  printf("  text vs printf: %u mismatches, %u exact ties rounded away from zero\n", check.mismatches, check.ties);
+  return ((text_format.allocations == 0UL) && (heap_string.allocations > 0UL) && (check.mismatches == 0UL)) ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "config.h"
+#include "trig_table.h"
+
+// Gauge geometry per frame (eleven tick endpoints plus the needle tip) with
+// float trig, as the dashboard used to do it, and with the Q15 table. Host
+// nanoseconds are only a ratio; on the FPU-less SAMD21 every sinf/cosf is a
+// software routine of several hundred cycles, which the table removes.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FULL_FRAMES = 2000000UL;
+constexpr uint32_t QUICK_FRAMES = 20000UL;
+constexpr float DEG_TO_RAD = 0.017453292519943295F;
+constexpr int16_t RADIUS = (DISPLAY_SIZE_PX / 2) - DISPLAY_OUTER_MARGIN;
+constexpr int16_t CX = DISPLAY_SIZE_PX / 2;
+constexpr int16_t CY = DISPLAY_SIZE_PX / 2;
+
+volatile int32_t g_sink = 0;
+
+int32_t FloatFrame(const uint32_t frame) {
+  int32_t sum = 0;
+  const float sweep = DISPLAY_GAUGE_END_DEG - DISPLAY_GAUGE_START_DEG;
+  for (uint8_t i = 0U; i <= DISPLAY_GAUGE_TICK_COUNT; i++) {
+    const float angle = (DISPLAY_GAUGE_START_DEG + ((sweep * i) / DISPLAY_GAUGE_TICK_COUNT)) * DEG_TO_RAD;
+    const float c = cosf(angle);
+    const float s = sinf(angle);
+    sum += static_cast<int16_t>(CX + (c * (RADIUS - DISPLAY_GAUGE_TICK_INNER_OFFSET)));
+    sum += static_cast<int16_t>(CY + (s * (RADIUS - DISPLAY_GAUGE_TICK_INNER_OFFSET)));
+    sum += static_cast<int16_t>(CX + (c * (RADIUS - DISPLAY_GAUGE_TICK_OUTER_OFFSET)));
+    sum += static_cast<int16_t>(CY + (s * (RADIUS - DISPLAY_GAUGE_TICK_OUTER_OFFSET)));
+  }
+  const float needle = (DISPLAY_GAUGE_START_DEG + static_cast<float>(frame % DISPLAY_NEEDLE_ANGLE_STEPS)) * DEG_TO_RAD;
+  sum += static_cast<int16_t>(CX + (cosf(needle) * (RADIUS - DISPLAY_GAUGE_NEEDLE_OFFSET)));
+  sum += static_cast<int16_t>(CY + (sinf(needle) * (RADIUS - DISPLAY_GAUGE_NEEDLE_OFFSET)));
+  return sum;
+}
+
+// Ticks come from constexpr tables in the firmware; only the needle is
+// looked up per frame.
+int32_t TableFrame(const uint32_t frame) {
+  const int32_t degrees = static_cast<int32_t>(DISPLAY_GAUGE_START_DEG) + static_cast<int32_t>(frame % DISPLAY_NEEDLE_ANGLE_STEPS);
+  const int16_t length = RADIUS - DISPLAY_GAUGE_NEEDLE_OFFSET;
+  return (CX + TrigTable::ScaleQ15(TrigTable::CosQ15(degrees), length)) +
+         (CY + TrigTable::ScaleQ15(TrigTable::SinQ15(degrees), length));
+}
+
+template <typename Frame>
+double NsPerFrame(Frame frame_fn, const uint32_t frames) {
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t frame = 0UL; frame < frames; frame++) {
+    g_sink = g_sink + frame_fn(frame);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / frames;
+}
+
+// Largest endpoint difference between the two paths, in pixels.
+int32_t MaxErrorPx() {
+  int32_t worst = 0;
+  for (uint16_t step = 0U; step <= DISPLAY_NEEDLE_ANGLE_STEPS; step++) {
+    const int32_t degrees = static_cast<int32_t>(DISPLAY_GAUGE_START_DEG) + step;
+    const float radians = static_cast<float>(degrees) * DEG_TO_RAD;
+    for (int16_t length = 1; length <= RADIUS; length++) {
+      const int32_t dx = TrigTable::ScaleQ15(TrigTable::CosQ15(degrees), length) - lroundf(cosf(radians) * length);
+      const int32_t dy = TrigTable::ScaleQ15(TrigTable::SinQ15(degrees), length) - lroundf(sinf(radians) * length);
+      worst = (abs(dx) > worst) ? abs(dx) : worst;
+      worst = (abs(dy) > worst) ? abs(dy) : worst;
+    }
+  }
+  return worst;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+  const uint32_t frames = quick ? QUICK_FRAMES : FULL_FRAMES;
+
+  const double float_ns = NsPerFrame(FloatFrame, frames);
+  const double table_ns = NsPerFrame(TableFrame, frames);
+  const int32_t error_px = MaxErrorPx();
+
+  printf("gauge geometry, %u frames\n", frames);
+  printf("  float trig   %8.1f ns/frame (%u sinf/cosf calls)\n", float_ns, (DISPLAY_GAUGE_TICK_COUNT + 2U) * 2U);
+  printf("  Q15 table    %8.1f ns/frame (0 calls)\n", table_ns);
+  printf("  speed-up     %8.1fx\n", (table_ns > 0.0) ? (float_ns / table_ns) : 0.0);
+  printf("  max error    %8d px\n", error_px);
+  return (error_px <= 1) ? 0 : 1;
+}
@@ -0,0 +1,536 @@
+#include <Adafruit_GFX.h>
+
+namespace {
+constexpr unsigned char FONT_FIRST = 0x20U;
+constexpr unsigned char FONT_LAST = 0x7EU;
+
+// glcdfont.c, printable ASCII: five columns per glyph, bit 0 is the top row.
+const uint8_t FONT[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00,  // space
+    0x00, 0x00, 0x5F, 0x00, 0x00,  // '!'
+    0x00, 0x07, 0x00, 0x07, 0x00,  // '"'
+    0x14, 0x7F, 0x14, 0x7F, 0x14,  // '#'
+    0x24, 0x2A, 0x7F, 0x2A, 0x12,  // '$'
+    0x23, 0x13, 0x08, 0x64, 0x62,  // '%'
+    0x36, 0x49, 0x56, 0x20, 0x50,  // '&'
+    0x00, 0x08, 0x07, 0x03, 0x00,  // '''
+    0x00, 0x1C, 0x22, 0x41, 0x00,  // '('
+    0x00, 0x41, 0x22, 0x1C, 0x00,  // ')'
+    0x2A, 0x1C, 0x7F, 0x1C, 0x2A,  // '*'
+    0x08, 0x08, 0x3E, 0x08, 0x08,  // '+'
+    0x00, 0x80, 0x70, 0x30, 0x00,  // ','
+    0x08, 0x08, 0x08, 0x08, 0x08,  // '-'
+    0x00, 0x60, 0x60, 0x00, 0x00,  // '.'
+    0x20, 0x10, 0x08, 0x04, 0x02,  // '/'
+    0x3E, 0x51, 0x49, 0x45, 0x3E,  // '0'
+    0x00, 0x42, 0x7F, 0x40, 0x00,  // '1'
+    0x72, 0x49, 0x49, 0x49, 0x46,  // '2'
+    0x21, 0x41, 0x49, 0x4D, 0x33,  // '3'
+    0x18, 0x14, 0x12, 0x7F, 0x10,  // '4'
+    0x27, 0x45, 0x45, 0x45, 0x39,  // '5'
+    0x3C, 0x4A, 0x49, 0x49, 0x31,  // '6'
+    0x41, 0x21, 0x11, 0x09, 0x07,  // '7'
+    0x36, 0x49, 0x49, 0x49, 0x36,  // '8'
+    0x46, 0x49, 0x49, 0x29, 0x1E,  // '9'
+    0x00, 0x00, 0x14, 0x00, 0x00,  // ':'
+    0x00, 0x40, 0x34, 0x00, 0x00,  // ';'
+    0x00, 0x08, 0x14, 0x22, 0x41,  // '<'
+    0x14, 0x14, 0x14, 0x14, 0x14,  // '='
+    0x00, 0x41, 0x22, 0x14, 0x08,  // '>'
+    0x02, 0x01, 0x59, 0x09, 0x06,  // '?'
+    0x3E, 0x41, 0x5D, 0x59, 0x4E,  // '@'
+    0x7C, 0x12, 0x11, 0x12, 0x7C,  // 'A'
+    0x7F, 0x49, 0x49, 0x49, 0x36,  // 'B'
+    0x3E, 0x41, 0x41, 0x41, 0x22,  // 'C'
+    0x7F, 0x41, 0x41, 0x41, 0x3E,  // 'D'
+    0x7F, 0x49, 0x49, 0x49, 0x41,  // 'E'
+    0x7F, 0x09, 0x09, 0x09, 0x01,  // 'F'
+    0x3E, 0x41, 0x41, 0x51, 0x73,  // 'G'
+    0x7F, 0x08, 0x08, 0x08, 0x7F,  // 'H'
+    0x00, 0x41, 0x7F, 0x41, 0x00,  // 'I'
+    0x20, 0x40, 0x41, 0x3F, 0x01,  // 'J'
+    0x7F, 0x08, 0x14, 0x22, 0x41,  // 'K'
+    0x7F, 0x40, 0x40, 0x40, 0x40,  // 'L'
+    0x7F, 0x02, 0x1C, 0x02, 0x7F,  // 'M'
+    0x7F, 0x04, 0x08, 0x10, 0x7F,  // 'N'
+    0x3E, 0x41, 0x41, 0x41, 0x3E,  // 'O'
+    0x7F, 0x09, 0x09, 0x09, 0x06,  // 'P'
+    0x3E, 0x41, 0x51, 0x21, 0x5E,  // 'Q'
+    0x7F, 0x09, 0x19, 0x29, 0x46,  // 'R'
+    0x26, 0x49, 0x49, 0x49, 0x32,  // 'S'
+    0x03, 0x01, 0x7F, 0x01, 0x03,  // 'T'
+    0x3F, 0x40, 0x40, 0x40, 0x3F,  // 'U'
+    0x1F, 0x20, 0x40, 0x20, 0x1F,  // 'V'
+    0x3F, 0x40, 0x38, 0x40, 0x3F,  // 'W'
+    0x63, 0x14, 0x08, 0x14, 0x63,  // 'X'
+    0x03, 0x04, 0x78, 0x04, 0x03,  // 'Y'
+    0x61, 0x59, 0x49, 0x4D, 0x43,  // 'Z'
+    0x00, 0x7F, 0x41, 0x41, 0x41,  // '['
+    0x02, 0x04, 0x08, 0x10, 0x20,  // backslash
+    0x00, 0x41, 0x41, 0x41, 0x7F,  // ']'
+    0x04, 0x02, 0x01, 0x02, 0x04,  // '^'
+    0x40, 0x40, 0x40, 0x40, 0x40,  // '_'
+    0x00, 0x03, 0x07, 0x08, 0x00,  // '`'
+    0x20, 0x54, 0x54, 0x78, 0x40,  // 'a'
+    0x7F, 0x28, 0x44, 0x44, 0x38,  // 'b'
+    0x38, 0x44, 0x44, 0x44, 0x28,  // 'c'
+    0x38, 0x44, 0x44, 0x28, 0x7F,  // 'd'
+    0x38, 0x54, 0x54, 0x54, 0x18,  // 'e'
+    0x00, 0x08, 0x7E, 0x09, 0x02,  // 'f'
+    0x18, 0xA4, 0xA4, 0x9C, 0x78,  // 'g'
+    0x7F, 0x08, 0x04, 0x04, 0x78,  // 'h'
+    0x00, 0x44, 0x7D, 0x40, 0x00,  // 'i'
+    0x20, 0x40, 0x40, 0x3D, 0x00,  // 'j'
+    0x7F, 0x10, 0x28, 0x44, 0x00,  // 'k'
+    0x00, 0x41, 0x7F, 0x40, 0x00,  // 'l'
+    0x7C, 0x04, 0x78, 0x04, 0x78,  // 'm'
+    0x7C, 0x08, 0x04, 0x04, 0x78,  // 'n'
+    0x38, 0x44, 0x44, 0x44, 0x38,  // 'o'
+    0xFC, 0x18, 0x24, 0x24, 0x18,  // 'p'
+    0x18, 0x24, 0x24, 0x18, 0xFC,  // 'q'
+    0x7C, 0x08, 0x04, 0x04, 0x08,  // 'r'
+    0x48, 0x54, 0x54, 0x54, 0x24,  // 's'
+    0x04, 0x04, 0x3F, 0x44, 0x24,  // 't'
+    0x3C, 0x40, 0x40, 0x20, 0x7C,  // 'u'
+    0x1C, 0x20, 0x40, 0x20, 0x1C,  // 'v'
+    0x3C, 0x40, 0x30, 0x40, 0x3C,  // 'w'
+    0x44, 0x28, 0x10, 0x28, 0x44,  // 'x'
+    0x4C, 0x90, 0x90, 0x90, 0x7C,  // 'y'
+    0x44, 0x64, 0x54, 0x4C, 0x44,  // 'z'
+    0x00, 0x08, 0x36, 0x41, 0x00,  // '{'
+    0x00, 0x00, 0x77, 0x00, 0x00,  // '|'
+    0x00, 0x41, 0x36, 0x08, 0x00,  // '}'
+    0x02, 0x01, 0x02, 0x04, 0x02,  // '~'
+};
+
+uint8_t GetFontColumn(const unsigned char c, const uint8_t column) {
+  if ((c < FONT_FIRST) || (c > FONT_LAST)) {
+    return 0U;
+  }
+  return FONT[(static_cast<size_t>(c - FONT_FIRST) * 5U) + column];
+}
+
+void Swap(int16_t* a, int16_t* b) {
+  const int16_t t = *a;
+  *a = *b;
+  *b = t;
+}
+
+size_t g_canvas_limit_bytes = 0U;
+}  // namespace
+
+Adafruit_GFX::Adafruit_GFX(const int16_t w, const int16_t h)
+    : WIDTH(w),
+      HEIGHT(h),
+      _width(w),
+      _height(h),
+      cursor_x(0),
+      cursor_y(0),
+      textcolor(0xFFFFU),
+      textbgcolor(0xFFFFU),
+      textsize_x(1U),
+      textsize_y(1U),
+      rotation(0U),
+      wrap(true),
+      _cp437(false) {}
+
+void Adafruit_GFX::startWrite() {}
+
+void Adafruit_GFX::writePixel(const int16_t x, const int16_t y, const uint16_t color) {
+  drawPixel(x, y, color);
+}
+
+void Adafruit_GFX::writeFillRect(
+    const int16_t x,
+    const int16_t y,
+    const int16_t w,
+    const int16_t h,
+    const uint16_t color) {
+  fillRect(x, y, w, h, color);
+}
+
+void Adafruit_GFX::writeFastVLine(const int16_t x, const int16_t y, const int16_t h, const uint16_t color) {
+  drawFastVLine(x, y, h, color);
+}
+
+void Adafruit_GFX::writeFastHLine(const int16_t x, const int16_t y, const int16_t w, const uint16_t color) {
+  drawFastHLine(x, y, w, color);
+}
+
+// Bresenham, as in the library.
+void Adafruit_GFX::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const uint16_t color) {
+  const bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    Swap(&x0, &y0);
+    Swap(&x1, &y1);
+  }
+  if (x0 > x1) {
+    Swap(&x0, &x1);
+    Swap(&y0, &y1);
+  }
+
+  const int16_t dx = static_cast<int16_t>(x1 - x0);
+  const int16_t dy = static_cast<int16_t>(abs(y1 - y0));
+  int16_t err = static_cast<int16_t>(dx / 2);
+  const int16_t ystep = (y0 < y1) ? 1 : -1;
+  for (; x0 <= x1; x0++) {
+    if (steep) {
+      writePixel(y0, x0, color);
+    } else {
+      writePixel(x0, y0, color);
+    }
+    err = static_cast<int16_t>(err - dy);
+    if (err < 0) {
+      y0 = static_cast<int16_t>(y0 + ystep);
+      err = static_cast<int16_t>(err + dx);
+    }
+  }
+}
+
+void Adafruit_GFX::endWrite() {}
+
+void Adafruit_GFX::setRotation(const uint8_t r) {
+  rotation = static_cast<uint8_t>(r & 3U);
+  const bool swapped = (rotation & 1U) != 0U;
+  _width = swapped ? HEIGHT : WIDTH;
+  _height = swapped ? WIDTH : HEIGHT;
+}
+
+void Adafruit_GFX::invertDisplay(const bool) {}
+
+void Adafruit_GFX::drawFastVLine(const int16_t x, const int16_t y, const int16_t h, const uint16_t color) {
+  startWrite();
+  writeLine(x, y, x, static_cast<int16_t>(y + h - 1), color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawFastHLine(const int16_t x, const int16_t y, const int16_t w, const uint16_t color) {
+  startWrite();
+  writeLine(x, y, static_cast<int16_t>(x + w - 1), y, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillRect(const int16_t x, const int16_t y, const int16_t w, const int16_t h, const uint16_t color) {
+  startWrite();
+  for (int16_t i = x; i < (x + w); i++) {
+    writeFastVLine(i, y, h, color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::fillScreen(const uint16_t color) {
+  fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const uint16_t color) {
+  if (x0 == x1) {
+    if (y0 > y1) {
+      Swap(&y0, &y1);
+    }
+    drawFastVLine(x0, y0, static_cast<int16_t>(y1 - y0 + 1), color);
+  } else if (y0 == y1) {
+    if (x0 > x1) {
+      Swap(&x0, &x1);
+    }
+    drawFastHLine(x0, y0, static_cast<int16_t>(x1 - x0 + 1), color);
+  } else {
+    startWrite();
+    writeLine(x0, y0, x1, y1, color);
+    endWrite();
+  }
+}
+
+void Adafruit_GFX::drawRect(const int16_t x, const int16_t y, const int16_t w, const int16_t h, const uint16_t color) {
+  startWrite();
+  writeFastHLine(x, y, w, color);
+  writeFastHLine(x, static_cast<int16_t>(y + h - 1), w, color);
+  writeFastVLine(x, y, h, color);
+  writeFastVLine(static_cast<int16_t>(x + w - 1), y, h, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawCircle(const int16_t x0, const int16_t y0, const int16_t r, const uint16_t color) {
+  int16_t f = static_cast<int16_t>(1 - r);
+  int16_t ddF_x = 1;
+  int16_t ddF_y = static_cast<int16_t>(-2 * r);
+  int16_t x = 0;
+  int16_t y = r;
+
+  startWrite();
+  writePixel(x0, static_cast<int16_t>(y0 + r), color);
+  writePixel(x0, static_cast<int16_t>(y0 - r), color);
+  writePixel(static_cast<int16_t>(x0 + r), y0, color);
+  writePixel(static_cast<int16_t>(x0 - r), y0, color);
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y = static_cast<int16_t>(ddF_y + 2);
+      f = static_cast<int16_t>(f + ddF_y);
+    }
+    x++;
+    ddF_x = static_cast<int16_t>(ddF_x + 2);
+    f = static_cast<int16_t>(f + ddF_x);
+
+    writePixel(static_cast<int16_t>(x0 + x), static_cast<int16_t>(y0 + y), color);
+    writePixel(static_cast<int16_t>(x0 - x), static_cast<int16_t>(y0 + y), color);
+    writePixel(static_cast<int16_t>(x0 + x), static_cast<int16_t>(y0 - y), color);
+    writePixel(static_cast<int16_t>(x0 - x), static_cast<int16_t>(y0 - y), color);
+    writePixel(static_cast<int16_t>(x0 + y), static_cast<int16_t>(y0 + x), color);
+    writePixel(static_cast<int16_t>(x0 - y), static_cast<int16_t>(y0 + x), color);
+    writePixel(static_cast<int16_t>(x0 + y), static_cast<int16_t>(y0 - x), color);
+    writePixel(static_cast<int16_t>(x0 - y), static_cast<int16_t>(y0 - x), color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::drawCircleHelper(
+    const int16_t x0,
+    const int16_t y0,
+    const int16_t r,
+    const uint8_t cornername,
+    const uint16_t color) {
+  int16_t f = static_cast<int16_t>(1 - r);
+  int16_t ddF_x = 1;
+  int16_t ddF_y = static_cast<int16_t>(-2 * r);
+  int16_t x = 0;
+  int16_t y = r;
+
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y = static_cast<int16_t>(ddF_y + 2);
+      f = static_cast<int16_t>(f + ddF_y);
+    }
+    x++;
+    ddF_x = static_cast<int16_t>(ddF_x + 2);
+    f = static_cast<int16_t>(f + ddF_x);
+    if ((cornername & 0x4U) != 0U) {
+      writePixel(static_cast<int16_t>(x0 + x), static_cast<int16_t>(y0 + y), color);
+      writePixel(static_cast<int16_t>(x0 + y), static_cast<int16_t>(y0 + x), color);
+    }
+    if ((cornername & 0x2U) != 0U) {
+      writePixel(static_cast<int16_t>(x0 + x), static_cast<int16_t>(y0 - y), color);
+      writePixel(static_cast<int16_t>(x0 + y), static_cast<int16_t>(y0 - x), color);
+    }
+    if ((cornername & 0x8U) != 0U) {
+      writePixel(static_cast<int16_t>(x0 - y), static_cast<int16_t>(y0 + x), color);
+      writePixel(static_cast<int16_t>(x0 - x), static_cast<int16_t>(y0 + y), color);
+    }
+    if ((cornername & 0x1U) != 0U) {
+      writePixel(static_cast<int16_t>(x0 - y), static_cast<int16_t>(y0 - x), color);
+      writePixel(static_cast<int16_t>(x0 - x), static_cast<int16_t>(y0 - y), color);
+    }
+  }
+}
+
+void Adafruit_GFX::fillCircle(const int16_t x0, const int16_t y0, const int16_t r, const uint16_t color) {
+  startWrite();
+  writeFastVLine(x0, static_cast<int16_t>(y0 - r), static_cast<int16_t>((2 * r) + 1), color);
+  fillCircleHelper(x0, y0, r, 3U, 0, color);
+  endWrite();
+}
+
+// The px/py bookkeeping keeps each column from being drawn twice.
+void Adafruit_GFX::fillCircleHelper(
+    const int16_t x0,
+    const int16_t y0,
+    const int16_t r,
+    const uint8_t corners,
+    int16_t delta,
+    const uint16_t color) {
+  int16_t f = static_cast<int16_t>(1 - r);
+  int16_t ddF_x = 1;
+  int16_t ddF_y = static_cast<int16_t>(-2 * r);
+  int16_t x = 0;
+  int16_t y = r;
+  int16_t px = x;
+  int16_t py = y;
+
+  delta++;
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y = static_cast<int16_t>(ddF_y + 2);
+      f = static_cast<int16_t>(f + ddF_y);
+    }
+    x++;
+    ddF_x = static_cast<int16_t>(ddF_x + 2);
+    f = static_cast<int16_t>(f + ddF_x);
+    if (x < (y + 1)) {
+      if ((corners & 1U) != 0U) {
+        writeFastVLine(static_cast<int16_t>(x0 + x), static_cast<int16_t>(y0 - y), static_cast<int16_t>((2 * y) + delta), color);
+      }
+      if ((corners & 2U) != 0U) {
+        writeFastVLine(static_cast<int16_t>(x0 - x), static_cast<int16_t>(y0 - y), static_cast<int16_t>((2 * y) + delta), color);
+      }
+    }
+    if (y != py) {
+      if ((corners & 1U) != 0U) {
+        writeFastVLine(static_cast<int16_t>(x0 + py), static_cast<int16_t>(y0 - px), static_cast<int16_t>((2 * px) + delta), color);
+      }
+      if ((corners & 2U) != 0U) {
+        writeFastVLine(static_cast<int16_t>(x0 - py), static_cast<int16_t>(y0 - px), static_cast<int16_t>((2 * px) + delta), color);
+      }
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void Adafruit_GFX::drawRoundRect(
+    const int16_t x,
+    const int16_t y,
+    const int16_t w,
+    const int16_t h,
+    int16_t r,
+    const uint16_t color) {
+  const int16_t max_radius = static_cast<int16_t>(((w < h) ? w : h) / 2);
+  if (r > max_radius) {
+    r = max_radius;
+  }
+  startWrite();
+  writeFastHLine(static_cast<int16_t>(x + r), y, static_cast<int16_t>(w - (2 * r)), color);
+  writeFastHLine(static_cast<int16_t>(x + r), static_cast<int16_t>(y + h - 1), static_cast<int16_t>(w - (2 * r)), color);
+  writeFastVLine(x, static_cast<int16_t>(y + r), static_cast<int16_t>(h - (2 * r)), color);
+  writeFastVLine(static_cast<int16_t>(x + w - 1), static_cast<int16_t>(y + r), static_cast<int16_t>(h - (2 * r)), color);
+  drawCircleHelper(static_cast<int16_t>(x + r), static_cast<int16_t>(y + r), r, 1U, color);
+  drawCircleHelper(static_cast<int16_t>(x + w - r - 1), static_cast<int16_t>(y + r), r, 2U, color);
+  drawCircleHelper(static_cast<int16_t>(x + w - r - 1), static_cast<int16_t>(y + h - r - 1), r, 4U, color);
+  drawCircleHelper(static_cast<int16_t>(x + r), static_cast<int16_t>(y + h - r - 1), r, 8U, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillRoundRect(
+    const int16_t x,
+    const int16_t y,
+    const int16_t w,
+    const int16_t h,
+    int16_t r,
+    const uint16_t color) {
+  const int16_t max_radius = static_cast<int16_t>(((w < h) ? w : h) / 2);
+  if (r > max_radius) {
+    r = max_radius;
+  }
+  startWrite();
+  writeFillRect(static_cast<int16_t>(x + r), y, static_cast<int16_t>(w - (2 * r)), h, color);
+  fillCircleHelper(
+      static_cast<int16_t>(x + w - r - 1), static_cast<int16_t>(y + r), r, 1U, static_cast<int16_t>(h - (2 * r) - 1), color);
+  fillCircleHelper(
+      static_cast<int16_t>(x + r), static_cast<int16_t>(y + r), r, 2U, static_cast<int16_t>(h - (2 * r) - 1), color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawChar(
+    const int16_t x,
+    const int16_t y,
+    const unsigned char c,
+    const uint16_t color,
+    const uint16_t bg,
+    const uint8_t size) {
+  drawChar(x, y, c, color, bg, size, size);
+}
+
+void Adafruit_GFX::drawChar(
+    const int16_t x,
+    const int16_t y,
+    unsigned char c,
+    const uint16_t color,
+    const uint16_t bg,
+    const uint8_t size_x,
+    const uint8_t size_y) {
+  if ((x >= _width) || (y >= _height) || ((x + (6 * size_x) - 1) < 0) || ((y + (8 * size_y) - 1) < 0)) {
+    return;
+  }
+  if (!_cp437 && (c >= 176U)) {
+    c++;
+  }
+
+  const bool unit = (size_x == 1U) && (size_y == 1U);
+  startWrite();
+  for (int8_t i = 0; i < 5; i++) {
+    uint8_t line = GetFontColumn(c, static_cast<uint8_t>(i));
+    for (int8_t j = 0; j < 8; j++, line = static_cast<uint8_t>(line >> 1U)) {
+      if ((line & 1U) != 0U) {
+        if (unit) {
+          writePixel(static_cast<int16_t>(x + i), static_cast<int16_t>(y + j), color);
+        } else {
+          writeFillRect(static_cast<int16_t>(x + (i * size_x)), static_cast<int16_t>(y + (j * size_y)), size_x, size_y, color);
+        }
+      } else if (bg != color) {
+        if (unit) {
+          writePixel(static_cast<int16_t>(x + i), static_cast<int16_t>(y + j), bg);
+        } else {
+          writeFillRect(static_cast<int16_t>(x + (i * size_x)), static_cast<int16_t>(y + (j * size_y)), size_x, size_y, bg);
+        }
+      }
+    }
+  }
+  if (bg != color) {
+    if (unit) {
+      writeFastVLine(static_cast<int16_t>(x + 5), y, 8, bg);
+    } else {
+      writeFillRect(static_cast<int16_t>(x + (5 * size_x)), y, size_x, static_cast<int16_t>(8 * size_y), bg);
+    }
+  }
+  endWrite();
+}
+
+size_t Adafruit_GFX::write(const uint8_t c) {
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y = static_cast<int16_t>(cursor_y + (textsize_y * 8));
+  } else if (c != '\r') {
+    if (wrap && ((cursor_x + (textsize_x * 6)) > _width)) {
+      cursor_x = 0;
+      cursor_y = static_cast<int16_t>(cursor_y + (textsize_y * 8));
+    }
+    drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+    cursor_x = static_cast<int16_t>(cursor_x + (textsize_x * 6));
+  }
+  return 1U;
+}
+
+void HostGfx_SetCanvasLimitBytes(const size_t bytes) {
+  g_canvas_limit_bytes = bytes;
+}
+
+GFXcanvas1::GFXcanvas1(const uint16_t w, const uint16_t h)
+    : Adafruit_GFX(static_cast<int16_t>(w), static_cast<int16_t>(h)), buffer(nullptr) {
+  const size_t bytes = static_cast<size_t>((w + 7U) / 8U) * h;
+  if ((g_canvas_limit_bytes > 0U) && (bytes > g_canvas_limit_bytes)) {
+    return;
+  }
+  buffer = static_cast<uint8_t*>(malloc(bytes));
+  if (buffer != nullptr) {
+    memset(buffer, 0, bytes);
+  }
+}
+
+GFXcanvas1::~GFXcanvas1() {
+  free(buffer);
+}
+
+void GFXcanvas1::drawPixel(const int16_t x, const int16_t y, const uint16_t color) {
+  if ((buffer == nullptr) || (x < 0) || (y < 0) || (x >= _width) || (y >= _height)) {
+    return;
+  }
+  uint8_t* ptr = &buffer[(x / 8) + (y * ((WIDTH + 7) / 8))];
+  if (color != 0U) {
+    *ptr = static_cast<uint8_t>(*ptr | (0x80U >> (x & 7)));
+  } else {
+    *ptr = static_cast<uint8_t>(*ptr & ~(0x80U >> (x & 7)));
+  }
+}
+
+void GFXcanvas1::fillScreen(const uint16_t color) {
+  if (buffer != nullptr) {
+    memset(buffer, (color != 0U) ? 0xFF : 0x00, static_cast<size_t>((WIDTH + 7) / 8) * HEIGHT);
+  }
+}
+
+bool GFXcanvas1::getPixel(const int16_t x, const int16_t y) const {
+  if ((buffer == nullptr) || (x < 0) || (y < 0) || (x >= _width) || (y >= _height)) {
+    return false;
+  }
+  return ((buffer[(x / 8) + (y * ((WIDTH + 7) / 8))] >> (7 - (x & 7))) & 0x01U) != 0U;
+}
@@ -0,0 +1,133 @@
+#ifndef ADAFRUIT_GFX_H
+#define ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+// Host copy of the Adafruit GFX subset the firmware draws with. The shape
+// and text algorithms follow the library line for line, so a fake display
+// sees the same primitive stream (and pixels) the ST7789 driver would.
+// Only the classic 5x7 font is provided; the ASCII range matches glcdfont.c.
+class Adafruit_GFX : public Print {
+ public:
+  Adafruit_GFX(int16_t w, int16_t h);
+  ~Adafruit_GFX() override {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void startWrite();
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color);
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  virtual void endWrite();
+
+  virtual void setRotation(uint8_t r);
+  virtual void invertDisplay(bool i);
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  virtual void fillScreen(uint16_t color);
+  virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+  void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t cornername, uint16_t color);
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color);
+  void drawRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radius, uint16_t color);
+  void fillRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radius, uint16_t color);
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+  void drawChar(
+      int16_t x,
+      int16_t y,
+      unsigned char c,
+      uint16_t color,
+      uint16_t bg,
+      uint8_t size_x,
+      uint8_t size_y);
+
+  void setCursor(int16_t x, int16_t y) {
+    cursor_x = x;
+    cursor_y = y;
+  }
+  void setTextColor(uint16_t c) {
+    textcolor = textbgcolor = c;
+  }
+  void setTextColor(uint16_t c, uint16_t bg) {
+    textcolor = c;
+    textbgcolor = bg;
+  }
+  void setTextSize(uint8_t s) {
+    setTextSize(s, s);
+  }
+  void setTextSize(uint8_t sx, uint8_t sy) {
+    textsize_x = (sx > 0U) ? sx : 1U;
+    textsize_y = (sy > 0U) ? sy : 1U;
+  }
+  void setTextWrap(bool w) {
+    wrap = w;
+  }
+  void cp437(bool x = true) {
+    _cp437 = x;
+  }
+
+  using Print::write;
+  size_t write(uint8_t c) override;
+
+  int16_t width() const {
+    return _width;
+  }
+  int16_t height() const {
+    return _height;
+  }
+  uint8_t getRotation() const {
+    return rotation;
+  }
+  int16_t getCursorX() const {
+    return cursor_x;
+  }
+  int16_t getCursorY() const {
+    return cursor_y;
+  }
+
+ protected:
+  int16_t WIDTH;
+  int16_t HEIGHT;
+  int16_t _width;
+  int16_t _height;
+  int16_t cursor_x;
+  int16_t cursor_y;
+  uint16_t textcolor;
+  uint16_t textbgcolor;
+  uint8_t textsize_x;
+  uint8_t textsize_y;
+  uint8_t rotation;
+  bool wrap;
+  bool _cp437;
+};
+
+// 1-bit canvas, MSB first, rows padded to whole bytes (rotation 0 only).
+// Host only: a canvas needing more than `bytes` fails to allocate, as it
+// would on a fragmented heap. 0 (the default) removes the limit.
+void HostGfx_SetCanvasLimitBytes(size_t bytes);
+
+class GFXcanvas1 : public Adafruit_GFX {
+ public:
+  GFXcanvas1(uint16_t w, uint16_t h);
+  ~GFXcanvas1() override;
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  bool getPixel(int16_t x, int16_t y) const;
+  uint8_t* getBuffer() const {
+    return buffer;
+  }
+
+ private:
+  uint8_t* buffer;
+};
+
+#endif  // ADAFRUIT_GFX_H
@@ -0,0 +1,355 @@
+#include <Arduino.h>
+
+#include <stdio.h>
+
+#include "host_clock.h"
+
+namespace {
+uint64_t g_now_us = 0U;
+uint32_t g_read_tick_us = 1U;
+uint32_t g_random_state = 1U;
+bool g_random_zero = false;
+
+unsigned long g_serial_baud = 9600UL;
+uint64_t g_serial_drained_us = 0U;  // FIFO state last brought up to date here
+uint32_t g_serial_fifo_used = 0U;
+uint64_t g_serial_blocked_us = 0U;
+uint32_t g_serial_bytes = 0U;
+std::string g_serial_output;
+bool g_serial_capture = true;
+bool g_serial_echo = false;
+
+uint64_t SerialByteUs() {
+  return (10ULL * 1000000ULL + g_serial_baud - 1U) / g_serial_baud;
+}
+
+void DrainSerialFifo() {
+  const uint64_t byte_us = SerialByteUs();
+  const uint64_t drained = (g_now_us - g_serial_drained_us) / byte_us;
+  if (drained >= g_serial_fifo_used) {
+    g_serial_fifo_used = 0U;
+    g_serial_drained_us = g_now_us;
+  } else {
+    g_serial_fifo_used -= static_cast<uint32_t>(drained);
+    g_serial_drained_us += drained * byte_us;
+  }
+}
+}  // namespace
+
+void HostClock_Reset(const uint64_t start_us) {
+  g_now_us = start_us;
+  g_serial_drained_us = start_us;
+  g_serial_fifo_used = 0U;
+}
+
+uint64_t HostClock_NowUs() {
+  return g_now_us;
+}
+
+void HostClock_AdvanceUs(const uint64_t us) {
+  g_now_us += us;
+}
+
+void HostClock_AdvanceMs(const uint32_t ms) {
+  g_now_us += static_cast<uint64_t>(ms) * 1000U;
+}
+
+void HostClock_SetReadTickUs(const uint32_t us) {
+  g_read_tick_us = us;
+}
+
+uint32_t millis() {
+  g_now_us += g_read_tick_us;
+  return static_cast<uint32_t>(g_now_us / 1000U);
+}
+
+uint32_t micros() {
+  g_now_us += g_read_tick_us;
+  return static_cast<uint32_t>(g_now_us);
+}
+
+void delay(const uint32_t ms) {
+  HostClock_AdvanceMs(ms);
+}
+
+void delayMicroseconds(const uint32_t us) {
+  HostClock_AdvanceUs(us);
+}
+
+// Park-Miller, so runs are identical on every host libc.
+void randomSeed(const unsigned long seed) {
+  g_random_state = static_cast<uint32_t>(seed % 2147483647UL);
+  if (g_random_state == 0U) {
+    g_random_state = 1U;
+  }
+}
+
+long random(const long max) {
+  if ((max <= 0L) || g_random_zero) {
+    return 0L;
+  }
+  g_random_state = static_cast<uint32_t>((static_cast<uint64_t>(g_random_state) * 48271U) % 2147483647U);
+  return static_cast<long>(g_random_state % static_cast<uint32_t>(max));
+}
+
+long random(const long min, const long max) {
+  return (min >= max) ? min : (min + random(max - min));
+}
+
+void HostRandom_SetZero(const bool zero) {
+  g_random_zero = zero;
+}
+
+long map(const long value, const long from_low, const long from_high, const long to_low, const long to_high) {
+  return (value - from_low) * (to_high - to_low) / (from_high - from_low) + to_low;
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t written = 0U;
+  while (size-- > 0U) {
+    const size_t one = write(*buffer++);
+    if (one == 0U) {
+      break;
+    }
+    written += one;
+  }
+  return written;
+}
+
+size_t Print::PrintNumber(unsigned long value, int base) {
+  char text[8U * sizeof(long) + 1U];
+  char* cursor = &text[sizeof(text) - 1U];
+  *cursor = '\0';
+  if (base < 2) {
+    base = 10;
+  }
+  do {
+    const unsigned long digit = value % static_cast<unsigned long>(base);
+    value /= static_cast<unsigned long>(base);
+    *--cursor = static_cast<char>((digit < 10U) ? ('0' + digit) : ('A' + digit - 10U));
+  } while (value > 0UL);
+  return write(cursor);
+}
+
+// Same rounding as the Arduino core's printFloat().
+size_t Print::PrintFloat(double value, int digits) {
+  if (isnan(value)) {
+    return print("nan");
+  }
+  if (isinf(value)) {
+    return print("inf");
+  }
+  if ((value > 4294967040.0) || (value < -4294967040.0)) {
+    return print("ovf");
+  }
+
+  size_t length = 0U;
+  if (value < 0.0) {
+    length += print('-');
+    value = -value;
+  }
+  double rounding = 0.5;
+  for (int i = 0; i < digits; i++) {
+    rounding /= 10.0;
+  }
+  value += rounding;
+
+  const unsigned long integer = static_cast<unsigned long>(value);
+  double remainder = value - static_cast<double>(integer);
+  length += PrintNumber(integer, DEC);
+  if (digits > 0) {
+    length += print('.');
+  }
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    const unsigned int digit = static_cast<unsigned int>(remainder);
+    length += print(static_cast<char>('0' + digit));
+    remainder -= digit;
+  }
+  return length;
+}
+
+size_t Print::print(const char* text) {
+  return write(text);
+}
+
+size_t Print::print(const char value) {
+  return write(static_cast<uint8_t>(value));
+}
+
+size_t Print::print(const unsigned char value, const int base) {
+  return PrintNumber(value, base);
+}
+
+size_t Print::print(const int value, const int base) {
+  return print(static_cast<long>(value), base);
+}
+
+size_t Print::print(const unsigned int value, const int base) {
+  return PrintNumber(value, base);
+}
+
+size_t Print::print(const long value, const int base) {
+  if ((base == DEC) && (value < 0L)) {
+    return print('-') + PrintNumber(static_cast<unsigned long>(-(value + 1L)) + 1UL, DEC);
+  }
+  return PrintNumber(static_cast<unsigned long>(value), base);
+}
+
+size_t Print::print(const unsigned long value, const int base) {
+  return PrintNumber(value, base);
+}
+
+size_t Print::print(const double value, const int digits) {
+  return PrintFloat(value, digits);
+}
+
+size_t Print::println() {
+  return write("\r\n");
+}
+
+size_t Print::println(const char* text) {
+  return print(text) + println();
+}
+
+size_t Print::println(const char value) {
+  return print(value) + println();
+}
+
+size_t Print::println(const unsigned char value, const int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(const int value, const int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(const unsigned int value, const int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(const long value, const int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(const unsigned long value, const int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(const double value, const int digits) {
+  return print(value, digits) + println();
+}
+
+bool IPAddress::fromString(const char* text) {
+  uint8_t octets[4] = {};
+  uint8_t index = 0U;
+  uint32_t value = 0U;
+  bool has_digit = false;
+  for (const char* cursor = text; ; cursor++) {
+    if ((*cursor >= '0') && (*cursor <= '9')) {
+      value = (value * 10U) + static_cast<uint32_t>(*cursor - '0');
+      has_digit = true;
+      if (value > 255U) {
+        return false;
+      }
+    } else if ((*cursor == '.') || (*cursor == '\0')) {
+      if (!has_digit || (index >= 4U)) {
+        return false;
+      }
+      octets[index++] = static_cast<uint8_t>(value);
+      value = 0U;
+      has_digit = false;
+      if (*cursor == '\0') {
+        break;
+      }
+    } else {
+      return false;
+    }
+  }
+  if (index != 4U) {
+    return false;
+  }
+  memcpy(octets_, octets, sizeof(octets_));
+  return true;
+}
+
+HostSerial Serial;
+
+void HostSerial::begin(const unsigned long baud) {
+  g_serial_baud = (baud > 0UL) ? baud : 9600UL;
+  g_serial_drained_us = g_now_us;
+  g_serial_fifo_used = 0U;
+}
+
+size_t HostSerial::write(const uint8_t value) {
+  return write(&value, 1U);
+}
+
+size_t HostSerial::write(const uint8_t* buffer, const size_t size) {
+  for (size_t i = 0U; i < size; i++) {
+    DrainSerialFifo();
+    if (g_serial_fifo_used >= HOST_SERIAL_FIFO_BYTES) {
+      // Blocks until the oldest byte has left the shift register.
+      const uint64_t wait_us = (g_serial_drained_us + SerialByteUs()) - g_now_us;
+      g_now_us += wait_us;
+      g_serial_blocked_us += wait_us;
+      DrainSerialFifo();
+    }
+    g_serial_fifo_used++;
+    if (g_serial_capture) {
+      g_serial_output.push_back(static_cast<char>(buffer[i]));
+    }
+    if (g_serial_echo) {
+      (void)fputc(buffer[i], stdout);
+    }
+  }
+  g_serial_bytes += static_cast<uint32_t>(size);
+  return size;
+}
+
+int HostSerial::availableForWrite() {
+  DrainSerialFifo();
+  return static_cast<int>(HOST_SERIAL_FIFO_BYTES - g_serial_fifo_used);
+}
+
+void HostSerial::flush() {
+  DrainSerialFifo();
+  const uint64_t wait_us = static_cast<uint64_t>(g_serial_fifo_used) * SerialByteUs();
+  g_now_us += wait_us;
+  g_serial_blocked_us += wait_us;
+  DrainSerialFifo();
+}
+
+void HostSerial_Reset() {
+  g_serial_drained_us = g_now_us;
+  g_serial_fifo_used = 0U;
+  g_serial_blocked_us = 0U;
+  g_serial_bytes = 0U;
+  g_serial_output.clear();
+}
+
+uint64_t HostSerial_BlockedUs() {
+  return g_serial_blocked_us;
+}
+
+uint32_t HostSerial_BytesWritten() {
+  return g_serial_bytes;
+}
+
+const std::string& HostSerial_Output() {
+  return g_serial_output;
+}
+
+std::string HostSerial_TakeOutput() {
+  std::string output;
+  output.swap(g_serial_output);
+  return output;
+}
+
+void HostSerial_SetCapture(const bool capture) {
+  g_serial_capture = capture;
+}
+
+void HostSerial_SetEcho(const bool echo) {
+  g_serial_echo = echo;
+}
@@ -0,0 +1,137 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Host stand-in for the subset of the Arduino core the sketch and src/ use.
+// Time is simulated (see host_clock.h); Serial models a slow UART whose TX
+// FIFO drains at the configured baud rate.
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef uint8_t pin_size_t;
+
+constexpr pin_size_t A0 = 15U;
+constexpr pin_size_t A1 = 16U;
+constexpr pin_size_t A2 = 17U;
+constexpr pin_size_t A3 = 18U;
+constexpr pin_size_t A4 = 19U;
+constexpr pin_size_t A5 = 20U;
+constexpr pin_size_t A6 = 21U;
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PROGMEM
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+long map(long value, long from_low, long from_high, long to_low, long to_high);
+
+class Print {
+ public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t value) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* text) {
+    return (text == nullptr) ? 0U : write(reinterpret_cast<const uint8_t*>(text), strlen(text));
+  }
+  virtual int availableForWrite() {
+    return 0;
+  }
+  virtual void flush() {}
+
+  size_t print(const char* text);
+  size_t print(char value);
+  size_t print(unsigned char value, int base = DEC);
+  size_t print(int value, int base = DEC);
+  size_t print(unsigned int value, int base = DEC);
+  size_t print(long value, int base = DEC);
+  size_t print(unsigned long value, int base = DEC);
+  size_t print(double value, int digits = 2);
+
+  size_t println();
+  size_t println(const char* text);
+  size_t println(char value);
+  size_t println(unsigned char value, int base = DEC);
+  size_t println(int value, int base = DEC);
+  size_t println(unsigned int value, int base = DEC);
+  size_t println(long value, int base = DEC);
+  size_t println(unsigned long value, int base = DEC);
+  size_t println(double value, int digits = 2);
+
+ private:
+  size_t PrintNumber(unsigned long value, int base);
+  size_t PrintFloat(double value, int digits);
+};
+
+class IPAddress {
+ public:
+  IPAddress() : octets_() {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets_{a, b, c, d} {}
+
+  bool fromString(const char* text);
+  uint8_t operator[](int index) const {
+    return octets_[index];
+  }
+  operator uint32_t() const {
+    return static_cast<uint32_t>(octets_[0]) | (static_cast<uint32_t>(octets_[1]) << 8U) |
+           (static_cast<uint32_t>(octets_[2]) << 16U) | (static_cast<uint32_t>(octets_[3]) << 24U);
+  }
+
+ private:
+  uint8_t octets_[4];
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+class Client : public Stream {
+ public:
+  virtual int connect(IPAddress ip, uint16_t port) = 0;
+  virtual int connect(const char* host, uint16_t port) = 0;
+  size_t write(uint8_t value) override = 0;
+  size_t write(const uint8_t* buffer, size_t size) override = 0;
+  int available() override = 0;
+  int read() override = 0;
+  virtual int read(uint8_t* buffer, size_t size) = 0;
+  int peek() override = 0;
+  void flush() override = 0;
+  virtual void stop() = 0;
+  virtual uint8_t connected() = 0;
+  virtual operator bool() = 0;
+};
+
+class HostSerial : public Print {
+ public:
+  using Print::write;
+
+  void begin(unsigned long baud);
+  operator bool() const {
+    return true;
+  }
+  size_t write(uint8_t value) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  int availableForWrite() override;
+  void flush() override;
+};
+
+extern HostSerial Serial;
+
+#endif  // ARDUINO_H
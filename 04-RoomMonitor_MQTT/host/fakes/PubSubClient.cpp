@@ -0,0 +1,341 @@
+#include <PubSubClient.h>
+
+namespace {
+constexpr uint8_t MQTTCONNECT = 0x10U;
+constexpr uint8_t MQTTPUBLISH = 0x30U;
+constexpr uint8_t MQTTPINGREQ = 0xC0U;
+constexpr uint8_t MQTTPINGRESP = 0xD0U;
+constexpr uint8_t MQTTDISCONNECT = 0xE0U;
+}  // namespace
+
+PubSubClient::PubSubClient()
+    : client_(nullptr),
+      buffer_(nullptr),
+      buffer_size_(0U),
+      keepalive_s_(MQTT_KEEPALIVE),
+      socket_timeout_s_(MQTT_SOCKET_TIMEOUT),
+      last_out_ms_(0UL),
+      last_in_ms_(0UL),
+      ping_outstanding_(false),
+      ip_(),
+      domain_(nullptr),
+      port_(0U),
+      state_(MQTT_DISCONNECTED) {
+  (void)setBufferSize(MQTT_MAX_PACKET_SIZE);
+}
+
+PubSubClient::PubSubClient(Client& client) : PubSubClient() {
+  client_ = &client;
+}
+
+PubSubClient::~PubSubClient() {
+  free(buffer_);
+}
+
+PubSubClient& PubSubClient::setClient(Client& client) {
+  client_ = &client;
+  return *this;
+}
+
+PubSubClient& PubSubClient::setServer(const IPAddress ip, const uint16_t port) {
+  ip_ = ip;
+  port_ = port;
+  domain_ = nullptr;
+  return *this;
+}
+
+PubSubClient& PubSubClient::setServer(const char* domain, const uint16_t port) {
+  domain_ = domain;
+  port_ = port;
+  return *this;
+}
+
+PubSubClient& PubSubClient::setKeepAlive(const uint16_t keepalive_s) {
+  keepalive_s_ = keepalive_s;
+  return *this;
+}
+
+PubSubClient& PubSubClient::setSocketTimeout(const uint16_t timeout_s) {
+  socket_timeout_s_ = timeout_s;
+  return *this;
+}
+
+bool PubSubClient::setBufferSize(const uint16_t size) {
+  if (size == 0U) {
+    return false;
+  }
+  uint8_t* resized = static_cast<uint8_t*>(realloc(buffer_, size));
+  if (resized == nullptr) {
+    return false;
+  }
+  buffer_ = resized;
+  buffer_size_ = size;
+  return true;
+}
+
+bool PubSubClient::connect(const char* id) {
+  return connect(id, nullptr, nullptr);
+}
+
+bool PubSubClient::connect(const char* id, const char* user, const char* pass) {
+  if (connected()) {
+    return true;
+  }
+  if (client_ == nullptr) {
+    state_ = MQTT_CONNECT_FAILED;
+    return false;
+  }
+
+  int result = 1;
+  if (!client_->connected()) {
+    result = (domain_ != nullptr) ? client_->connect(domain_, port_) : client_->connect(ip_, port_);
+  }
+  if (result != 1) {
+    state_ = MQTT_CONNECT_FAILED;
+    return false;
+  }
+
+  uint16_t length = MQTT_MAX_HEADER_SIZE;
+  const uint8_t protocol[] = {0x00, 0x04, 'M', 'Q', 'T', 'T', MQTT_VERSION_3_1_1};
+  memcpy(buffer_ + length, protocol, sizeof(protocol));
+  length = static_cast<uint16_t>(length + sizeof(protocol));
+
+  uint8_t flags = 0x02U;  // clean session
+  if (user != nullptr) {
+    flags = static_cast<uint8_t>(flags | 0x80U);
+    if (pass != nullptr) {
+      flags = static_cast<uint8_t>(flags | 0x40U);
+    }
+  }
+  buffer_[length++] = flags;
+  buffer_[length++] = static_cast<uint8_t>(keepalive_s_ >> 8U);
+  buffer_[length++] = static_cast<uint8_t>(keepalive_s_ & 0xFFU);
+  length = WriteString(id, buffer_, length);
+  if (user != nullptr) {
+    length = WriteString(user, buffer_, length);
+    if (pass != nullptr) {
+      length = WriteString(pass, buffer_, length);
+    }
+  }
+  (void)WritePacket(MQTTCONNECT, buffer_, static_cast<uint16_t>(length - MQTT_MAX_HEADER_SIZE));
+
+  last_in_ms_ = millis();
+  last_out_ms_ = last_in_ms_;
+  while (client_->available() == 0) {
+    if ((millis() - last_in_ms_) >= (static_cast<uint32_t>(socket_timeout_s_) * 1000UL)) {
+      state_ = MQTT_CONNECTION_TIMEOUT;
+      client_->stop();
+      return false;
+    }
+  }
+  const uint32_t packet_length = ReadPacket();
+  if (packet_length == 4U) {
+    if (buffer_[3] == 0U) {
+      last_in_ms_ = millis();
+      ping_outstanding_ = false;
+      state_ = MQTT_CONNECTED;
+      return true;
+    }
+    state_ = buffer_[3];
+  }
+  client_->stop();
+  return false;
+}
+
+void PubSubClient::disconnect() {
+  if (client_ == nullptr) {
+    return;
+  }
+  buffer_[0] = MQTTDISCONNECT;
+  buffer_[1] = 0U;
+  (void)client_->write(buffer_, 2U);
+  state_ = MQTT_DISCONNECTED;
+  client_->stop();
+  last_in_ms_ = millis();
+  last_out_ms_ = last_in_ms_;
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload, const bool retained) {
+  return publish(topic, reinterpret_cast<const uint8_t*>(payload), (payload != nullptr) ? strlen(payload) : 0U, retained);
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, const unsigned int plength, const bool retained) {
+  if (!connected()) {
+    return false;
+  }
+  if (buffer_size_ < (MQTT_MAX_HEADER_SIZE + 2U + strnlen(topic, buffer_size_) + plength)) {
+    return false;
+  }
+  uint16_t length = WriteString(topic, buffer_, MQTT_MAX_HEADER_SIZE);
+  for (unsigned int i = 0U; i < plength; i++) {
+    buffer_[length++] = payload[i];
+  }
+  const uint8_t header = static_cast<uint8_t>(MQTTPUBLISH | (retained ? 1U : 0U));
+  return WritePacket(header, buffer_, static_cast<uint16_t>(length - MQTT_MAX_HEADER_SIZE));
+}
+
+bool PubSubClient::beginPublish(const char* topic, const unsigned int plength, const bool retained) {
+  if (!connected()) {
+    return false;
+  }
+  const uint16_t length = WriteString(topic, buffer_, MQTT_MAX_HEADER_SIZE);
+  const uint8_t header = static_cast<uint8_t>(MQTTPUBLISH | (retained ? 1U : 0U));
+  const size_t header_length =
+      BuildHeader(header, buffer_, static_cast<uint16_t>(plength + length - MQTT_MAX_HEADER_SIZE));
+  const size_t start = MQTT_MAX_HEADER_SIZE - header_length;
+  const size_t written = client_->write(buffer_ + start, length - start);
+  last_out_ms_ = millis();
+  return written == (length - start);
+}
+
+int PubSubClient::endPublish() {
+  return 1;
+}
+
+size_t PubSubClient::write(const uint8_t value) {
+  last_out_ms_ = millis();
+  return client_->write(value);
+}
+
+size_t PubSubClient::write(const uint8_t* buffer, const size_t size) {
+  last_out_ms_ = millis();
+  return client_->write(buffer, size);
+}
+
+bool PubSubClient::loop() {
+  if (!connected()) {
+    return false;
+  }
+  const uint32_t now = millis();
+  const uint32_t keepalive_ms = static_cast<uint32_t>(keepalive_s_) * 1000UL;
+  if (((now - last_in_ms_) > keepalive_ms) || ((now - last_out_ms_) > keepalive_ms)) {
+    if (ping_outstanding_) {
+      state_ = MQTT_CONNECTION_TIMEOUT;
+      client_->stop();
+      return false;
+    }
+    buffer_[0] = MQTTPINGREQ;
+    buffer_[1] = 0U;
+    (void)client_->write(buffer_, 2U);
+    last_out_ms_ = now;
+    last_in_ms_ = now;
+    ping_outstanding_ = true;
+  }
+  if (client_->available() > 0) {
+    const uint32_t length = ReadPacket();
+    if (length > 0U) {
+      last_in_ms_ = now;
+      const uint8_t type = static_cast<uint8_t>(buffer_[0] & 0xF0U);
+      if (type == MQTTPINGREQ) {
+        buffer_[0] = MQTTPINGRESP;
+        buffer_[1] = 0U;
+        (void)client_->write(buffer_, 2U);
+      } else if (type == MQTTPINGRESP) {
+        ping_outstanding_ = false;
+      }
+    } else if (!connected()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PubSubClient::connected() {
+  if (client_ == nullptr) {
+    return false;
+  }
+  if (client_->connected() == 0U) {
+    if (state_ == MQTT_CONNECTED) {
+      state_ = MQTT_CONNECTION_LOST;
+      client_->flush();
+      client_->stop();
+    }
+    return false;
+  }
+  return state_ == MQTT_CONNECTED;
+}
+
+bool PubSubClient::ReadByte(uint8_t* out_byte) {
+  const uint32_t start = millis();
+  while (client_->available() == 0) {
+    if ((millis() - start) >= (static_cast<uint32_t>(socket_timeout_s_) * 1000UL)) {
+      return false;
+    }
+  }
+  *out_byte = static_cast<uint8_t>(client_->read());
+  return true;
+}
+
+// Whole packet into buffer_; bytes past the buffer are read and dropped.
+uint32_t PubSubClient::ReadPacket() {
+  uint32_t length = 0U;
+  if (!ReadByte(&buffer_[length++])) {
+    return 0U;
+  }
+  uint32_t multiplier = 1U;
+  uint32_t remaining = 0U;
+  uint8_t digit = 0U;
+  do {
+    if (length == 5U) {
+      state_ = MQTT_DISCONNECTED;
+      client_->stop();
+      return 0U;
+    }
+    if (!ReadByte(&digit)) {
+      return 0U;
+    }
+    buffer_[length++] = digit;
+    remaining += (digit & 0x7FU) * multiplier;
+    multiplier *= 128U;
+  } while ((digit & 0x80U) != 0U);
+
+  for (uint32_t i = 0U; i < remaining; i++) {
+    if (!ReadByte(&digit)) {
+      return 0U;
+    }
+    if (length < buffer_size_) {
+      buffer_[length] = digit;
+    }
+    length++;
+  }
+  return (length <= buffer_size_) ? length : 0U;
+}
+
+size_t PubSubClient::BuildHeader(const uint8_t header, uint8_t* buf, uint16_t length) {
+  uint8_t encoded[4];
+  size_t count = 0U;
+  do {
+    uint8_t digit = static_cast<uint8_t>(length % 128U);
+    length = static_cast<uint16_t>(length / 128U);
+    if (length > 0U) {
+      digit |= 0x80U;
+    }
+    encoded[count++] = digit;
+  } while (length > 0U);
+
+  buf[4U - count] = header;
+  for (size_t i = 0U; i < count; i++) {
+    buf[MQTT_MAX_HEADER_SIZE - count + i] = encoded[i];
+  }
+  return count + 1U;
+}
+
+bool PubSubClient::WritePacket(const uint8_t header, uint8_t* buf, const uint16_t length) {
+  const size_t header_length = BuildHeader(header, buf, length);
+  const size_t start = MQTT_MAX_HEADER_SIZE - header_length;
+  const size_t written = client_->write(buf + start, length + header_length);
+  last_out_ms_ = millis();
+  return written == (length + header_length);
+}
+
+uint16_t PubSubClient::WriteString(const char* text, uint8_t* buf, uint16_t pos) {
+  const uint16_t start = pos;
+  pos = static_cast<uint16_t>(pos + 2U);
+  for (const char* cursor = text; (*cursor != '\0') && (pos < buffer_size_); cursor++) {
+    buf[pos++] = static_cast<uint8_t>(*cursor);
+  }
+  const uint16_t length = static_cast<uint16_t>(pos - start - 2U);
+  buf[start] = static_cast<uint8_t>(length >> 8U);
+  buf[start + 1U] = static_cast<uint8_t>(length & 0xFFU);
+  return pos;
+}
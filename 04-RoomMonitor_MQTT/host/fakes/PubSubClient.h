@@ -0,0 +1,75 @@
+#ifndef PUBSUBCLIENT_H
+#define PUBSUBCLIENT_H
+
+#include <Arduino.h>
+
+// Host copy of the PubSubClient 2.8 calls the firmware makes, speaking
+// MQTT 3.1.1 over any Client. Buffer limits, keep-alive handling and
+// state() codes follow the library, so a payload it would reject on the
+// board is rejected here too.
+
+#define MQTT_VERSION_3_1_1 4
+#define MQTT_MAX_PACKET_SIZE 256
+#define MQTT_KEEPALIVE 15
+#define MQTT_SOCKET_TIMEOUT 15
+#define MQTT_MAX_HEADER_SIZE 5
+
+#define MQTT_CONNECTION_TIMEOUT -4
+#define MQTT_CONNECTION_LOST -3
+#define MQTT_CONNECT_FAILED -2
+#define MQTT_DISCONNECTED -1
+#define MQTT_CONNECTED 0
+
+class PubSubClient : public Print {
+ public:
+  PubSubClient();
+  explicit PubSubClient(Client& client);
+  ~PubSubClient() override;
+
+  PubSubClient& setClient(Client& client);
+  PubSubClient& setServer(IPAddress ip, uint16_t port);
+  PubSubClient& setServer(const char* domain, uint16_t port);
+  PubSubClient& setKeepAlive(uint16_t keepalive_s);
+  PubSubClient& setSocketTimeout(uint16_t timeout_s);
+  bool setBufferSize(uint16_t size);
+  uint16_t getBufferSize() const {
+    return buffer_size_;
+  }
+
+  bool connect(const char* id);
+  bool connect(const char* id, const char* user, const char* pass);
+  void disconnect();
+  bool publish(const char* topic, const char* payload, bool retained);
+  bool publish(const char* topic, const uint8_t* payload, unsigned int plength, bool retained);
+  bool beginPublish(const char* topic, unsigned int plength, bool retained);
+  int endPublish();
+  size_t write(uint8_t value) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  bool loop();
+  bool connected();
+  int state() const {
+    return state_;
+  }
+
+ private:
+  bool ReadByte(uint8_t* out_byte);
+  uint32_t ReadPacket();
+  size_t BuildHeader(uint8_t header, uint8_t* buf, uint16_t length);
+  bool WritePacket(uint8_t header, uint8_t* buf, uint16_t length);
+  uint16_t WriteString(const char* text, uint8_t* buf, uint16_t pos);
+
+  Client* client_;
+  uint8_t* buffer_;
+  uint16_t buffer_size_;
+  uint16_t keepalive_s_;
+  uint16_t socket_timeout_s_;
+  uint32_t last_out_ms_;
+  uint32_t last_in_ms_;
+  bool ping_outstanding_;
+  IPAddress ip_;
+  const char* domain_;
+  uint16_t port_;
+  int state_;
+};
+
+#endif  // PUBSUBCLIENT_H
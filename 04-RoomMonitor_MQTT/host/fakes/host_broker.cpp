@@ -0,0 +1,433 @@
+#include "host_broker.h"
+
+#include "host_clock.h"
+#include "host_heap.h"
+
+namespace {
+constexpr uint8_t PACKET_CONNECT = 0x10U;
+constexpr uint8_t PACKET_CONNACK = 0x20U;
+constexpr uint8_t PACKET_PUBLISH = 0x30U;
+constexpr uint8_t PACKET_PUBACK = 0x40U;
+constexpr uint8_t PACKET_PINGREQ = 0xC0U;
+constexpr uint8_t PACKET_PINGRESP = 0xD0U;
+constexpr uint8_t PACKET_DISCONNECT = 0xE0U;
+
+constexpr uint8_t PROPERTY_RECEIVE_MAXIMUM = 0x21U;
+constexpr uint8_t PROPERTY_TOPIC_ALIAS_MAXIMUM = 0x22U;
+constexpr uint8_t PROPERTY_TOPIC_ALIAS = 0x23U;
+constexpr uint8_t PROPERTY_MAXIMUM_QOS = 0x24U;
+constexpr uint8_t QOS_ABSENT = 0xFFU;
+
+const HostBrokerConfig DEFAULT_CONFIG = {true, true, 0U, 0U, QOS_ABSENT, true, true, 0UL, true};
+
+void PutVarint(std::vector<uint8_t>* out, uint32_t value) {
+  do {
+    uint8_t digit = static_cast<uint8_t>(value % 128U);
+    value /= 128U;
+    if (value > 0U) {
+      digit |= 0x80U;
+    }
+    out->push_back(digit);
+  } while (value > 0U);
+}
+
+bool ReadVarint(const uint8_t* data, const size_t length, size_t* offset, uint32_t* out_value) {
+  uint32_t value = 0U;
+  for (uint8_t shift = 0U; shift < 28U; shift = static_cast<uint8_t>(shift + 7U)) {
+    if (*offset >= length) {
+      return false;
+    }
+    const uint8_t digit = data[(*offset)++];
+    value |= static_cast<uint32_t>(digit & 0x7FU) << shift;
+    if ((digit & 0x80U) == 0U) {
+      *out_value = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ReadUint16(const uint8_t* data, const size_t length, size_t* offset, uint16_t* out_value) {
+  if ((*offset + 2U) > length) {
+    return false;
+  }
+  *out_value = static_cast<uint16_t>((data[*offset] << 8U) | data[*offset + 1U]);
+  *offset += 2U;
+  return true;
+}
+
+bool ReadString(const uint8_t* data, const size_t length, size_t* offset, std::string* out_text) {
+  uint16_t text_length = 0U;
+  if (!ReadUint16(data, length, offset, &text_length) || ((*offset + text_length) > length)) {
+    return false;
+  }
+  out_text->assign(reinterpret_cast<const char*>(data + *offset), text_length);
+  *offset += text_length;
+  return true;
+}
+
+void AppendProperty16(std::vector<uint8_t>* out, const uint8_t id, const uint16_t value) {
+  out->push_back(id);
+  out->push_back(static_cast<uint8_t>(value >> 8U));
+  out->push_back(static_cast<uint8_t>(value & 0xFFU));
+}
+}  // namespace
+
+HostBroker::HostBroker() {
+  Reset();
+}
+
+void HostBroker::Reset() {
+  config_ = DEFAULT_CONFIG;
+  session_open_ = false;
+  connected_ = false;
+  protocol_level_ = 0U;
+  keepalive_s_ = 0U;
+  client_id_.clear();
+  input_.clear();
+  output_.clear();
+  output_offset_ = 0U;
+  packet_bytes_ = 0U;
+  aliases_.clear();
+  messages_.clear();
+  retained_.clear();
+  for (uint8_t i = 0U; i < HOST_MQTT_PACKET_TYPES; i++) {
+    packets_in_[i] = 0U;
+  }
+  bytes_in_ = 0U;
+  bytes_out_ = 0U;
+  sessions_ = 0U;
+  connects_ = 0U;
+  protocol_errors_ = 0U;
+  last_error_.clear();
+}
+
+void HostBroker::OpenSession() {
+  const HostHeapExclude exclude;
+  session_open_ = true;
+  connected_ = false;
+  input_.clear();
+  output_.clear();
+  output_offset_ = 0U;
+  aliases_.clear();
+  sessions_++;
+}
+
+void HostBroker::CloseSession() {
+  const HostHeapExclude exclude;
+  session_open_ = false;
+  connected_ = false;
+  input_.clear();
+  output_.clear();
+  output_offset_ = 0U;
+}
+
+void HostBroker::DropSession() {
+  const HostHeapExclude exclude;
+  CloseSession();
+}
+
+size_t HostBroker::Receive(const uint8_t* data, const size_t length) {
+  const HostHeapExclude exclude;
+  if (!session_open_ || !config_.accept_writes) {
+    return 0U;
+  }
+  input_.insert(input_.end(), data, data + length);
+  bytes_in_ += static_cast<uint32_t>(length);
+  ParseInput();
+  return length;
+}
+
+int HostBroker::Available() {
+  const uint32_t now = NowMs();
+  int count = 0;
+  size_t offset = output_offset_;
+  for (const Outbound& packet : output_) {
+    if (static_cast<int32_t>(now - packet.ready_ms) < 0) {
+      break;
+    }
+    count += static_cast<int>(packet.bytes.size() - offset);
+    offset = 0U;
+  }
+  return count;
+}
+
+int HostBroker::Read() {
+  const int value = Peek();
+  if (value < 0) {
+    return value;
+  }
+  output_offset_++;
+  if (output_offset_ >= output_.front().bytes.size()) {
+    output_.pop_front();
+    output_offset_ = 0U;
+  }
+  return value;
+}
+
+int HostBroker::Peek() {
+  if (output_.empty() || (static_cast<int32_t>(NowMs() - output_.front().ready_ms) < 0)) {
+    return -1;
+  }
+  return output_.front().bytes[output_offset_];
+}
+
+std::vector<HostMqttMessage> HostBroker::GetMessagesOn(const std::string& topic) const {
+  std::vector<HostMqttMessage> matches;
+  for (const HostMqttMessage& message : messages_) {
+    if (message.topic == topic) {
+      matches.push_back(message);
+    }
+  }
+  return matches;
+}
+
+const HostMqttMessage* HostBroker::GetRetained(const std::string& topic) const {
+  const auto it = retained_.find(topic);
+  return (it != retained_.end()) ? &it->second : nullptr;
+}
+
+void HostBroker::ParseInput() {
+  while (session_open_ && (input_.size() >= 2U)) {
+    size_t offset = 1U;
+    uint32_t remaining = 0U;
+    if (!ReadVarint(input_.data(), input_.size(), &offset, &remaining)) {
+      if (input_.size() > 5U) {
+        Fail("malformed remaining length");
+      }
+      return;
+    }
+    if ((offset + remaining) > input_.size()) {
+      return;
+    }
+    const uint8_t header = input_[0];
+    const std::vector<uint8_t> body(input_.begin() + static_cast<long>(offset),
+                                    input_.begin() + static_cast<long>(offset + remaining));
+    input_.erase(input_.begin(), input_.begin() + static_cast<long>(offset + remaining));
+    packets_in_[header >> 4U]++;
+    packet_bytes_ = static_cast<uint32_t>(offset + remaining);
+    HandlePacket(header, body.data(), body.size());
+  }
+}
+
+void HostBroker::HandlePacket(const uint8_t header, const uint8_t* body, const size_t length) {
+  const uint8_t type = static_cast<uint8_t>(header & 0xF0U);
+  if ((type != PACKET_CONNECT) && !connected_) {
+    Fail("packet before CONNECT");
+    return;
+  }
+  switch (type) {
+    case PACKET_CONNECT:
+      HandleConnect(body, length);
+      break;
+    case PACKET_PUBLISH:
+      HandlePublish(header, body, length);
+      break;
+    case PACKET_PINGREQ:
+      if (config_.send_pingresp) {
+        Send({PACKET_PINGRESP, 0U});
+      }
+      break;
+    case PACKET_DISCONNECT:
+      CloseSession();
+      break;
+    default:
+      Fail("unexpected packet type");
+      break;
+  }
+}
+
+void HostBroker::HandleConnect(const uint8_t* body, const size_t length) {
+  size_t offset = 0U;
+  std::string protocol;
+  if (!ReadString(body, length, &offset, &protocol) || (protocol != "MQTT") || ((offset + 2U) > length)) {
+    Fail("bad CONNECT header");
+    return;
+  }
+  protocol_level_ = body[offset++];
+  offset++;  // connect flags: clean session, user and password are not checked
+  if (!ReadUint16(body, length, &offset, &keepalive_s_)) {
+    Fail("bad CONNECT keep-alive");
+    return;
+  }
+  if (protocol_level_ == 5U) {
+    uint32_t properties_length = 0U;
+    if (!ReadVarint(body, length, &offset, &properties_length)) {
+      Fail("bad CONNECT properties");
+      return;
+    }
+    offset += properties_length;
+  }
+  if (!ReadString(body, length, &offset, &client_id_)) {
+    Fail("bad CONNECT client id");
+    return;
+  }
+
+  if (!config_.send_connack) {
+    return;
+  }
+  std::vector<uint8_t> connack = {PACKET_CONNACK};
+  if (protocol_level_ == 5U) {
+    std::vector<uint8_t> properties;
+    if (config_.receive_maximum > 0U) {
+      AppendProperty16(&properties, PROPERTY_RECEIVE_MAXIMUM, config_.receive_maximum);
+    }
+    if (config_.topic_alias_maximum > 0U) {
+      AppendProperty16(&properties, PROPERTY_TOPIC_ALIAS_MAXIMUM, config_.topic_alias_maximum);
+    }
+    if (config_.maximum_qos != QOS_ABSENT) {
+      properties.push_back(PROPERTY_MAXIMUM_QOS);
+      properties.push_back(config_.maximum_qos);
+    }
+    std::vector<uint8_t> variable = {0U, static_cast<uint8_t>(config_.accept_connect ? 0x00U : 0x87U)};
+    PutVarint(&variable, static_cast<uint32_t>(properties.size()));
+    variable.insert(variable.end(), properties.begin(), properties.end());
+    PutVarint(&connack, static_cast<uint32_t>(variable.size()));
+    connack.insert(connack.end(), variable.begin(), variable.end());
+  } else {
+    connack.push_back(2U);
+    connack.push_back(0U);
+    connack.push_back(config_.accept_connect ? 0x00U : 0x05U);
+  }
+  Send(connack);
+  connected_ = config_.accept_connect;
+  connects_ += connected_ ? 1U : 0U;
+  aliases_.clear();
+}
+
+void HostBroker::HandlePublish(const uint8_t header, const uint8_t* body, const size_t length) {
+  HostMqttMessage message = {};
+  message.qos = static_cast<uint8_t>((header >> 1U) & 0x03U);
+  message.retained = (header & 0x01U) != 0U;
+  message.dup = (header & 0x08U) != 0U;
+  message.received_ms = NowMs();
+  message.wire_bytes = packet_bytes_;
+
+  size_t offset = 0U;
+  if (!ReadString(body, length, &offset, &message.topic)) {
+    Fail("bad PUBLISH topic");
+    return;
+  }
+  if ((message.qos > 0U) && !ReadUint16(body, length, &offset, &message.packet_id)) {
+    Fail("bad PUBLISH packet id");
+    return;
+  }
+  if (message.qos > 1U) {
+    Fail("QoS 2 not supported");
+    return;
+  }
+  if (protocol_level_ == 5U) {
+    uint32_t properties_length = 0U;
+    if (!ReadVarint(body, length, &offset, &properties_length) || ((offset + properties_length) > length)) {
+      Fail("bad PUBLISH properties");
+      return;
+    }
+    const size_t end = offset + properties_length;
+    while (offset < end) {
+      const uint8_t id = body[offset++];
+      if ((id != PROPERTY_TOPIC_ALIAS) || !ReadUint16(body, end, &offset, &message.topic_alias)) {
+        Fail("unexpected PUBLISH property");
+        return;
+      }
+    }
+    if ((config_.maximum_qos != QOS_ABSENT) && (message.qos > config_.maximum_qos)) {
+      Fail("QoS above Maximum QoS");
+      return;
+    }
+    if (message.topic_alias != 0U) {
+      if (message.topic_alias > config_.topic_alias_maximum) {
+        Fail("topic alias above Topic Alias Maximum");
+        return;
+      }
+      if (message.topic.empty()) {
+        const auto it = aliases_.find(message.topic_alias);
+        if (it == aliases_.end()) {
+          Fail("unknown topic alias");
+          return;
+        }
+        message.topic = it->second;
+      } else {
+        aliases_[message.topic_alias] = message.topic;
+      }
+    }
+  }
+  if (message.topic.empty()) {
+    Fail("empty topic");
+    return;
+  }
+  message.payload.assign(reinterpret_cast<const char*>(body + offset), length - offset);
+
+  messages_.push_back(message);
+  if (message.retained) {
+    if (message.payload.empty()) {
+      retained_.erase(message.topic);
+    } else {
+      retained_[message.topic] = message;
+    }
+  }
+  if ((message.qos == 1U) && config_.send_puback) {
+    Send({PACKET_PUBACK, 2U, static_cast<uint8_t>(message.packet_id >> 8U),
+          static_cast<uint8_t>(message.packet_id & 0xFFU)});
+  }
+}
+
+void HostBroker::Send(const std::vector<uint8_t>& packet) {
+  output_.push_back({NowMs() + config_.response_delay_ms, packet});
+  bytes_out_ += static_cast<uint32_t>(packet.size());
+}
+
+void HostBroker::Fail(const char* reason) {
+  protocol_errors_++;
+  last_error_ = reason;
+  CloseSession();
+}
+
+uint32_t HostBroker::NowMs() {
+  return static_cast<uint32_t>(HostClock_NowUs() / 1000U);
+}
+
+int HostTransportClient::connect(IPAddress, uint16_t) {
+  broker_->OpenSession();
+  return 1;
+}
+
+int HostTransportClient::connect(const char*, uint16_t) {
+  broker_->OpenSession();
+  return 1;
+}
+
+size_t HostTransportClient::write(const uint8_t value) {
+  return write(&value, 1U);
+}
+
+size_t HostTransportClient::write(const uint8_t* buffer, const size_t size) {
+  return broker_->Receive(buffer, size);
+}
+
+int HostTransportClient::available() {
+  return broker_->IsSessionOpen() ? broker_->Available() : 0;
+}
+
+int HostTransportClient::read() {
+  return broker_->IsSessionOpen() ? broker_->Read() : -1;
+}
+
+int HostTransportClient::read(uint8_t* buffer, const size_t size) {
+  size_t count = 0U;
+  while ((count < size) && (available() > 0)) {
+    buffer[count++] = static_cast<uint8_t>(read());
+  }
+  return static_cast<int>(count);
+}
+
+int HostTransportClient::peek() {
+  return broker_->IsSessionOpen() ? broker_->Peek() : -1;
+}
+
+void HostTransportClient::stop() {
+  broker_->CloseSession();
+}
+
+uint8_t HostTransportClient::connected() {
+  return broker_->IsSessionOpen() ? 1U : 0U;
+}
@@ -0,0 +1,168 @@
+#ifndef HOST_BROKER_H
+#define HOST_BROKER_H
+
+#include <Arduino.h>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+// In-process MQTT broker stand-in speaking 3.1.1 (PubSubClient) and 5
+// (MqttLiteClient) to one client over HostTransportClient. It records every
+// PUBLISH, keeps retained messages, answers CONNECT/PUBLISH/PINGREQ after a
+// configurable delay of simulated time, and drops the session on protocol
+// errors such as an unknown topic alias or a QoS above its maximum.
+
+struct HostMqttMessage {
+  std::string topic;
+  std::string payload;
+  uint8_t qos;
+  bool retained;
+  bool dup;
+  uint16_t packet_id;
+  uint16_t topic_alias;
+  uint32_t received_ms;
+  uint32_t wire_bytes;  // whole PUBLISH packet
+};
+
+struct HostBrokerConfig {
+  bool accept_connect;
+  bool send_connack;  // false: a CONNECT is never answered
+  // MQTT 5 CONNACK properties; 0 (0xFF for the QoS) leaves them out.
+  uint16_t receive_maximum;
+  uint16_t topic_alias_maximum;
+  uint8_t maximum_qos;
+  bool send_puback;
+  bool send_pingresp;
+  uint32_t response_delay_ms;
+  bool accept_writes;  // false: client writes fail as on a dead socket
+};
+
+constexpr uint8_t HOST_MQTT_PACKET_TYPES = 16U;
+
+class HostBroker {
+ public:
+  HostBroker();
+
+  void Reset();
+  HostBrokerConfig& Config() {
+    return config_;
+  }
+
+  // Transport side, driven by HostTransportClient.
+  void OpenSession();
+  void CloseSession();
+  bool IsSessionOpen() const {
+    return session_open_;
+  }
+  size_t Receive(const uint8_t* data, size_t length);
+  int Available();
+  int Read();
+  int Peek();
+
+  // Broker-initiated close; the client sees connected() go false.
+  void DropSession();
+
+  const std::vector<HostMqttMessage>& GetMessages() const {
+    return messages_;
+  }
+  void ClearMessages() {
+    messages_.clear();
+  }
+  std::vector<HostMqttMessage> GetMessagesOn(const std::string& topic) const;
+  const HostMqttMessage* GetRetained(const std::string& topic) const;
+
+  uint32_t GetPacketCount(uint8_t packet_type) const {
+    return packets_in_[(packet_type >> 4U) & 0x0FU];
+  }
+  uint32_t GetBytesIn() const {
+    return bytes_in_;
+  }
+  uint32_t GetBytesOut() const {
+    return bytes_out_;
+  }
+  uint32_t GetSessionCount() const {
+    return sessions_;
+  }
+  // CONNECTs accepted.
+  uint32_t GetConnectCount() const {
+    return connects_;
+  }
+  uint32_t GetProtocolErrors() const {
+    return protocol_errors_;
+  }
+  const std::string& GetLastError() const {
+    return last_error_;
+  }
+  uint8_t GetProtocolLevel() const {
+    return protocol_level_;
+  }
+  uint16_t GetKeepAliveS() const {
+    return keepalive_s_;
+  }
+  const std::string& GetClientId() const {
+    return client_id_;
+  }
+
+ private:
+  struct Outbound {
+    uint32_t ready_ms;
+    std::vector<uint8_t> bytes;
+  };
+
+  void ParseInput();
+  void HandlePacket(uint8_t header, const uint8_t* body, size_t length);
+  void HandleConnect(const uint8_t* body, size_t length);
+  void HandlePublish(uint8_t header, const uint8_t* body, size_t length);
+  void Send(const std::vector<uint8_t>& packet);
+  void Fail(const char* reason);
+  static uint32_t NowMs();
+
+  HostBrokerConfig config_;
+  bool session_open_;
+  bool connected_;
+  uint8_t protocol_level_;
+  uint16_t keepalive_s_;
+  std::string client_id_;
+  std::vector<uint8_t> input_;
+  std::deque<Outbound> output_;
+  size_t output_offset_;
+  uint32_t packet_bytes_;
+  std::map<uint16_t, std::string> aliases_;
+  std::vector<HostMqttMessage> messages_;
+  std::map<std::string, HostMqttMessage> retained_;
+  uint32_t packets_in_[HOST_MQTT_PACKET_TYPES];
+  uint32_t bytes_in_;
+  uint32_t bytes_out_;
+  uint32_t sessions_;
+  uint32_t connects_;
+  uint32_t protocol_errors_;
+  std::string last_error_;
+};
+
+// The firmware's end of the TCP connection.
+class HostTransportClient : public Client {
+ public:
+  explicit HostTransportClient(HostBroker* broker) : broker_(broker) {}
+
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(const char* host, uint16_t port) override;
+  size_t write(uint8_t value) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buffer, size_t size) override;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override {
+    return connected() != 0U;
+  }
+
+ private:
+  HostBroker* broker_;
+};
+
+#endif  // HOST_BROKER_H
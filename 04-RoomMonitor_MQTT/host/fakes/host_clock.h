@@ -0,0 +1,40 @@
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+#include <stdint.h>
+
+#include <string>
+
+// Simulated time behind millis()/micros(). Nothing advances it except the
+// fakes (bus transfers, SPI pixels, UART stalls, idle sleep), delay() and
+// the tests themselves, plus an optional tick per clock read so polling
+// loops always make progress.
+void HostClock_Reset(uint64_t start_us = 0U);
+uint64_t HostClock_NowUs();
+void HostClock_AdvanceUs(uint64_t us);
+void HostClock_AdvanceMs(uint32_t ms);
+// Microseconds added on every millis()/micros() call (default 1).
+void HostClock_SetReadTickUs(uint32_t us);
+
+// random() normally follows randomSeed(); with zero on it always returns
+// its minimum, as if the firmware's jitter were compiled out.
+void HostRandom_SetZero(bool zero);
+
+// Serial: a TX FIFO of HOST_SERIAL_FIFO_BYTES drained at baud / 10 bytes
+// per second of simulated time. A write() that does not fit stalls the
+// clock until it does, exactly where the real core would block.
+constexpr uint32_t HOST_SERIAL_FIFO_BYTES = 64U;
+
+void HostSerial_Reset();
+// Total simulated time spent blocked inside Serial.write().
+uint64_t HostSerial_BlockedUs();
+uint32_t HostSerial_BytesWritten();
+// Everything written so far; Take clears it.
+const std::string& HostSerial_Output();
+std::string HostSerial_TakeOutput();
+// Keeps output in memory (default on); long simulations turn it off.
+void HostSerial_SetCapture(bool capture);
+// Copies output to stdout as it is written.
+void HostSerial_SetEcho(bool echo);
+
+#endif  // HOST_CLOCK_H
@@ -0,0 +1,133 @@
+#include "host_display.h"
+
+#include <stdio.h>
+
+#include "host_clock.h"
+
+namespace {
+// CASET + 4, RASET + 4, RAMWR, as counted by display_profiler.cpp.
+constexpr uint32_t SPI_ADDR_WINDOW_BYTES = 11UL;
+constexpr uint32_t SPI_BYTES_PER_PIXEL = 2UL;
+}  // namespace
+
+HostDisplay::HostDisplay()
+    : Adafruit_GFX(PANEL_WIDTH, PANEL_HEIGHT),
+      framebuffer_(static_cast<size_t>(PANEL_WIDTH) * PANEL_HEIGHT, 0U),
+      stats_(),
+      charge_clock_(true),
+      asleep_(false),
+      recording_(false),
+      section_(nullptr),
+      calls_() {}
+
+void HostDisplay::drawPixel(const int16_t x, const int16_t y, const uint16_t color) {
+  Fill("drawPixel", x, y, 1, 1, color);
+}
+
+void HostDisplay::writePixel(const int16_t x, const int16_t y, const uint16_t color) {
+  Fill("writePixel", x, y, 1, 1, color);
+}
+
+void HostDisplay::writeFillRect(const int16_t x, const int16_t y, const int16_t w, const int16_t h, const uint16_t color) {
+  Fill("writeFillRect", x, y, w, h, color);
+}
+
+void HostDisplay::writeFastVLine(const int16_t x, const int16_t y, const int16_t h, const uint16_t color) {
+  Fill("writeFastVLine", x, y, 1, h, color);
+}
+
+void HostDisplay::writeFastHLine(const int16_t x, const int16_t y, const int16_t w, const uint16_t color) {
+  Fill("writeFastHLine", x, y, w, 1, color);
+}
+
+void HostDisplay::drawFastVLine(const int16_t x, const int16_t y, const int16_t h, const uint16_t color) {
+  Fill("drawFastVLine", x, y, 1, h, color);
+}
+
+void HostDisplay::drawFastHLine(const int16_t x, const int16_t y, const int16_t w, const uint16_t color) {
+  Fill("drawFastHLine", x, y, w, 1, color);
+}
+
+void HostDisplay::fillRect(const int16_t x, const int16_t y, const int16_t w, const int16_t h, const uint16_t color) {
+  Fill("fillRect", x, y, w, h, color);
+}
+
+void HostDisplay::fillScreen(const uint16_t color) {
+  Fill("fillScreen", 0, 0, _width, _height, color);
+}
+
+uint16_t HostDisplay::GetPixel(const int16_t x, const int16_t y) const {
+  if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height)) {
+    return 0U;
+  }
+  return framebuffer_[(static_cast<size_t>(y) * PANEL_WIDTH) + static_cast<size_t>(x)];
+}
+
+void HostDisplay::ResetStats() {
+  stats_ = {};
+}
+
+bool HostDisplay::WritePpm(const char* path) const {
+  FILE* file = fopen(path, "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  fprintf(file, "P6\n%d %d\n255\n", PANEL_WIDTH, PANEL_HEIGHT);
+  std::vector<uint8_t> rgb;
+  rgb.reserve(framebuffer_.size() * 3U);
+  for (const uint16_t pixel : framebuffer_) {
+    // Widen each field so full scale stays full scale.
+    rgb.push_back(static_cast<uint8_t>((((pixel >> 11) & 0x1FU) * 255U + 15U) / 31U));
+    rgb.push_back(static_cast<uint8_t>((((pixel >> 5) & 0x3FU) * 255U + 31U) / 63U));
+    rgb.push_back(static_cast<uint8_t>(((pixel & 0x1FU) * 255U + 15U) / 31U));
+  }
+  const bool written = fwrite(rgb.data(), 1U, rgb.size(), file) == rgb.size();
+  return (fclose(file) == 0) && written;
+}
+
+// Negative sizes flip the origin, as Adafruit_SPITFT accepts them.
+void HostDisplay::Fill(const char* primitive, int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t color) {
+  HostDisplayCall call = {primitive, section_, x, y, w, h, color, 0UL, 0UL, 0UL};
+  if (w < 0) {
+    x = static_cast<int16_t>(x + w + 1);
+    w = static_cast<int16_t>(-w);
+  }
+  if (h < 0) {
+    y = static_cast<int16_t>(y + h + 1);
+    h = static_cast<int16_t>(-h);
+  }
+  const int32_t x0 = (x < 0) ? 0 : x;
+  const int32_t y0 = (y < 0) ? 0 : y;
+  const int32_t x1 = ((x + w) > _width) ? _width : (x + w);
+  const int32_t y1 = ((y + h) > _height) ? _height : (y + h);
+  if ((x1 <= x0) || (y1 <= y0)) {
+    if (recording_) {
+      calls_.push_back(call);
+    }
+    return;
+  }
+
+  for (int32_t row = y0; row < y1; row++) {
+    uint16_t* line = &framebuffer_[static_cast<size_t>(row) * PANEL_WIDTH];
+    for (int32_t column = x0; column < x1; column++) {
+      line[column] = color;
+    }
+  }
+
+  const uint32_t pixels = static_cast<uint32_t>((x1 - x0) * (y1 - y0));
+  const uint32_t spi_bytes = SPI_ADDR_WINDOW_BYTES + (pixels * SPI_BYTES_PER_PIXEL);
+  const uint64_t busy_us = ((static_cast<uint64_t>(spi_bytes) * 8U * 1000000U) + HOST_DISPLAY_SPI_HZ - 1U) / HOST_DISPLAY_SPI_HZ;
+  stats_.calls++;
+  stats_.pixels += pixels;
+  stats_.spi_bytes += spi_bytes;
+  stats_.busy_us += busy_us;
+  if (recording_) {
+    call.pixels = pixels;
+    call.spi_bytes = spi_bytes;
+    call.busy_us = static_cast<uint32_t>(busy_us);
+    calls_.push_back(call);
+  }
+  if (charge_clock_) {
+    HostClock_AdvanceUs(busy_us);
+  }
+}
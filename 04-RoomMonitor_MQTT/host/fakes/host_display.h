@@ -0,0 +1,102 @@
+#ifndef HOST_DISPLAY_H
+#define HOST_DISPLAY_H
+
+#include <Adafruit_GFX.h>
+
+#include <vector>
+
+struct HostDisplayStats {
+  uint32_t calls;      // primitives that reached the panel
+  uint32_t pixels;     // pixels streamed after clipping
+  uint32_t spi_bytes;  // address windows plus 16-bit pixels
+  uint64_t busy_us;    // simulated time charged for the transfers
+};
+
+// One primitive as it reached the panel, before clipping; pixels and
+// spi_bytes are after clipping and are zero for a call entirely off screen.
+struct HostDisplayCall {
+  const char* primitive;  // the overridden method, e.g. "writeFillRect"
+  const char* section;    // label set with SetSection(), or nullptr
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+  uint16_t color;
+  uint32_t pixels;
+  uint32_t spi_bytes;
+  uint32_t busy_us;
+};
+
+// 240x240 RGB565 framebuffer standing in for the carrier's ST7789. It
+// overrides the same primitives Adafruit_SPITFT does, so every call costs
+// one address window plus two bytes per pixel, and charges that transfer
+// to the simulated clock at HOST_DISPLAY_SPI_HZ.
+class HostDisplay : public Adafruit_GFX {
+ public:
+  static constexpr int16_t PANEL_WIDTH = 240;
+  static constexpr int16_t PANEL_HEIGHT = 240;
+  // Effective SAMD21 SPI throughput for Adafruit_SPITFT without DMA.
+  static constexpr uint32_t HOST_DISPLAY_SPI_HZ = 12000000UL;
+
+  HostDisplay();
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+
+  uint16_t GetPixel(int16_t x, int16_t y) const;
+  const std::vector<uint16_t>& GetFramebuffer() const {
+    return framebuffer_;
+  }
+  const HostDisplayStats& GetStats() const {
+    return stats_;
+  }
+  void ResetStats();
+  // With charging off the display is free, for tests that only look at
+  // pixels.
+  void SetChargeClock(bool charge) {
+    charge_clock_ = charge;
+  }
+  void SetSleep(bool sleep) {
+    asleep_ = sleep;
+  }
+  bool IsAsleep() const {
+    return asleep_;
+  }
+
+  // Recording keeps every primitive call, labelled with the current
+  // section, until ClearCalls().
+  void SetRecording(bool recording) {
+    recording_ = recording;
+  }
+  void SetSection(const char* section) {
+    section_ = section;
+  }
+  const std::vector<HostDisplayCall>& GetCalls() const {
+    return calls_;
+  }
+  void ClearCalls() {
+    calls_.clear();
+  }
+  // The framebuffer as a binary PPM (P6, RGB888) for viewing and diffing.
+  bool WritePpm(const char* path) const;
+
+ private:
+  void Fill(const char* primitive, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+  std::vector<uint16_t> framebuffer_;
+  HostDisplayStats stats_;
+  bool charge_clock_;
+  bool asleep_;
+  bool recording_;
+  const char* section_;
+  std::vector<HostDisplayCall> calls_;
+};
+
+#endif  // HOST_DISPLAY_H
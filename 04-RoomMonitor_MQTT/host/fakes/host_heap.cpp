@@ -0,0 +1,56 @@
+#include "host_heap.h"
+
+#include <stddef.h>
+
+// glibc's own entry points; the definitions below replace the public ones
+// for the whole process.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+}
+
+namespace {
+bool g_counting = false;
+uint32_t g_exclude_depth = 0UL;
+uint32_t g_allocations = 0UL;
+
+void CountAllocation() {
+  if (g_counting && (g_exclude_depth == 0UL)) {
+    g_allocations++;
+  }
+}
+}  // namespace
+
+extern "C" void* malloc(const size_t size) {
+  CountAllocation();
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(const size_t count, const size_t size) {
+  CountAllocation();
+  return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* pointer, const size_t size) {
+  CountAllocation();
+  return __libc_realloc(pointer, size);
+}
+
+void HostHeap_StartCounting() {
+  g_allocations = 0UL;
+  g_counting = true;
+}
+
+uint32_t HostHeap_StopCounting() {
+  g_counting = false;
+  return g_allocations;
+}
+
+HostHeapExclude::HostHeapExclude() {
+  g_exclude_depth++;
+}
+
+HostHeapExclude::~HostHeapExclude() {
+  g_exclude_depth--;
+}
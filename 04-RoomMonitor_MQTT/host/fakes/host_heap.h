@@ -0,0 +1,21 @@
+#ifndef HOST_HEAP_H
+#define HOST_HEAP_H
+
+#include <stdint.h>
+
+// Counts heap allocations (malloc, calloc, realloc and so operator new)
+// between Start and Stop. The outside world the fakes simulate, i.e. the
+// broker behind the transport, allocates inside a HostHeapExclude scope, so
+// the count is the firmware's own.
+void HostHeap_StartCounting();
+uint32_t HostHeap_StopCounting();
+
+class HostHeapExclude {
+ public:
+  HostHeapExclude();
+  ~HostHeapExclude();
+  HostHeapExclude(const HostHeapExclude&) = delete;
+  HostHeapExclude& operator=(const HostHeapExclude&) = delete;
+};
+
+#endif  // HOST_HEAP_H
@@ -0,0 +1,245 @@
+#include "hal.h"
+
+#include "config.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+
+namespace {
+constexpr uint32_t DEFAULT_READ_US[HOST_SENSOR_COUNT] = {600UL, 600UL, 700UL, 50UL, 50UL};
+constexpr uint8_t DEFAULT_MAC[RoomMonitorConfig::MAC_ADDRESS_LENGTH] = {0x24U, 0x0AU, 0xC4U, 0x12U, 0x34U, 0x56U};
+
+HostDisplay g_display;
+HostBroker g_broker;
+HostTransportClient g_transport_client(&g_broker);
+
+HostSensorScript g_scripts[HOST_SENSOR_COUNT];
+uint32_t g_read_us[HOST_SENSOR_COUNT] = {};
+uint32_t g_reads[HOST_SENSOR_COUNT] = {};
+bool g_touched = false;
+
+uint8_t g_mac[RoomMonitorConfig::MAC_ADDRESS_LENGTH] = {};
+bool g_wifi_available = true;
+bool g_wifi_begun = false;
+bool g_wifi_low_power = false;
+uint32_t g_wifi_associate_ms = 0UL;
+uint32_t g_wifi_begin_ms = 0UL;
+
+bool g_transport_open = false;
+bool g_transport_refused = false;
+uint32_t g_transport_connect_ms = 0UL;
+uint32_t g_transport_open_ms = 0UL;
+uint32_t g_transport_opens = 0UL;
+
+uint32_t g_idle_sleeps = 0UL;
+
+uint32_t NowMs() {
+  return static_cast<uint32_t>(HostClock_NowUs() / 1000U);
+}
+
+float ReadSensor(const HostSensor sensor) {
+  g_reads[sensor]++;
+  HostClock_AdvanceUs(g_read_us[sensor]);
+  return g_scripts[sensor] ? g_scripts[sensor](NowMs()) : 0.0F;
+}
+
+void SetDefaultScripts() {
+  g_scripts[HOST_SENSOR_TEMPERATURE] = [](uint32_t) { return 21.5F; };
+  g_scripts[HOST_SENSOR_HUMIDITY] = [](uint32_t) { return 45.0F; };
+  g_scripts[HOST_SENSOR_PRESSURE] = [](uint32_t) { return 1013.2F; };
+  g_scripts[HOST_SENSOR_SOIL1] = [](uint32_t) { return 400.0F; };
+  g_scripts[HOST_SENSOR_SOIL2] = [](uint32_t) { return 600.0F; };
+}
+}  // namespace
+
+void HostHal_Reset() {
+  HostGfx_SetCanvasLimitBytes(0U);
+  g_display.fillScreen(0U);
+  g_display.ResetStats();
+  g_display.SetSleep(false);
+  g_display.SetChargeClock(true);
+  g_display.SetRecording(false);
+  g_display.SetSection(nullptr);
+  g_display.ClearCalls();
+  g_broker.Reset();
+  SetDefaultScripts();
+  for (uint8_t i = 0U; i < HOST_SENSOR_COUNT; i++) {
+    g_read_us[i] = DEFAULT_READ_US[i];
+    g_reads[i] = 0UL;
+  }
+  g_touched = false;
+  memcpy(g_mac, DEFAULT_MAC, sizeof(g_mac));
+  g_wifi_available = true;
+  g_wifi_begun = false;
+  g_wifi_low_power = false;
+  g_wifi_associate_ms = 0UL;
+  g_transport_open = false;
+  g_transport_refused = false;
+  g_transport_connect_ms = 0UL;
+  g_transport_opens = 0UL;
+  g_idle_sleeps = 0UL;
+  HostClock_Reset();
+  HostSerial_Reset();
+  HostRandom_SetZero(false);
+}
+
+HostDisplay* HostHal_GetDisplay() {
+  return &g_display;
+}
+
+HostBroker* HostHal_GetBroker() {
+  return &g_broker;
+}
+
+void HostHal_SetSensorScript(const HostSensor sensor, HostSensorScript script) {
+  g_scripts[sensor] = script;
+}
+
+void HostHal_SetSensorReadUs(const HostSensor sensor, const uint32_t read_us) {
+  g_read_us[sensor] = read_us;
+}
+
+uint32_t HostHal_GetSensorReads(const HostSensor sensor) {
+  return g_reads[sensor];
+}
+
+void HostHal_SetTouch(const bool touched) {
+  g_touched = touched;
+}
+
+void HostHal_SetMacAddress(const uint8_t* mac) {
+  memcpy(g_mac, mac, sizeof(g_mac));
+}
+
+void HostHal_SetWifiAssociateMs(const uint32_t associate_ms) {
+  g_wifi_associate_ms = associate_ms;
+}
+
+void HostHal_SetWifiAvailable(const bool available) {
+  g_wifi_available = available;
+}
+
+bool HostHal_IsWifiLowPower() {
+  return g_wifi_low_power;
+}
+
+void HostHal_SetTransportConnectMs(const uint32_t connect_ms) {
+  g_transport_connect_ms = connect_ms;
+}
+
+void HostHal_SetTransportRefused(const bool refused) {
+  g_transport_refused = refused;
+}
+
+uint32_t HostHal_GetTransportOpens() {
+  return g_transport_opens;
+}
+
+uint32_t HostHal_GetIdleSleeps() {
+  return g_idle_sleeps;
+}
+
+void Hal_Init() {}
+
+Adafruit_GFX* Hal_GetDisplay() {
+  return &g_display;
+}
+
+void Hal_SetDisplaySleep(const bool sleep) {
+  g_display.SetSleep(sleep);
+}
+
+bool Hal_ReadTouchAny() {
+  return g_touched;
+}
+
+// Sleeps to the next SysTick, i.e. the next millisecond boundary.
+void Hal_IdleSleep() {
+  g_idle_sleeps++;
+  HostClock_AdvanceUs(1000U - (HostClock_NowUs() % 1000U));
+}
+
+float Hal_ReadTemperatureC() {
+  return ReadSensor(HOST_SENSOR_TEMPERATURE);
+}
+
+float Hal_ReadHumidityPct() {
+  return ReadSensor(HOST_SENSOR_HUMIDITY);
+}
+
+float Hal_ReadPressureHpa() {
+  return ReadSensor(HOST_SENSOR_PRESSURE);
+}
+
+int Hal_ReadAnalog(const pin_size_t pin) {
+  if (pin == RoomMonitorConfig::SOIL1_PIN) {
+    return static_cast<int>(ReadSensor(HOST_SENSOR_SOIL1));
+  }
+  if (pin == RoomMonitorConfig::SOIL2_PIN) {
+    return static_cast<int>(ReadSensor(HOST_SENSOR_SOIL2));
+  }
+  return 0;
+}
+
+void Hal_WifiInit() {
+  g_wifi_begun = false;
+}
+
+void Hal_WifiBegin(const char*, const char*) {
+  g_wifi_begun = true;
+  g_wifi_begin_ms = NowMs();
+}
+
+void Hal_WifiDisconnect() {
+  g_wifi_begun = false;
+}
+
+void Hal_WifiSetLowPower(const bool enabled) {
+  g_wifi_low_power = enabled;
+}
+
+bool Hal_WifiIsConnected() {
+  if (!g_wifi_available) {
+    g_wifi_begun = false;
+    return false;
+  }
+  return g_wifi_begun && ((NowMs() - g_wifi_begin_ms) >= g_wifi_associate_ms);
+}
+
+void Hal_WifiGetMacAddress(uint8_t* out_mac) {
+  memcpy(out_mac, g_mac, sizeof(g_mac));
+}
+
+bool Hal_ResolveHost(const char* host, IPAddress* out_ip) {
+  return out_ip->fromString(host);
+}
+
+Client* Hal_GetTransportClient() {
+  return &g_transport_client;
+}
+
+bool Hal_TransportOpen(const IPAddress&, const uint16_t) {
+  g_broker.CloseSession();
+  g_transport_open = true;
+  g_transport_open_ms = NowMs();
+  g_transport_opens++;
+  return true;
+}
+
+HalTransportState Hal_TransportPoll() {
+  if (!g_transport_open) {
+    return HAL_TRANSPORT_CLOSED;
+  }
+  if (g_broker.IsSessionOpen()) {
+    return HAL_TRANSPORT_ESTABLISHED;
+  }
+  if (g_transport_refused || ((NowMs() - g_transport_open_ms) < g_transport_connect_ms)) {
+    return HAL_TRANSPORT_CONNECTING;
+  }
+  g_broker.OpenSession();
+  return HAL_TRANSPORT_ESTABLISHED;
+}
+
+void Hal_TransportClose() {
+  g_transport_open = false;
+  g_broker.CloseSession();
+}
@@ -0,0 +1,54 @@
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+#include <functional>
+
+#include "fakes/host_broker.h"
+#include "fakes/host_display.h"
+
+// Controls for the host implementation of hal.h (hal_host.cpp). Sensors
+// are scripted over simulated time, Wi-Fi associates after a set delay,
+// the MQTT transport ends at the in-process HostBroker and the display is
+// a HostDisplay framebuffer.
+
+enum HostSensor : uint8_t {
+  HOST_SENSOR_TEMPERATURE = 0U,
+  HOST_SENSOR_HUMIDITY,
+  HOST_SENSOR_PRESSURE,
+  HOST_SENSOR_SOIL1,  // raw ADC counts per analogRead()
+  HOST_SENSOR_SOIL2,
+  HOST_SENSOR_COUNT
+};
+
+typedef std::function<float(uint32_t now_ms)> HostSensorScript;
+
+// Fresh clock, broker, display and default (constant room) scripts.
+void HostHal_Reset();
+
+HostDisplay* HostHal_GetDisplay();
+HostBroker* HostHal_GetBroker();
+
+void HostHal_SetSensorScript(HostSensor sensor, HostSensorScript script);
+// Bus time charged to the clock per read; the defaults are rough figures
+// for the carrier's I2C sensors and the SAMD21 ADC.
+void HostHal_SetSensorReadUs(HostSensor sensor, uint32_t read_us);
+uint32_t HostHal_GetSensorReads(HostSensor sensor);
+
+void HostHal_SetTouch(bool touched);
+
+void HostHal_SetMacAddress(const uint8_t* mac);
+// Association completes this long after Hal_WifiBegin(); an unavailable
+// network never associates and drops a current association.
+void HostHal_SetWifiAssociateMs(uint32_t associate_ms);
+void HostHal_SetWifiAvailable(bool available);
+bool HostHal_IsWifiLowPower();
+
+// The TCP handshake completes this long after Hal_TransportOpen(); a
+// refused transport never completes.
+void HostHal_SetTransportConnectMs(uint32_t connect_ms);
+void HostHal_SetTransportRefused(bool refused);
+uint32_t HostHal_GetTransportOpens();
+
+uint32_t HostHal_GetIdleSleeps();
+
+#endif  // HAL_HOST_H
@@ -0,0 +1,151 @@
+#include "host_cbor.h"
+
+namespace {
+constexpr uint8_t MAJOR_UNSIGNED = 0U;
+constexpr uint8_t MAJOR_NEGATIVE = 1U;
+constexpr uint8_t MAJOR_MAP = 5U;
+constexpr uint8_t INFO_DIRECT_MAX = 23U;
+constexpr uint8_t INFO_UINT8 = 24U;
+constexpr uint8_t INFO_UINT64 = 27U;
+
+enum StateKey : uint8_t {
+  KEY_SEQUENCE = 0U,
+  KEY_TEMPERATURE_CENTI_C,
+  KEY_HUMIDITY_CENTI_PCT,
+  KEY_PRESSURE_DECI_HPA,
+  KEY_SOIL1_PCT,
+  KEY_SOIL2_PCT,
+  KEY_STALE_MASK,
+  KEY_COUNT
+};
+
+class Reader {
+ public:
+  Reader(const uint8_t* data, const size_t length) : data_(data), length_(length), pos_(0U) {}
+
+  // Major type and argument of the next item; rejects indefinite lengths,
+  // reserved values and arguments longer than they need to be.
+  bool Head(uint8_t* major, uint64_t* argument) {
+    if (pos_ >= length_) {
+      return false;
+    }
+    const uint8_t initial = data_[pos_++];
+    *major = static_cast<uint8_t>(initial >> 5);
+    const uint8_t info = static_cast<uint8_t>(initial & 0x1FU);
+    if (info <= INFO_DIRECT_MAX) {
+      *argument = info;
+      return true;
+    }
+    if (info > INFO_UINT64) {
+      return false;
+    }
+    const size_t bytes = static_cast<size_t>(1U) << (info - INFO_UINT8);
+    if ((length_ - pos_) < bytes) {
+      return false;
+    }
+    uint64_t value = 0U;
+    for (size_t i = 0U; i < bytes; i++) {
+      value = (value << 8) | data_[pos_++];
+    }
+    // Shortest form: the value must not fit the next smaller argument.
+    const uint64_t smaller_max = (bytes == 1U) ? INFO_DIRECT_MAX : ((1ULL << (4U * bytes)) - 1U);
+    *argument = value;
+    return value > smaller_max;
+  }
+
+  bool Integer(int64_t* value) {
+    uint8_t major = 0U;
+    uint64_t argument = 0U;
+    if (!Head(&major, &argument) || (argument > static_cast<uint64_t>(INT64_MAX))) {
+      return false;
+    }
+    if (major == MAJOR_UNSIGNED) {
+      *value = static_cast<int64_t>(argument);
+      return true;
+    }
+    if (major == MAJOR_NEGATIVE) {
+      *value = -1 - static_cast<int64_t>(argument);
+      return true;
+    }
+    return false;
+  }
+
+  bool AtEnd() const {
+    return pos_ == length_;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t length_;
+  size_t pos_;
+};
+
+bool InRange(const int64_t value, const int64_t min_value, const int64_t max_value) {
+  return (value >= min_value) && (value <= max_value);
+}
+}  // namespace
+
+bool HostCbor_DecodeIntMap(const uint8_t* data, const size_t length, std::vector<HostCborEntry>* out_entries) {
+  if ((data == nullptr) || (out_entries == nullptr)) {
+    return false;
+  }
+  Reader reader(data, length);
+  uint8_t major = 0U;
+  uint64_t pairs = 0U;
+  // Each pair takes at least two bytes, which also bounds the loop.
+  if (!reader.Head(&major, &pairs) || (major != MAJOR_MAP) || (pairs > (length / 2U))) {
+    return false;
+  }
+  out_entries->clear();
+  for (uint64_t i = 0U; i < pairs; i++) {
+    int64_t key = 0;
+    int64_t value = 0;
+    if (!reader.Integer(&key) || (key < 0) || !reader.Integer(&value)) {
+      return false;
+    }
+    for (const HostCborEntry& entry : *out_entries) {
+      if (entry.key == static_cast<uint64_t>(key)) {
+        return false;
+      }
+    }
+    out_entries->push_back(HostCborEntry{static_cast<uint64_t>(key), value});
+  }
+  return reader.AtEnd();
+}
+
+bool HostCbor_DecodeState(const uint8_t* data, const size_t length, HostBinaryState* out_state) {
+  std::vector<HostCborEntry> entries;
+  if ((out_state == nullptr) || !HostCbor_DecodeIntMap(data, length, &entries)) {
+    return false;
+  }
+  int64_t values[KEY_COUNT] = {};
+  bool present[KEY_COUNT] = {};
+  for (const HostCborEntry& entry : entries) {
+    if (entry.key < KEY_COUNT) {
+      values[entry.key] = entry.value;
+      present[entry.key] = true;
+    }
+  }
+  for (const bool field_present : present) {
+    if (!field_present) {
+      return false;
+    }
+  }
+  if (!InRange(values[KEY_SEQUENCE], 0, UINT32_MAX) || !InRange(values[KEY_TEMPERATURE_CENTI_C], INT32_MIN, INT32_MAX) ||
+      !InRange(values[KEY_HUMIDITY_CENTI_PCT], INT32_MIN, INT32_MAX) ||
+      !InRange(values[KEY_PRESSURE_DECI_HPA], INT32_MIN, INT32_MAX) || !InRange(values[KEY_SOIL1_PCT], 0, UINT8_MAX) ||
+      !InRange(values[KEY_SOIL2_PCT], 0, UINT8_MAX) ||
+      !InRange(values[KEY_STALE_MASK], 0, (1 << SENSOR_FIELD_COUNT) - 1)) {
+    return false;
+  }
+
+  *out_state = HostBinaryState{};
+  out_state->sequence = static_cast<uint32_t>(values[KEY_SEQUENCE]);
+  out_state->data.temperature_c = static_cast<float>(values[KEY_TEMPERATURE_CENTI_C]) / 100.0F;
+  out_state->data.humidity_pct = static_cast<float>(values[KEY_HUMIDITY_CENTI_PCT]) / 100.0F;
+  out_state->data.pressure_hpa = static_cast<float>(values[KEY_PRESSURE_DECI_HPA]) / 10.0F;
+  out_state->data.soil1_pct = static_cast<uint8_t>(values[KEY_SOIL1_PCT]);
+  out_state->data.soil2_pct = static_cast<uint8_t>(values[KEY_SOIL2_PCT]);
+  out_state->data.stale_mask = static_cast<uint8_t>(values[KEY_STALE_MASK]);
+  return true;
+}
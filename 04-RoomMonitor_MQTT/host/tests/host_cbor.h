@@ -0,0 +1,31 @@
+#ifndef HOST_CBOR_H
+#define HOST_CBOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "data_model.h"
+
+// Host decoder for the TOPIC_STATE_BIN payload. It is strict about what
+// cbor_writer emits: a single definite-length map of unsigned keys to
+// integers, shortest-form heads, no duplicate keys and no trailing bytes.
+
+struct HostCborEntry {
+  uint64_t key;
+  int64_t value;
+};
+
+bool HostCbor_DecodeIntMap(const uint8_t* data, size_t length, std::vector<HostCborEntry>* out_entries);
+
+// The snapshot per the key table in README.md. Unknown keys are skipped;
+// a missing or out-of-range field fails the decode.
+struct HostBinaryState {
+  uint32_t sequence;
+  SensorData data;
+};
+
+bool HostCbor_DecodeState(const uint8_t* data, size_t length, HostBinaryState* out_state);
+
+#endif  // HOST_CBOR_H
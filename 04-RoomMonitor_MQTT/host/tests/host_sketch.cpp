@@ -0,0 +1,83 @@
+#include "host_sketch.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "task_scheduler.h"
+
+void setup();
+void loop();
+
+namespace {
+uint32_t g_loops = 0UL;
+uint32_t g_max_loop_us = 0UL;
+
+void Step() {
+  const uint64_t start_us = HostClock_NowUs();
+  loop();
+  g_loops++;
+  const uint64_t elapsed_us = HostClock_NowUs() - start_us;
+  if (elapsed_us > g_max_loop_us) {
+    g_max_loop_us = static_cast<uint32_t>(elapsed_us);
+  }
+  const uint32_t idle_ms = TaskScheduler_MsUntilNextRelease(millis());
+  if (idle_ms > 0UL) {
+    HostClock_AdvanceMs(idle_ms);
+  }
+}
+}  // namespace
+
+void HostSketch_Reset() {
+  HostHal_Reset();
+  HostSerial_SetEcho(false);
+  HostSerial_SetCapture(false);
+  g_loops = 0UL;
+  g_max_loop_us = 0UL;
+}
+
+void HostSketch_Setup() {
+  setup();
+}
+
+void HostSketch_RunFor(const uint32_t duration_ms) {
+  const uint32_t start = millis();
+  while ((millis() - start) < duration_ms) {
+    Step();
+  }
+}
+
+bool HostSketch_RunUntil(const std::function<bool()>& done, const uint32_t timeout_ms) {
+  const uint32_t start = millis();
+  while (!done()) {
+    if ((millis() - start) >= timeout_ms) {
+      return false;
+    }
+    Step();
+  }
+  return true;
+}
+
+uint32_t HostSketch_LoopCount() {
+  return g_loops;
+}
+
+uint32_t HostSketch_MaxLoopUs() {
+  return g_max_loop_us;
+}
+
+bool HostSketch_RunIsolated(const std::function<bool()>& scenario) {
+  fflush(stdout);
+  const pid_t pid = fork();
+  if (pid == 0) {
+    const bool passed = scenario();
+    fflush(stdout);
+    _exit(passed ? 0 : 1);
+  }
+  int status = 0;
+  if ((pid < 0) || (waitpid(pid, &status, 0) != pid)) {
+    return false;
+  }
+  return WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+}
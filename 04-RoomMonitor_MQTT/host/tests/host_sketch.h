@@ -0,0 +1,32 @@
+#ifndef HOST_SKETCH_H
+#define HOST_SKETCH_H
+
+#include <Arduino.h>
+
+#include <functional>
+
+// Drives the sketch's setup()/loop() on the simulated clock. Module state
+// is global, so a process boots the sketch once; scenarios that need a
+// fresh device run in a forked child via HostSketch_RunIsolated().
+
+// Resets the host HAL (call HostHal_* setters afterwards) ...
+void HostSketch_Reset();
+// ... then runs setup().
+void HostSketch_Setup();
+
+// Runs loop() until `duration_ms` of simulated time has passed. Idle
+// gaps between task releases are skipped rather than polled.
+void HostSketch_RunFor(uint32_t duration_ms);
+// Runs loop() until `done` returns true or `timeout_ms` passes; returns
+// whether `done` was reached.
+bool HostSketch_RunUntil(const std::function<bool()>& done, uint32_t timeout_ms);
+
+uint32_t HostSketch_LoopCount();
+// Longest single loop() pass seen so far, in simulated microseconds.
+uint32_t HostSketch_MaxLoopUs();
+
+// Runs `scenario` in a child process and returns true when it exits 0,
+// i.e. when `scenario` returned true.
+bool HostSketch_RunIsolated(const std::function<bool()>& scenario);
+
+#endif  // HOST_SKETCH_H
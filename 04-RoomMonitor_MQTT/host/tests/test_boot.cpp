@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <string>
+
+#include "boot_profiler.h"
+#include "config.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+
+// Simulated power-on through the fast-boot path: the first state reaches
+// the broker within BOOT_FIRST_PUBLISH_TARGET_MS for realistic join times,
+// the dashboard is up while Wi-Fi is still associating, and the retained
+// boot report carries the milestones the device recorded. Each boot runs
+// in a forked child, since milestones are only marked once per process.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+// Join times for the NINA module: an AP answering at once, a typical WPA2
+// join and a slow one.
+constexpr uint32_t ASSOCIATE_MS[] = {0UL, 1500UL, 3000UL};
+constexpr uint8_t BOOT_COUNT = sizeof(ASSOCIATE_MS) / sizeof(ASSOCIATE_MS[0]);
+constexpr uint32_t TRANSPORT_CONNECT_MS = 120UL;
+constexpr uint32_t BOOT_TIMEOUT_MS = 30000UL;
+
+const char* const MILESTONE_KEYS[BOOT_MILESTONE_COUNT] = {
+    "sensor_ready_ms", "first_frame_ms", "wifi_up_ms", "mqtt_connected_ms", "discovery_done_ms", "first_publish_ms"};
+
+struct BootRun {
+  uint32_t marks_ms[BOOT_MILESTONE_COUNT];  // UINT32_MAX when unmarked
+  bool report_matches;
+};
+
+bool IsBootReported() {
+  return HostHal_GetBroker()->GetRetained(TOPIC_BOOT) != nullptr;
+}
+
+// Every milestone appears in the boot report with the value recorded.
+bool ReportMatches(const uint32_t* marks_ms) {
+  const HostMqttMessage* report = HostHal_GetBroker()->GetRetained(TOPIC_BOOT);
+  if (report == nullptr) {
+    return false;
+  }
+  for (uint8_t i = 0U; i < BOOT_MILESTONE_COUNT; i++) {
+    const std::string field = std::string("\"") + MILESTONE_KEYS[i] + "\":" + std::to_string(marks_ms[i]);
+    if (report->payload.find(field) == std::string::npos) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Boot(const uint32_t associate_ms, FILE* out) {
+  HostSketch_Reset();
+  HostHal_SetWifiAssociateMs(associate_ms);
+  HostHal_SetTransportConnectMs(TRANSPORT_CONNECT_MS);
+  HostSketch_Setup();
+  const bool reported = HostSketch_RunUntil(IsBootReported, BOOT_TIMEOUT_MS);
+
+  BootRun run = {};
+  for (uint8_t i = 0U; i < BOOT_MILESTONE_COUNT; i++) {
+    const BootMilestone milestone = static_cast<BootMilestone>(i);
+    run.marks_ms[i] = BootProfiler_IsMarked(milestone) ? BootProfiler_GetMs(milestone) : UINT32_MAX;
+  }
+  run.report_matches = reported && ReportMatches(run.marks_ms);
+  return (fwrite(&run, sizeof(run), 1U, out) == 1U) && (fflush(out) == 0);
+}
+}  // namespace
+
+TEST(Boot, FirstPublishWithinTarget) {
+  FILE* out = tmpfile();
+  ASSERT_NE(nullptr, out);
+  for (const uint32_t associate_ms : ASSOCIATE_MS) {
+    ASSERT_TRUE(HostSketch_RunIsolated([associate_ms, out]() { return Boot(associate_ms, out); }));
+  }
+  rewind(out);
+  BootRun runs[BOOT_COUNT] = {};
+  ASSERT_EQ(BOOT_COUNT, fread(runs, sizeof(BootRun), BOOT_COUNT, out));
+  fclose(out);
+
+  printf("  %8s", "join");
+  for (const char* key : MILESTONE_KEYS) {
+    printf(" %18s", key);
+  }
+  printf("\n");
+  for (uint8_t b = 0U; b < BOOT_COUNT; b++) {
+    const uint32_t* marks_ms = runs[b].marks_ms;
+    printf("  %5u ms", ASSOCIATE_MS[b]);
+    for (uint8_t i = 0U; i < BOOT_MILESTONE_COUNT; i++) {
+      printf(" %18u", marks_ms[i]);
+    }
+    printf("\n");
+
+    for (uint8_t i = 0U; i < BOOT_MILESTONE_COUNT; i++) {
+      ASSERT_NE(UINT32_MAX, marks_ms[i]) << MILESTONE_KEYS[i];
+    }
+    EXPECT_TRUE(runs[b].report_matches);
+    EXPECT_LE(marks_ms[BOOT_MILESTONE_FIRST_PUBLISH], BOOT_FIRST_PUBLISH_TARGET_MS) << ASSOCIATE_MS[b] << " ms join";
+    // The link comes up in order, each step once the one before is done.
+    EXPECT_GE(marks_ms[BOOT_MILESTONE_WIFI_UP], ASSOCIATE_MS[b]);
+    EXPECT_GE(marks_ms[BOOT_MILESTONE_MQTT_CONNECTED], marks_ms[BOOT_MILESTONE_WIFI_UP] + TRANSPORT_CONNECT_MS);
+    EXPECT_GE(marks_ms[BOOT_MILESTONE_DISCOVERY_DONE], marks_ms[BOOT_MILESTONE_MQTT_CONNECTED]);
+    EXPECT_GE(marks_ms[BOOT_MILESTONE_FIRST_PUBLISH], marks_ms[BOOT_MILESTONE_DISCOVERY_DONE]);
+    // Sensors and the first dashboard do not wait for the network.
+    EXPECT_LE(marks_ms[BOOT_MILESTONE_SENSOR_READY], marks_ms[BOOT_MILESTONE_FIRST_FRAME]);
+    if (ASSOCIATE_MS[b] > 0UL) {
+      EXPECT_LT(marks_ms[BOOT_MILESTONE_FIRST_FRAME], marks_ms[BOOT_MILESTONE_WIFI_UP]);
+    }
+  }
+}
@@ -0,0 +1,337 @@
+#include <gtest/gtest.h>
+
+#include <PubSubClient.h>
+#include <stdio.h>
+
+#include <random>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "boot_profiler.h"
+#include "cbor_writer.h"
+#include "config.h"
+#include "fakes/host_clock.h"
+#include "hal.h"
+#include "hal_host.h"
+#include "host_cbor.h"
+#include "instrumentation.h"
+#include "logger.h"
+#include "mqtt_lite_client.h"
+#include "mqtt_manager.h"
+#include "power_manager.h"
+#include "rate_controller.h"
+#include "rolling_stats.h"
+#include "telemetry_buffer.h"
+#include "text_format.h"
+#include "wifi_manager.h"
+
+// CborWriter against RFC 8949 vectors and the host decoder, a randomized
+// round trip through both, and the TOPIC_STATE_BIN payload end to end.
+// MQTT_BINARY_STATE is a constexpr, so the end-to-end check uses its own
+// copy of mqtt_manager.cpp with the flag name swapped by the preprocessor
+// for one that is on. Its headers are already included above and stay out
+// of the namespace.
+
+namespace RoomMonitorConfig {
+constexpr bool HOST_BINARY_STATE_ON = true;
+}  // namespace RoomMonitorConfig
+
+#define MQTT_BINARY_STATE HOST_BINARY_STATE_ON
+namespace binary {
+#include "mqtt_manager.cpp"
+}  // namespace binary
+#undef MQTT_BINARY_STATE
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FUZZ_ROUNDS = 20000UL;
+constexpr uint8_t MAX_FUZZ_PAIRS = 40U;
+// Head plus the widest argument, for the key and the value of each pair.
+constexpr size_t MAX_PAIR_BYTES = 10U;
+
+typedef std::vector<uint8_t> Bytes;
+
+Bytes Encode(const std::vector<HostCborEntry>& entries) {
+  Bytes buffer(2U + (entries.size() * MAX_PAIR_BYTES));
+  CborWriter writer;
+  CborWriter_Init(&writer, buffer.data(), buffer.size());
+  CborWriter_BeginMap(&writer, static_cast<uint8_t>(entries.size()));
+  for (const HostCborEntry& entry : entries) {
+    CborWriter_PutUnsigned(&writer, static_cast<uint32_t>(entry.key));
+    CborWriter_PutSigned(&writer, static_cast<int32_t>(entry.value));
+  }
+  buffer.resize(CborWriter_Finish(&writer));
+  return buffer;
+}
+
+Bytes EncodeSigned(const int32_t value) {
+  uint8_t buffer[8];
+  CborWriter writer;
+  CborWriter_Init(&writer, buffer, sizeof(buffer));
+  CborWriter_PutSigned(&writer, value);
+  return Bytes(buffer, buffer + CborWriter_Finish(&writer));
+}
+
+bool Decodes(const Bytes& bytes) {
+  std::vector<HostCborEntry> entries;
+  return HostCbor_DecodeIntMap(bytes.data(), bytes.size(), &entries);
+}
+
+// Values clustered on the head-size boundaries, where encoders go wrong.
+int32_t FuzzValue(std::mt19937* rng) {
+  static const int64_t EDGES[] = {0, 23, 24, 255, 256, 65535, 65536, INT32_MAX};
+  std::uniform_int_distribution<int> pick(0, 3);
+  std::uniform_int_distribution<size_t> edge(0U, (sizeof(EDGES) / sizeof(EDGES[0])) - 1U);
+  std::uniform_int_distribution<int> nudge(-2, 2);
+  std::uniform_int_distribution<int32_t> any(INT32_MIN, INT32_MAX);
+  if (pick(*rng) == 0) {
+    return any(*rng);
+  }
+  int64_t value = EDGES[edge(*rng)] + nudge(*rng);
+  value = (pick(*rng) < 2) ? value : (-1 - value);
+  value = (value > INT32_MAX) ? INT32_MAX : value;
+  return static_cast<int32_t>((value < INT32_MIN) ? INT32_MIN : value);
+}
+
+std::vector<HostCborEntry> FuzzMap(std::mt19937* rng) {
+  std::uniform_int_distribution<uint32_t> pair_count(0U, MAX_FUZZ_PAIRS);
+  std::uniform_int_distribution<uint32_t> small_key(0U, 30U);
+  std::uniform_int_distribution<uint32_t> any_key(0U, UINT32_MAX);
+  const uint32_t pairs = pair_count(*rng);
+  std::set<uint64_t> keys;
+  std::vector<HostCborEntry> entries;
+  while (entries.size() < pairs) {
+    const uint64_t key = ((*rng)() % 2U == 0U) ? small_key(*rng) : any_key(*rng);
+    if (keys.insert(key).second) {
+      entries.push_back(HostCborEntry{key, FuzzValue(rng)});
+    }
+  }
+  return entries;
+}
+
+size_t HeadBytes(const uint64_t argument) {
+  if (argument <= 23U) {
+    return 1U;
+  }
+  if (argument <= UINT8_MAX) {
+    return 2U;
+  }
+  return (argument <= UINT16_MAX) ? 3U : 5U;
+}
+
+size_t ExpectedLength(const std::vector<HostCborEntry>& entries) {
+  size_t length = HeadBytes(entries.size());
+  for (const HostCborEntry& entry : entries) {
+    const uint64_t magnitude = (entry.value < 0) ? static_cast<uint64_t>(-1 - entry.value) : entry.value;
+    length += HeadBytes(entry.key) + HeadBytes(magnitude);
+  }
+  return length;
+}
+
+SensorData FuzzSensorData(std::mt19937* rng) {
+  std::uniform_real_distribution<float> temperature(-40.0F, 85.0F);
+  std::uniform_real_distribution<float> humidity(0.0F, 100.0F);
+  std::uniform_real_distribution<float> pressure(300.0F, 1100.0F);
+  std::uniform_int_distribution<int> percent(0, 100);
+  std::uniform_int_distribution<int> mask(0, (1 << SENSOR_FIELD_COUNT) - 1);
+  SensorData data = {};
+  data.temperature_c = temperature(*rng);
+  data.humidity_pct = humidity(*rng);
+  data.pressure_hpa = pressure(*rng);
+  data.soil1_pct = static_cast<uint8_t>(percent(*rng));
+  data.soil2_pct = static_cast<uint8_t>(percent(*rng));
+  data.stale_mask = static_cast<uint8_t>(mask(*rng));
+  return data;
+}
+
+void ExpectSameState(const SensorData& expected, const SensorData& actual) {
+  // Half a fixed-point step, plus float rounding.
+  EXPECT_NEAR(expected.temperature_c, actual.temperature_c, 0.0051F);
+  EXPECT_NEAR(expected.humidity_pct, actual.humidity_pct, 0.0051F);
+  EXPECT_NEAR(expected.pressure_hpa, actual.pressure_hpa, 0.051F);
+  EXPECT_EQ(expected.soil1_pct, actual.soil1_pct);
+  EXPECT_EQ(expected.soil2_pct, actual.soil2_pct);
+  EXPECT_EQ(expected.stale_mask, actual.stale_mask);
+}
+}  // namespace
+
+TEST(Cbor, WriterMatchesRfc8949Vectors) {
+  const struct {
+    int32_t value;
+    Bytes encoded;
+  } vectors[] = {
+      {0, {0x00}},
+      {1, {0x01}},
+      {23, {0x17}},
+      {24, {0x18, 0x18}},
+      {100, {0x18, 0x64}},
+      {1000, {0x19, 0x03, 0xE8}},
+      {1000000, {0x1A, 0x00, 0x0F, 0x42, 0x40}},
+      {-1, {0x20}},
+      {-10, {0x29}},
+      {-100, {0x38, 0x63}},
+      {-1000, {0x39, 0x03, 0xE7}},
+      {INT32_MIN, {0x3A, 0x7F, 0xFF, 0xFF, 0xFF}},
+  };
+  for (const auto& vector : vectors) {
+    EXPECT_EQ(vector.encoded, EncodeSigned(vector.value)) << vector.value;
+  }
+
+  uint8_t buffer[8];
+  CborWriter writer;
+  CborWriter_Init(&writer, buffer, sizeof(buffer));
+  CborWriter_PutUnsigned(&writer, UINT32_MAX);
+  EXPECT_EQ(Bytes({0x1A, 0xFF, 0xFF, 0xFF, 0xFF}), Bytes(buffer, buffer + CborWriter_Finish(&writer)));
+  EXPECT_EQ(Bytes({0xA0}), Encode({}));
+  EXPECT_EQ(Bytes({0xA2, 0x01, 0x02, 0x03, 0x04}), Encode({{1U, 2}, {3U, 4}}));
+}
+
+TEST(Cbor, WriterReportsOverflowAtEveryShortCapacity) {
+  const std::vector<HostCborEntry> entries = {{0U, 70000}, {1U, -2150}, {2U, 4523}, {3U, 10125}};
+  const Bytes full = Encode(entries);
+  ASSERT_FALSE(full.empty());
+  for (size_t capacity = 0U; capacity < full.size(); capacity++) {
+    Bytes buffer(full.size(), 0xEEU);
+    CborWriter writer;
+    CborWriter_Init(&writer, buffer.data(), capacity);
+    CborWriter_BeginMap(&writer, static_cast<uint8_t>(entries.size()));
+    for (const HostCborEntry& entry : entries) {
+      CborWriter_PutUnsigned(&writer, static_cast<uint32_t>(entry.key));
+      CborWriter_PutSigned(&writer, static_cast<int32_t>(entry.value));
+    }
+    EXPECT_EQ(0U, CborWriter_Finish(&writer)) << capacity;
+    // Nothing past the capacity is touched.
+    for (size_t i = capacity; i < buffer.size(); i++) {
+      EXPECT_EQ(0xEEU, buffer[i]) << capacity;
+    }
+  }
+}
+
+TEST(Cbor, DecoderRejectsWhatTheWriterNeverEmits) {
+  EXPECT_TRUE(Decodes({0xA1, 0x01, 0x18, 0x18}));
+  EXPECT_FALSE(Decodes({}));
+  EXPECT_FALSE(Decodes({0xA1, 0x01, 0x18, 0x17}));              // 23 in two bytes
+  EXPECT_FALSE(Decodes({0xA1, 0x01, 0x19, 0x00, 0xFF}));        // 255 in three bytes
+  EXPECT_FALSE(Decodes({0xBF, 0x01, 0x02, 0xFF}));              // indefinite map
+  EXPECT_FALSE(Decodes({0x81, 0x01}));                          // array
+  EXPECT_FALSE(Decodes({0xA1, 0x20, 0x01}));                    // negative key
+  EXPECT_FALSE(Decodes({0xA2, 0x01, 0x02, 0x01, 0x03}));        // duplicate key
+  EXPECT_FALSE(Decodes({0xA1, 0x01, 0x02, 0x00}));              // trailing byte
+  EXPECT_FALSE(Decodes({0xA1, 0x01, 0x1C}));                    // reserved info
+  EXPECT_FALSE(Decodes({0xBB, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}));  // absurd pair count
+}
+
+TEST(Cbor, FuzzRoundTripThroughTheDecoder) {
+  std::mt19937 rng(0xC0B0U);
+  uint32_t mutated_accepted = 0UL;
+  for (uint32_t round = 0UL; round < FUZZ_ROUNDS; round++) {
+    const std::vector<HostCborEntry> entries = FuzzMap(&rng);
+    const Bytes encoded = Encode(entries);
+    ASSERT_EQ(ExpectedLength(entries), encoded.size()) << "round " << round;
+
+    std::vector<HostCborEntry> decoded;
+    ASSERT_TRUE(HostCbor_DecodeIntMap(encoded.data(), encoded.size(), &decoded)) << "round " << round;
+    ASSERT_EQ(entries.size(), decoded.size());
+    for (size_t i = 0U; i < entries.size(); i++) {
+      ASSERT_EQ(entries[i].key, decoded[i].key) << "round " << round;
+      ASSERT_EQ(entries[i].value, decoded[i].value) << "round " << round;
+    }
+
+    // A cut-off payload never decodes.
+    const size_t cut = rng() % encoded.size();
+    ASSERT_FALSE(Decodes(Bytes(encoded.begin(), encoded.begin() + cut))) << "round " << round << " cut " << cut;
+
+    // A corrupted one either fails or, being canonical, re-encodes to
+    // exactly the same bytes.
+    Bytes mutated = encoded;
+    mutated[rng() % mutated.size()] ^= static_cast<uint8_t>(1U << (rng() % 8U));
+    std::vector<HostCborEntry> reread;
+    if (HostCbor_DecodeIntMap(mutated.data(), mutated.size(), &reread)) {
+      bool fits = reread.size() <= UINT8_MAX;
+      for (const HostCborEntry& entry : reread) {
+        fits = fits && (entry.key <= UINT32_MAX) && (entry.value >= INT32_MIN) && (entry.value <= INT32_MAX);
+      }
+      if (fits) {
+        ASSERT_EQ(mutated, Encode(reread)) << "round " << round;
+        mutated_accepted++;
+      }
+    }
+  }
+  printf("%u maps round-tripped, %u single-bit corruptions decoded and re-encoded identically\n",
+         FUZZ_ROUNDS,
+         mutated_accepted);
+}
+
+TEST(Cbor, StatePayloadRoundTrips) {
+  std::mt19937 rng(0x5EEDU);
+  uint8_t payload[MQTT_STATE_CBOR_CAPACITY];
+  size_t longest = 0U;
+  for (uint32_t round = 0UL; round < FUZZ_ROUNDS; round++) {
+    const SensorData data = FuzzSensorData(&rng);
+    const uint32_t sequence = rng();
+    const size_t length = binary::EncodeBinaryState(&data, sequence, payload, sizeof(payload));
+    ASSERT_GT(length, 0U) << "round " << round;
+    longest = (length > longest) ? length : longest;
+
+    HostBinaryState state = {};
+    ASSERT_TRUE(HostCbor_DecodeState(payload, length, &state)) << "round " << round;
+    EXPECT_EQ(sequence, state.sequence);
+    ExpectSameState(data, state.data);
+    if (HasFailure()) {
+      return;
+    }
+  }
+  printf("longest state payload %u of %u bytes\n", static_cast<unsigned>(longest), static_cast<unsigned>(MQTT_STATE_CBOR_CAPACITY));
+  EXPECT_LE(longest, MQTT_STATE_CBOR_CAPACITY);
+}
+
+TEST(Cbor, StateBinMatchesTheTextTopics) {
+  HostHal_Reset();
+  binary::MqttManager_Init();
+  HostBroker* broker = HostHal_GetBroker();
+  SensorData data = {};
+  data.temperature_c = 21.37F;
+  data.humidity_pct = 44.5F;
+  data.pressure_hpa = 1013.2F;
+  data.soil1_pct = 41U;
+  data.soil2_pct = 63U;
+
+  bool published = false;
+  for (uint32_t elapsed_ms = 0UL; !published && (elapsed_ms < 60000UL); elapsed_ms += MQTT_SERVICE_INTERVAL_MS) {
+    (void)binary::MqttManager_EnsureConnected();
+    binary::MqttManager_Loop();
+    published = binary::MqttManager_PublishData(&data) && (broker->GetRetained(TOPIC_STATE_BIN) != nullptr);
+    HostClock_AdvanceMs(MQTT_SERVICE_INTERVAL_MS);
+  }
+  ASSERT_TRUE(published);
+
+  uint32_t last_sequence = 0UL;
+  for (uint8_t round = 0U; round < 3U; round++) {
+    const HostMqttMessage* message = broker->GetRetained(TOPIC_STATE_BIN);
+    ASSERT_NE(nullptr, message);
+    HostBinaryState state = {};
+    ASSERT_TRUE(HostCbor_DecodeState(
+        reinterpret_cast<const uint8_t*>(message->payload.data()), message->payload.size(), &state));
+    ExpectSameState(data, state.data);
+    EXPECT_NEAR(std::stof(broker->GetRetained(TOPIC_TEMP_STATE)->payload), state.data.temperature_c, 0.051F);
+    EXPECT_NEAR(std::stof(broker->GetRetained(TOPIC_PRESSURE_STATE)->payload), state.data.pressure_hpa, 0.051F);
+    EXPECT_EQ(std::to_string(state.data.soil1_pct), broker->GetRetained(TOPIC_SOIL1_STATE)->payload);
+    if (round > 0U) {
+      EXPECT_EQ(last_sequence + 1UL, state.sequence);
+    }
+    last_sequence = state.sequence;
+
+    // Move every value past its deadband so the next publish is due.
+    data.temperature_c += 1.0F;
+    data.humidity_pct += 5.0F;
+    data.pressure_hpa += 2.0F;
+    data.soil1_pct = static_cast<uint8_t>(data.soil1_pct + 5U);
+    data.soil2_pct = static_cast<uint8_t>(data.soil2_pct - 5U);
+    HostClock_AdvanceMs(PUBLISH_INTERVAL_MS);
+    binary::MqttManager_Loop();
+    ASSERT_TRUE(binary::MqttManager_PublishData(&data));
+  }
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "display_service.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "logger.h"
+
+// Retained-mode dashboard: incremental refreshes against the HostDisplay
+// framebuffer, without the rest of the sketch.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t FRAME_COUNT = 60UL;
+constexpr uint32_t FULL_FRAME_PIXELS = static_cast<uint32_t>(DISPLAY_SIZE_PX) * DISPLAY_SIZE_PX;
+
+HostDisplay* Display() {
+  return HostHal_GetDisplay();
+}
+
+// A room drifting slowly: every refresh moves at least one readout digit.
+SensorSnapshot MakeSnapshot(const uint32_t frame) {
+  SensorSnapshot snapshot = {};
+  snapshot.seq = frame + 1UL;
+  snapshot.valid_mask = static_cast<uint8_t>((1U << SENSOR_FIELD_COUNT) - 1U);
+  snapshot.data.temperature_c = 21.0F + (0.1F * static_cast<float>(frame % 20UL));
+  snapshot.data.humidity_pct = 45.0F + static_cast<float>((frame / 4UL) % 3UL);
+  snapshot.data.pressure_hpa = 1010.0F + static_cast<float>((frame / 3UL) % 5UL);
+  snapshot.data.soil1_pct = static_cast<uint8_t>(40UL + ((frame / 5UL) % 4UL));
+  snapshot.data.soil2_pct = static_cast<uint8_t>(60UL + ((frame / 7UL) % 3UL));
+  return snapshot;
+}
+
+void SetUpDisplay() {
+  HostHal_Reset();
+  HostClock_SetReadTickUs(0U);
+  Display()->SetChargeClock(false);
+  DisplayService_Init();
+}
+
+// Init's log line, once the logger has drained it to the UART. Takes one
+// whole gauge mode cycle, so frames before and after look the same.
+std::string TakeInitLog() {
+  constexpr uint32_t CYCLE_MS = 3UL * DISPLAY_GAUGE_MODE_SWITCH_MS;
+  for (uint32_t elapsed_ms = 0UL; elapsed_ms < CYCLE_MS; elapsed_ms += 100UL) {
+    Logger_Drain();
+    HostClock_AdvanceMs(100UL);
+  }
+  return HostSerial_TakeOutput();
+}
+
+uint32_t DrawFrame(const SensorSnapshot& snapshot) {
+  Display()->ResetStats();
+  DisplayService_ShowData(&snapshot);
+  return Display()->GetStats().pixels;
+}
+}  // namespace
+
+TEST(DisplayService, IncrementalFramesWriteTenTimesFewerPixels) {
+  SetUpDisplay();
+  DisplayService_ShowBootText();
+  const uint32_t full_pixels = DrawFrame(MakeSnapshot(0UL));
+  EXPECT_GE(full_pixels, FULL_FRAME_PIXELS);
+
+  uint64_t incremental_pixels = 0U;
+  uint32_t worst_pixels = 0UL;
+  for (uint32_t frame = 1UL; frame <= FRAME_COUNT; frame++) {
+    HostClock_AdvanceMs(DISPLAY_REFRESH_MS);
+    const uint32_t pixels = DrawFrame(MakeSnapshot(frame));
+    incremental_pixels += pixels;
+    worst_pixels = (pixels > worst_pixels) ? pixels : worst_pixels;
+  }
+  const uint64_t average_pixels = incremental_pixels / FRAME_COUNT;
+  printf("full frame %u px, incremental avg %llu px, worst %u px\n",
+         full_pixels,
+         static_cast<unsigned long long>(average_pixels),
+         worst_pixels);
+  EXPECT_LE(average_pixels * 10U, full_pixels);
+  EXPECT_LT(worst_pixels, full_pixels / 4UL);
+}
+
+TEST(DisplayService, IncrementalFramesMatchFullRedraw) {
+  SetUpDisplay();
+  DisplayService_ShowBootText();
+  (void)DrawFrame(MakeSnapshot(0UL));
+
+  for (uint32_t frame = 1UL; frame <= FRAME_COUNT; frame++) {
+    HostClock_AdvanceMs(DISPLAY_REFRESH_MS / 2UL);
+    const SensorSnapshot snapshot = MakeSnapshot(frame);
+    (void)DrawFrame(snapshot);
+    const std::vector<uint16_t> incremental = Display()->GetFramebuffer();
+
+    // Same time and data from a blank screen.
+    DisplayService_ShowBootText();
+    (void)DrawFrame(snapshot);
+    ASSERT_TRUE(incremental == Display()->GetFramebuffer()) << "frame " << frame;
+  }
+}
+
+TEST(DisplayService, UnchangedSnapshotOnlyTouchesGauge) {
+  SetUpDisplay();
+  DisplayService_ShowBootText();
+  const SensorSnapshot snapshot = MakeSnapshot(0UL);
+  (void)DrawFrame(snapshot);
+
+  // Same seq within the same gauge mode and blink phase: nothing to draw.
+  EXPECT_EQ(0UL, DrawFrame(snapshot));
+}
+
+TEST(DisplayService, StaticLayerCacheMatchesDirectDraw) {
+  SetUpDisplay();
+  const std::string cached_log = TakeInitLog();
+  const char* line = strstr(cached_log.c_str(), "Static layer cached: ");
+  ASSERT_NE(nullptr, line) << cached_log;
+  unsigned spans = 0U;
+  unsigned used_bytes = 0U;
+  unsigned reserved_bytes = 0U;
+  ASSERT_EQ(3, sscanf(line, "Static layer cached: %u spans, %u of %u bytes", &spans, &used_bytes, &reserved_bytes));
+  printf("static layer: %u spans, %u of %u bytes\n", spans, used_bytes, reserved_bytes);
+  EXPECT_GT(spans, 0U);
+  EXPECT_LE(used_bytes, reserved_bytes);
+  EXPECT_LE(reserved_bytes, 4096U);
+
+  const SensorSnapshot snapshot = MakeSnapshot(0UL);
+  DisplayService_ShowBootText();
+  (void)DrawFrame(snapshot);
+  const std::vector<uint16_t> cached = Display()->GetFramebuffer();
+  const HostDisplayStats cached_stats = Display()->GetStats();
+
+  // Without heap for the band canvas Init falls back to the primitives.
+  HostGfx_SetCanvasLimitBytes(64U);
+  DisplayService_Init();
+  EXPECT_NE(std::string::npos, TakeInitLog().find("Static layer cache unavailable"));
+  DisplayService_ShowBootText();
+  (void)DrawFrame(snapshot);
+  EXPECT_TRUE(cached == Display()->GetFramebuffer());
+  EXPECT_LT(cached_stats.busy_us, Display()->GetStats().busy_us);
+}
+
+TEST(DisplayService, RecordedCallsAddUpToTheFrame) {
+  SetUpDisplay();
+  DisplayService_ShowBootText();
+  Display()->SetRecording(true);
+  const uint32_t pixels = DrawFrame(MakeSnapshot(0UL));
+
+  uint64_t recorded_pixels = 0U;
+  uint64_t recorded_spi_bytes = 0U;
+  for (const HostDisplayCall& call : Display()->GetCalls()) {
+    recorded_pixels += call.pixels;
+    recorded_spi_bytes += call.spi_bytes;
+  }
+  EXPECT_GE(Display()->GetCalls().size(), Display()->GetStats().calls);
+  EXPECT_EQ(pixels, recorded_pixels);
+  EXPECT_EQ(Display()->GetStats().spi_bytes, recorded_spi_bytes);
+
+  // Clipped to the panel, and an off-screen call costs nothing.
+  Display()->ClearCalls();
+  Display()->SetSection("probe");
+  Display()->fillRect(-5, -5, 10, 10, DISPLAY_COLOR_RED);
+  Display()->drawPixel(DISPLAY_SIZE_PX + 10, 0, DISPLAY_COLOR_RED);
+  ASSERT_EQ(2U, Display()->GetCalls().size());
+  const HostDisplayCall& rect = Display()->GetCalls()[0];
+  EXPECT_STREQ("fillRect", rect.primitive);
+  EXPECT_STREQ("probe", rect.section);
+  EXPECT_EQ(-5, rect.x);
+  EXPECT_EQ(10, rect.w);
+  EXPECT_EQ(25UL, rect.pixels);
+  EXPECT_EQ(11UL + (25UL * 2UL), rect.spi_bytes);
+  EXPECT_EQ(0UL, Display()->GetCalls()[1].pixels);
+  EXPECT_EQ(0UL, Display()->GetCalls()[1].spi_bytes);
+}
+
+TEST(DisplayService, PpmDumpMatchesTheFramebuffer) {
+  SetUpDisplay();
+  Display()->fillScreen(DISPLAY_COLOR_BLACK);
+  Display()->fillRect(0, 0, 2, 1, DISPLAY_COLOR_WHITE);
+  Display()->drawPixel(1, 0, DISPLAY_COLOR_RED);
+  const std::string path = ::testing::TempDir() + "display_service.ppm";
+  ASSERT_TRUE(Display()->WritePpm(path.c_str()));
+
+  FILE* file = fopen(path.c_str(), "rb");
+  ASSERT_NE(nullptr, file);
+  int width = 0;
+  int height = 0;
+  int max_value = 0;
+  ASSERT_EQ(3, fscanf(file, "P6 %d %d %d", &width, &height, &max_value));
+  ASSERT_EQ('\n', fgetc(file));
+  EXPECT_EQ(DISPLAY_SIZE_PX, width);
+  EXPECT_EQ(DISPLAY_SIZE_PX, height);
+  EXPECT_EQ(255, max_value);
+  std::vector<uint8_t> rgb(static_cast<size_t>(width) * height * 3U + 1U);
+  EXPECT_EQ(rgb.size() - 1U, fread(rgb.data(), 1U, rgb.size(), file));
+  fclose(file);
+  remove(path.c_str());
+
+  const uint8_t expected[] = {255U, 255U, 255U, 255U, 0U, 0U, 0U, 0U, 0U};
+  EXPECT_EQ(0, memcmp(expected, rgb.data(), sizeof(expected)));
+}
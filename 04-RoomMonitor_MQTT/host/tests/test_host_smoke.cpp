@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include "config.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+
+namespace {
+bool HasRetainedState() {
+  return HostHal_GetBroker()->GetRetained(RoomMonitorConfig::TOPIC_TEMP_STATE) != nullptr;
+}
+}  // namespace
+
+TEST(HostSmoke, BootsToFirstPublish) {
+  HostSketch_Reset();
+  HostSketch_Setup();
+  ASSERT_TRUE(HostSketch_RunUntil(HasRetainedState, 30000UL));
+
+  const HostBroker* broker = HostHal_GetBroker();
+  EXPECT_EQ(0U, broker->GetProtocolErrors()) << broker->GetLastError();
+  EXPECT_EQ(1U, broker->GetSessionCount());
+
+  const HostDisplay* display = HostHal_GetDisplay();
+  const std::vector<uint16_t>& frame = display->GetFramebuffer();
+  size_t lit = 0U;
+  for (size_t i = 0U; i < frame.size(); i++) {
+    if (frame[i] != frame[0]) {
+      lit++;
+    }
+  }
+  EXPECT_GT(lit, 0U);
+}
+
+// Constant readings only go out on the max-silence heartbeat.
+TEST(HostSmoke, KeepsRunning) {
+  HostSketch_RunFor(RoomMonitorConfig::MQTT_MAX_SILENCE_TEMP_MS + 30000UL);
+  const HostBroker* broker = HostHal_GetBroker();
+  EXPECT_TRUE(broker->IsSessionOpen());
+  EXPECT_EQ(0U, broker->GetProtocolErrors()) << broker->GetLastError();
+  EXPECT_GE(broker->GetMessagesOn(RoomMonitorConfig::TOPIC_TEMP_STATE).size(), 2U);
+}
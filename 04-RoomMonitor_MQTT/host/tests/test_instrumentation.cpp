@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "fakes/host_clock.h"
+#include "instrumentation.h"
+
+namespace {
+using namespace RoomMonitorConfig;
+
+// Upper bound of the log2 bucket a duration lands in, per the layout in
+// instrumentation.cpp.
+uint32_t BucketUpperUs(const uint32_t duration_us) {
+  uint8_t bucket = 0U;
+  while ((bucket < (INSTRUMENT_HISTOGRAM_BUCKETS - 1U)) && ((duration_us >> (bucket + 1U)) != 0UL)) {
+    bucket++;
+  }
+  return (2UL << bucket) - 1UL;
+}
+
+void RecordMany(const InstrumentSection section, const uint32_t duration_us, const uint32_t count) {
+  for (uint32_t i = 0UL; i < count; i++) {
+    Instrumentation_Record(section, duration_us);
+  }
+}
+
+void ResetWindow() {
+  InstrumentSnapshot discard = {};
+  Instrumentation_TakeSnapshot(&discard);
+}
+}  // namespace
+
+TEST(Instrumentation, SnapshotStartsFreshWindow) {
+  ResetWindow();
+  RecordMany(INSTRUMENT_SECTION_LOOP, 1000UL, 100UL);
+  RecordMany(INSTRUMENT_SECTION_DISPLAY, 40000UL, 10UL);
+
+  InstrumentSnapshot first = {};
+  Instrumentation_TakeSnapshot(&first);
+  EXPECT_EQ(1000UL, first.loop_max_us);
+  EXPECT_EQ(1023UL, first.section_p99_us[INSTRUMENT_SECTION_LOOP]);
+  EXPECT_EQ(65535UL, first.section_p99_us[INSTRUMENT_SECTION_DISPLAY]);
+
+  // The next interval is quiet: its p99 and max reflect only itself.
+  RecordMany(INSTRUMENT_SECTION_LOOP, 10UL, 100UL);
+  InstrumentSnapshot second = {};
+  Instrumentation_TakeSnapshot(&second);
+  EXPECT_EQ(10UL, second.loop_max_us);
+  EXPECT_EQ(15UL, second.section_p99_us[INSTRUMENT_SECTION_LOOP]);
+  EXPECT_EQ(0UL, second.section_p99_us[INSTRUMENT_SECTION_DISPLAY]);
+}
+
+TEST(Instrumentation, BucketsArePowersOfTwo) {
+  const uint32_t last_upper_us = (1UL << INSTRUMENT_HISTOGRAM_BUCKETS) - 1UL;
+  const struct {
+    uint32_t duration_us;
+    uint32_t upper_us;
+  } cases[] = {
+      {0UL, 1UL},
+      {1UL, 1UL},
+      {2UL, 3UL},
+      {3UL, 3UL},
+      {4UL, 7UL},
+      {1023UL, 1023UL},
+      {1024UL, 2047UL},
+      {(1UL << (INSTRUMENT_HISTOGRAM_BUCKETS - 1U)) - 1UL, (1UL << (INSTRUMENT_HISTOGRAM_BUCKETS - 1U)) - 1UL},
+      // The last bucket takes everything from its lower bound up.
+      {1UL << (INSTRUMENT_HISTOGRAM_BUCKETS - 1U), last_upper_us},
+      {UINT32_MAX, last_upper_us},
+  };
+  for (const auto& entry : cases) {
+    ResetWindow();
+    Instrumentation_Record(INSTRUMENT_SECTION_SENSOR, entry.duration_us);
+    EXPECT_EQ(entry.upper_us, Instrumentation_PercentileUs(INSTRUMENT_SECTION_SENSOR, 100U)) << entry.duration_us;
+    EXPECT_EQ(entry.upper_us, BucketUpperUs(entry.duration_us)) << entry.duration_us;
+  }
+}
+
+TEST(Instrumentation, PercentileRoundsTheRankUp) {
+  ResetWindow();
+  RecordMany(INSTRUMENT_SECTION_PUBLISH, 10UL, 99UL);
+  RecordMany(INSTRUMENT_SECTION_PUBLISH, 5000UL, 1UL);
+  EXPECT_EQ(15UL, Instrumentation_PercentileUs(INSTRUMENT_SECTION_PUBLISH, 99U));
+  EXPECT_EQ(8191UL, Instrumentation_PercentileUs(INSTRUMENT_SECTION_PUBLISH, 100U));
+
+  // 99 of 101 is 98.0 %: the 99th percentile needs the 100th sample.
+  RecordMany(INSTRUMENT_SECTION_PUBLISH, 5000UL, 1UL);
+  EXPECT_EQ(8191UL, Instrumentation_PercentileUs(INSTRUMENT_SECTION_PUBLISH, 99U));
+  EXPECT_EQ(15UL, Instrumentation_PercentileUs(INSTRUMENT_SECTION_PUBLISH, 98U));
+
+  // Percentile 0 is the first non-empty bucket, not bucket 0.
+  EXPECT_EQ(15UL, Instrumentation_PercentileUs(INSTRUMENT_SECTION_PUBLISH, 0U));
+}
+
+TEST(Instrumentation, EmptyAndUnknownSectionsReadZero) {
+  ResetWindow();
+  EXPECT_EQ(0UL, Instrumentation_PercentileUs(INSTRUMENT_SECTION_MQTT, 99U));
+  Instrumentation_Record(INSTRUMENT_SECTION_COUNT, 100UL);
+  EXPECT_EQ(0UL, Instrumentation_PercentileUs(INSTRUMENT_SECTION_COUNT, 99U));
+}
+
+// Against nearest-rank percentiles of the raw samples: the histogram must
+// report the upper bound of the bucket that holds the exact value.
+TEST(Instrumentation, PercentilesMatchSortedReference) {
+  std::mt19937 rng(42U);
+  std::lognormal_distribution<double> durations(7.0, 1.5);
+  for (const uint32_t count : {1UL, 7UL, 100UL, 1000UL, 50000UL}) {
+    ResetWindow();
+    std::vector<uint32_t> samples;
+    for (uint32_t i = 0UL; i < count; i++) {
+      const double value = durations(rng);
+      samples.push_back((value > 4.0e9) ? UINT32_MAX : static_cast<uint32_t>(value));
+      Instrumentation_Record(INSTRUMENT_SECTION_DISPLAY, samples.back());
+    }
+    std::sort(samples.begin(), samples.end());
+    for (const uint8_t percentile : {1U, 50U, 90U, 99U, 100U}) {
+      const size_t rank = ((static_cast<size_t>(count) * percentile) + 99U) / 100U;
+      const uint32_t exact_us = samples[(rank > 0U) ? (rank - 1U) : 0U];
+      EXPECT_EQ(BucketUpperUs(exact_us), Instrumentation_PercentileUs(INSTRUMENT_SECTION_DISPLAY, percentile))
+          << "p" << static_cast<unsigned>(percentile) << " of " << count << " samples, exact " << exact_us;
+    }
+  }
+}
+
+TEST(Instrumentation, LoopRateOverTheWindow) {
+  HostClock_Reset();
+  HostClock_SetReadTickUs(0U);
+  ResetWindow();
+  for (uint32_t i = 0UL; i < 2500UL; i++) {
+    Instrumentation_CountLoop();
+    HostClock_AdvanceUs(2000UL);
+  }
+  InstrumentSnapshot snapshot = {};
+  Instrumentation_TakeSnapshot(&snapshot);
+  EXPECT_EQ(500UL, snapshot.loop_hz);
+  EXPECT_GT(snapshot.free_ram_min, 0UL);
+
+  // No time since the last snapshot: no rate rather than a division by 0.
+  Instrumentation_TakeSnapshot(&snapshot);
+  EXPECT_EQ(0UL, snapshot.loop_hz);
+}
+
+TEST(Instrumentation, ScopedTimerRecordsItsScope) {
+  HostClock_Reset();
+  HostClock_SetReadTickUs(0U);
+  ResetWindow();
+  {
+    const ScopedTimer timer(INSTRUMENT_SECTION_LOOP);
+    HostClock_AdvanceUs(3000UL);
+  }
+  InstrumentSnapshot snapshot = {};
+  Instrumentation_TakeSnapshot(&snapshot);
+  EXPECT_EQ(3000UL, snapshot.loop_max_us);
+  EXPECT_EQ(4095UL, snapshot.section_p99_us[INSTRUMENT_SECTION_LOOP]);
+
+  // Compiled out, the timer has no state to carry.
+  EXPECT_TRUE(std::is_empty<ScopedTimerT<false>>::value);
+}
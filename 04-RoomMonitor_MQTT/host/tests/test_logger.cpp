@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "config.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+#include "logger.h"
+
+// The ring-buffered logger against the fake UART, which blocks the
+// simulated clock whenever its TX FIFO is full: lines go out whole or are
+// dropped and counted, disabled levels compile away, and the sketch never
+// waits on Serial even when the UART is far too slow for its output.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t DRAIN_STEP_MS = 10UL;
+constexpr uint32_t SKETCH_RUN_MS = 2UL * 60UL * 1000UL;
+// Far slower than the sketch's output: 30 bytes a second.
+constexpr unsigned long CRAWLING_BAUD = 300UL;
+
+static_assert(std::is_base_of<Print, Log<LOG_LEVEL_INFO>>::value, "enabled levels print");
+static_assert(!std::is_base_of<Print, Log<LOG_LEVEL_DEBUG>>::value, "levels above LOG_LEVEL compile away");
+static_assert(std::is_empty<Log<LOG_LEVEL_DEBUG>>::value, "a stripped logger holds nothing");
+
+std::vector<std::string> Lines(const std::string& output) {
+  std::vector<std::string> lines;
+  std::istringstream stream(output);
+  std::string line;
+  while (std::getline(stream, line)) {
+    // println() ends lines with "\r\n".
+    if (!line.empty() && (line.back() == '\r')) {
+      line.pop_back();
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+// Drains the ring at the UART's pace until `ms` have passed.
+void DrainFor(const uint32_t ms) {
+  for (uint32_t elapsed = 0UL; elapsed < ms; elapsed += DRAIN_STEP_MS) {
+    HostClock_AdvanceMs(DRAIN_STEP_MS);
+    Logger_Drain();
+  }
+}
+
+void StartUart(const unsigned long baud) {
+  HostHal_Reset();
+  HostSerial_SetCapture(true);
+  Serial.begin(baud);
+}
+
+struct SketchRun {
+  uint32_t dropped;
+  uint32_t max_loop_us;
+  std::vector<std::string> lines;
+};
+
+// Readings that move every sample, so the sketch logs all five every
+// refresh: about 110 bytes a second.
+bool RunChattySketch(const unsigned long baud, FILE* out) {
+  HostSketch_Reset();
+  HostHal_SetSensorScript(HOST_SENSOR_TEMPERATURE, [](uint32_t now_ms) { return 20.0F + ((now_ms % 60000UL) / 10000.0F); });
+  HostSerial_SetCapture(true);
+  HostSketch_Setup();
+  Serial.begin(baud);
+  const uint32_t dropped_before = Logger_DroppedCount();
+  HostSketch_RunFor(SKETCH_RUN_MS);
+  // Let the UART catch up with what is still queued.
+  DrainFor(static_cast<uint32_t>((LOG_RING_CAPACITY * 10UL * 1000UL) / baud) + 1000UL);
+  const SketchRun run = {Logger_DroppedCount() - dropped_before, HostSketch_MaxLoopUs(), {}};
+  printf("  %5lu baud: %6u bytes sent, %4u lines dropped, blocked %u us, max loop %u us\n",
+         baud,
+         HostSerial_BytesWritten(),
+         run.dropped,
+         static_cast<unsigned>(HostSerial_BlockedUs()),
+         run.max_loop_us);
+  const std::string& output = HostSerial_Output();
+  const uint32_t bytes = static_cast<uint32_t>(output.size());
+  return (HostSerial_BlockedUs() == 0U) && (fwrite(&run, sizeof(uint32_t), 2U, out) == 2U) &&
+         (fwrite(&bytes, sizeof(bytes), 1U, out) == 1U) && (fwrite(output.data(), 1U, bytes, out) == bytes) &&
+         (fflush(out) == 0);
+}
+
+SketchRun ReadRun(FILE* in) {
+  rewind(in);
+  SketchRun run = {};
+  uint32_t bytes = 0UL;
+  if ((fread(&run, sizeof(uint32_t), 2U, in) == 2U) && (fread(&bytes, sizeof(bytes), 1U, in) == 1U)) {
+    std::string output(bytes, '\0');
+    if (fread(&output[0], 1U, bytes, in) == bytes) {
+      run.lines = Lines(output);
+    }
+  }
+  return run;
+}
+}  // namespace
+
+TEST(Logger, OverflowDropsWholeLinesWithoutBlocking) {
+  StartUart(SERIAL_BAUD_RATE);
+  const uint32_t dropped_before = Logger_DroppedCount();
+  Log<LOG_LEVEL_INFO> logger;
+  // Far more than LOG_RING_CAPACITY in one burst.
+  constexpr uint32_t LINES = 100UL;
+  for (uint32_t i = 0UL; i < LINES; i++) {
+    logger.print("line ");
+    logger.println(i);
+    Logger_Drain();
+  }
+  EXPECT_EQ(0U, HostSerial_BlockedUs());
+  const uint32_t dropped = Logger_DroppedCount() - dropped_before;
+  EXPECT_GT(dropped, 0UL);
+
+  DrainFor(2000UL);
+  EXPECT_EQ(0U, HostSerial_BlockedUs());
+  const std::vector<std::string> lines = Lines(HostSerial_Output());
+  EXPECT_EQ(LINES, lines.size() + dropped);
+  // In order, each one whole.
+  uint32_t last = 0UL;
+  for (const std::string& line : lines) {
+    uint32_t value = 0UL;
+    char tail = '\0';
+    ASSERT_EQ(1, sscanf(line.c_str(), "line %u%c", &value, &tail)) << line;
+    EXPECT_TRUE(lines.front() == line || value > last) << line;
+    last = value;
+  }
+  EXPECT_EQ('\n', HostSerial_Output().back());
+}
+
+TEST(Logger, LongLinesAreTruncatedKeepingTheNewline) {
+  StartUart(SERIAL_BAUD_RATE);
+  const std::string text(2U * LOG_LINE_CAPACITY, 'x');
+  Log<LOG_LEVEL_WARN> logger;
+  logger.println(text.c_str());
+  logger.println("next");
+  DrainFor(1000UL);
+  // Truncation takes the '\r' that println() puts before the newline.
+  EXPECT_EQ(std::string(LOG_LINE_CAPACITY - 1U, 'x') + "\nnext\r\n", HostSerial_Output());
+}
+
+TEST(Logger, DisabledLevelsWriteNothing) {
+  StartUart(SERIAL_BAUD_RATE);
+  Log<LOG_LEVEL_DEBUG> debug;
+  debug.print("debug ");
+  debug.println(42);
+  debug.println();
+  DrainFor(100UL);
+  EXPECT_EQ(0U, HostSerial_BytesWritten());
+}
+
+// The same simulated minutes at two baud rates. Logging never waits on
+// the UART, so both runs take the same path and the slow one's output must
+// be the fast one's, minus whole dropped lines.
+TEST(Logger, SketchDropsRatherThanBlocksOnASlowUart) {
+  FILE* out[2] = {tmpfile(), tmpfile()};
+  ASSERT_TRUE((out[0] != nullptr) && (out[1] != nullptr));
+  ASSERT_TRUE(HostSketch_RunIsolated([&out]() { return RunChattySketch(SERIAL_BAUD_RATE, out[0]); }));
+  ASSERT_TRUE(HostSketch_RunIsolated([&out]() { return RunChattySketch(CRAWLING_BAUD, out[1]); }));
+  SketchRun runs[2];
+  for (uint8_t i = 0U; i < 2U; i++) {
+    runs[i] = ReadRun(out[i]);
+    fclose(out[i]);
+  }
+
+  const SketchRun& fast = runs[0];
+  const SketchRun& slow = runs[1];
+  EXPECT_EQ(0U, fast.dropped);
+  EXPECT_GT(slow.dropped, 0UL);
+  EXPECT_EQ(fast.lines.size(), slow.lines.size() + slow.dropped);
+  EXPECT_EQ(fast.max_loop_us, slow.max_loop_us);
+  size_t next = 0U;
+  for (const std::string& line : slow.lines) {
+    while ((next < fast.lines.size()) && (fast.lines[next] != line)) {
+      next++;
+    }
+    ASSERT_LT(next, fast.lines.size()) << "not a whole line, or out of order: " << line;
+    next++;
+  }
+}
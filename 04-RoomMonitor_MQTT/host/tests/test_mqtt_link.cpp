@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "config.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+
+// The non-blocking link state machine against slow and failing Wi-Fi and
+// TCP connects and brokers that are slow to answer CONNECT or never do.
+// Each case boots its own device; throughout, no loop() pass may exceed
+// LOOP_BUDGET_US and sampling and the display keep going.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+// A full dashboard redraw is the longest regular pass (about 7 ms of SPI);
+// a connect step must never come close to a blocking TCP timeout.
+constexpr uint32_t LOOP_BUDGET_US = 20000UL;
+constexpr uint32_t WINDOW_MS = 2UL * 60UL * 1000UL;
+
+struct LinkCase {
+  const char* name;
+  uint32_t associate_ms;
+  uint32_t connect_ms;
+  bool refused;
+  uint32_t connack_delay_ms;
+  bool connack_withheld;
+  bool expect_online;
+};
+
+const LinkCase LINK_CASES[] = {
+    {"fast network", 100UL, 50UL, false, 0UL, false, true},
+    {"slow association", 12000UL, 50UL, false, 0UL, false, true},
+    {"slow TCP connect", 100UL, 4000UL, false, 0UL, false, true},
+    {"TCP connect timeout", 100UL, 2UL * MQTT_TCP_CONNECT_TIMEOUT_MS, false, 0UL, false, false},
+    {"broker refuses", 100UL, 50UL, true, 0UL, false, false},
+    {"slow CONNACK", 100UL, 50UL, false, MQTT_CONNACK_TIMEOUT_MS / 2UL, false, true},
+    {"CONNACK withheld", 100UL, 50UL, false, 0UL, true, false},
+};
+
+HostBroker* Broker() {
+  return HostHal_GetBroker();
+}
+
+bool IsOnline() {
+  return Broker()->GetRetained(TOPIC_TEMP_STATE) != nullptr;
+}
+
+// A reconnect republishes every metric.
+bool HasPublishedSinceClear() {
+  const std::vector<HostMqttMessage>& messages = Broker()->GetMessages();
+  return std::any_of(messages.begin(), messages.end(), [](const HostMqttMessage& message) {
+    return message.topic == TOPIC_TEMP_STATE;
+  });
+}
+
+// Sensor reads and display primitives over the last `ms` of running.
+struct Activity {
+  uint32_t sensor_reads;
+  uint32_t display_calls;
+};
+
+Activity RunWatched(const uint32_t ms) {
+  const uint32_t reads_before = HostHal_GetSensorReads(HOST_SENSOR_TEMPERATURE);
+  HostHal_GetDisplay()->ResetStats();
+  HostSketch_RunFor(ms);
+  return Activity{HostHal_GetSensorReads(HOST_SENSOR_TEMPERATURE) - reads_before,
+                  HostHal_GetDisplay()->GetStats().calls};
+}
+
+// Temperature reads a healthy device makes in `ms`, give or take a read.
+uint32_t ExpectedReads(const uint32_t ms) {
+  return ms / SENSOR_TEMP_PERIOD_MS;
+}
+
+bool RunLinkCase(const LinkCase& link) {
+  HostSketch_Reset();
+  HostHal_SetWifiAssociateMs(link.associate_ms);
+  HostHal_SetTransportConnectMs(link.connect_ms);
+  HostHal_SetTransportRefused(link.refused);
+  Broker()->Config().response_delay_ms = link.connack_delay_ms;
+  Broker()->Config().send_connack = !link.connack_withheld;
+  HostSketch_Setup();
+
+  const Activity activity = RunWatched(WINDOW_MS);
+  const bool online = IsOnline();
+  printf("  %-20s %8s %9u us %6u %6u %6u\n",
+         link.name,
+         online ? "online" : "offline",
+         HostSketch_MaxLoopUs(),
+         HostHal_GetTransportOpens(),
+         activity.sensor_reads,
+         activity.display_calls);
+  return (online == link.expect_online) && (HostSketch_MaxLoopUs() <= LOOP_BUDGET_US) &&
+         ((activity.sensor_reads + 1UL) >= ExpectedReads(WINDOW_MS)) && (activity.display_calls > 0UL);
+}
+
+// Online, then the access point vanishes for `outage_ms` and returns.
+bool RunWifiDrop(const uint32_t outage_ms) {
+  HostSketch_Reset();
+  HostSketch_Setup();
+  if (!HostSketch_RunUntil(IsOnline, 60000UL)) {
+    return false;
+  }
+
+  HostHal_SetWifiAvailable(false);
+  const Activity offline = RunWatched(outage_ms);
+  HostHal_SetWifiAvailable(true);
+  Broker()->ClearMessages();
+  const uint32_t recover_timeout_ms = MQTT_RETRY_MAX_DELAY_MS + WIFI_ASSOCIATE_TIMEOUT_MS + 60000UL;
+  const bool back = HostSketch_RunUntil(HasPublishedSinceClear, recover_timeout_ms);
+  printf("  %8u s %8s %9u us %6u %6u\n",
+         outage_ms / 1000U,
+         back ? "online" : "offline",
+         HostSketch_MaxLoopUs(),
+         offline.sensor_reads,
+         offline.display_calls);
+  return back && (HostSketch_MaxLoopUs() <= LOOP_BUDGET_US) &&
+         ((offline.sensor_reads + 1UL) >= ExpectedReads(outage_ms)) && (offline.display_calls > 0UL);
+}
+}  // namespace
+
+TEST(MqttLink, SlowAndFailingConnectsStayWithinLoopBudget) {
+  printf("  %-20s %8s %12s %6s %6s %6s\n", "case", "link", "max loop", "opens", "reads", "draws");
+  for (const LinkCase& link : LINK_CASES) {
+    EXPECT_TRUE(HostSketch_RunIsolated([&link]() { return RunLinkCase(link); })) << link.name;
+  }
+}
+
+TEST(MqttLink, WifiDropRecoversWithinLoopBudget) {
+  printf("  %10s %8s %12s %6s %6s\n", "wifi drop", "link", "max loop", "reads", "draws");
+  for (const uint32_t outage_ms : {5000UL, 60000UL, 10UL * 60UL * 1000UL}) {
+    EXPECT_TRUE(HostSketch_RunIsolated([outage_ms]() { return RunWifiDrop(outage_ms); })) << outage_ms << " ms";
+  }
+}
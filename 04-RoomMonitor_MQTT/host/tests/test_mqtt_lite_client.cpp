@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+
+#include "config.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "mqtt_lite_client.h"
+
+namespace {
+constexpr uint32_t KEEPALIVE_MS = static_cast<uint32_t>(RoomMonitorConfig::MQTT_KEEPALIVE_S) * 1000UL;
+constexpr uint32_t SERVICE_STEP_MS = 20UL;
+const char* const STATE_TOPICS[] = {
+    RoomMonitorConfig::TOPIC_TEMP_STATE,
+    RoomMonitorConfig::TOPIC_HUM_STATE,
+    RoomMonitorConfig::TOPIC_PRESSURE_STATE,
+    RoomMonitorConfig::TOPIC_SOIL1_STATE,
+    RoomMonitorConfig::TOPIC_SOIL2_STATE,
+};
+const char* const STREAMED_TOPICS[] = {
+    RoomMonitorConfig::TOPIC_TEMP_CONFIG,
+    RoomMonitorConfig::TOPIC_HUM_CONFIG,
+    RoomMonitorConfig::TOPIC_PRESSURE_CONFIG,
+    RoomMonitorConfig::TOPIC_SOIL1_CONFIG,
+    RoomMonitorConfig::TOPIC_SOIL2_CONFIG,
+    RoomMonitorConfig::TOPIC_STATS_TEMP,
+    RoomMonitorConfig::TOPIC_STATS_HUM,
+    RoomMonitorConfig::TOPIC_STATS_PRESSURE,
+    RoomMonitorConfig::TOPIC_STATS_SOIL1,
+    RoomMonitorConfig::TOPIC_STATS_SOIL2,
+};
+
+class MqttLiteClientTest : public ::testing::Test {
+ protected:
+  MqttLiteClientTest() : transport_(HostHal_GetBroker()) {}
+
+  void SetUp() override {
+    HostHal_Reset();
+    broker_ = HostHal_GetBroker();
+    mqtt_.setClient(transport_);
+    mqtt_.setServer("broker", 1883U);
+  }
+
+  bool Connect() {
+    return mqtt_.connect("room_monitor");
+  }
+
+  bool Stream(const char* topic, const char* payload) {
+    const size_t length = strlen(payload);
+    return mqtt_.beginPublish(topic, static_cast<unsigned int>(length), true) &&
+           (mqtt_.write(reinterpret_cast<const uint8_t*>(payload), length) == length) && (mqtt_.endPublish() == 1);
+  }
+
+  // Publishes and services until the broker has acknowledged it.
+  bool PublishAcked(const char* topic, const char* payload) {
+    if (!mqtt_.publish(topic, payload, true)) {
+      return false;
+    }
+    return ServiceFor(SERVICE_STEP_MS) && (mqtt_.inFlightCount() == 0U);
+  }
+
+  // loop() on the MQTT service cadence; false once the session drops.
+  bool ServiceFor(const uint32_t duration_ms) {
+    for (uint32_t elapsed = 0UL; elapsed < duration_ms; elapsed += SERVICE_STEP_MS) {
+      HostClock_AdvanceMs(SERVICE_STEP_MS);
+      if (!mqtt_.loop()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  HostBroker* broker_;
+  HostTransportClient transport_;
+  MqttLiteClient mqtt_;
+};
+}  // namespace
+
+TEST_F(MqttLiteClientTest, IdleSessionSurvivesKeepAlive) {
+  ASSERT_TRUE(Connect());
+  EXPECT_TRUE(ServiceFor(10UL * KEEPALIVE_MS));
+  EXPECT_TRUE(mqtt_.connected());
+  EXPECT_GE(broker_->GetPacketCount(0xC0U), 9U);
+  EXPECT_EQ(0U, broker_->GetProtocolErrors());
+}
+
+TEST_F(MqttLiteClientTest, SlowPingRespWithinKeepAliveIsAccepted) {
+  broker_->Config().response_delay_ms = KEEPALIVE_MS / 2UL;
+  ASSERT_TRUE(Connect());
+  EXPECT_TRUE(ServiceFor(5UL * KEEPALIVE_MS));
+}
+
+TEST_F(MqttLiteClientTest, MissingPingRespTimesOutAfterKeepAlive) {
+  ASSERT_TRUE(Connect());
+  broker_->Config().send_pingresp = false;
+  // First PINGREQ after one idle interval, drop one interval later.
+  EXPECT_TRUE(ServiceFor(KEEPALIVE_MS + KEEPALIVE_MS - SERVICE_STEP_MS));
+  EXPECT_FALSE(ServiceFor(3UL * SERVICE_STEP_MS));
+  EXPECT_EQ(-4, mqtt_.state());
+}
+
+// beginConnect() only sends CONNECT; loop() picks up a late CONNACK
+// without ever waiting for it.
+TEST_F(MqttLiteClientTest, BeginConnectPollsForSlowConnack) {
+  broker_->Config().response_delay_ms = RoomMonitorConfig::MQTT_CONNACK_TIMEOUT_MS / 2UL;
+  uint64_t start_us = HostClock_NowUs();
+  ASSERT_TRUE(mqtt_.beginConnect("room_monitor", nullptr, nullptr));
+  uint64_t longest_us = HostClock_NowUs() - start_us;
+  EXPECT_TRUE(mqtt_.connecting());
+  EXPECT_FALSE(mqtt_.connected());
+
+  uint32_t slices = 0UL;
+  while (mqtt_.connecting() && (slices < (RoomMonitorConfig::MQTT_CONNACK_TIMEOUT_MS / SERVICE_STEP_MS))) {
+    HostClock_AdvanceMs(SERVICE_STEP_MS);
+    start_us = HostClock_NowUs();
+    (void)mqtt_.loop();
+    const uint64_t slice_us = HostClock_NowUs() - start_us;
+    longest_us = (slice_us > longest_us) ? slice_us : longest_us;
+    slices++;
+  }
+  EXPECT_FALSE(mqtt_.connecting());
+  EXPECT_TRUE(mqtt_.connected());
+  EXPECT_EQ(0, mqtt_.state());
+  EXPECT_GE(slices * SERVICE_STEP_MS, RoomMonitorConfig::MQTT_CONNACK_TIMEOUT_MS / 2UL);
+  EXPECT_LT(longest_us, SERVICE_STEP_MS * 1000ULL);
+  EXPECT_EQ(1U, broker_->GetPacketCount(0x10U));
+}
+
+// Without a CONNACK the poll never gives up on its own; the caller owns
+// the deadline. The blocking connect() still ends at the socket timeout.
+TEST_F(MqttLiteClientTest, WithheldConnackLeavesTheDeadlineToTheCaller) {
+  broker_->Config().send_connack = false;
+  ASSERT_TRUE(mqtt_.beginConnect("room_monitor", nullptr, nullptr));
+  for (uint32_t elapsed = 0UL; elapsed < (2UL * RoomMonitorConfig::MQTT_CONNACK_TIMEOUT_MS);
+       elapsed += SERVICE_STEP_MS) {
+    HostClock_AdvanceMs(SERVICE_STEP_MS);
+    const uint64_t start_us = HostClock_NowUs();
+    EXPECT_FALSE(mqtt_.loop());
+    ASSERT_LT(HostClock_NowUs() - start_us, SERVICE_STEP_MS * 1000ULL);
+  }
+  EXPECT_TRUE(mqtt_.connecting());
+  EXPECT_EQ(-1, mqtt_.state());
+
+  mqtt_.setSocketTimeout(1U);
+  const uint32_t start_ms = millis();
+  EXPECT_FALSE(Connect());
+  EXPECT_FALSE(mqtt_.connecting());
+  EXPECT_EQ(-4, mqtt_.state());
+  EXPECT_GE(millis() - start_ms, 1000UL);
+}
+
+TEST_F(MqttLiteClientTest, OnlyStateTopicsTakeAliases) {
+  broker_->Config().topic_alias_maximum = RoomMonitorConfig::MQTT_LITE_TOPIC_ALIAS_SLOTS;
+  ASSERT_TRUE(Connect());
+  for (const char* topic : STREAMED_TOPICS) {
+    ASSERT_TRUE(Stream(topic, "{}"));
+  }
+  for (uint8_t round = 0U; round < 2U; round++) {
+    for (const char* topic : STATE_TOPICS) {
+      ASSERT_TRUE(PublishAcked(topic, "21.5"));
+    }
+  }
+  EXPECT_EQ(0U, broker_->GetProtocolErrors()) << broker_->GetLastError();
+
+  const std::vector<HostMqttMessage>& messages = broker_->GetMessages();
+  const size_t streamed = sizeof(STREAMED_TOPICS) / sizeof(STREAMED_TOPICS[0]);
+  const size_t states = sizeof(STATE_TOPICS) / sizeof(STATE_TOPICS[0]);
+  ASSERT_EQ(streamed + (2U * states), messages.size());
+  for (size_t i = 0U; i < streamed; i++) {
+    EXPECT_EQ(0U, messages[i].topic_alias);
+  }
+  // Second round: alias only, so the topic name is no longer on the wire.
+  for (size_t i = 0U; i < states; i++) {
+    const HostMqttMessage& first = messages[streamed + i];
+    const HostMqttMessage& repeat = messages[streamed + states + i];
+    EXPECT_EQ(i + 1U, first.topic_alias);
+    EXPECT_EQ(first.topic_alias, repeat.topic_alias);
+    EXPECT_EQ(first.topic, repeat.topic);
+    EXPECT_EQ(first.wire_bytes - strlen(STATE_TOPICS[i]), repeat.wire_bytes);
+  }
+}
+
+TEST_F(MqttLiteClientTest, AliasRegisteredOnlyAfterSuccessfulSend) {
+  broker_->Config().topic_alias_maximum = RoomMonitorConfig::MQTT_LITE_TOPIC_ALIAS_SLOTS;
+  ASSERT_TRUE(Connect());
+  const char* topic = RoomMonitorConfig::TOPIC_TEMP_STATE;
+
+  // Too large for the buffer: nothing is sent.
+  const std::string oversized(RoomMonitorConfig::MQTT_BUFFER_SIZE_BYTES, 'x');
+  EXPECT_FALSE(mqtt_.publish(topic, oversized.c_str(), true));
+  // The socket refuses the write.
+  broker_->Config().accept_writes = false;
+  EXPECT_FALSE(mqtt_.publish(topic, "21.5", true));
+  broker_->Config().accept_writes = true;
+
+  ASSERT_TRUE(PublishAcked(topic, "21.6"));
+  ASSERT_TRUE(PublishAcked(topic, "21.7"));
+  EXPECT_EQ(0U, broker_->GetProtocolErrors()) << broker_->GetLastError();
+  const std::vector<HostMqttMessage> received = broker_->GetMessagesOn(topic);
+  ASSERT_EQ(2U, received.size());
+  EXPECT_EQ("21.6", received[0].payload);
+  EXPECT_EQ("21.7", received[1].payload);
+}
+
+TEST_F(MqttLiteClientTest, WindowHoldsOnePublishCycle) {
+  broker_->Config().send_puback = false;
+  ASSERT_TRUE(Connect());
+  for (const char* topic : STATE_TOPICS) {
+    EXPECT_TRUE(mqtt_.publish(topic, "1", true));
+  }
+  EXPECT_TRUE(mqtt_.publish(RoomMonitorConfig::TOPIC_STATE_BIN, "1", true));
+  EXPECT_EQ(RoomMonitorConfig::MQTT_LITE_INFLIGHT_WINDOW, mqtt_.inFlightCount());
+}
+
+TEST_F(MqttLiteClientTest, ReceiveMaximumShrinksWindow) {
+  broker_->Config().send_puback = false;
+  broker_->Config().receive_maximum = 2U;
+  ASSERT_TRUE(Connect());
+  EXPECT_TRUE(mqtt_.publish(STATE_TOPICS[0], "1", true));
+  EXPECT_TRUE(mqtt_.publish(STATE_TOPICS[1], "1", true));
+  EXPECT_FALSE(mqtt_.publish(STATE_TOPICS[2], "1", true));
+}
+
+TEST_F(MqttLiteClientTest, UnackedPublishIsResentWithDup) {
+  broker_->Config().send_puback = false;
+  ASSERT_TRUE(Connect());
+  ASSERT_TRUE(mqtt_.publish(STATE_TOPICS[0], "21.5", true));
+  ASSERT_TRUE(ServiceFor(RoomMonitorConfig::MQTT_LITE_PUBACK_TIMEOUT_MS + SERVICE_STEP_MS));
+
+  std::vector<HostMqttMessage> received = broker_->GetMessagesOn(STATE_TOPICS[0]);
+  ASSERT_EQ(2U, received.size());
+  EXPECT_FALSE(received[0].dup);
+  EXPECT_TRUE(received[1].dup);
+  EXPECT_EQ(received[0].packet_id, received[1].packet_id);
+  EXPECT_EQ(received[0].payload, received[1].payload);
+  EXPECT_EQ(1U, mqtt_.inFlightCount());
+  EXPECT_EQ(0U, mqtt_.unackedCount());
+
+  // The PUBACK for the resend clears the slot.
+  broker_->Config().send_puback = true;
+  ASSERT_TRUE(ServiceFor(RoomMonitorConfig::MQTT_LITE_PUBACK_TIMEOUT_MS));
+  EXPECT_EQ(0U, mqtt_.inFlightCount());
+  EXPECT_EQ(0U, mqtt_.unackedCount());
+  EXPECT_EQ(0U, broker_->GetProtocolErrors()) << broker_->GetLastError();
+}
+
+TEST_F(MqttLiteClientTest, GivesUpAfterLastResend) {
+  broker_->Config().send_puback = false;
+  ASSERT_TRUE(Connect());
+  ASSERT_TRUE(mqtt_.publish(STATE_TOPICS[0], "21.5", true));
+  const uint32_t attempts = 1UL + RoomMonitorConfig::MQTT_LITE_PUBACK_RESENDS;
+  ASSERT_TRUE(ServiceFor(attempts * (RoomMonitorConfig::MQTT_LITE_PUBACK_TIMEOUT_MS + SERVICE_STEP_MS)));
+  EXPECT_EQ(attempts, broker_->GetMessagesOn(STATE_TOPICS[0]).size());
+  EXPECT_EQ(0U, mqtt_.inFlightCount());
+  EXPECT_EQ(1U, mqtt_.unackedCount());
+}
+
+TEST_F(MqttLiteClientTest, ResendKeepsAliasedTopic) {
+  broker_->Config().topic_alias_maximum = RoomMonitorConfig::MQTT_LITE_TOPIC_ALIAS_SLOTS;
+  ASSERT_TRUE(Connect());
+  ASSERT_TRUE(PublishAcked(STATE_TOPICS[0], "21.5"));
+  broker_->Config().send_puback = false;
+  ASSERT_TRUE(mqtt_.publish(STATE_TOPICS[0], "21.6", true));
+  ASSERT_TRUE(ServiceFor(RoomMonitorConfig::MQTT_LITE_PUBACK_TIMEOUT_MS + SERVICE_STEP_MS));
+  const std::vector<HostMqttMessage> received = broker_->GetMessagesOn(STATE_TOPICS[0]);
+  ASSERT_EQ(3U, received.size());
+  EXPECT_TRUE(received[2].dup);
+  EXPECT_EQ("21.6", received[2].payload);
+  EXPECT_EQ(0U, broker_->GetProtocolErrors()) << broker_->GetLastError();
+}
+
+TEST_F(MqttLiteClientTest, HonoursBrokerMaximumQos) {
+  broker_->Config().maximum_qos = 0U;
+  ASSERT_TRUE(Connect());
+  for (const char* topic : STATE_TOPICS) {
+    ASSERT_TRUE(mqtt_.publish(topic, "1", true));
+  }
+  ASSERT_TRUE(ServiceFor(SERVICE_STEP_MS));
+  EXPECT_EQ(0U, broker_->GetProtocolErrors()) << broker_->GetLastError();
+  EXPECT_EQ(0U, mqtt_.inFlightCount());
+  for (const HostMqttMessage& message : broker_->GetMessages()) {
+    EXPECT_EQ(0U, message.qos);
+  }
+}
@@ -0,0 +1,295 @@
+#include <gtest/gtest.h>
+
+#include <ctype.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+
+#include "config.h"
+#include "fakes/host_heap.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+#include "mqtt_manager.h"
+
+// MqttManager through the sketch over PubSubClient and the host broker.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t PUBLISH_CYCLES = 20UL;
+
+HostBroker* Broker() {
+  return HostHal_GetBroker();
+}
+
+struct DiscoveryCase {
+  const char* topic;
+  const char* name;
+  const char* state_topic;
+  const char* unit;
+  const char* device_class;  // nullptr: none
+  const char* unique_id;
+};
+
+const DiscoveryCase STATE_DISCOVERY[] = {
+    {TOPIC_TEMP_CONFIG, "Room Temperature", TOPIC_TEMP_STATE, "\u00b0C", "temperature", "room_monitor_temperature"},
+    {TOPIC_HUM_CONFIG, "Room Humidity", TOPIC_HUM_STATE, "%", "humidity", "room_monitor_humidity"},
+    {TOPIC_PRESSURE_CONFIG, "Room Pressure", TOPIC_PRESSURE_STATE, "hPa", "pressure", "room_monitor_pressure"},
+    {TOPIC_SOIL1_CONFIG, "Soil Moisture 1", TOPIC_SOIL1_STATE, "%", nullptr, "room_monitor_soil1"},
+    {TOPIC_SOIL2_CONFIG, "Soil Moisture 2", TOPIC_SOIL2_STATE, "%", nullptr, "room_monitor_soil2"},
+};
+
+// The document the String-based SendDiscoveryConfig() used to build.
+std::string LegacyDiscoveryJson(const DiscoveryCase& entry) {
+  const std::string device_json = std::string("{\"identifiers\":[\"") + DEVICE_ID + "\"],\"name\":\"" + DEVICE_NAME +
+                                  "\",\"model\":\"" + DEVICE_MODEL + "\",\"manufacturer\":\"" +
+                                  DEVICE_MANUFACTURER + "\"}";
+  std::string json = std::string("{") + "\"name\":\"" + entry.name + "\"," + "\"state_topic\":\"" +
+                     entry.state_topic + "\"," + "\"unit_of_measurement\":\"" + entry.unit + "\",";
+  if (entry.device_class != nullptr) {
+    json += std::string("\"device_class\":\"") + entry.device_class + "\",";
+  }
+  json += std::string("\"state_class\":\"measurement\",") + "\"unique_id\":\"" + entry.unique_id + "\"," +
+          "\"device\":" + device_json + "}";
+  return json;
+}
+
+// Minimal RFC 8259 syntax check: objects, arrays, strings, numbers,
+// literals.
+class JsonChecker {
+ public:
+  explicit JsonChecker(const std::string& text) : text_(text), pos_(0U) {}
+
+  bool IsValid() {
+    return Value() && (SkipSpace(), pos_ == text_.size());
+  }
+
+ private:
+  void SkipSpace() {
+    while ((pos_ < text_.size()) && isspace(static_cast<unsigned char>(text_[pos_]))) {
+      pos_++;
+    }
+  }
+  bool Take(const char c) {
+    SkipSpace();
+    if ((pos_ < text_.size()) && (text_[pos_] == c)) {
+      pos_++;
+      return true;
+    }
+    return false;
+  }
+  bool String() {
+    if (!Take('"')) {
+      return false;
+    }
+    while (pos_ < text_.size()) {
+      const unsigned char c = static_cast<unsigned char>(text_[pos_++]);
+      if (c == '"') {
+        return true;
+      }
+      if (c < 0x20U) {
+        return false;
+      }
+      if (c == '\\') {
+        if (pos_ >= text_.size()) {
+          return false;
+        }
+        const char escaped = text_[pos_++];
+        if (escaped == 'u') {
+          for (uint8_t i = 0U; i < 4U; i++) {
+            if ((pos_ >= text_.size()) || !isxdigit(static_cast<unsigned char>(text_[pos_++]))) {
+              return false;
+            }
+          }
+        } else if (strchr("\"\\/bfnrt", escaped) == nullptr) {
+          return false;
+        }
+      }
+    }
+    return false;
+  }
+  bool Number() {
+    SkipSpace();
+    const size_t start = pos_;
+    if ((pos_ < text_.size()) && (text_[pos_] == '-')) {
+      pos_++;
+    }
+    while ((pos_ < text_.size()) && (isdigit(static_cast<unsigned char>(text_[pos_])) || (strchr(".eE+-", text_[pos_]) != nullptr))) {
+      pos_++;
+    }
+    return (pos_ > start) && isdigit(static_cast<unsigned char>(text_[pos_ - 1U]));
+  }
+  bool Literal(const char* word) {
+    SkipSpace();
+    const size_t length = strlen(word);
+    if (text_.compare(pos_, length, word) != 0) {
+      return false;
+    }
+    pos_ += length;
+    return true;
+  }
+  bool Value() {
+    SkipSpace();
+    if (pos_ >= text_.size()) {
+      return false;
+    }
+    const char c = text_[pos_];
+    if (c == '{') {
+      pos_++;
+      if (Take('}')) {
+        return true;
+      }
+      do {
+        if (!String() || !Take(':') || !Value()) {
+          return false;
+        }
+      } while (Take(','));
+      return Take('}');
+    }
+    if (c == '[') {
+      pos_++;
+      if (Take(']')) {
+        return true;
+      }
+      do {
+        if (!Value()) {
+          return false;
+        }
+      } while (Take(','));
+      return Take(']');
+    }
+    if (c == '"') {
+      return String();
+    }
+    if ((c == 't') || (c == 'f') || (c == 'n')) {
+      return Literal("true") || Literal("false") || Literal("null");
+    }
+    return Number();
+  }
+
+  const std::string& text_;
+  size_t pos_;
+};
+
+bool IsOnline() {
+  return Broker()->GetRetained(TOPIC_TEMP_STATE) != nullptr;
+}
+
+// Every metric moves past its deadband from one cycle to the next, and the
+// first cycle is far from the default room the sketch has published.
+SensorData MakeData(const uint32_t cycle) {
+  const float step = static_cast<float>(cycle % 2UL);
+  SensorData data = {};
+  data.temperature_c = 30.0F + (step * 4.0F * MQTT_DEADBAND_TEMP_C);
+  data.humidity_pct = 70.0F + (step * 4.0F * MQTT_DEADBAND_HUM_PCT);
+  data.pressure_hpa = 990.0F + (step * 4.0F * MQTT_DEADBAND_PRESSURE_HPA);
+  data.soil1_pct = static_cast<uint8_t>(10.0F + (step * 4.0F * MQTT_DEADBAND_SOIL_PCT));
+  data.soil2_pct = static_cast<uint8_t>(90.0F + (step * 4.0F * MQTT_DEADBAND_SOIL_PCT));
+  return data;
+}
+
+class MqttManagerTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    HostSketch_Reset();
+    HostSketch_Setup();
+  }
+};
+}  // namespace
+
+TEST_F(MqttManagerTest, DiagnosticsFitThroughTheClient) {
+  const bool published = HostSketch_RunUntil(
+      []() { return Broker()->GetRetained(RoomMonitorConfig::TOPIC_DIAGNOSTICS) != nullptr; },
+      RoomMonitorConfig::DIAGNOSTICS_PUBLISH_INTERVAL_MS + RoomMonitorConfig::TASK_DIAGNOSTICS_PHASE_MS + 1000UL);
+  ASSERT_TRUE(published);
+  EXPECT_EQ(0U, Broker()->GetProtocolErrors()) << Broker()->GetLastError();
+
+  const std::string& payload = Broker()->GetRetained(RoomMonitorConfig::TOPIC_DIAGNOSTICS)->payload;
+  EXPECT_EQ('{', payload.front());
+  EXPECT_EQ('}', payload.back());
+  EXPECT_EQ(11, std::count(payload.begin(), payload.end(), ':'));
+  EXPECT_NE(std::string::npos, payload.find("\"sample_interval_ms\":"));
+}
+
+TEST_F(MqttManagerTest, PublishCycleDoesNotAllocate) {
+  ASSERT_TRUE(HostSketch_RunUntil(IsOnline, 60000UL));
+  const uint32_t publishes_before = Broker()->GetPacketCount(0x30U);
+
+  for (uint32_t cycle = 0UL; cycle < PUBLISH_CYCLES; cycle++) {
+    const SensorData data = MakeData(cycle);
+    HostHeap_StartCounting();
+    const bool published = MqttManager_PublishData(&data);
+    MqttManager_Loop();
+    const uint32_t allocations = HostHeap_StopCounting();
+    ASSERT_TRUE(published);
+    EXPECT_EQ(0UL, allocations) << "cycle " << cycle;
+  }
+  EXPECT_GE(Broker()->GetPacketCount(0x30U) - publishes_before, PUBLISH_CYCLES * SENSOR_FIELD_COUNT);
+  EXPECT_EQ(0U, Broker()->GetProtocolErrors()) << Broker()->GetLastError();
+}
+
+// Sensor, display, publish and reconnect tasks over a minute, including a
+// broker-side disconnect: the client ID and payloads come from static storage.
+TEST_F(MqttManagerTest, LoopAndReconnectDoNotAllocate) {
+  ASSERT_TRUE(HostSketch_RunUntil(IsOnline, 60000UL));
+  const uint32_t sessions_before = Broker()->GetSessionCount();
+
+  HostHeap_StartCounting();
+  HostSketch_RunFor(20000UL);
+  Broker()->DropSession();
+  HostSketch_RunFor(40000UL);
+  const uint32_t allocations = HostHeap_StopCounting();
+
+  EXPECT_EQ(0UL, allocations);
+  EXPECT_GT(Broker()->GetSessionCount(), sessions_before);
+  EXPECT_TRUE(Broker()->IsSessionOpen());
+}
+
+// Reconnect after a broker restart: discovery is streamed from flash, with
+// nothing on the heap and no document held in the MQTT buffer.
+TEST_F(MqttManagerTest, DiscoveryMatchesLegacyPayloads) {
+  ASSERT_TRUE(HostSketch_RunUntil(IsOnline, 60000UL));
+  Broker()->ClearMessages();
+  Broker()->DropSession();
+
+  HostHeap_StartCounting();
+  // The predicate runs while counting, so it must not copy messages.
+  const bool rediscovered = HostSketch_RunUntil(
+      []() {
+        const std::vector<HostMqttMessage>& messages = Broker()->GetMessages();
+        return std::any_of(messages.begin(), messages.end(), [](const HostMqttMessage& message) {
+          return message.topic == TOPIC_SOIL2_CONFIG;
+        });
+      },
+      60000UL);
+  const uint32_t allocations = HostHeap_StopCounting();
+  ASSERT_TRUE(rediscovered);
+  EXPECT_EQ(0UL, allocations);
+
+  size_t legacy_heap_bytes = 0U;
+  size_t largest_document = 0U;
+  for (const DiscoveryCase& entry : STATE_DISCOVERY) {
+    const std::vector<HostMqttMessage> messages = Broker()->GetMessagesOn(entry.topic);
+    ASSERT_EQ(1U, messages.size()) << entry.topic;
+    const std::string expected = LegacyDiscoveryJson(entry);
+    EXPECT_EQ(expected, messages.front().payload) << entry.topic;
+    EXPECT_TRUE(messages.front().retained) << entry.topic;
+    // The String path held every document (plus device_json) at once.
+    legacy_heap_bytes += expected.size() + 1U;
+    largest_document = std::max(largest_document, expected.size());
+  }
+
+  uint32_t documents = 0UL;
+  for (const HostMqttMessage& message : Broker()->GetMessages()) {
+    if (message.topic.compare(0U, 14U, "homeassistant/") == 0) {
+      documents++;
+      EXPECT_TRUE(JsonChecker(message.payload).IsValid()) << message.topic << ": " << message.payload;
+      largest_document = std::max(largest_document, message.payload.size());
+    }
+  }
+  printf("discovery: %u documents, largest %zu bytes\n", documents, largest_document);
+  printf("  before: %u byte MQTT buffer + >= %zu bytes of String heap per reconnect\n", 1024U, legacy_heap_bytes);
+  printf("  after:  %u byte MQTT buffer + 0 heap allocations\n", MQTT_BUFFER_SIZE_BYTES);
+  EXPECT_LT(MQTT_BUFFER_SIZE_BYTES, largest_document);
+}
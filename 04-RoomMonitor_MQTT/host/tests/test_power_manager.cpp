@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include "config.h"
+#include "fakes/host_clock.h"
+#include "hal.h"
+#include "hal_host.h"
+#include "power_manager.h"
+
+namespace {
+using namespace RoomMonitorConfig;
+
+void ServiceFor(const uint32_t duration_ms) {
+  for (uint32_t elapsed = 0UL; elapsed < duration_ms; elapsed += POWER_TASK_INTERVAL_MS) {
+    HostClock_AdvanceMs(POWER_TASK_INTERVAL_MS);
+    PowerManager_Service(millis());
+  }
+}
+
+uint32_t AssociatedRadioUa() {
+  return LOW_POWER_ENABLED ? POWER_RADIO_SAVE_UA : POWER_RADIO_ACTIVE_UA;
+}
+
+// Without idle time the MCU is charged as active throughout.
+uint32_t ExpectedUa(const uint32_t radio_ua) {
+  return POWER_MCU_ACTIVE_UA + POWER_DISPLAY_ON_UA + radio_ua;
+}
+}  // namespace
+
+// One sequence, since the estimate accumulates from boot.
+TEST(PowerManager, ChargesRadioPerState) {
+  HostHal_Reset();
+  HostHal_SetWifiAssociateMs(10000UL);
+  Hal_WifiBegin(WIFI_SSID, WIFI_PASSWORD);
+  PowerManager_Init(millis());
+
+  ServiceFor(10000UL);
+  ASSERT_TRUE(Hal_WifiIsConnected());
+  EXPECT_EQ(ExpectedUa(POWER_RADIO_JOIN_UA), PowerManager_AverageCurrentUa());
+
+  // Another 10 s associated: the average moves halfway, give or take the
+  // one interval charged at the old state.
+  ServiceFor(10000UL);
+  const uint32_t expected = (ExpectedUa(POWER_RADIO_JOIN_UA) + ExpectedUa(AssociatedRadioUa())) / 2UL;
+  const uint32_t slack = (POWER_RADIO_JOIN_UA - AssociatedRadioUa()) * POWER_TASK_INTERVAL_MS / 20000UL;
+  EXPECT_NEAR(expected, PowerManager_AverageCurrentUa(), slack);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "config.h"
+#include "display_service.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "readout_font.h"
+
+// The readout glyph runs against Adafruit GFX drawChar(), glyph by glyph and
+// across a whole dashboard frame.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+const char READOUT_CHARS[] = "0123456789.-";
+constexpr uint8_t MAX_TEXT_SIZE = 4U;
+// Fits the 6x8 verification canvas but not the static layer band.
+constexpr size_t FONT_ONLY_CANVAS_BYTES = 64U;
+
+struct GlyphDraw {
+  std::vector<uint16_t> pixels;
+  uint32_t calls;
+};
+
+GlyphDraw DrawWith(const bool use_font, const char c, const uint8_t size) {
+  HostDisplay display;
+  display.SetChargeClock(false);
+  display.fillScreen(DISPLAY_COLOR_BLACK);
+  display.ResetStats();
+  if (use_font) {
+    ReadoutFont_DrawGlyph(display, 7, 11, c, DISPLAY_COLOR_WHITE, size);
+  } else {
+    display.drawChar(7, 11, static_cast<unsigned char>(c), DISPLAY_COLOR_WHITE, DISPLAY_COLOR_WHITE, size);
+  }
+  return GlyphDraw{display.GetFramebuffer(), display.GetStats().calls};
+}
+
+SensorSnapshot MakeSnapshot() {
+  SensorSnapshot snapshot = {};
+  snapshot.seq = 1UL;
+  snapshot.valid_mask = static_cast<uint8_t>((1U << SENSOR_FIELD_COUNT) - 1U);
+  snapshot.data.temperature_c = -8.5F;
+  snapshot.data.humidity_pct = 45.0F;
+  snapshot.data.pressure_hpa = 1012.0F;
+  snapshot.data.soil1_pct = 40U;
+  snapshot.data.soil2_pct = 60U;
+  return snapshot;
+}
+
+GlyphDraw DrawDashboard(const size_t canvas_limit_bytes) {
+  HostHal_Reset();
+  HostClock_SetReadTickUs(0U);
+  HostHal_GetDisplay()->SetChargeClock(false);
+  HostGfx_SetCanvasLimitBytes(canvas_limit_bytes);
+  DisplayService_Init();
+  DisplayService_ShowBootText();
+  HostHal_GetDisplay()->ResetStats();
+  const SensorSnapshot snapshot = MakeSnapshot();
+  DisplayService_ShowData(&snapshot);
+  return GlyphDraw{HostHal_GetDisplay()->GetFramebuffer(), HostHal_GetDisplay()->GetStats().calls};
+}
+}  // namespace
+
+TEST(ReadoutFont, VerifiesAgainstGfxFont) {
+  ASSERT_TRUE(ReadoutFont_Verify());
+  for (const char* c = READOUT_CHARS; *c != '\0'; c++) {
+    EXPECT_TRUE(ReadoutFont_HasGlyph(*c)) << *c;
+  }
+  EXPECT_FALSE(ReadoutFont_HasGlyph('a'));
+  EXPECT_FALSE(ReadoutFont_HasGlyph(' '));
+}
+
+TEST(ReadoutFont, GlyphsArePixelIdenticalWithFewerCalls) {
+  ASSERT_TRUE(ReadoutFont_Verify());
+  for (uint8_t size = 1U; size <= MAX_TEXT_SIZE; size++) {
+    uint32_t font_calls = 0UL;
+    uint32_t gfx_calls = 0UL;
+    for (const char* c = READOUT_CHARS; *c != '\0'; c++) {
+      const GlyphDraw font = DrawWith(true, *c, size);
+      const GlyphDraw gfx = DrawWith(false, *c, size);
+      EXPECT_TRUE(font.pixels == gfx.pixels) << "'" << *c << "' at size " << static_cast<int>(size);
+      font_calls += font.calls;
+      gfx_calls += gfx.calls;
+    }
+    printf("size %u: %u rects vs %u drawChar primitives\n", size, font_calls, gfx_calls);
+    EXPECT_LT(font_calls * 2UL, gfx_calls) << static_cast<int>(size);
+  }
+}
+
+TEST(ReadoutFont, DashboardFrameMatchesDrawChar) {
+  const GlyphDraw font = DrawDashboard(FONT_ONLY_CANVAS_BYTES);
+  // A canvas limit below one glyph cell fails verification: drawChar only.
+  const GlyphDraw gfx = DrawDashboard(1U);
+  ASSERT_FALSE(ReadoutFont_HasGlyph('0'));
+
+  EXPECT_TRUE(font.pixels == gfx.pixels);
+  printf("full frame: %u draw calls with glyph runs, %u with drawChar\n", font.calls, gfx.calls);
+  EXPECT_LT(font.calls, gfx.calls);
+}
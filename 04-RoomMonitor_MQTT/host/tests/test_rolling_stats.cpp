@@ -0,0 +1,299 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "config.h"
+#include "data_model.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "rolling_stats.h"
+
+// The fixed-point windows against a double-precision reference fed the
+// same readings: a simulated day and a bit of noisy, drifting, partly
+// stale signals at the sensor task's cadence, queried every few minutes.
+// The reference covers exactly the buckets the ring holds, so the only
+// differences are the field resolution and the fixed-point arithmetic.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t RUN_MS = 26UL * 60UL * 60UL * 1000UL;
+constexpr uint32_t QUERY_INTERVAL_MS = 5UL * 60UL * 1000UL;
+constexpr double PI = 3.14159265358979323846;
+constexpr double DAY_MS = 24.0 * 60.0 * 60.0 * 1000.0;
+constexpr double MS_PER_HOUR = 3600000.0;
+const double FIELD_SCALE[SENSOR_FIELD_COUNT] = {100.0, 100.0, 10.0, 1.0, 1.0};
+const uint32_t WINDOW_MS[STATS_WINDOW_COUNT] = {
+    ROLLING_STATS_WINDOW_1M_MS, ROLLING_STATS_WINDOW_1H_MS, ROLLING_STATS_WINDOW_24H_MS};
+const char* const WINDOW_NAMES[STATS_WINDOW_COUNT] = {"1 min", "1 h", "24 h"};
+
+// Tolerances in units of each field's resolution. Rounding a reading to
+// the resolution moves min, max and mean by at most half a unit. The trend
+// may also move as far as half-unit errors in every bucket mean can push a
+// least-squares slope; beyond that only the Q8 arithmetic is left.
+constexpr double ROUNDING = 0.5;
+constexpr double STDDEV_TOLERANCE = 0.5;
+constexpr double TREND_TOLERANCE_PER_BUCKET = 0.01;
+
+struct Reading {
+  uint32_t ms;
+  double value;
+};
+
+struct Expected {
+  uint32_t count;
+  double min;
+  double max;
+  double mean;
+  double stddev;
+  double trend_per_hour;
+  double trend_rounding_per_bucket;  // in units of the resolution
+};
+
+// Every reading of one field, in double.
+class Reference {
+ public:
+  void Add(const uint32_t ms, const double value) {
+    readings_.push_back(Reading{ms, value});
+    while ((ms - readings_.front().ms) > (ROLLING_STATS_WINDOW_24H_MS + QUERY_INTERVAL_MS)) {
+      readings_.pop_front();
+    }
+  }
+
+  // The readings in the ROLLING_STATS_BUCKETS buckets ending with the one
+  // `now_ms` falls in.
+  bool Get(const uint32_t window_ms, const uint32_t now_ms, Expected* out) const {
+    const uint32_t span_ms = window_ms / ROLLING_STATS_BUCKETS;
+    const uint32_t epoch = now_ms / span_ms;
+    double sums[ROLLING_STATS_BUCKETS] = {};
+    uint32_t counts[ROLLING_STATS_BUCKETS] = {};
+    std::vector<double> values;
+    for (const Reading& reading : readings_) {
+      const uint32_t age = epoch - (reading.ms / span_ms);
+      if (age < ROLLING_STATS_BUCKETS) {
+        values.push_back(reading.value);
+        sums[age] += reading.value;
+        counts[age]++;
+      }
+    }
+    if (values.empty()) {
+      return false;
+    }
+
+    double sum = 0.0;
+    for (const double value : values) {
+      sum += value;
+    }
+    const double mean = sum / values.size();
+    double m2 = 0.0;
+    for (const double value : values) {
+      m2 += (value - mean) * (value - mean);
+    }
+    out->count = static_cast<uint32_t>(values.size());
+    out->min = *std::min_element(values.begin(), values.end());
+    out->max = *std::max_element(values.begin(), values.end());
+    out->mean = mean;
+    out->stddev = (values.size() > 1U) ? sqrt(m2 / (values.size() - 1U)) : 0.0;
+
+    // Least squares over the non-empty bucket means, oldest first. The
+    // slope is sum(c_i * y_i), so rounding moves it by up to
+    // ROUNDING * sum(|c_i|).
+    double points = 0.0;
+    double sum_x = 0.0;
+    double sum_xx = 0.0;
+    for (uint8_t age = 0U; age < ROLLING_STATS_BUCKETS; age++) {
+      if (counts[age] != 0UL) {
+        const double x = ROLLING_STATS_BUCKETS - 1U - age;
+        points += 1.0;
+        sum_x += x;
+        sum_xx += x * x;
+      }
+    }
+    const double denominator = (points * sum_xx) - (sum_x * sum_x);
+    double per_bucket = 0.0;
+    out->trend_rounding_per_bucket = 0.0;
+    for (uint8_t age = 0U; (points >= 2.0) && (denominator != 0.0) && (age < ROLLING_STATS_BUCKETS); age++) {
+      if (counts[age] != 0UL) {
+        const double weight = ((points * (ROLLING_STATS_BUCKETS - 1U - age)) - sum_x) / denominator;
+        per_bucket += weight * (sums[age] / counts[age]);
+        out->trend_rounding_per_bucket += ROUNDING * fabs(weight);
+      }
+    }
+    out->trend_per_hour = per_bucket * (MS_PER_HOUR / span_ms);
+    return true;
+  }
+
+ private:
+  std::deque<Reading> readings_;
+};
+
+struct MaxErrors {
+  double min_max;
+  double mean;
+  double stddev;
+  double trend_per_bucket;  // beyond what rounding allows
+  uint32_t queries;
+};
+
+// A room over a day: a daily temperature swing, faster humidity swings
+// with an hour of a stuck sensor, a falling barometer, and soil steps.
+SensorData Room(const uint32_t ms, std::mt19937* rng) {
+  std::normal_distribution<double> noise(0.0, 1.0);
+  const double day = ms / DAY_MS;
+  SensorData data = {};
+  data.temperature_c = static_cast<float>(21.0 + (3.0 * sin(2.0 * PI * day)) + (0.2 * noise(*rng)));
+  data.humidity_pct = static_cast<float>(45.0 + (10.0 * sin(8.0 * PI * day)) + noise(*rng));
+  data.pressure_hpa = static_cast<float>(1013.0 - (4.0 * day) + (0.3 * noise(*rng)));
+  data.soil1_pct = static_cast<uint8_t>(40.0 + lround(10.0 * sin(4.0 * PI * day)));
+  data.soil2_pct = static_cast<uint8_t>(55U + ((ms / 600000UL) % 3UL));
+  if ((ms >= (5UL * 3600000UL)) && (ms < (6UL * 3600000UL))) {
+    data.stale_mask |= 1U << SENSOR_FIELD_HUMIDITY;
+  }
+  if (((ms / 1000UL) % 97UL) == 0UL) {
+    data.stale_mask |= 1U << SENSOR_FIELD_SOIL2;
+  }
+  return data;
+}
+
+double FieldValue(const SensorData& data, const uint8_t field) {
+  switch (field) {
+    case SENSOR_FIELD_TEMPERATURE:
+      return data.temperature_c;
+    case SENSOR_FIELD_HUMIDITY:
+      return data.humidity_pct;
+    case SENSOR_FIELD_PRESSURE:
+      return data.pressure_hpa;
+    case SENSOR_FIELD_SOIL1:
+      return data.soil1_pct;
+    default:
+      return data.soil2_pct;
+  }
+}
+
+void Track(double* worst, const double error) {
+  *worst = std::max(*worst, fabs(error));
+}
+}  // namespace
+
+TEST(RollingStats, MatchesDoubleReferenceOverADay) {
+  HostHal_Reset();
+  std::mt19937 rng(2024U);
+  Reference references[SENSOR_FIELD_COUNT];
+  MaxErrors worst[SENSOR_FIELD_COUNT][STATS_WINDOW_COUNT] = {};
+  const uint32_t start_ms = millis();
+  uint32_t next_query_ms = start_ms + QUERY_INTERVAL_MS;
+
+  while ((millis() - start_ms) < RUN_MS) {
+    HostClock_AdvanceMs(DISPLAY_REFRESH_MS);
+    const uint32_t now_ms = millis();
+    const SensorData data = Room(now_ms - start_ms, &rng);
+    RollingStats_Add(&data, now_ms);
+    for (uint8_t field = 0U; field < SENSOR_FIELD_COUNT; field++) {
+      if ((data.stale_mask & (1U << field)) == 0U) {
+        references[field].Add(now_ms, FieldValue(data, field));
+      }
+    }
+    if (static_cast<int32_t>(now_ms - next_query_ms) < 0L) {
+      continue;
+    }
+    next_query_ms += QUERY_INTERVAL_MS;
+
+    for (uint8_t field = 0U; field < SENSOR_FIELD_COUNT; field++) {
+      const double unit = 1.0 / FIELD_SCALE[field];
+      for (uint8_t window = 0U; window < STATS_WINDOW_COUNT; window++) {
+        Expected expected = {};
+        StatsSummary summary = {};
+        const bool has_expected = references[field].Get(WINDOW_MS[window], now_ms, &expected);
+        ASSERT_EQ(has_expected,
+                  RollingStats_Get(static_cast<SensorField>(field), static_cast<StatsWindow>(window), &summary))
+            << "field " << static_cast<int>(field) << ", " << WINDOW_NAMES[window] << ", " << now_ms << " ms";
+        if (!has_expected) {
+          continue;
+        }
+        const double buckets_per_hour = MS_PER_HOUR / (WINDOW_MS[window] / ROLLING_STATS_BUCKETS);
+        MaxErrors* errors = &worst[field][window];
+        ASSERT_EQ(expected.count, summary.count);
+        Track(&errors->min_max, (summary.min - expected.min) / unit);
+        Track(&errors->min_max, (summary.max - expected.max) / unit);
+        Track(&errors->mean, (summary.mean - expected.mean) / unit);
+        Track(&errors->stddev, (summary.stddev - expected.stddev) / unit);
+        const double trend_error = ((summary.trend_per_hour - expected.trend_per_hour) / buckets_per_hour) / unit;
+        errors->trend_per_bucket =
+            std::max(errors->trend_per_bucket, fabs(trend_error) - expected.trend_rounding_per_bucket);
+        errors->queries++;
+      }
+    }
+  }
+
+  printf("  worst error in units of the field's resolution (trend: per bucket, beyond rounding)\n");
+  printf("  %-6s %-6s %8s %8s %8s %8s %8s\n", "field", "window", "queries", "min/max", "mean", "stddev", "trend/b");
+  for (uint8_t field = 0U; field < SENSOR_FIELD_COUNT; field++) {
+    for (uint8_t window = 0U; window < STATS_WINDOW_COUNT; window++) {
+      const MaxErrors& errors = worst[field][window];
+      printf("  %-6u %-6s %8u %8.3f %8.3f %8.3f %8.4f\n",
+             field,
+             WINDOW_NAMES[window],
+             errors.queries,
+             errors.min_max,
+             errors.mean,
+             errors.stddev,
+             errors.trend_per_bucket);
+      EXPECT_GT(errors.queries, 0UL);
+      EXPECT_LE(errors.min_max, ROUNDING + 1e-3);
+      EXPECT_LE(errors.mean, ROUNDING);
+      EXPECT_LE(errors.stddev, STDDEV_TOLERANCE);
+      EXPECT_LE(errors.trend_per_bucket, TREND_TOLERANCE_PER_BUCKET);
+    }
+  }
+}
+
+// A 4 h bucket at 1 Hz: a step of ten units after three hours still moves
+// the mean by a quarter of it.
+TEST(RollingStats, FullBucketsFollowSmallSteps) {
+  HostHal_Reset();
+  constexpr uint32_t SPAN_MS = ROLLING_STATS_WINDOW_24H_MS / ROLLING_STATS_BUCKETS;
+  HostClock_AdvanceMs(SPAN_MS - (millis() % SPAN_MS));
+  SensorData data = {};
+  for (uint32_t second = 0UL; second < (4UL * 3600UL); second++) {
+    data.temperature_c = (second < (3UL * 3600UL)) ? 20.0F : 20.1F;
+    RollingStats_Add(&data, millis());
+    HostClock_AdvanceMs(1000UL);
+  }
+
+  StatsSummary summary = {};
+  ASSERT_TRUE(RollingStats_Get(SENSOR_FIELD_TEMPERATURE, STATS_WINDOW_24H, &summary));
+  EXPECT_EQ(4UL * 3600UL, summary.count);
+  EXPECT_NEAR(20.025, summary.mean, 0.001);
+  EXPECT_NEAR(sqrt(0.1 * 0.1 * 0.25 * 0.75 * summary.count / (summary.count - 1UL)), summary.stddev, 0.001);
+}
+
+// The widest values a bucket can hold, as many times as it counts.
+TEST(RollingStats, SaturatedBucketsStayExact) {
+  HostHal_Reset();
+  HostClock_AdvanceMs(1000UL);
+  SensorData data = {};
+  constexpr uint32_t ADDS = 70000UL;
+  for (uint32_t i = 0UL; i < ADDS; i++) {
+    data.pressure_hpa = ((i % 2UL) == 0UL) ? 4000.0F : -4000.0F;
+    RollingStats_Add(&data, millis());
+  }
+
+  StatsSummary summary = {};
+  ASSERT_TRUE(RollingStats_Get(SENSOR_FIELD_PRESSURE, STATS_WINDOW_1M, &summary));
+  // Clamped to int16 in 0.1 hPa; the bucket stops counting at UINT16_MAX.
+  EXPECT_EQ(UINT16_MAX, summary.count);
+  EXPECT_FLOAT_EQ(3276.7F, summary.max);
+  EXPECT_FLOAT_EQ(-3276.8F, summary.min);
+  const double plus = (UINT16_MAX + 1UL) / 2UL;
+  const double minus = UINT16_MAX - plus;
+  const double mean = ((plus * 3276.7) - (minus * 3276.8)) / UINT16_MAX;
+  EXPECT_NEAR(mean, summary.mean, 0.01);
+  const double m2 = (plus * (3276.7 - mean) * (3276.7 - mean)) + (minus * (3276.8 + mean) * (3276.8 + mean));
+  EXPECT_NEAR(sqrt(m2 / (UINT16_MAX - 1UL)), summary.stddev, 0.01);
+}
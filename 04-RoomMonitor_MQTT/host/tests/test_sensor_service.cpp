@@ -0,0 +1,273 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "sensor_service.h"
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t STEP_AT_MS = 60000UL;
+
+void SampleFor(const uint32_t duration_ms) {
+  for (uint32_t elapsed = 0UL; elapsed < duration_ms; elapsed += SENSOR_SAMPLE_INTERVAL_MS) {
+    HostClock_AdvanceMs(SENSOR_SAMPLE_INTERVAL_MS);
+    (void)SensorService_Sample();
+  }
+}
+
+class SensorServiceTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    HostHal_Reset();
+    HostHal_SetSensorScript(HOST_SENSOR_TEMPERATURE, [](uint32_t now) { return (now < STEP_AT_MS) ? 20.0F : 25.0F; });
+    HostHal_SetSensorScript(HOST_SENSOR_PRESSURE, [](uint32_t now) { return (now < STEP_AT_MS) ? 1000.0F : 1010.0F; });
+    HostHal_SetSensorScript(HOST_SENSOR_SOIL1, [](uint32_t now) { return (now < STEP_AT_MS) ? 1023.0F : 512.0F; });
+    SensorService_Init();
+    SampleFor(STEP_AT_MS - millis());
+  }
+};
+}  // namespace
+
+// Lag per channel stays within the budget (or one period for slow
+// channels) plus the channel's phase against the step.
+TEST_F(SensorServiceTest, StepLatencyFollowsChannelPeriod) {
+  const SensorData& before = SensorService_GetSnapshot()->data;
+  ASSERT_FLOAT_EQ(20.0F, before.temperature_c);
+  ASSERT_EQ(0U, before.soil1_pct);
+
+  uint32_t temp_ms = UINT32_MAX;
+  uint32_t pressure_ms = UINT32_MAX;
+  uint32_t soil_ms = UINT32_MAX;
+  const uint32_t start = millis();
+  while ((millis() - start) < 60000UL) {
+    SampleFor(SENSOR_SAMPLE_INTERVAL_MS);
+    const SensorData& data = SensorService_GetSnapshot()->data;
+    const uint32_t elapsed = millis() - start;
+    if ((temp_ms == UINT32_MAX) && (data.temperature_c >= 22.5F)) {
+      temp_ms = elapsed;
+    }
+    if ((pressure_ms == UINT32_MAX) && (data.pressure_hpa >= 1005.0F)) {
+      pressure_ms = elapsed;
+    }
+    if ((soil_ms == UINT32_MAX) && (data.soil1_pct >= 25U)) {
+      soil_ms = elapsed;
+    }
+  }
+
+  EXPECT_LE(temp_ms, SENSOR_FILTER_MAX_DELAY_MS + SENSOR_TEMP_PERIOD_MS);
+  EXPECT_LE(pressure_ms, 2UL * SENSOR_PRESSURE_PERIOD_MS);
+  EXPECT_LE(soil_ms, 2UL * SENSOR_SOIL_PERIOD_MS);
+}
+
+TEST_F(SensorServiceTest, SettlesOnStepValue) {
+  SampleFor(60000UL);
+  const SensorData& after = SensorService_GetSnapshot()->data;
+  EXPECT_NEAR(25.0F, after.temperature_c, 0.01F);
+  EXPECT_NEAR(1010.0F, after.pressure_hpa, 0.01F);
+  EXPECT_EQ(50U, after.soil1_pct);
+}
+
+// Readings are steady by now: the published snapshot must not change
+// under a consumer, sample times included.
+TEST_F(SensorServiceTest, PublishedSnapshotIsNeverWrittenInPlace) {
+  const SensorSnapshot* published = SensorService_GetSnapshot();
+  const SensorSnapshot copy = *published;
+  SampleFor(30000UL);
+  ASSERT_EQ(published, SensorService_GetSnapshot());
+  EXPECT_EQ(copy.seq, published->seq);
+  EXPECT_EQ(0, memcmp(&copy, published, sizeof(copy)));
+}
+
+namespace {
+constexpr uint32_t SCHEDULE_RUN_MS = 10UL * 60UL * 1000UL;
+constexpr HostSensor FIELD_SENSORS[SENSOR_FIELD_COUNT] = {
+    HOST_SENSOR_TEMPERATURE, HOST_SENSOR_HUMIDITY, HOST_SENSOR_PRESSURE, HOST_SENSOR_SOIL1, HOST_SENSOR_SOIL2};
+constexpr const char* FIELD_NAMES[SENSOR_FIELD_COUNT] = {"temperature", "humidity", "pressure", "soil1", "soil2"};
+constexpr uint32_t FIELD_PERIODS_MS[SENSOR_FIELD_COUNT] = {
+    SENSOR_TEMP_PERIOD_MS, SENSOR_HUM_PERIOD_MS, SENSOR_PRESSURE_PERIOD_MS, SENSOR_SOIL_PERIOD_MS, SENSOR_SOIL_PERIOD_MS};
+
+// A channel released together with the others waits at most one sample
+// tick per channel ahead of it; each tick also carries the previous
+// pass's bus time (under a millisecond) and millis() truncation.
+constexpr uint32_t MAX_JITTER_MS = (SENSOR_FIELD_COUNT - 1U) * (SENSOR_SAMPLE_INTERVAL_MS + 2UL);
+
+struct ScheduleReport {
+  uint32_t samples[SENSOR_FIELD_COUNT];
+  uint32_t shortest_ms[SENSOR_FIELD_COUNT];
+  uint32_t longest_ms[SENSOR_FIELD_COUNT];
+  uint32_t worst_pass_us[SENSOR_FIELD_COUNT];
+  uint32_t multi_channel_passes;
+};
+
+// The sample task on its own for SCHEDULE_RUN_MS, recording per pass which
+// channels were read (from the carrier's read counters), the pass's
+// simulated time and the gaps between a channel's reads. The snapshot's
+// updated_ms only moves when a value does, so the gaps come from the pass
+// times.
+ScheduleReport RunSchedule() {
+  HostHal_Reset();
+  HostClock_SetReadTickUs(0U);
+  SensorService_Init();
+
+  ScheduleReport report = {};
+  uint32_t last_ms[SENSOR_FIELD_COUNT] = {};
+  for (uint8_t i = 0U; i < SENSOR_FIELD_COUNT; i++) {
+    report.shortest_ms[i] = UINT32_MAX;
+    last_ms[i] = millis();
+  }
+  while (millis() < SCHEDULE_RUN_MS) {
+    HostClock_AdvanceMs(SENSOR_SAMPLE_INTERVAL_MS);
+    uint32_t reads_before[SENSOR_FIELD_COUNT];
+    for (uint8_t i = 0U; i < SENSOR_FIELD_COUNT; i++) {
+      reads_before[i] = HostHal_GetSensorReads(FIELD_SENSORS[i]);
+    }
+    const uint32_t now_ms = millis();
+    const uint64_t start_us = HostClock_NowUs();
+    (void)SensorService_Sample();
+    const uint32_t pass_us = static_cast<uint32_t>(HostClock_NowUs() - start_us);
+
+    uint8_t channels_read = 0U;
+    for (uint8_t i = 0U; i < SENSOR_FIELD_COUNT; i++) {
+      if (HostHal_GetSensorReads(FIELD_SENSORS[i]) == reads_before[i]) {
+        continue;
+      }
+      channels_read++;
+      report.samples[i]++;
+      report.worst_pass_us[i] = (pass_us > report.worst_pass_us[i]) ? pass_us : report.worst_pass_us[i];
+      const uint32_t gap_ms = now_ms - last_ms[i];
+      report.shortest_ms[i] = (gap_ms < report.shortest_ms[i]) ? gap_ms : report.shortest_ms[i];
+      report.longest_ms[i] = (gap_ms > report.longest_ms[i]) ? gap_ms : report.longest_ms[i];
+      last_ms[i] = now_ms;
+    }
+    report.multi_channel_passes += (channels_read > 1U) ? 1UL : 0UL;
+  }
+  return report;
+}
+}  // namespace
+
+TEST(SensorSchedule, ChannelsKeepTheirOwnPeriodsOneReadPerPass) {
+  const ScheduleReport report = RunSchedule();
+
+  printf("  %-12s %8s %8s %10s %10s %10s\n", "channel", "period", "samples", "shortest", "longest", "worst pass");
+  uint32_t worst_pass_us = 0UL;
+  uint32_t all_channels_us = 0UL;
+  for (uint8_t i = 0U; i < SENSOR_FIELD_COUNT; i++) {
+    printf("  %-12s %5u ms %8u %7u ms %7u ms %7u us\n",
+           FIELD_NAMES[i],
+           FIELD_PERIODS_MS[i],
+           report.samples[i],
+           report.shortest_ms[i],
+           report.longest_ms[i],
+           report.worst_pass_us[i]);
+    EXPECT_NEAR(SCHEDULE_RUN_MS / FIELD_PERIODS_MS[i], report.samples[i], 1.0) << FIELD_NAMES[i];
+    EXPECT_GE(report.shortest_ms[i] + MAX_JITTER_MS, FIELD_PERIODS_MS[i]) << FIELD_NAMES[i];
+    EXPECT_LE(report.longest_ms[i], FIELD_PERIODS_MS[i] + MAX_JITTER_MS) << FIELD_NAMES[i];
+    worst_pass_us = (report.worst_pass_us[i] > worst_pass_us) ? report.worst_pass_us[i] : worst_pass_us;
+    all_channels_us += report.worst_pass_us[i];
+  }
+  printf("  worst pass %u us; every channel in one pass would take %u us\n", worst_pass_us, all_channels_us);
+  EXPECT_EQ(0UL, report.multi_channel_passes);
+  EXPECT_LT(worst_pass_us * 2UL, all_channels_us);
+}
+
+TEST(SensorSchedule, SlowBusOnlyDelaysItsOwnChannel) {
+  // A pressure sensor stuck in a 20 ms transaction: the other channels'
+  // passes stay at their own cost.
+  HostHal_Reset();
+  HostHal_SetSensorReadUs(HOST_SENSOR_PRESSURE, 20000UL);
+  HostClock_SetReadTickUs(0U);
+  SensorService_Init();
+
+  uint32_t worst_other_us = 0UL;
+  uint32_t worst_pressure_us = 0UL;
+  while (millis() < 60000UL) {
+    HostClock_AdvanceMs(SENSOR_SAMPLE_INTERVAL_MS);
+    const uint32_t pressure_before = HostHal_GetSensorReads(HOST_SENSOR_PRESSURE);
+    const uint64_t start_us = HostClock_NowUs();
+    (void)SensorService_Sample();
+    const uint32_t pass_us = static_cast<uint32_t>(HostClock_NowUs() - start_us);
+    uint32_t* worst = (HostHal_GetSensorReads(HOST_SENSOR_PRESSURE) != pressure_before) ? &worst_pressure_us
+                                                                                       : &worst_other_us;
+    *worst = (pass_us > *worst) ? pass_us : *worst;
+  }
+  EXPECT_GE(worst_pressure_us, 20000UL);
+  EXPECT_LT(worst_other_us, 1000UL);
+}
+
+namespace {
+constexpr uint32_t CONSISTENCY_RUN_MS = 10UL * 60UL * 1000UL;
+constexpr uint8_t ALL_FIELDS = static_cast<uint8_t>((1U << SENSOR_FIELD_COUNT) - 1U);
+
+float FieldOf(const SensorData& data, const uint8_t field) {
+  switch (field) {
+    case SENSOR_FIELD_TEMPERATURE:
+      return data.temperature_c;
+    case SENSOR_FIELD_HUMIDITY:
+      return data.humidity_pct;
+    case SENSOR_FIELD_PRESSURE:
+      return data.pressure_hpa;
+    case SENSOR_FIELD_SOIL1:
+      return data.soil1_pct;
+    default:
+      return data.soil2_pct;
+  }
+}
+}  // namespace
+
+// Readings that keep moving, checked after every sample pass: a snapshot
+// held from the pass before still reads the same, seq moves by one exactly
+// when the content does, and a field only changes value together with a
+// newer sample time.
+TEST(SensorSnapshot, StaysConsistentWhileReadingsMove) {
+  HostHal_Reset();
+  HostHal_SetSensorScript(HOST_SENSOR_TEMPERATURE, [](uint32_t now) { return 20.0F + ((now / 3000UL) % 10UL); });
+  HostHal_SetSensorScript(HOST_SENSOR_HUMIDITY, [](uint32_t now) { return ((now / 7000UL) % 2UL) ? 40.0F : 50.0F; });
+  HostHal_SetSensorScript(HOST_SENSOR_SOIL2, [](uint32_t now) { return 300.0F + ((now / 20000UL) % 3UL) * 100.0F; });
+  SensorService_Init();
+  // The service carries state over from the tests above; start from the
+  // first snapshot this run publishes.
+  const uint32_t seq_before = SensorService_GetSnapshot()->seq;
+  while ((SensorService_GetSnapshot()->seq == seq_before) && (millis() < SENSOR_TEMP_STALE_MS)) {
+    HostClock_AdvanceMs(SENSOR_SAMPLE_INTERVAL_MS);
+    (void)SensorService_Sample();
+  }
+
+  const SensorSnapshot* held = SensorService_GetSnapshot();
+  SensorSnapshot last = *held;
+  ASSERT_NE(seq_before, last.seq);
+  uint32_t passes = 0UL;
+  uint32_t flips = 0UL;
+  while (millis() < CONSISTENCY_RUN_MS) {
+    HostClock_AdvanceMs(SENSOR_SAMPLE_INTERVAL_MS);
+    (void)SensorService_Sample();
+    passes++;
+    ASSERT_EQ(0, memcmp(&last, held, sizeof(last))) << "held snapshot changed at " << millis() << " ms";
+
+    const SensorSnapshot* current = SensorService_GetSnapshot();
+    if (current->seq == last.seq) {
+      ASSERT_EQ(held, current);
+    } else {
+      ASSERT_EQ(last.seq + 1UL, current->seq);
+      ASSERT_NE(held, current);
+      ASSERT_EQ(ALL_FIELDS, current->valid_mask);
+      for (uint8_t field = 0U; field < SENSOR_FIELD_COUNT; field++) {
+        ASSERT_LE(current->data.updated_ms[field], millis());
+        ASSERT_GE(current->data.updated_ms[field], last.data.updated_ms[field]);
+        if (FieldOf(current->data, field) != FieldOf(last.data, field)) {
+          ASSERT_GT(current->data.updated_ms[field], last.data.updated_ms[field]) << static_cast<int>(field);
+        }
+      }
+      flips++;
+    }
+    held = current;
+    last = *current;
+  }
+  printf("  %u sample passes, %u snapshots published\n", passes, flips);
+  EXPECT_GT(flips, CONSISTENCY_RUN_MS / 20000UL);
+  EXPECT_LT(flips * 5UL, passes);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <string>
+
+#include "config.h"
+#include "data_model.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+#include "sensor_service.h"
+
+// The sketch's consumers against the sensor snapshot: serial output and
+// the MQTT state only do work when it moves. A steady room and a drifting
+// one run the same window, each in a forked child, and the work each
+// consumer did is counted against the snapshots published. The panel's
+// skip is checked frame by frame in test_display_service.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t SETTLE_MS = 2UL * 60UL * 1000UL;
+constexpr uint32_t WINDOW_MS = 10UL * 60UL * 1000UL;
+constexpr uint32_t FRAMES = WINDOW_MS / DISPLAY_REFRESH_MS;
+
+struct ConsumerWork {
+  uint32_t snapshots;
+  uint32_t serial_blocks;
+  uint32_t temperature_states;
+};
+
+uint32_t CountOf(const std::string& text, const char* needle) {
+  uint32_t count = 0UL;
+  for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1U)) {
+    count++;
+  }
+  return count;
+}
+
+size_t TemperatureStates() {
+  return HostHal_GetBroker()->GetMessagesOn(TOPIC_TEMP_STATE).size();
+}
+
+// Settles the filters, then counts one window of consumer work.
+bool RunRoom(const HostSensorScript& temperature, FILE* out) {
+  HostSketch_Reset();
+  if (temperature) {
+    HostHal_SetSensorScript(HOST_SENSOR_TEMPERATURE, temperature);
+  }
+  HostSerial_SetCapture(true);
+  HostSketch_Setup();
+  HostSketch_RunFor(SETTLE_MS);
+
+  (void)HostSerial_TakeOutput();
+  const uint32_t seq_before = SensorService_GetSnapshot()->seq;
+  const size_t states_before = TemperatureStates();
+  HostSketch_RunFor(WINDOW_MS);
+
+  const ConsumerWork work = {SensorService_GetSnapshot()->seq - seq_before,
+                             CountOf(HostSerial_Output(), "Temperature(C): "),
+                             static_cast<uint32_t>(TemperatureStates() - states_before)};
+  printf("  %4u snapshots, %4u of %u serial blocks, %3u temperature states\n",
+         work.snapshots,
+         work.serial_blocks,
+         FRAMES,
+         work.temperature_states);
+  return (fwrite(&work, sizeof(work), 1U, out) == 1U) && (fflush(out) == 0);
+}
+
+ConsumerWork ReadWork(FILE* in) {
+  rewind(in);
+  ConsumerWork work = {};
+  (void)fread(&work, sizeof(work), 1U, in);
+  return work;
+}
+}  // namespace
+
+TEST(SnapshotConsumers, SkipWorkWhileTheSnapshotIsUnchanged) {
+  FILE* out[2] = {tmpfile(), tmpfile()};
+  ASSERT_TRUE((out[0] != nullptr) && (out[1] != nullptr));
+  // A sawtooth of a degree a minute, in 0.1 degree steps.
+  const HostSensorScript drifting = [](uint32_t now_ms) { return 20.0F + ((now_ms / 6000UL) % 10UL) / 10.0F; };
+  ASSERT_TRUE(HostSketch_RunIsolated([&out]() { return RunRoom(nullptr, out[0]); }));
+  ASSERT_TRUE(HostSketch_RunIsolated([&out, &drifting]() { return RunRoom(drifting, out[1]); }));
+  const ConsumerWork steady = ReadWork(out[0]);
+  const ConsumerWork moving = ReadWork(out[1]);
+  fclose(out[0]);
+  fclose(out[1]);
+
+  // Nothing new: no serial output and only the heartbeat on MQTT.
+  EXPECT_EQ(0UL, steady.snapshots);
+  EXPECT_EQ(0UL, steady.serial_blocks);
+  EXPECT_LE(steady.temperature_states, (WINDOW_MS / MQTT_MAX_SILENCE_TEMP_MS) + 1UL);
+
+  // One serial block per sensor task run that saw a new snapshot.
+  EXPECT_GT(moving.snapshots, 0UL);
+  EXPECT_GT(moving.serial_blocks, 0UL);
+  EXPECT_LE(moving.serial_blocks, moving.snapshots);
+  EXPECT_LE(moving.serial_blocks, FRAMES);
+  EXPECT_GT(moving.temperature_states, steady.temperature_states);
+}
@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include "config.h"
+#include "fakes/host_clock.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+#include "task_scheduler.h"
+
+// The task table is global and append-only, so every test builds its
+// table in a forked child of the untouched process: the sketch's own
+// tasks, or a few test tasks with ids from 0.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t SKETCH_RUN_MS = 10UL * 60UL * 1000UL;
+
+uint32_t g_work_ms = 0UL;
+uint32_t g_runs = 0UL;
+
+// Tags of the WorkA/WorkB runs, in run order.
+char g_order[64];
+uint8_t g_order_length = 0U;
+
+class StdoutPrint : public Print {
+ public:
+  size_t write(uint8_t value) override {
+    return (fputc(value, stdout) == EOF) ? 0U : 1U;
+  }
+};
+
+void Work() {
+  g_runs++;
+  HostClock_AdvanceMs(g_work_ms);
+}
+
+void Record(const char tag) {
+  if (g_order_length < (sizeof(g_order) - 1U)) {
+    g_order[g_order_length++] = tag;
+    g_order[g_order_length] = '\0';
+  }
+}
+
+void WorkA() {
+  Record('a');
+  HostClock_AdvanceMs(g_work_ms);
+}
+
+void WorkB() {
+  Record('b');
+  HostClock_AdvanceMs(g_work_ms);
+}
+
+TaskStats GetStats(const uint8_t id) {
+  TaskStats stats = {};
+  EXPECT_TRUE(TaskScheduler_GetStats(id, &stats));
+  return stats;
+}
+
+// Runs `ms` of simulated time the way the sketch's loop() does, one
+// RunOnce() per pass and idle gaps skipped.
+void RunFor(const uint32_t ms) {
+  const uint32_t start_ms = millis();
+  while ((millis() - start_ms) < ms) {
+    (void)TaskScheduler_RunOnce(millis());
+    HostClock_AdvanceMs(TaskScheduler_MsUntilNextRelease(millis()));
+  }
+}
+
+bool RunSketchTable() {
+  HostSketch_Reset();
+  HostSketch_Setup();
+  HostSketch_RunFor(SKETCH_RUN_MS);
+
+  StdoutPrint out;
+  TaskScheduler_PrintStats(&out);
+  printf("loop passes %u, longest %u us\n", HostSketch_LoopCount(), HostSketch_MaxLoopUs());
+
+  bool ok = true;
+  TaskStats stats = {};
+  for (uint8_t id = 0U; TaskScheduler_GetStats(id, &stats); id++) {
+    // Every registered task ran and none missed a deadline in a steady room.
+    ok = ok && (stats.runs > 0UL) && (stats.missed == 0UL) && (stats.avg_us <= stats.max_us);
+  }
+  // One task per pass: the longest pass is the longest task, not a sum.
+  uint32_t longest_task_us = 0UL;
+  for (uint8_t id = 0U; TaskScheduler_GetStats(id, &stats); id++) {
+    longest_task_us = (stats.max_us > longest_task_us) ? stats.max_us : longest_task_us;
+  }
+  return ok && (HostSketch_MaxLoopUs() <= (longest_task_us + 1000UL));
+}
+
+// Runs `check` against a fresh task table; its failures print from the
+// child as usual.
+bool InFreshTable(void (*check)()) {
+  return HostSketch_RunIsolated([check]() {
+    check();
+    return !::testing::Test::HasFailure();
+  });
+}
+
+void CheckPhasesSpreadTasksOverPasses() {
+  HostClock_Reset();
+  HostClock_SetReadTickUs(0U);
+  g_work_ms = 0UL;
+  g_order_length = 0U;
+  const uint8_t a = TaskScheduler_Add("phase_a", WorkA, 100UL, 0UL, 50UL);
+  const uint8_t b = TaskScheduler_Add("phase_b", WorkB, 100UL, 0UL, 50UL);
+  ASSERT_NE(TASK_SCHEDULER_INVALID_ID, b);
+  TaskScheduler_Start(millis());
+
+  // Released together: one per RunOnce(), in registration order.
+  ASSERT_TRUE(TaskScheduler_RunOnce(millis()));
+  EXPECT_STREQ("a", g_order);
+  ASSERT_TRUE(TaskScheduler_RunOnce(millis()));
+  EXPECT_STREQ("ab", g_order);
+  EXPECT_FALSE(TaskScheduler_RunOnce(millis()));
+  EXPECT_EQ(100UL, TaskScheduler_MsUntilNextRelease(millis()));
+
+  // Releases at 100..900 ms.
+  RunFor(1000UL);
+  EXPECT_EQ(10UL, GetStats(a).runs);
+  EXPECT_EQ(10UL, GetStats(b).runs);
+  EXPECT_EQ(0UL, GetStats(a).missed + GetStats(b).missed);
+}
+
+void CheckLateRunsKeepThePhase() {
+  HostClock_Reset();
+  HostClock_SetReadTickUs(0U);
+  g_work_ms = 0UL;
+  const uint8_t id = TaskScheduler_Add("jitter", Work, 100UL, 30UL, 50UL);
+  ASSERT_NE(TASK_SCHEDULER_INVALID_ID, id);
+  TaskScheduler_Start(millis());
+
+  // Each release is serviced 0..40 ms late; releases stay on the grid.
+  for (uint32_t i = 0UL; i < 100UL; i++) {
+    HostClock_AdvanceMs(TaskScheduler_MsUntilNextRelease(millis()) + ((i * 7UL) % 41UL));
+    const uint32_t late_ms = (millis() - 30UL) % 100UL;
+    EXPECT_EQ((i * 7UL) % 41UL, late_ms) << "release " << i;
+    ASSERT_TRUE(TaskScheduler_RunOnce(millis()));
+  }
+  EXPECT_EQ(30UL + (100UL * 100UL), millis() + TaskScheduler_MsUntilNextRelease(millis()));
+  EXPECT_EQ(0UL, GetStats(id).missed);
+}
+
+void CheckStatsTrackAverageAndWorstDuration() {
+  HostClock_Reset();
+  HostClock_SetReadTickUs(0U);
+  const uint8_t id = TaskScheduler_Add("stats", Work, 100UL, 0UL, 50UL);
+  ASSERT_NE(TASK_SCHEDULER_INVALID_ID, id);
+  TaskScheduler_Start(millis());
+
+  const uint32_t work_ms[] = {2UL, 4UL, 12UL, 6UL};
+  for (const uint32_t ms : work_ms) {
+    HostClock_AdvanceMs(TaskScheduler_MsUntilNextRelease(millis()));
+    g_work_ms = ms;
+    ASSERT_TRUE(TaskScheduler_RunOnce(millis()));
+  }
+  const TaskStats stats = GetStats(id);
+  EXPECT_EQ(4UL, stats.runs);
+  EXPECT_EQ(6000UL, stats.avg_us);
+  EXPECT_EQ(12000UL, stats.max_us);
+  EXPECT_EQ(0UL, stats.missed);
+}
+
+void CheckLateReleaseCountsOnce() {
+  HostClock_Reset();
+  const uint8_t id = TaskScheduler_Add("late", Work, 100UL, 0UL, 50UL);
+  ASSERT_NE(TASK_SCHEDULER_INVALID_ID, id);
+  TaskScheduler_Start(millis());
+
+  // 350 ms of work: past the deadline and three releases swallowed.
+  g_work_ms = 350UL;
+  ASSERT_TRUE(TaskScheduler_RunOnce(millis()));
+  EXPECT_EQ(1UL, GetStats(id).missed);
+
+  // Back on time: no further misses, phase kept.
+  g_work_ms = 0UL;
+  HostClock_AdvanceMs(TaskScheduler_MsUntilNextRelease(millis()));
+  EXPECT_EQ(400UL, millis());
+  ASSERT_TRUE(TaskScheduler_RunOnce(millis()));
+  EXPECT_EQ(1UL, GetStats(id).missed);
+}
+
+void CheckZeroDeadlineMissesOnlyOnSkippedPeriod() {
+  HostClock_Reset();
+  const uint8_t id = TaskScheduler_Add("nodeadline", Work, 100UL, 0UL, 0UL);
+  ASSERT_NE(TASK_SCHEDULER_INVALID_ID, id);
+  TaskScheduler_Start(millis());
+
+  g_work_ms = 90UL;
+  ASSERT_TRUE(TaskScheduler_RunOnce(millis()));
+  EXPECT_EQ(0UL, GetStats(id).missed);
+
+  HostClock_AdvanceMs(TaskScheduler_MsUntilNextRelease(millis()));
+  g_work_ms = 250UL;
+  ASSERT_TRUE(TaskScheduler_RunOnce(millis()));
+  EXPECT_EQ(1UL, GetStats(id).missed);
+}
+
+void CheckShorterPeriodTakesEffectAtOnce() {
+  HostClock_Reset();
+  HostClock_SetReadTickUs(0U);
+  g_work_ms = 0UL;
+  const uint8_t id = TaskScheduler_Add("retune", Work, 10000UL, 0UL, 0UL);
+  ASSERT_NE(TASK_SCHEDULER_INVALID_ID, id);
+  TaskScheduler_Start(millis());
+  ASSERT_TRUE(TaskScheduler_RunOnce(millis()));
+  EXPECT_EQ(10000UL, TaskScheduler_MsUntilNextRelease(millis()));
+
+  HostClock_AdvanceMs(1000UL);
+  ASSERT_TRUE(TaskScheduler_SetPeriod(id, 2000UL, millis()));
+  EXPECT_EQ(2000UL, TaskScheduler_MsUntilNextRelease(millis()));
+  // A longer period leaves the pending release alone.
+  ASSERT_TRUE(TaskScheduler_SetPeriod(id, 60000UL, millis()));
+  EXPECT_EQ(2000UL, TaskScheduler_MsUntilNextRelease(millis()));
+  EXPECT_FALSE(TaskScheduler_SetPeriod(TASK_SCHEDULER_INVALID_ID, 1000UL, millis()));
+}
+}  // namespace
+
+TEST(TaskScheduler, SketchTimingTable) {
+  EXPECT_TRUE(HostSketch_RunIsolated(RunSketchTable));
+}
+
+TEST(TaskScheduler, PhasesSpreadTasksOverPasses) {
+  EXPECT_TRUE(InFreshTable(CheckPhasesSpreadTasksOverPasses));
+}
+
+TEST(TaskScheduler, LateRunsKeepThePhase) {
+  EXPECT_TRUE(InFreshTable(CheckLateRunsKeepThePhase));
+}
+
+TEST(TaskScheduler, StatsTrackAverageAndWorstDuration) {
+  EXPECT_TRUE(InFreshTable(CheckStatsTrackAverageAndWorstDuration));
+}
+
+TEST(TaskScheduler, LateReleaseCountsOnce) {
+  EXPECT_TRUE(InFreshTable(CheckLateReleaseCountsOnce));
+}
+
+TEST(TaskScheduler, ZeroDeadlineMissesOnlyOnSkippedPeriod) {
+  EXPECT_TRUE(InFreshTable(CheckZeroDeadlineMissesOnlyOnSkippedPeriod));
+}
+
+TEST(TaskScheduler, ShorterPeriodTakesEffectAtOnce) {
+  EXPECT_TRUE(InFreshTable(CheckShorterPeriodTakesEffectAtOnce));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "config.h"
+#include "hal_host.h"
+#include "host_sketch.h"
+#include "telemetry_buffer.h"
+
+// Store-and-forward through the sketch: boot without a network, then an
+// outage after the first connect.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t BOOT_OFFLINE_MS = 60000UL;
+constexpr uint32_t OUTAGE_MS = 60000UL;
+
+HostBroker* Broker() {
+  return HostHal_GetBroker();
+}
+
+bool IsOnline() {
+  return Broker()->GetRetained(TOPIC_TEMP_STATE) != nullptr;
+}
+
+// One device through an outage of `outage_ms` and the drain afterwards;
+// prints a report row and returns whether the replay behaved.
+bool RunOutage(const uint32_t outage_ms) {
+  HostSketch_Reset();
+  HostSketch_Setup();
+  if (!HostSketch_RunUntil(IsOnline, 60000UL)) {
+    return false;
+  }
+  HostSketch_RunFor(10000UL);
+
+  HostHal_SetWifiAvailable(false);
+  HostSketch_RunFor(outage_ms);
+  const uint16_t buffered = TelemetryBuffer_Count();
+  const uint32_t dropped = TelemetryBuffer_DroppedCount();
+
+  HostHal_SetWifiAvailable(true);
+  Broker()->ClearMessages();
+  const uint32_t reconnect_ms = millis();
+  const uint32_t drain_timeout_ms = 60000UL + (2UL * TELEMETRY_BUFFER_CAPACITY * TELEMETRY_DRAIN_INTERVAL_MS);
+  if (!HostSketch_RunUntil([]() { return TelemetryBuffer_Count() == 0U; }, drain_timeout_ms)) {
+    return false;
+  }
+  const uint32_t drain_ms = millis() - reconnect_ms;
+
+  const std::vector<HostMqttMessage> backlog = Broker()->GetMessagesOn(TOPIC_BACKLOG);
+  uint32_t closest_ms = UINT32_MAX;
+  for (size_t i = 1U; i < backlog.size(); i++) {
+    const uint32_t spacing_ms = backlog[i].received_ms - backlog[i - 1U].received_ms;
+    closest_ms = (spacing_ms < closest_ms) ? spacing_ms : closest_ms;
+  }
+  // Age of the oldest replayed sample at the moment the outage ended.
+  unsigned oldest_age_s = 0U;
+  if (!backlog.empty() && (sscanf(backlog[0].payload.c_str(), "{\"age_s\":%u", &oldest_age_s) == 1)) {
+    oldest_age_s -= (backlog[0].received_ms - reconnect_ms) / 1000UL;
+  }
+  printf("  %6u s %8u %8u %8zu %8u s %8u s %9u us\n",
+         outage_ms / 1000U,
+         buffered,
+         dropped,
+         backlog.size(),
+         oldest_age_s,
+         drain_ms / 1000U,
+         HostSketch_MaxLoopUs());
+
+  const uint32_t outage_s = outage_ms / 1000UL;
+  const uint32_t sample_s = PUBLISH_INTERVAL_MS / 1000UL;
+  return (backlog.size() == buffered) && (Broker()->GetProtocolErrors() == 0U) &&
+         ((backlog.size() < 2U) || (closest_ms >= TELEMETRY_DRAIN_INTERVAL_MS)) &&
+         // Decimation keeps the start of the outage however long it was.
+         ((oldest_age_s + (2UL * sample_s)) >= outage_s);
+}
+}  // namespace
+
+// Runs first: each outage forks a fresh device from the unbooted process.
+TEST(TelemetryBacklog, OutagesOfVaryingLengthReplayPaced) {
+  const uint32_t outages_ms[] = {
+      30UL * 1000UL, 10UL * 60UL * 1000UL, 60UL * 60UL * 1000UL, 6UL * 60UL * 60UL * 1000UL};
+  printf("  %8s %8s %8s %8s %10s %10s %12s\n", "outage", "buffered", "dropped", "replayed", "oldest", "drain", "max loop");
+  for (const uint32_t outage_ms : outages_ms) {
+    EXPECT_TRUE(HostSketch_RunIsolated([outage_ms]() { return RunOutage(outage_ms); })) << outage_ms << " ms outage";
+  }
+}
+
+TEST(TelemetryBacklog, BuffersOnlyAfterFirstConnect) {
+  HostSketch_Reset();
+  HostHal_SetWifiAvailable(false);
+  HostSketch_Setup();
+  HostSketch_RunFor(BOOT_OFFLINE_MS);
+  EXPECT_EQ(0U, TelemetryBuffer_Count());
+
+  HostHal_SetWifiAvailable(true);
+  ASSERT_TRUE(HostSketch_RunUntil(IsOnline, 60000UL));
+  HostSketch_RunFor(10000UL);
+  EXPECT_TRUE(Broker()->GetMessagesOn(TOPIC_BACKLOG).empty());
+
+  HostHal_SetWifiAvailable(false);
+  HostSketch_RunFor(OUTAGE_MS);
+  const uint16_t buffered = TelemetryBuffer_Count();
+  EXPECT_GE(buffered, (OUTAGE_MS / PUBLISH_INTERVAL_MS) - 1UL);
+
+  HostHal_SetWifiAvailable(true);
+  Broker()->ClearMessages();
+  ASSERT_TRUE(HostSketch_RunUntil([]() { return TelemetryBuffer_Count() == 0U; }, 120000UL));
+  EXPECT_EQ(buffered, Broker()->GetMessagesOn(TOPIC_BACKLOG).size());
+  EXPECT_EQ(0U, Broker()->GetProtocolErrors()) << Broker()->GetLastError();
+}
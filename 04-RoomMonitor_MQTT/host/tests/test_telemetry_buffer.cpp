@@ -0,0 +1,239 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include "config.h"
+#include "telemetry_buffer.h"
+
+// The ring buffer on its own, under both overflow policies. The policy is
+// a constexpr in config.h, so each policy gets its own copy of
+// telemetry_buffer.cpp in a namespace, with the policy name swapped by the
+// preprocessor. Its headers are already included above and stay out of the
+// namespaces.
+
+#define TELEMETRY_OVERFLOW_POLICY TelemetryOverflowPolicy::DROP_OLDEST
+namespace drop_oldest {
+#include "telemetry_buffer.cpp"
+}  // namespace drop_oldest
+#undef TELEMETRY_OVERFLOW_POLICY
+
+#define TELEMETRY_OVERFLOW_POLICY TelemetryOverflowPolicy::DECIMATE
+namespace decimate {
+#include "telemetry_buffer.cpp"
+}  // namespace decimate
+#undef TELEMETRY_OVERFLOW_POLICY
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr uint32_t SAMPLE_INTERVAL_MS = PUBLISH_INTERVAL_MS;
+
+// One policy's copy of the API.
+struct BufferApi {
+  const char* name;
+  void (*record)(const SensorData*, uint32_t);
+  bool (*peek_oldest)(BufferedSample*);
+  void (*drop_oldest)();
+  uint16_t (*count)();
+  uint32_t (*dropped_count)();
+};
+
+const BufferApi DROP_OLDEST_API = {"drop-oldest",
+                                   drop_oldest::TelemetryBuffer_Record,
+                                   drop_oldest::TelemetryBuffer_PeekOldest,
+                                   drop_oldest::TelemetryBuffer_DropOldest,
+                                   drop_oldest::TelemetryBuffer_Count,
+                                   drop_oldest::TelemetryBuffer_DroppedCount};
+const BufferApi DECIMATE_API = {"decimate",
+                                decimate::TelemetryBuffer_Record,
+                                decimate::TelemetryBuffer_PeekOldest,
+                                decimate::TelemetryBuffer_DropOldest,
+                                decimate::TelemetryBuffer_Count,
+                                decimate::TelemetryBuffer_DroppedCount};
+
+struct OutageResult {
+  uint32_t recorded;
+  uint16_t kept;
+  uint32_t dropped;
+  uint32_t oldest_s;
+  uint32_t newest_s;
+  uint32_t widest_gap_s;
+};
+
+SensorData MakeSample(const uint32_t index) {
+  SensorData data = {};
+  data.temperature_c = 18.0F + (0.1F * static_cast<float>(index % 50UL));
+  data.humidity_pct = 40.0F + static_cast<float>(index % 20UL);
+  data.pressure_hpa = 1000.0F + (0.1F * static_cast<float>(index % 100UL));
+  data.soil1_pct = static_cast<uint8_t>(index % 101UL);
+  data.soil2_pct = static_cast<uint8_t>(100UL - (index % 101UL));
+  return data;
+}
+
+void Empty(const BufferApi& api) {
+  while (api.count() > 0U) {
+    api.drop_oldest();
+  }
+}
+
+// Records one sample per publish interval for `outage_ms`, then drains
+// the buffer and reports what survived.
+OutageResult SimulateOutage(const BufferApi& api, const uint32_t outage_ms) {
+  Empty(api);
+  const uint32_t dropped_before = api.dropped_count();
+  OutageResult result = {};
+  for (uint32_t now_ms = 0UL; now_ms < outage_ms; now_ms += SAMPLE_INTERVAL_MS) {
+    const SensorData data = MakeSample(result.recorded);
+    api.record(&data, now_ms);
+    result.recorded++;
+  }
+  result.kept = api.count();
+  result.dropped = api.dropped_count() - dropped_before;
+
+  BufferedSample sample = {};
+  bool first = true;
+  while (api.peek_oldest(&sample)) {
+    if (first) {
+      result.oldest_s = sample.timestamp_s;
+    } else if ((sample.timestamp_s - result.newest_s) > result.widest_gap_s) {
+      result.widest_gap_s = sample.timestamp_s - result.newest_s;
+    }
+    first = false;
+    result.newest_s = sample.timestamp_s;
+    api.drop_oldest();
+  }
+  return result;
+}
+
+void ExpectNear(const SensorData& expected, const SensorData& actual) {
+  EXPECT_NEAR(expected.temperature_c, actual.temperature_c, 0.051F);
+  EXPECT_NEAR(expected.humidity_pct, actual.humidity_pct, 0.51F);
+  EXPECT_NEAR(expected.pressure_hpa, actual.pressure_hpa, 0.051F);
+  EXPECT_EQ(expected.soil1_pct, actual.soil1_pct);
+  EXPECT_EQ(expected.soil2_pct, actual.soil2_pct);
+}
+}  // namespace
+
+TEST(TelemetryBuffer, PackedSampleRoundTripsWithinOneStep) {
+  Empty(DECIMATE_API);
+  for (uint32_t index = 0UL; index < TELEMETRY_BUFFER_CAPACITY; index++) {
+    const SensorData data = MakeSample(index);
+    DECIMATE_API.record(&data, index * 1000UL);
+  }
+  for (uint32_t index = 0UL; index < TELEMETRY_BUFFER_CAPACITY; index++) {
+    BufferedSample sample = {};
+    ASSERT_TRUE(DECIMATE_API.peek_oldest(&sample));
+    EXPECT_EQ(index, sample.timestamp_s);
+    ExpectNear(MakeSample(index), sample.data);
+    DECIMATE_API.drop_oldest();
+  }
+  EXPECT_EQ(0U, DECIMATE_API.count());
+}
+
+TEST(TelemetryBuffer, OutOfRangeValuesClampToTheField) {
+  Empty(DROP_OLDEST_API);
+  SensorData cold = {};
+  cold.temperature_c = -60.0F;
+  cold.humidity_pct = -5.0F;
+  cold.pressure_hpa = 700.0F;
+  SensorData hot = {};
+  hot.temperature_c = 200.0F;
+  hot.humidity_pct = 140.0F;
+  hot.pressure_hpa = 1300.0F;
+  DROP_OLDEST_API.record(&cold, 0UL);
+  DROP_OLDEST_API.record(&hot, 0UL);
+
+  BufferedSample sample = {};
+  ASSERT_TRUE(DROP_OLDEST_API.peek_oldest(&sample));
+  EXPECT_NEAR(-40.0F, sample.data.temperature_c, 0.01F);
+  EXPECT_EQ(0.0F, sample.data.humidity_pct);
+  EXPECT_NEAR(800.0F, sample.data.pressure_hpa, 0.01F);
+  DROP_OLDEST_API.drop_oldest();
+  ASSERT_TRUE(DROP_OLDEST_API.peek_oldest(&sample));
+  EXPECT_GT(sample.data.temperature_c, 150.0F);
+  EXPECT_EQ(127.0F, sample.data.humidity_pct);
+  EXPECT_GT(sample.data.pressure_hpa, 1200.0F);
+  DROP_OLDEST_API.drop_oldest();
+}
+
+TEST(TelemetryBuffer, OutagesOfVaryingLength) {
+  const uint32_t outages_ms[] = {
+      60UL * 1000UL, 10UL * 60UL * 1000UL, 40UL * 60UL * 1000UL, 60UL * 60UL * 1000UL, 6UL * 60UL * 60UL * 1000UL};
+  const uint32_t capacity_span_s = (TELEMETRY_BUFFER_CAPACITY * SAMPLE_INTERVAL_MS) / 1000UL;
+  const uint32_t interval_s = SAMPLE_INTERVAL_MS / 1000UL;
+
+  printf("  %-11s %8s %8s %6s %7s %10s %10s %9s\n",
+         "policy",
+         "outage",
+         "recorded",
+         "kept",
+         "dropped",
+         "oldest",
+         "newest",
+         "widest");
+  for (const BufferApi* api : {&DROP_OLDEST_API, &DECIMATE_API}) {
+    for (const uint32_t outage_ms : outages_ms) {
+      const OutageResult result = SimulateOutage(*api, outage_ms);
+      const uint32_t last_s = ((outage_ms - 1UL) / SAMPLE_INTERVAL_MS) * interval_s;
+      printf("  %-11s %6u s %8u %6u %7u %8u s %8u s %7u s\n",
+             api->name,
+             outage_ms / 1000U,
+             result.recorded,
+             result.kept,
+             result.dropped,
+             result.oldest_s,
+             result.newest_s,
+             result.widest_gap_s);
+
+      EXPECT_LE(result.kept, TELEMETRY_BUFFER_CAPACITY);
+      EXPECT_EQ(result.recorded, result.kept + result.dropped) << api->name;
+      if (result.recorded <= TELEMETRY_BUFFER_CAPACITY) {
+        // Fits: nothing lost under either policy.
+        EXPECT_EQ(0UL, result.dropped) << api->name;
+        EXPECT_EQ(0UL, result.oldest_s);
+        EXPECT_EQ(last_s, result.newest_s);
+        EXPECT_EQ(interval_s, result.widest_gap_s);
+      } else if (api == &DROP_OLDEST_API) {
+        // The most recent capacity's worth, at full resolution.
+        EXPECT_EQ(TELEMETRY_BUFFER_CAPACITY, result.kept);
+        EXPECT_EQ(last_s, result.newest_s);
+        EXPECT_EQ(last_s - capacity_span_s + interval_s, result.oldest_s);
+        EXPECT_EQ(interval_s, result.widest_gap_s);
+      } else {
+        // The whole outage, at a coarser resolution.
+        EXPECT_EQ(0UL, result.oldest_s);
+        EXPECT_GE(result.kept, TELEMETRY_BUFFER_CAPACITY / 2U);
+        EXPECT_LE(last_s - result.newest_s, result.widest_gap_s);
+        EXPECT_LE(result.widest_gap_s * TELEMETRY_BUFFER_CAPACITY, 2UL * (outage_ms / 1000UL));
+      }
+    }
+  }
+}
+
+TEST(TelemetryBuffer, DrainingRestoresFullRate) {
+  // A long outage leaves decimate recording every n-th sample ...
+  (void)SimulateOutage(DECIMATE_API, 6UL * 60UL * 60UL * 1000UL);
+  // ... until the buffer has been emptied.
+  const OutageResult result = SimulateOutage(DECIMATE_API, 60UL * 1000UL);
+  EXPECT_EQ(result.recorded, result.kept);
+  EXPECT_EQ(SAMPLE_INTERVAL_MS / 1000UL, result.widest_gap_s);
+}
+
+TEST(TelemetryBuffer, AgeIsExactAcrossTheMillisWrap) {
+  Empty(DECIMATE_API);
+  const uint32_t before_wrap_ms = UINT32_MAX - 4500UL;
+  for (uint32_t i = 0UL; i < 4UL; i++) {
+    const SensorData data = MakeSample(i);
+    DECIMATE_API.record(&data, static_cast<uint32_t>(before_wrap_ms + (i * SAMPLE_INTERVAL_MS)));
+  }
+  // Past the wrap: millis() has restarted from zero.
+  const uint32_t now_ms = static_cast<uint32_t>(before_wrap_ms + (4UL * SAMPLE_INTERVAL_MS));
+  const uint32_t interval_s = SAMPLE_INTERVAL_MS / 1000UL;
+
+  BufferedSample sample = {};
+  for (uint32_t i = 0UL; i < 4UL; i++) {
+    ASSERT_TRUE(DECIMATE_API.peek_oldest(&sample));
+    EXPECT_EQ((4UL - i) * interval_s, decimate::TelemetryBuffer_AgeSeconds(&sample, now_ms)) << i;
+    DECIMATE_API.drop_oldest();
+  }
+}
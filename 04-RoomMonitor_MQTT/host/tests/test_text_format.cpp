@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <random>
+#include <string>
+
+#include "config.h"
+#include "text_format.h"
+
+// TextFormat_Float against printf over the values the sketch formats, and
+// its one documented difference: exact binary ties round away from zero.
+
+namespace {
+constexpr size_t CAPACITY = 24U;
+constexpr uint8_t MAX_DECIMALS = 6U;
+constexpr uint32_t SWEEP_VALUES = 200000UL;
+
+std::string Format(const float value, const uint8_t decimals, const size_t capacity = CAPACITY) {
+  char text[CAPACITY] = {};
+  const size_t length = TextFormat_Float(text, capacity, value, decimals);
+  EXPECT_EQ(strlen(text), length);
+  return (length > 0U) ? std::string(text) : std::string();
+}
+
+std::string Printf(const float value, const uint8_t decimals) {
+  char text[64];
+  snprintf(text, sizeof(text), "%.*f", decimals, static_cast<double>(value));
+  return text;
+}
+
+// The float's exact value times 10^decimals ends in exactly .5.
+bool IsExactTie(const float value, const uint8_t decimals) {
+  const double scaled = fabs(static_cast<double>(value)) * pow(10.0, decimals);
+  return (scaled - floor(scaled)) == 0.5;
+}
+}  // namespace
+
+TEST(TextFormat, ExactTiesRoundAwayFromZero) {
+  EXPECT_EQ("17.13", Format(17.125F, 2U));
+  EXPECT_EQ("-17.13", Format(-17.125F, 2U));
+  EXPECT_EQ("0.3", Format(0.25F, 1U));
+  EXPECT_EQ("1", Format(0.5F, 0U));
+  EXPECT_EQ("3", Format(2.5F, 0U));
+  EXPECT_EQ("-3", Format(-2.5F, 0U));
+  // printf rounds this one to even: 1013.2.
+  EXPECT_EQ("1013.3", Format(1013.25F, 1U));
+}
+
+// Values whose decimal form ends in 5 are not ties as floats; the exact
+// value decides, as it does for printf.
+TEST(TextFormat, NearTiesFollowTheFloatsExactValue) {
+  EXPECT_EQ(Printf(267.835F, 2U), Format(267.835F, 2U));
+  EXPECT_EQ("267.83", Format(267.835F, 2U));
+  EXPECT_EQ(Printf(0.15F, 1U), Format(0.15F, 1U));
+  EXPECT_EQ(Printf(-21.45F, 1U), Format(-21.45F, 1U));
+}
+
+TEST(TextFormat, MatchesPrintfAwayFromTies) {
+  std::mt19937 rng(5U);
+  std::uniform_real_distribution<float> magnitude(-2000.0F, 2000.0F);
+  uint32_t ties = 0UL;
+  for (uint32_t i = 0UL; i < SWEEP_VALUES; i++) {
+    const float value = magnitude(rng);
+    const uint8_t decimals = static_cast<uint8_t>(i % (MAX_DECIMALS + 1U));
+    if (IsExactTie(value, decimals)) {
+      ties++;
+      continue;
+    }
+    ASSERT_EQ(Printf(value, decimals), Format(value, decimals)) << value << " at " << static_cast<int>(decimals);
+  }
+  // Integers and small fractions; the published precision on every value
+  // a sensor reading can take.
+  for (int32_t tenths = -4000; tenths <= 11000; tenths++) {
+    const float value = static_cast<float>(tenths) / 10.0F;
+    if (!IsExactTie(value, RoomMonitorConfig::FLOAT_DECIMALS)) {
+      ASSERT_EQ(Printf(value, RoomMonitorConfig::FLOAT_DECIMALS), Format(value, RoomMonitorConfig::FLOAT_DECIMALS))
+          << value;
+    }
+  }
+  printf("  %u random values, %u exact ties skipped\n", SWEEP_VALUES, ties);
+}
+
+TEST(TextFormat, TinyAndSubnormalValuesRoundToZero) {
+  EXPECT_EQ("0.00", Format(0.004F, 2U));
+  EXPECT_EQ("0.01", Format(0.006F, 2U));
+  // Just below the tie as a float.
+  EXPECT_EQ("0.00", Format(0.005F, 2U));
+  EXPECT_EQ("0.000000", Format(1.0e-30F, 6U));
+  EXPECT_EQ("0.000000", Format(1.0e-45F, 6U));
+  EXPECT_EQ("-0.0", Format(-0.04F, 1U));
+}
+
+TEST(TextFormat, OutOfRangeAndSpecialValues) {
+  EXPECT_EQ("nan", Format(NAN, 1U));
+  EXPECT_EQ("inf", Format(INFINITY, 1U));
+  EXPECT_EQ("-inf", Format(-INFINITY, 1U));
+  // The largest float below 2^32 still fits; 2^32 does not.
+  EXPECT_EQ("4294967040", Format(4294967040.0F, 0U));
+  EXPECT_EQ("", Format(4294967296.0F, 0U));
+  EXPECT_EQ("", Format(5.0e3F, 6U));
+  EXPECT_EQ("", Format(1.0F, MAX_DECIMALS + 1U));
+  // "21.5" and its terminator need five bytes.
+  EXPECT_EQ("", Format(21.5F, 1U, 4U));
+  EXPECT_EQ("21.5", Format(21.5F, 1U, 5U));
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+
+#include "config.h"
+#include "trig_table.h"
+
+// The Q15 tables against libm, at every pixel length the gauge uses.
+
+namespace {
+using namespace RoomMonitorConfig;
+
+constexpr float DEG_TO_RAD = 0.017453292519943295F;
+constexpr int16_t MAX_LENGTH_PX = (DISPLAY_SIZE_PX / 2) - DISPLAY_OUTER_MARGIN;
+
+int16_t FloatScale(const float factor, const int16_t length) {
+  return static_cast<int16_t>(lroundf(factor * static_cast<float>(length)));
+}
+}  // namespace
+
+TEST(TrigTable, FactorsMatchLibmToOneLsb) {
+  for (int32_t degrees = -360L; degrees <= 720L; degrees++) {
+    const float radians = static_cast<float>(degrees) * DEG_TO_RAD;
+    EXPECT_NEAR(sinf(radians) * TrigTable::Q15_ONE, TrigTable::SinQ15(degrees), 1.0F) << degrees;
+    EXPECT_NEAR(cosf(radians) * TrigTable::Q15_ONE, TrigTable::CosQ15(degrees), 1.0F) << degrees;
+  }
+}
+
+TEST(TrigTable, EndpointsWithinOnePixel) {
+  for (int32_t degrees = 0L; degrees < 360L; degrees++) {
+    const float radians = static_cast<float>(degrees) * DEG_TO_RAD;
+    for (int16_t length = 1; length <= MAX_LENGTH_PX; length++) {
+      EXPECT_LE(abs(TrigTable::ScaleQ15(TrigTable::CosQ15(degrees), length) - FloatScale(cosf(radians), length)), 1)
+          << degrees << " deg, " << length << " px";
+      EXPECT_LE(abs(TrigTable::ScaleQ15(TrigTable::SinQ15(degrees), length) - FloatScale(sinf(radians), length)), 1)
+          << degrees << " deg, " << length << " px";
+    }
+  }
+}
+
+// The needle quantises to DISPLAY_NEEDLE_ANGLE_STEPS across the sweep; each
+// step has to land on a whole degree for the table to cover it exactly.
+TEST(TrigTable, NeedleStepsAreWholeDegrees) {
+  const float sweep = DISPLAY_GAUGE_END_DEG - DISPLAY_GAUGE_START_DEG;
+  for (uint16_t step = 0U; step <= DISPLAY_NEEDLE_ANGLE_STEPS; step++) {
+    const float degrees = DISPLAY_GAUGE_START_DEG + ((sweep * step) / DISPLAY_NEEDLE_ANGLE_STEPS);
+    EXPECT_FLOAT_EQ(roundf(degrees), degrees) << step;
+  }
+}
+
+TEST(TrigTable, ScaleRoundsSymmetrically) {
+  EXPECT_EQ(0, TrigTable::ScaleQ15(0, MAX_LENGTH_PX));
+  EXPECT_EQ(MAX_LENGTH_PX, TrigTable::ScaleQ15(TrigTable::Q15_ONE, MAX_LENGTH_PX));
+  EXPECT_EQ(-MAX_LENGTH_PX, TrigTable::ScaleQ15(static_cast<int16_t>(-TrigTable::Q15_ONE), MAX_LENGTH_PX));
+  for (int32_t factor = -TrigTable::Q15_ONE; factor <= TrigTable::Q15_ONE; factor += 97L) {
+    EXPECT_EQ(
+        -TrigTable::ScaleQ15(static_cast<int16_t>(factor), 90), TrigTable::ScaleQ15(static_cast<int16_t>(-factor), 90))
+        << factor;
+  }
+}
@@ -0,0 +1,23 @@
+#include "boot_profiler.h"
+
+namespace {
+uint32_t g_marked_ms[BOOT_MILESTONE_COUNT] = {};
+uint8_t g_marked_mask = 0U;
+static_assert(BOOT_MILESTONE_COUNT <= 8U, "Milestone mask is a uint8_t");
+}  // namespace
+
+void BootProfiler_Mark(const BootMilestone milestone) {
+  if ((milestone >= BOOT_MILESTONE_COUNT) || BootProfiler_IsMarked(milestone)) {
+    return;
+  }
+  g_marked_ms[milestone] = millis();
+  g_marked_mask = static_cast<uint8_t>(g_marked_mask | (1U << milestone));
+}
+
+bool BootProfiler_IsMarked(const BootMilestone milestone) {
+  return (milestone < BOOT_MILESTONE_COUNT) && ((g_marked_mask & (1U << milestone)) != 0U);
+}
+
+uint32_t BootProfiler_GetMs(const BootMilestone milestone) {
+  return BootProfiler_IsMarked(milestone) ? g_marked_ms[milestone] : 0UL;
+}
@@ -0,0 +1,23 @@
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+#include <Arduino.h>
+
+enum BootMilestone : uint8_t {
+  BOOT_MILESTONE_SENSOR_READY = 0U,
+  BOOT_MILESTONE_FIRST_FRAME,
+  BOOT_MILESTONE_WIFI_UP,
+  BOOT_MILESTONE_MQTT_CONNECTED,
+  BOOT_MILESTONE_DISCOVERY_DONE,
+  BOOT_MILESTONE_FIRST_PUBLISH,
+  BOOT_MILESTONE_COUNT
+};
+
+// Records millis() the first time each milestone is reached; later calls
+// (reconnects, redraws) are ignored, so the marks describe this boot only.
+void BootProfiler_Mark(BootMilestone milestone);
+bool BootProfiler_IsMarked(BootMilestone milestone);
+// millis() at the mark, 0 while the milestone is unreached.
+uint32_t BootProfiler_GetMs(BootMilestone milestone);
+
+#endif  // BOOT_PROFILER_H
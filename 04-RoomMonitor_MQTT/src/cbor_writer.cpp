@@ -0,0 +1,72 @@
+#include "cbor_writer.h"
+
+namespace {
+constexpr uint8_t MAJOR_UNSIGNED = 0U;
+constexpr uint8_t MAJOR_NEGATIVE = 1U;
+constexpr uint8_t MAJOR_MAP = 5U;
+constexpr uint8_t MAJOR_SHIFT = 5U;
+
+constexpr uint8_t INFO_DIRECT_MAX = 23U;
+constexpr uint8_t INFO_UINT8 = 24U;
+constexpr uint8_t INFO_UINT16 = 25U;
+constexpr uint8_t INFO_UINT32 = 26U;
+
+void PutByte(CborWriter* writer, const uint8_t value) {
+  if (writer->length >= writer->capacity) {
+    writer->overflow = true;
+    return;
+  }
+  writer->buffer[writer->length++] = value;
+}
+
+// Initial byte plus the shortest big-endian argument that holds |value|.
+void PutHead(CborWriter* writer, const uint8_t major, const uint32_t value) {
+  const uint8_t type = static_cast<uint8_t>(major << MAJOR_SHIFT);
+  if (value <= INFO_DIRECT_MAX) {
+    PutByte(writer, static_cast<uint8_t>(type | value));
+    return;
+  }
+
+  uint8_t bytes = 4U;
+  uint8_t info = INFO_UINT32;
+  if (value <= UINT8_MAX) {
+    bytes = 1U;
+    info = INFO_UINT8;
+  } else if (value <= UINT16_MAX) {
+    bytes = 2U;
+    info = INFO_UINT16;
+  }
+  PutByte(writer, static_cast<uint8_t>(type | info));
+  for (uint8_t i = bytes; i > 0U; i--) {
+    PutByte(writer, static_cast<uint8_t>(value >> (8U * (i - 1U))));
+  }
+}
+}  // namespace
+
+void CborWriter_Init(CborWriter* writer, uint8_t* buffer, const size_t capacity) {
+  writer->buffer = buffer;
+  writer->capacity = capacity;
+  writer->length = 0U;
+  writer->overflow = false;
+}
+
+void CborWriter_BeginMap(CborWriter* writer, const uint8_t pair_count) {
+  PutHead(writer, MAJOR_MAP, pair_count);
+}
+
+void CborWriter_PutUnsigned(CborWriter* writer, const uint32_t value) {
+  PutHead(writer, MAJOR_UNSIGNED, value);
+}
+
+// CBOR stores a negative n as -1 - n, which avoids overflowing INT32_MIN.
+void CborWriter_PutSigned(CborWriter* writer, const int32_t value) {
+  if (value >= 0L) {
+    PutHead(writer, MAJOR_UNSIGNED, static_cast<uint32_t>(value));
+  } else {
+    PutHead(writer, MAJOR_NEGATIVE, static_cast<uint32_t>(-(value + 1L)));
+  }
+}
+
+size_t CborWriter_Finish(const CborWriter* writer) {
+  return writer->overflow ? 0U : writer->length;
+}
@@ -0,0 +1,24 @@
+#ifndef CBOR_WRITER_H
+#define CBOR_WRITER_H
+
+#include <Arduino.h>
+
+// Allocation-free CBOR (RFC 8949) encoder for the definite-length maps and
+// integers the binary state payload uses. Writes go into a caller buffer;
+// once one does not fit, the writer is marked overflowed and ignores the rest.
+struct CborWriter {
+  uint8_t* buffer;
+  size_t capacity;
+  size_t length;
+  bool overflow;
+};
+
+void CborWriter_Init(CborWriter* writer, uint8_t* buffer, size_t capacity);
+void CborWriter_BeginMap(CborWriter* writer, uint8_t pair_count);
+void CborWriter_PutUnsigned(CborWriter* writer, uint32_t value);
+void CborWriter_PutSigned(CborWriter* writer, int32_t value);
+
+// Encoded length, or 0 if the buffer overflowed.
+size_t CborWriter_Finish(const CborWriter* writer);
+
+#endif  // CBOR_WRITER_H
@@ -27,6 +27,26 @@ constexpr const char* TOPIC_HUM_STATE = "home/room_monitor/humidity";
 constexpr const char* TOPIC_PRESSURE_STATE = "home/room_monitor/pressure";
 constexpr const char* TOPIC_SOIL1_STATE = "home/room_monitor/soil1";
 constexpr const char* TOPIC_SOIL2_STATE = "home/room_monitor/soil2";
+constexpr const char* TOPIC_STATE = "home/room_monitor/state";
+constexpr const char* TOPIC_STATE_BIN = "home/room_monitor/state/bin";
+constexpr const char* TOPIC_STATS_TEMP = "home/room_monitor/stats/temperature";
+constexpr const char* TOPIC_STATS_HUM = "home/room_monitor/stats/humidity";
+constexpr const char* TOPIC_STATS_PRESSURE = "home/room_monitor/stats/pressure";
+constexpr const char* TOPIC_STATS_SOIL1 = "home/room_monitor/stats/soil1";
+constexpr const char* TOPIC_STATS_SOIL2 = "home/room_monitor/stats/soil2";
+// No discovery on purpose: an entity would record each replayed sample at
+// its arrival time. The expected consumer is a timestamped import (e.g.
+// into a recorder or time-series store) that stamps each sample at
+// arrival minus its age_s field.
+constexpr const char* TOPIC_BACKLOG = "home/room_monitor/backlog";
+constexpr const char* TOPIC_DIAGNOSTICS = "home/room_monitor/diagnostics";
+constexpr const char* TOPIC_BOOT = "home/room_monitor/boot";
+
+// false: one retained message per state topic above.
+// true: one JSON object on TOPIC_STATE, discovery uses value_template.
+constexpr bool MQTT_BATCHED_STATE = false;
+// true: also publish a fixed-point CBOR snapshot on TOPIC_STATE_BIN.
+constexpr bool MQTT_BINARY_STATE = false;
 
 // Home Assistant discovery topics
 constexpr const char* TOPIC_TEMP_CONFIG = "homeassistant/sensor/room_monitor_temperature/config";
@@ -34,23 +54,168 @@ constexpr const char* TOPIC_HUM_CONFIG = "homeassistant/sensor/room_monitor_humi
 constexpr const char* TOPIC_PRESSURE_CONFIG = "homeassistant/sensor/room_monitor_pressure/config";
 constexpr const char* TOPIC_SOIL1_CONFIG = "homeassistant/sensor/room_monitor_soil1/config";
 constexpr const char* TOPIC_SOIL2_CONFIG = "homeassistant/sensor/room_monitor_soil2/config";
+constexpr const char* TOPIC_STATS_TEMP_MIN_CONFIG = "homeassistant/sensor/room_monitor_temperature_min_24h/config";
+constexpr const char* TOPIC_STATS_TEMP_MAX_CONFIG = "homeassistant/sensor/room_monitor_temperature_max_24h/config";
+constexpr const char* TOPIC_STATS_TEMP_TREND_CONFIG = "homeassistant/sensor/room_monitor_temperature_trend_1h/config";
+constexpr const char* TOPIC_STATS_HUM_MIN_CONFIG = "homeassistant/sensor/room_monitor_humidity_min_24h/config";
+constexpr const char* TOPIC_STATS_HUM_MAX_CONFIG = "homeassistant/sensor/room_monitor_humidity_max_24h/config";
+constexpr const char* TOPIC_STATS_PRESSURE_MIN_CONFIG = "homeassistant/sensor/room_monitor_pressure_min_24h/config";
+constexpr const char* TOPIC_STATS_PRESSURE_MAX_CONFIG = "homeassistant/sensor/room_monitor_pressure_max_24h/config";
+constexpr const char* TOPIC_STATS_PRESSURE_TREND_CONFIG = "homeassistant/sensor/room_monitor_pressure_trend_1h/config";
+constexpr const char* TOPIC_STATS_SOIL1_MIN_CONFIG = "homeassistant/sensor/room_monitor_soil1_min_24h/config";
+constexpr const char* TOPIC_STATS_SOIL1_MAX_CONFIG = "homeassistant/sensor/room_monitor_soil1_max_24h/config";
+constexpr const char* TOPIC_STATS_SOIL2_MIN_CONFIG = "homeassistant/sensor/room_monitor_soil2_min_24h/config";
+constexpr const char* TOPIC_STATS_SOIL2_MAX_CONFIG = "homeassistant/sensor/room_monitor_soil2_max_24h/config";
+constexpr const char* TOPIC_DIAG_LOOP_MAX_CONFIG = "homeassistant/sensor/room_monitor_loop_max_us/config";
+constexpr const char* TOPIC_DIAG_LOOP_HZ_CONFIG = "homeassistant/sensor/room_monitor_loop_hz/config";
+constexpr const char* TOPIC_DIAG_FREE_RAM_CONFIG = "homeassistant/sensor/room_monitor_free_ram_min/config";
+constexpr const char* TOPIC_DIAG_SENSOR_P99_CONFIG = "homeassistant/sensor/room_monitor_sensor_p99_us/config";
+constexpr const char* TOPIC_DIAG_DISPLAY_P99_CONFIG = "homeassistant/sensor/room_monitor_display_p99_us/config";
+constexpr const char* TOPIC_DIAG_PUBLISH_P99_CONFIG = "homeassistant/sensor/room_monitor_publish_p99_us/config";
+constexpr const char* TOPIC_DIAG_MQTT_P99_CONFIG = "homeassistant/sensor/room_monitor_mqtt_p99_us/config";
+constexpr const char* TOPIC_DIAG_AVG_CURRENT_CONFIG = "homeassistant/sensor/room_monitor_avg_current_ua/config";
+constexpr const char* TOPIC_DIAG_LOG_DROPPED_CONFIG = "homeassistant/sensor/room_monitor_log_dropped/config";
+constexpr const char* TOPIC_DIAG_PUBLISH_INTERVAL_CONFIG = "homeassistant/sensor/room_monitor_publish_interval_ms/config";
+constexpr const char* TOPIC_DIAG_SAMPLE_INTERVAL_CONFIG = "homeassistant/sensor/room_monitor_sample_interval_ms/config";
+constexpr const char* TOPIC_DIAG_BOOT_PUBLISH_CONFIG = "homeassistant/sensor/room_monitor_boot_first_publish_ms/config";
 
 // Timing and retry parameters
 constexpr uint32_t PUBLISH_INTERVAL_MS = 10UL * 1000UL;
 constexpr uint32_t DISPLAY_REFRESH_MS = 1000UL;
 constexpr uint32_t DISPLAY_HEARTBEAT_BLINK_MS = 500UL;
 constexpr uint32_t DISPLAY_GAUGE_MODE_SWITCH_MS = 1000UL;
+constexpr uint32_t MQTT_SERVICE_INTERVAL_MS = 20UL;
 constexpr uint32_t WIFI_RETRY_DELAY_MS = 500UL;
 constexpr uint8_t WIFI_MAX_RETRIES = 20U;
+constexpr uint32_t WIFI_ASSOCIATE_TIMEOUT_MS = 15000UL;
 constexpr uint32_t MQTT_RETRY_DELAY_MS = 5000UL;
 constexpr uint32_t MQTT_RETRY_MAX_DELAY_MS = 60000UL;
-constexpr uint16_t MQTT_BUFFER_SIZE_BYTES = 1024U;
+constexpr uint32_t MQTT_TCP_CONNECT_TIMEOUT_MS = 5000UL;
+constexpr bool MQTT_FLEET_JITTER_ENABLED = true;  // MAC-seeded publish phase and reconnect jitter
+constexpr uint32_t MQTT_RECONNECT_JITTER_MAX_MS = 10000UL;
+constexpr uint32_t MQTT_CONNACK_TIMEOUT_MS = 5000UL;  // polled once per link step, never waited on
+constexpr uint16_t MQTT_SOCKET_TIMEOUT_S = 1U;  // bounds reading a packet that has started to arrive
+constexpr uint16_t MQTT_BUFFER_SIZE_BYTES = 256U;  // state messages only, discovery is streamed
+constexpr size_t MQTT_DISCOVERY_CHUNK_BYTES = 64U;
+constexpr uint16_t MQTT_KEEPALIVE_S = 15U;
+
+// MQTT client: false uses PubSubClient (MQTT 3.1.1, QoS 0); true uses the
+// built-in static-buffer MQTT 5 client with QoS 1 and topic aliases.
+constexpr bool MQTT_USE_LITE_CLIENT = false;
+constexpr uint8_t MQTT_LITE_PUBLISH_QOS = 1U;
+constexpr uint8_t MQTT_LITE_INFLIGHT_WINDOW = 6U;  // one publish cycle: five state topics plus state/bin
+constexpr uint8_t MQTT_LITE_TOPIC_ALIAS_SLOTS = 8U;
+constexpr uint32_t MQTT_LITE_PUBACK_TIMEOUT_MS = 10000UL;
+constexpr uint8_t MQTT_LITE_PUBACK_RESENDS = 2U;  // DUP resends before a message counts as unacked
+constexpr size_t MQTT_STATE_JSON_CAPACITY = 128U;
+constexpr size_t MQTT_LITE_RESEND_PAYLOAD_BYTES = MQTT_STATE_JSON_CAPACITY;  // larger payloads are sent once
+constexpr size_t MQTT_STATE_CBOR_CAPACITY = 32U;
+
+// Cooperative scheduler: phases spread tasks sharing a period across
+// loop() passes, deadlines (0 = none) count late completions as missed.
+constexpr uint8_t TASK_SCHEDULER_CAPACITY = 10U;
+constexpr uint32_t TASK_SAMPLE_PHASE_MS = 50UL;
+constexpr uint32_t TASK_SENSOR_PHASE_MS = 0UL;
+constexpr uint32_t TASK_DISPLAY_PHASE_MS = 100UL;
+constexpr uint32_t TASK_PUBLISH_PHASE_MS = 300UL;
+constexpr uint32_t TASK_MQTT_PHASE_MS = 10UL;
+constexpr uint32_t TASK_SAMPLE_DEADLINE_MS = 50UL;
+constexpr uint32_t TASK_SENSOR_DEADLINE_MS = 100UL;
+constexpr uint32_t TASK_DISPLAY_DEADLINE_MS = 250UL;
+constexpr uint32_t TASK_PUBLISH_DEADLINE_MS = 500UL;
+constexpr uint32_t TASK_MQTT_DEADLINE_MS = 0UL;
+constexpr bool TASK_STATS_PRINT_ENABLED = false;
+constexpr uint32_t TASK_STATS_PRINT_INTERVAL_MS = 60UL * 1000UL;
+
+// Instrumentation: false turns ScopedTimer into an empty object and drops
+// the diagnostics topic together with its discovery entities.
+constexpr bool INSTRUMENTATION_ENABLED = true;
+constexpr uint8_t INSTRUMENT_HISTOGRAM_BUCKETS = 20U;  // log2 us, last bucket >= 0.5 s
+constexpr uint32_t DIAGNOSTICS_PUBLISH_INTERVAL_MS = 60UL * 1000UL;
+constexpr uint32_t TASK_DIAGNOSTICS_PHASE_MS = 700UL;
+
+// Report-by-exception: at each publish tick a metric is only sent when it
+// moved by at least its deadband, or when it has been silent for its
+// max-silence interval (which doubles as the keepalive).
+constexpr float MQTT_DEADBAND_TEMP_C = 0.1F;
+constexpr float MQTT_DEADBAND_HUM_PCT = 1.0F;
+constexpr float MQTT_DEADBAND_PRESSURE_HPA = 0.5F;
+constexpr float MQTT_DEADBAND_SOIL_PCT = 2.0F;
+constexpr uint32_t MQTT_MAX_SILENCE_TEMP_MS = 5UL * 60UL * 1000UL;
+constexpr uint32_t MQTT_MAX_SILENCE_HUM_MS = 5UL * 60UL * 1000UL;
+constexpr uint32_t MQTT_MAX_SILENCE_PRESSURE_MS = 5UL * 60UL * 1000UL;
+constexpr uint32_t MQTT_MAX_SILENCE_SOIL_MS = 15UL * 60UL * 1000UL;
+
+// Adaptive rate: per field, a sample that moved by half a deadband or more
+// runs the channel 2^FAST_SHIFT times faster than its period below, each
+// sample that moved by under a quarter doubles the period back, up to
+// 2^SLOW_SHIFT times slower. The publish interval follows the fastest field.
+constexpr bool ADAPTIVE_RATE_ENABLED = false;
+constexpr uint8_t ADAPTIVE_RATE_FAST_SHIFT = 2U;
+constexpr uint8_t ADAPTIVE_RATE_SLOW_SHIFT = 1U;
+
+// Rolling statistics over 1 min, 1 h and 24 h, fed once per sensor task
+// run. Every field's stats topic carries all windows and is republished
+// round-robin, so the whole set refreshes once per publish interval.
+constexpr bool ROLLING_STATS_ENABLED = true;
+constexpr uint8_t ROLLING_STATS_BUCKETS = 6U;
+constexpr uint32_t ROLLING_STATS_WINDOW_1M_MS = 60UL * 1000UL;
+constexpr uint32_t ROLLING_STATS_WINDOW_1H_MS = 60UL * 60UL * 1000UL;
+constexpr uint32_t ROLLING_STATS_WINDOW_24H_MS = 24UL * 60UL * 60UL * 1000UL;
+constexpr size_t ROLLING_STATS_MEMORY_BUDGET_BYTES = 2304U;
+constexpr uint32_t ROLLING_STATS_PUBLISH_INTERVAL_MS = 60UL * 1000UL;
+constexpr uint32_t TASK_ROLLING_STATS_PHASE_MS = 800UL;
+
+// Offline store-and-forward: samples taken while disconnected are kept
+// (8 bytes each) and replayed on TOPIC_BACKLOG one per drain interval.
+enum class TelemetryOverflowPolicy : uint8_t { DROP_OLDEST, DECIMATE };
+constexpr uint16_t TELEMETRY_BUFFER_CAPACITY = 256U;
+constexpr TelemetryOverflowPolicy TELEMETRY_OVERFLOW_POLICY = TelemetryOverflowPolicy::DECIMATE;
+constexpr uint32_t TELEMETRY_DRAIN_INTERVAL_MS = 250UL;
+
+// Low-power mode: the MCU waits in WFI between scheduled tasks, the NINA
+// radio runs its power-save mode, due sensor channels are read in one
+// batch per wake and the display sleeps after a period without a touch on
+// the carrier pads. The power task polls the pads and integrates the
+// estimated current below into the avg_current_ua diagnostic.
+constexpr bool LOW_POWER_ENABLED = false;
+constexpr uint32_t LOW_POWER_SAMPLE_INTERVAL_MS = 2000UL;
+constexpr uint32_t LOW_POWER_MQTT_SERVICE_INTERVAL_MS = 250UL;
+constexpr uint32_t LOW_POWER_DISPLAY_SLEEP_AFTER_MS = 30UL * 1000UL;
+constexpr uint32_t POWER_TASK_INTERVAL_MS = 250UL;
+constexpr uint32_t TASK_POWER_PHASE_MS = 200UL;
+
+// Supply current estimates per state (uA), board-level rough figures.
+constexpr uint32_t POWER_MCU_ACTIVE_UA = 7000UL;
+constexpr uint32_t POWER_MCU_IDLE_UA = 3000UL;
+constexpr uint32_t POWER_DISPLAY_ON_UA = 25000UL;
+constexpr uint32_t POWER_DISPLAY_SLEEP_UA = 1000UL;
+constexpr uint32_t POWER_RADIO_JOIN_UA = 110000UL;  // scanning and associating
+constexpr uint32_t POWER_RADIO_ACTIVE_UA = 90000UL;  // associated, receiver always on
+constexpr uint32_t POWER_RADIO_SAVE_UA = 25000UL;  // associated, NINA power-save
 
 // Serial and numeric formatting
 constexpr uint32_t SERIAL_BAUD_RATE = 9600UL;
+
+// Fast boot: Wi-Fi association starts before the carrier and sensors are
+// brought up, the boot screen is not held, the first MQTT attempt skips the
+// retry delay and the first state goes out as soon as the link is online.
+// setup() only waits for a serial monitor with FAST_BOOT_SERIAL_WAIT (for
+// debugging boot). Milestones are published once on TOPIC_BOOT.
+constexpr bool FAST_BOOT_ENABLED = true;
+constexpr bool FAST_BOOT_SERIAL_WAIT = false;
+constexpr uint32_t BOOT_FIRST_PUBLISH_TARGET_MS = 5000UL;
+constexpr size_t MQTT_BOOT_JSON_CAPACITY = 192U;
+
+// Logging: lines queue in a RAM ring that drains to Serial only as TX
+// space frees up; a line that does not fit is dropped and counted.
+// LOG_LEVEL: 0 none, 1 error, 2 warn, 3 info, 4 debug. Calls above it
+// compile to nothing.
+constexpr uint8_t LOG_LEVEL = 3U;
+constexpr size_t LOG_RING_CAPACITY = 512U;
+constexpr size_t LOG_LINE_CAPACITY = 96U;
 constexpr uint8_t FLOAT_DECIMALS = 1U;
 constexpr uint8_t MAC_ADDRESS_LENGTH = 6U;
-constexpr uint8_t HEX_ZERO_PAD_THRESHOLD = 16U;
 
 // Sensor pins and mapping
 constexpr pin_size_t SOIL1_PIN = A5;
@@ -61,6 +226,31 @@ constexpr int SOIL_PERCENT_MIN = 0;
 constexpr int SOIL_PERCENT_MAX = 100;
 constexpr float KPA_TO_HPA_FACTOR = 10.0F;
 
+// Sensor filtering: burst ADC oversampling for soil, then per channel a
+// median-of-N spike filter and an EMA with alpha = 1 / 2^shift. A channel
+// gets the largest N and shift up to the values below whose lag,
+// (N - 1) / 2 + 2^shift - 1 samples at its base period, fits
+// SENSOR_FILTER_MAX_DELAY_MS (or one period, for slower channels): median
+// of 5 and shift 1 for temperature and humidity (6 s), median of 3 and no
+// EMA for pressure (5 s) and soil (10 s).
+constexpr uint32_t SENSOR_SAMPLE_INTERVAL_MS = 100UL;
+constexpr uint8_t SENSOR_ADC_OVERSAMPLE_COUNT = 16U;
+constexpr uint8_t SENSOR_MEDIAN_WINDOW = 5U;
+constexpr uint32_t SENSOR_FILTER_MAX_DELAY_MS = 6000UL;
+constexpr uint8_t SENSOR_EMA_SHIFT_SOIL = 1U;
+constexpr uint8_t SENSOR_EMA_SHIFT_ENV = 1U;
+
+// Per-channel schedules: each sample tick reads at most one due channel,
+// a value older than its stale limit is flagged in SensorData::stale_mask.
+constexpr uint32_t SENSOR_TEMP_PERIOD_MS = 2000UL;
+constexpr uint32_t SENSOR_HUM_PERIOD_MS = 2000UL;
+constexpr uint32_t SENSOR_PRESSURE_PERIOD_MS = 5000UL;
+constexpr uint32_t SENSOR_SOIL_PERIOD_MS = 10000UL;
+constexpr uint32_t SENSOR_TEMP_STALE_MS = 3UL * SENSOR_TEMP_PERIOD_MS;
+constexpr uint32_t SENSOR_HUM_STALE_MS = 3UL * SENSOR_HUM_PERIOD_MS;
+constexpr uint32_t SENSOR_PRESSURE_STALE_MS = 3UL * SENSOR_PRESSURE_PERIOD_MS;
+constexpr uint32_t SENSOR_SOIL_STALE_MS = 3UL * SENSOR_SOIL_PERIOD_MS;
+
 // Display colors and layout
 constexpr uint16_t DISPLAY_COLOR_WHITE = 0xFFFFU;
 constexpr uint16_t DISPLAY_COLOR_RED = 0xF800U;
@@ -77,11 +267,15 @@ constexpr int16_t DISPLAY_BOOT_Y = 80;
 constexpr int16_t DISPLAY_DATA_X = 10;
 constexpr int16_t DISPLAY_DATA_Y = 20;
 constexpr uint32_t DISPLAY_BOOT_HOLD_MS = 1500UL;
+constexpr int16_t DISPLAY_SIZE_PX = 240;  // MKR IoT Carrier round TFT is 240x240
 constexpr int16_t DISPLAY_OUTER_MARGIN = 12;
 constexpr int16_t DISPLAY_GAUGE_RING_OFFSET = 24;
 constexpr int16_t DISPLAY_GAUGE_TICK_INNER_OFFSET = 10;
 constexpr int16_t DISPLAY_GAUGE_TICK_OUTER_OFFSET = 2;
 constexpr uint8_t DISPLAY_GAUGE_TICK_COUNT = 10U;
+constexpr uint16_t DISPLAY_NEEDLE_ANGLE_STEPS = 270U;
+constexpr uint16_t DISPLAY_STATIC_SPAN_CAPACITY = 1024U;
+constexpr int16_t DISPLAY_STATIC_BAND_ROWS = 16;
 constexpr int16_t DISPLAY_GAUGE_NEEDLE_OFFSET = 30;
 constexpr int16_t DISPLAY_NEEDLE_CENTER_RADIUS = 5;
 constexpr int16_t DISPLAY_HEARTBEAT_OFFSET_X = 12;
@@ -113,7 +307,17 @@ constexpr float DISPLAY_PRESSURE_MIN_HPA = 950.0F;
 constexpr float DISPLAY_PRESSURE_MAX_HPA = 1050.0F;
 constexpr float DISPLAY_GAUGE_START_DEG = 135.0F;
 constexpr float DISPLAY_GAUGE_END_DEG = 405.0F;
-constexpr float DISPLAY_DEG_TO_RAD = 0.01745329252F;
+
+// Marks the 24 h min and max just outside the gauge ring.
+constexpr bool DISPLAY_STATS_BAND_ENABLED = false;
+constexpr int16_t DISPLAY_STATS_BAND_OFFSET = 6;
+constexpr int16_t DISPLAY_STATS_BAND_RADIUS = 2;
+
+// Display profiler: wraps the display to count primitives, pixels and
+// estimated SPI bytes per dashboard section, reported every N frames.
+constexpr bool DISPLAY_PROFILER_ENABLED = false;
+constexpr bool DISPLAY_PROFILER_TRACE = false;  // one Serial line per primitive
+constexpr uint32_t DISPLAY_PROFILER_REPORT_FRAMES = 10UL;
 
 }  // namespace RoomMonitorConfig
 
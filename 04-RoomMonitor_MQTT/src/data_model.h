@@ -3,12 +3,34 @@
 
 #include <Arduino.h>
 
+enum SensorField : uint8_t {
+  SENSOR_FIELD_TEMPERATURE = 0U,
+  SENSOR_FIELD_HUMIDITY,
+  SENSOR_FIELD_PRESSURE,
+  SENSOR_FIELD_SOIL1,
+  SENSOR_FIELD_SOIL2,
+  SENSOR_FIELD_COUNT
+};
+
 struct SensorData {
   float temperature_c;
   float humidity_pct;
   float pressure_hpa;
   uint8_t soil1_pct;
   uint8_t soil2_pct;
+  // millis() of the last sample per SensorField as of the snapshot, and a
+  // bit per field whose value is older than its channel's staleness limit.
+  uint32_t updated_ms[SENSOR_FIELD_COUNT];
+  uint8_t stale_mask;
+};
+
+// seq advances only when a value, the stale mask or the valid mask changes,
+// so consumers can skip work while it is unchanged. valid_mask has a bit per
+// field that has been sampled at least once.
+struct SensorSnapshot {
+  uint32_t seq;
+  uint8_t valid_mask;
+  SensorData data;
 };
 
 #endif  // DATA_MODEL_H
@@ -0,0 +1,232 @@
+#include "display_profiler.h"
+
+#include "config.h"
+
+namespace {
+// Adafruit_SPITFT cost model: every pixel or rectangle write sets an
+// address window (CASET + 4, RASET + 4, RAMWR) and streams 16-bit pixels.
+constexpr uint32_t SPI_ADDR_WINDOW_BYTES = 11UL;
+constexpr uint32_t SPI_BYTES_PER_PIXEL = 2UL;
+
+enum PrimitiveKind : uint8_t {
+  PRIMITIVE_PIXEL = 0U,
+  PRIMITIVE_HLINE,
+  PRIMITIVE_VLINE,
+  PRIMITIVE_RECT,
+  PRIMITIVE_SCREEN,
+  PRIMITIVE_COUNT
+};
+
+const char* const SECTION_NAMES[DISPLAY_SECTION_COUNT] = {
+    "clear", "static", "needle", "heartbeat", "gauge_text", "panel_text", "stats_band"};
+const char* const PRIMITIVE_NAMES[PRIMITIVE_COUNT] = {"pixel", "hline", "vline", "rect", "screen"};
+
+struct ProfileCounters {
+  uint32_t calls;
+  uint32_t pixels;
+  uint32_t spi_bytes;
+  uint32_t time_us;
+};
+
+ProfileCounters g_frame_sections[DISPLAY_SECTION_COUNT] = {};
+ProfileCounters g_frame_primitives[PRIMITIVE_COUNT] = {};
+ProfileCounters g_window_total = {};
+uint32_t g_frame_index = 0UL;
+uint32_t g_frame_start_us = 0UL;
+uint32_t g_section_start_us = 0UL;
+DisplayProfileSection g_section = DISPLAY_SECTION_CLEAR;
+
+void AddCounters(ProfileCounters* total, const ProfileCounters& part) {
+  total->calls += part.calls;
+  total->pixels += part.pixels;
+  total->spi_bytes += part.spi_bytes;
+  total->time_us += part.time_us;
+}
+
+void CloseSection(const uint32_t now_us) {
+  g_frame_sections[g_section].time_us += now_us - g_section_start_us;
+  g_section_start_us = now_us;
+}
+
+void PrintCounters(const char* name, const ProfileCounters& counters) {
+  Serial.print("  ");
+  Serial.print(name);
+  Serial.print('\t');
+  Serial.print(counters.calls);
+  Serial.print('\t');
+  Serial.print(counters.pixels);
+  Serial.print('\t');
+  Serial.print(counters.spi_bytes);
+  Serial.print('\t');
+  Serial.println(counters.time_us);
+}
+
+void PrintFrameReport(const uint32_t frame_us) {
+  Serial.print("Display frame ");
+  Serial.print(g_frame_index);
+  Serial.print(": ");
+  Serial.print(frame_us);
+  Serial.println(" us");
+  Serial.println("  section\tcalls\tpixels\tspi_b\tus");
+  for (uint8_t i = 0U; i < DISPLAY_SECTION_COUNT; i++) {
+    PrintCounters(SECTION_NAMES[i], g_frame_sections[i]);
+  }
+  Serial.println("  primitive\tcalls\tpixels\tspi_b");
+  for (uint8_t i = 0U; i < PRIMITIVE_COUNT; i++) {
+    PrintCounters(PRIMITIVE_NAMES[i], g_frame_primitives[i]);
+  }
+
+  const uint32_t frames = RoomMonitorConfig::DISPLAY_PROFILER_REPORT_FRAMES;
+  Serial.print("  avg over ");
+  Serial.print(frames);
+  Serial.print(" frames: ");
+  Serial.print(g_window_total.time_us / frames);
+  Serial.print(" us, ");
+  Serial.print(g_window_total.pixels / frames);
+  Serial.print(" px, ");
+  Serial.print(g_window_total.spi_bytes / frames);
+  Serial.println(" SPI bytes");
+  g_window_total = {};
+}
+
+int32_t ClipSpan(const int16_t start, const int16_t length, const int16_t limit) {
+  const int32_t begin = (start < 0) ? 0L : start;
+  const int32_t end = static_cast<int32_t>(start) + length;
+  const int32_t clipped_end = (end > limit) ? limit : end;
+  return (clipped_end > begin) ? (clipped_end - begin) : 0L;
+}
+
+class ProfilingGfx : public Adafruit_GFX {
+ public:
+  explicit ProfilingGfx(Adafruit_GFX* target) : Adafruit_GFX(target->width(), target->height()), target_(target) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    Record(PRIMITIVE_PIXEL, x, y, 1, 1, color);
+    target_->drawPixel(x, y, color);
+  }
+  void startWrite() override {
+    target_->startWrite();
+  }
+  void endWrite() override {
+    target_->endWrite();
+  }
+  void writePixel(int16_t x, int16_t y, uint16_t color) override {
+    Record(PRIMITIVE_PIXEL, x, y, 1, 1, color);
+    target_->writePixel(x, y, color);
+  }
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+    Record(PRIMITIVE_RECT, x, y, w, h, color);
+    target_->writeFillRect(x, y, w, h, color);
+  }
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+    Record(PRIMITIVE_VLINE, x, y, 1, h, color);
+    target_->writeFastVLine(x, y, h, color);
+  }
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+    Record(PRIMITIVE_HLINE, x, y, w, 1, color);
+    target_->writeFastHLine(x, y, w, color);
+  }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+    Record(PRIMITIVE_VLINE, x, y, 1, h, color);
+    target_->drawFastVLine(x, y, h, color);
+  }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+    Record(PRIMITIVE_HLINE, x, y, w, 1, color);
+    target_->drawFastHLine(x, y, w, color);
+  }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+    Record(PRIMITIVE_RECT, x, y, w, h, color);
+    target_->fillRect(x, y, w, h, color);
+  }
+  void fillScreen(uint16_t color) override {
+    Record(PRIMITIVE_SCREEN, 0, 0, width(), height(), color);
+    target_->fillScreen(color);
+  }
+  // drawLine, drawRect, circles, round rects and glyphs are left to the
+  // Adafruit_GFX base so they decompose into the primitives above.
+
+ private:
+  void Record(
+      const PrimitiveKind kind,
+      const int16_t x,
+      const int16_t y,
+      const int16_t w,
+      const int16_t h,
+      const uint16_t color) {
+    const uint32_t pixels = static_cast<uint32_t>(ClipSpan(x, w, width()) * ClipSpan(y, h, height()));
+    const uint32_t spi_bytes = (pixels > 0UL) ? (SPI_ADDR_WINDOW_BYTES + (pixels * SPI_BYTES_PER_PIXEL)) : 0UL;
+
+    ProfileCounters* section = &g_frame_sections[g_section];
+    ProfileCounters* primitive = &g_frame_primitives[kind];
+    section->calls++;
+    section->pixels += pixels;
+    section->spi_bytes += spi_bytes;
+    primitive->calls++;
+    primitive->pixels += pixels;
+    primitive->spi_bytes += spi_bytes;
+
+    if (RoomMonitorConfig::DISPLAY_PROFILER_TRACE) {
+      Serial.print(PRIMITIVE_NAMES[kind]);
+      Serial.print(' ');
+      Serial.print(x);
+      Serial.print(',');
+      Serial.print(y);
+      Serial.print(' ');
+      Serial.print(w);
+      Serial.print('x');
+      Serial.print(h);
+      Serial.print(" #");
+      Serial.println(color, HEX);
+    }
+  }
+
+  Adafruit_GFX* target_;
+};
+}  // namespace
+
+Adafruit_GFX* DisplayProfiler_Wrap(Adafruit_GFX* target) {
+  if (!RoomMonitorConfig::DISPLAY_PROFILER_ENABLED || (target == nullptr)) {
+    return target;
+  }
+  static ProfilingGfx profiling_gfx(target);
+  return &profiling_gfx;
+}
+
+void DisplayProfiler_SetSection(const DisplayProfileSection section) {
+  if (!RoomMonitorConfig::DISPLAY_PROFILER_ENABLED || (section >= DISPLAY_SECTION_COUNT)) {
+    return;
+  }
+  CloseSection(micros());
+  g_section = section;
+}
+
+void DisplayProfiler_BeginFrame() {
+  if (!RoomMonitorConfig::DISPLAY_PROFILER_ENABLED) {
+    return;
+  }
+  for (uint8_t i = 0U; i < DISPLAY_SECTION_COUNT; i++) {
+    g_frame_sections[i] = {};
+  }
+  for (uint8_t i = 0U; i < PRIMITIVE_COUNT; i++) {
+    g_frame_primitives[i] = {};
+  }
+  g_frame_start_us = micros();
+  g_section_start_us = g_frame_start_us;
+  g_section = DISPLAY_SECTION_CLEAR;
+}
+
+void DisplayProfiler_EndFrame() {
+  if (!RoomMonitorConfig::DISPLAY_PROFILER_ENABLED) {
+    return;
+  }
+  const uint32_t now_us = micros();
+  CloseSection(now_us);
+
+  for (uint8_t i = 0U; i < DISPLAY_SECTION_COUNT; i++) {
+    AddCounters(&g_window_total, g_frame_sections[i]);
+  }
+  g_frame_index++;
+  if ((g_frame_index % RoomMonitorConfig::DISPLAY_PROFILER_REPORT_FRAMES) == 0UL) {
+    PrintFrameReport(now_us - g_frame_start_us);
+  }
+}
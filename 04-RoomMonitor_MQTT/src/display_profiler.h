@@ -0,0 +1,26 @@
+#ifndef DISPLAY_PROFILER_H
+#define DISPLAY_PROFILER_H
+
+#include <Adafruit_GFX.h>
+
+enum DisplayProfileSection : uint8_t {
+  DISPLAY_SECTION_CLEAR = 0U,
+  DISPLAY_SECTION_STATIC,
+  DISPLAY_SECTION_NEEDLE,
+  DISPLAY_SECTION_HEARTBEAT,
+  DISPLAY_SECTION_GAUGE_TEXT,
+  DISPLAY_SECTION_PANEL_TEXT,
+  DISPLAY_SECTION_STATS_BAND,
+  DISPLAY_SECTION_COUNT
+};
+
+// With DISPLAY_PROFILER_ENABLED, Wrap() returns a GFX that forwards every
+// primitive to the target while counting calls, pixels, estimated SPI bytes
+// and time per section; otherwise it returns the target unchanged and the
+// other calls do nothing.
+Adafruit_GFX* DisplayProfiler_Wrap(Adafruit_GFX* target);
+void DisplayProfiler_SetSection(DisplayProfileSection section);
+void DisplayProfiler_BeginFrame();
+void DisplayProfiler_EndFrame();
+
+#endif  // DISPLAY_PROFILER_H
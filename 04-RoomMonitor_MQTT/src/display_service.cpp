@@ -1,10 +1,15 @@
 #include "display_service.h"
 
-#include <math.h>
 #include <stdio.h>
+#include <string.h>
 
-#include "carrier_platform.h"
 #include "config.h"
+#include "display_profiler.h"
+#include "hal.h"
+#include "logger.h"
+#include "readout_font.h"
+#include "rolling_stats.h"
+#include "trig_table.h"
 
 namespace {
 struct DashboardView {
@@ -15,6 +20,7 @@ struct DashboardView {
   float max_value;
   uint8_t decimals;
   uint16_t needle_color;
+  SensorField band_field;  // SENSOR_FIELD_COUNT: no min/max band
 };
 
 struct DisplayLayout {
@@ -29,6 +35,166 @@ struct DisplayLayout {
   int16_t right_col_x;
 };
 
+constexpr uint8_t DISPLAY_TEXT_CAPACITY = 16U;
+constexpr int16_t DISPLAY_CHAR_WIDTH = 6;
+constexpr int16_t DISPLAY_CHAR_HEIGHT = 8;
+
+enum GaugeTextIndex : uint8_t {
+  GAUGE_TEXT_TITLE = 0U,
+  GAUGE_TEXT_VALUE,
+  GAUGE_TEXT_UNIT,
+  GAUGE_TEXT_MIN_LABEL,
+  GAUGE_TEXT_MAX_LABEL,
+  GAUGE_TEXT_COUNT
+};
+
+enum PanelTextIndex : uint8_t {
+  PANEL_TEXT_HUMIDITY = 0U,
+  PANEL_TEXT_PRESSURE,
+  PANEL_TEXT_SOIL1,
+  PANEL_TEXT_SOIL2,
+  PANEL_TEXT_COUNT
+};
+
+struct TextItem {
+  int16_t x;
+  int16_t y;
+  uint8_t size;
+  uint16_t color;
+  char text[DISPLAY_TEXT_CAPACITY];
+};
+
+struct NeedleState {
+  int16_t tip_x;
+  int16_t tip_y;
+  uint16_t color;
+};
+
+// 24 h min/max markers outside the gauge ring.
+struct StatsBandState {
+  bool min_visible;
+  bool max_visible;
+  int16_t min_x;
+  int16_t min_y;
+  int16_t max_x;
+  int16_t max_y;
+};
+
+struct ScreenRect {
+  int16_t x0;
+  int16_t y0;
+  int16_t x1;
+  int16_t y1;
+};
+
+// What is currently on screen, so a refresh only repaints what changed.
+struct DashboardState {
+  bool valid;
+  bool heartbeat_on;
+  uint32_t seq;
+  NeedleState needle;
+  StatsBandState band;
+  TextItem gauge_text[GAUGE_TEXT_COUNT];
+  TextItem panel_text[PANEL_TEXT_COUNT];
+};
+
+DashboardState g_drawn = {};
+TextItem g_next_panel_text[PANEL_TEXT_COUNT] = {};
+
+struct TickSegment {
+  int8_t inner_dx;
+  int8_t inner_dy;
+  int8_t outer_dx;
+  int8_t outer_dy;
+};
+
+constexpr int16_t GAUGE_RADIUS =
+    (RoomMonitorConfig::DISPLAY_SIZE_PX / 2) - RoomMonitorConfig::DISPLAY_OUTER_MARGIN;
+constexpr int32_t GAUGE_START_DEG = static_cast<int32_t>(RoomMonitorConfig::DISPLAY_GAUGE_START_DEG);
+constexpr int32_t GAUGE_SWEEP_DEG =
+    static_cast<int32_t>(RoomMonitorConfig::DISPLAY_GAUGE_END_DEG - RoomMonitorConfig::DISPLAY_GAUGE_START_DEG);
+
+static_assert(
+    static_cast<float>(GAUGE_START_DEG) == RoomMonitorConfig::DISPLAY_GAUGE_START_DEG,
+    "Gauge start angle must be a whole degree for the trig table");
+static_assert(
+    static_cast<float>(GAUGE_START_DEG + GAUGE_SWEEP_DEG) == RoomMonitorConfig::DISPLAY_GAUGE_END_DEG,
+    "Gauge end angle must be a whole degree for the trig table");
+
+constexpr int32_t TickAngleDeg(const uint8_t index) {
+  return GAUGE_START_DEG + ((GAUGE_SWEEP_DEG * index) / RoomMonitorConfig::DISPLAY_GAUGE_TICK_COUNT);
+}
+
+constexpr TickSegment MakeTick(const uint8_t index) {
+  return TickSegment{
+      static_cast<int8_t>(TrigTable::ScaleQ15(
+          TrigTable::CosQ15(TickAngleDeg(index)), GAUGE_RADIUS - RoomMonitorConfig::DISPLAY_GAUGE_TICK_INNER_OFFSET)),
+      static_cast<int8_t>(TrigTable::ScaleQ15(
+          TrigTable::SinQ15(TickAngleDeg(index)), GAUGE_RADIUS - RoomMonitorConfig::DISPLAY_GAUGE_TICK_INNER_OFFSET)),
+      static_cast<int8_t>(TrigTable::ScaleQ15(
+          TrigTable::CosQ15(TickAngleDeg(index)), GAUGE_RADIUS - RoomMonitorConfig::DISPLAY_GAUGE_TICK_OUTER_OFFSET)),
+      static_cast<int8_t>(TrigTable::ScaleQ15(
+          TrigTable::SinQ15(TickAngleDeg(index)), GAUGE_RADIUS - RoomMonitorConfig::DISPLAY_GAUGE_TICK_OUTER_OFFSET))};
+}
+
+// Tick endpoints relative to the gauge centre, resolved at compile time.
+static_assert(RoomMonitorConfig::DISPLAY_GAUGE_TICK_COUNT == 10U, "GAUGE_TICKS lists one entry per tick position");
+constexpr TickSegment GAUGE_TICKS[] = {
+    MakeTick(0U),
+    MakeTick(1U),
+    MakeTick(2U),
+    MakeTick(3U),
+    MakeTick(4U),
+    MakeTick(5U),
+    MakeTick(6U),
+    MakeTick(7U),
+    MakeTick(8U),
+    MakeTick(9U),
+    MakeTick(10U)};
+
+// The rings, ticks and panel border never change. They are rasterised once
+// into horizontal runs and replayed with bulk line writes on full redraws.
+struct StaticSpan {
+  uint8_t x;
+  uint8_t y;
+  uint8_t length;
+  uint8_t color_index;
+};
+
+static_assert(RoomMonitorConfig::DISPLAY_SIZE_PX <= 256, "StaticSpan stores coordinates as uint8_t");
+
+constexpr uint16_t STATIC_LAYER_COLORS[] = {
+    RoomMonitorConfig::DISPLAY_COLOR_CYAN,
+    RoomMonitorConfig::DISPLAY_COLOR_BLUE,
+    RoomMonitorConfig::DISPLAY_COLOR_GRAY};
+constexpr uint8_t STATIC_LAYER_COLOR_COUNT = sizeof(STATIC_LAYER_COLORS) / sizeof(STATIC_LAYER_COLORS[0]);
+constexpr int8_t STATIC_LAYER_TRUE_COLORS = -1;
+
+StaticSpan g_static_spans[RoomMonitorConfig::DISPLAY_STATIC_SPAN_CAPACITY];
+uint16_t g_static_span_count = 0U;
+bool g_static_layer_ready = false;
+
+// Captures text exactly as Print would send it to the display.
+class TextItemWriter : public Print {
+ public:
+  explicit TextItemWriter(TextItem* item) : item_(item), length_(0U) {
+    item_->text[0] = '\0';
+  }
+
+  size_t write(uint8_t c) override {
+    if ((length_ + 1U) >= DISPLAY_TEXT_CAPACITY) {
+      return 0U;
+    }
+    item_->text[length_++] = static_cast<char>(c);
+    item_->text[length_] = '\0';
+    return 1U;
+  }
+
+ private:
+  TextItem* item_;
+  size_t length_;
+};
+
 float ClampFloat(const float value, const float min_value, const float max_value) {
   if (value < min_value) {
     return min_value;
@@ -49,49 +215,49 @@ float MapFloat(
   return to_min + (scale * (to_max - to_min));
 }
 
-int16_t GetDisplayRadius(MKRIoTCarrier* carrier) {
-  const int16_t width = carrier->display.width();
-  const int16_t height = carrier->display.height();
+int16_t GetDisplayRadius(Adafruit_GFX* display) {
+  const int16_t width = display->width();
+  const int16_t height = display->height();
   const int16_t min_side = (width < height) ? width : height;
   return (min_side / 2) - RoomMonitorConfig::DISPLAY_OUTER_MARGIN;
 }
 
 void SetDefaultTextStyle() {
-  MKRIoTCarrier* carrier = CarrierPlatform_Get();
-  if (carrier == nullptr) {
+  Adafruit_GFX* display = Hal_GetDisplay();
+  if (display == nullptr) {
     return;
   }
 
-  carrier->display.fillScreen(RoomMonitorConfig::DISPLAY_COLOR_BLACK);
-  carrier->display.setTextColor(RoomMonitorConfig::DISPLAY_COLOR_CYAN);
-  carrier->display.setTextSize(RoomMonitorConfig::DISPLAY_TEXT_SIZE_SMALL);
+  display->fillScreen(RoomMonitorConfig::DISPLAY_COLOR_BLACK);
+  display->setTextColor(RoomMonitorConfig::DISPLAY_COLOR_CYAN);
+  display->setTextSize(RoomMonitorConfig::DISPLAY_TEXT_SIZE_SMALL);
 }
 
-void DrawDashboardTicks(MKRIoTCarrier* carrier, const int16_t cx, const int16_t cy, const int16_t radius) {
+void DrawDashboardTicks(Adafruit_GFX& gfx, const int16_t cx, const int16_t cy, const uint16_t color) {
   for (uint8_t i = 0U; i <= RoomMonitorConfig::DISPLAY_GAUGE_TICK_COUNT; i++) {
-    const float angle_deg = MapFloat(
-        static_cast<float>(i),
-        0.0F,
-        static_cast<float>(RoomMonitorConfig::DISPLAY_GAUGE_TICK_COUNT),
-        RoomMonitorConfig::DISPLAY_GAUGE_START_DEG,
-        RoomMonitorConfig::DISPLAY_GAUGE_END_DEG);
-    const float angle_rad = angle_deg * RoomMonitorConfig::DISPLAY_DEG_TO_RAD;
-
-    const int16_t x1 = static_cast<int16_t>(
-        static_cast<float>(cx) + cosf(angle_rad) * static_cast<float>(radius - RoomMonitorConfig::DISPLAY_GAUGE_TICK_INNER_OFFSET));
-    const int16_t y1 = static_cast<int16_t>(
-        static_cast<float>(cy) + sinf(angle_rad) * static_cast<float>(radius - RoomMonitorConfig::DISPLAY_GAUGE_TICK_INNER_OFFSET));
-    const int16_t x2 = static_cast<int16_t>(
-        static_cast<float>(cx) + cosf(angle_rad) * static_cast<float>(radius - RoomMonitorConfig::DISPLAY_GAUGE_TICK_OUTER_OFFSET));
-    const int16_t y2 = static_cast<int16_t>(
-        static_cast<float>(cy) + sinf(angle_rad) * static_cast<float>(radius - RoomMonitorConfig::DISPLAY_GAUGE_TICK_OUTER_OFFSET));
-
-    carrier->display.drawLine(x1, y1, x2, y2, RoomMonitorConfig::DISPLAY_COLOR_GRAY);
+    gfx.drawLine(
+        cx + GAUGE_TICKS[i].inner_dx,
+        cy + GAUGE_TICKS[i].inner_dy,
+        cx + GAUGE_TICKS[i].outer_dx,
+        cy + GAUGE_TICKS[i].outer_dy,
+        color);
   }
 }
 
-void DrawDashboardNeedle(
-    MKRIoTCarrier* carrier,
+int32_t GetGaugeAngleDeg(const float value, const float min_value, const float max_value) {
+  const float bounded_value = ClampFloat(value, min_value, max_value);
+  const int32_t step = static_cast<int32_t>(
+      MapFloat(
+          bounded_value,
+          min_value,
+          max_value,
+          0.0F,
+          static_cast<float>(RoomMonitorConfig::DISPLAY_NEEDLE_ANGLE_STEPS)) +
+      0.5F);
+  return GAUGE_START_DEG + ((GAUGE_SWEEP_DEG * step) / RoomMonitorConfig::DISPLAY_NEEDLE_ANGLE_STEPS);
+}
+
+NeedleState BuildNeedle(
     const int16_t cx,
     const int16_t cy,
     const int16_t radius,
@@ -99,129 +265,470 @@ void DrawDashboardNeedle(
     const float min_value,
     const float max_value,
     const uint16_t needle_color) {
-  const float bounded_value = ClampFloat(value, min_value, max_value);
-  const float angle_deg = MapFloat(
-      bounded_value,
-      min_value,
-      max_value,
-      RoomMonitorConfig::DISPLAY_GAUGE_START_DEG,
-      RoomMonitorConfig::DISPLAY_GAUGE_END_DEG);
-  const float angle_rad = angle_deg * RoomMonitorConfig::DISPLAY_DEG_TO_RAD;
+  const int32_t angle_deg = GetGaugeAngleDeg(value, min_value, max_value);
+  const int16_t length = radius - RoomMonitorConfig::DISPLAY_GAUGE_NEEDLE_OFFSET;
+
+  NeedleState needle = {};
+  needle.tip_x = cx + TrigTable::ScaleQ15(TrigTable::CosQ15(angle_deg), length);
+  needle.tip_y = cy + TrigTable::ScaleQ15(TrigTable::SinQ15(angle_deg), length);
+  needle.color = needle_color;
+  return needle;
+}
+
+StatsBandState BuildStatsBand(const DisplayLayout& layout, const DashboardView& gauge) {
+  StatsBandState band = {};
+  StatsSummary summary = {};
+  if (!RoomMonitorConfig::DISPLAY_STATS_BAND_ENABLED || (gauge.band_field >= SENSOR_FIELD_COUNT) ||
+      !RollingStats_Get(gauge.band_field, STATS_WINDOW_24H, &summary)) {
+    return band;
+  }
+
+  const int16_t radius = layout.radius + RoomMonitorConfig::DISPLAY_STATS_BAND_OFFSET;
+  const int32_t min_deg = GetGaugeAngleDeg(summary.min, gauge.min_value, gauge.max_value);
+  const int32_t max_deg = GetGaugeAngleDeg(summary.max, gauge.min_value, gauge.max_value);
+  band.min_x = layout.cx + TrigTable::ScaleQ15(TrigTable::CosQ15(min_deg), radius);
+  band.min_y = layout.cy + TrigTable::ScaleQ15(TrigTable::SinQ15(min_deg), radius);
+  band.max_x = layout.cx + TrigTable::ScaleQ15(TrigTable::CosQ15(max_deg), radius);
+  band.max_y = layout.cy + TrigTable::ScaleQ15(TrigTable::SinQ15(max_deg), radius);
+  // Near the ends of the sweep the panel covers the ring; hide markers there.
+  const int16_t lowest_y = layout.panel_y - RoomMonitorConfig::DISPLAY_STATS_BAND_RADIUS - 1;
+  band.min_visible = band.min_y < lowest_y;
+  band.max_visible = band.max_y < lowest_y;
+  return band;
+}
+
+bool IsSameStatsBand(const StatsBandState& a, const StatsBandState& b) {
+  return (a.min_visible == b.min_visible) && (a.max_visible == b.max_visible) && (a.min_x == b.min_x) && (a.min_y == b.min_y) && (a.max_x == b.max_x) &&
+         (a.max_y == b.max_y);
+}
 
-  const int16_t x = static_cast<int16_t>(
-      static_cast<float>(cx) + cosf(angle_rad) * static_cast<float>(radius - RoomMonitorConfig::DISPLAY_GAUGE_NEEDLE_OFFSET));
-  const int16_t y = static_cast<int16_t>(
-      static_cast<float>(cy) + sinf(angle_rad) * static_cast<float>(radius - RoomMonitorConfig::DISPLAY_GAUGE_NEEDLE_OFFSET));
+// The markers sit in the outer margin, clear of the ring and the static
+// layer, so erasing one never needs a repaint underneath.
+void DrawStatsBand(Adafruit_GFX* display, const StatsBandState& band, const uint16_t min_color, const uint16_t max_color) {
+  if (band.min_visible) {
+    display->fillCircle(band.min_x, band.min_y, RoomMonitorConfig::DISPLAY_STATS_BAND_RADIUS, min_color);
+  }
+  if (band.max_visible) {
+    display->fillCircle(band.max_x, band.max_y, RoomMonitorConfig::DISPLAY_STATS_BAND_RADIUS, max_color);
+  }
+}
 
-  carrier->display.drawLine(cx, cy, x, y, needle_color);
-  carrier->display.fillCircle(cx, cy, RoomMonitorConfig::DISPLAY_NEEDLE_CENTER_RADIUS, needle_color);
+void DrawDashboardNeedle(
+    Adafruit_GFX* display,
+    const int16_t cx,
+    const int16_t cy,
+    const NeedleState& needle,
+    const uint16_t color) {
+  display->drawLine(cx, cy, needle.tip_x, needle.tip_y, color);
+  display->fillCircle(cx, cy, RoomMonitorConfig::DISPLAY_NEEDLE_CENTER_RADIUS, color);
 }
 
-DisplayLayout BuildLayout(MKRIoTCarrier* carrier) {
+DisplayLayout BuildLayout(Adafruit_GFX* display) {
   DisplayLayout layout = {};
-  layout.cx = carrier->display.width() / 2;
-  layout.cy = carrier->display.height() / 2;
-  layout.radius = GetDisplayRadius(carrier);
-  layout.panel_w = carrier->display.width() - RoomMonitorConfig::DISPLAY_PANEL_WIDTH_REDUCTION;
+  layout.cx = display->width() / 2;
+  layout.cy = display->height() / 2;
+  layout.radius = GetDisplayRadius(display);
+  layout.panel_w = display->width() - RoomMonitorConfig::DISPLAY_PANEL_WIDTH_REDUCTION;
   layout.panel_h = RoomMonitorConfig::DISPLAY_PANEL_HEIGHT;
   layout.panel_x = RoomMonitorConfig::DISPLAY_PANEL_X;
-  layout.panel_y = carrier->display.height() - layout.panel_h - RoomMonitorConfig::DISPLAY_PANEL_BOTTOM_MARGIN;
+  layout.panel_y = display->height() - layout.panel_h - RoomMonitorConfig::DISPLAY_PANEL_BOTTOM_MARGIN;
   layout.left_col_x = layout.panel_x + RoomMonitorConfig::DISPLAY_PANEL_LEFT_COL_OFFSET;
   layout.right_col_x = layout.panel_x + (layout.panel_w / 2) + RoomMonitorConfig::DISPLAY_PANEL_RIGHT_COL_OFFSET;
   return layout;
 }
 
-void DrawDashboardFrame(MKRIoTCarrier* carrier, const DisplayLayout& layout) {
-  carrier->display.drawCircle(layout.cx, layout.cy, layout.radius, RoomMonitorConfig::DISPLAY_COLOR_CYAN);
-  carrier->display.drawCircle(
+// Maps a colour for static layer rasterisation. With a colour index the
+// target is a 1-bit canvas holding only the pixels that end up in that
+// colour, so later shapes still knock out earlier ones.
+uint16_t StaticInk(const uint16_t color, const int8_t target_index) {
+  if (target_index == STATIC_LAYER_TRUE_COLORS) {
+    return color;
+  }
+  return (color == STATIC_LAYER_COLORS[target_index]) ? 1U : 0U;
+}
+
+void DrawStaticLayer(Adafruit_GFX& gfx, const DisplayLayout& layout, const int16_t offset_y, const int8_t target_index) {
+  const int16_t cy = layout.cy + offset_y;
+  gfx.drawCircle(layout.cx, cy, layout.radius, StaticInk(RoomMonitorConfig::DISPLAY_COLOR_CYAN, target_index));
+  gfx.drawCircle(
       layout.cx,
-      layout.cy,
+      cy,
       layout.radius - RoomMonitorConfig::DISPLAY_GAUGE_RING_OFFSET,
-      RoomMonitorConfig::DISPLAY_COLOR_BLUE);
-  DrawDashboardTicks(carrier, layout.cx, layout.cy, layout.radius);
+      StaticInk(RoomMonitorConfig::DISPLAY_COLOR_BLUE, target_index));
+  DrawDashboardTicks(gfx, layout.cx, cy, StaticInk(RoomMonitorConfig::DISPLAY_COLOR_GRAY, target_index));
+
+  // The panel background hides the lower part of the outer ring.
+  gfx.fillRoundRect(
+      layout.panel_x,
+      layout.panel_y + offset_y,
+      layout.panel_w,
+      layout.panel_h,
+      RoomMonitorConfig::DISPLAY_PANEL_CORNER_RADIUS,
+      StaticInk(RoomMonitorConfig::DISPLAY_COLOR_BLACK, target_index));
+  gfx.drawRoundRect(
+      layout.panel_x,
+      layout.panel_y + offset_y,
+      layout.panel_w,
+      layout.panel_h,
+      RoomMonitorConfig::DISPLAY_PANEL_CORNER_RADIUS,
+      StaticInk(RoomMonitorConfig::DISPLAY_COLOR_CYAN, target_index));
+}
+
+bool AppendStaticSpan(const int16_t x, const int16_t y, const int16_t length, const uint8_t color_index) {
+  if (g_static_span_count >= RoomMonitorConfig::DISPLAY_STATIC_SPAN_CAPACITY) {
+    return false;
+  }
+  StaticSpan& span = g_static_spans[g_static_span_count++];
+  span.x = static_cast<uint8_t>(x);
+  span.y = static_cast<uint8_t>(y);
+  span.length = static_cast<uint8_t>(length);
+  span.color_index = color_index;
+  return true;
+}
+
+// Rasterises the static layer a band of rows at a time so the scratch
+// canvas stays small, then keeps only the resulting runs.
+bool BuildStaticLayer(Adafruit_GFX* display, const DisplayLayout& layout) {
+  const int16_t width = display->width();
+  const int16_t height = display->height();
+  GFXcanvas1 band(width, RoomMonitorConfig::DISPLAY_STATIC_BAND_ROWS);
+  if (band.getBuffer() == nullptr) {
+    return false;
+  }
+
+  g_static_span_count = 0U;
+  for (int16_t band_y = 0; band_y < height; band_y += RoomMonitorConfig::DISPLAY_STATIC_BAND_ROWS) {
+    for (uint8_t color_index = 0U; color_index < STATIC_LAYER_COLOR_COUNT; color_index++) {
+      band.fillScreen(0U);
+      DrawStaticLayer(band, layout, -band_y, static_cast<int8_t>(color_index));
+
+      for (int16_t row = 0; (row < RoomMonitorConfig::DISPLAY_STATIC_BAND_ROWS) && ((band_y + row) < height); row++) {
+        int16_t run_start = -1;
+        for (int16_t x = 0; x <= width; x++) {
+          const bool is_set = (x < width) && band.getPixel(x, row);
+          if (is_set && (run_start < 0)) {
+            run_start = x;
+          } else if (!is_set && (run_start >= 0)) {
+            if (!AppendStaticSpan(run_start, band_y + row, x - run_start, color_index)) {
+              return false;
+            }
+            run_start = -1;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void BlitStaticLayer(Adafruit_GFX* display) {
+  display->startWrite();
+  for (uint16_t i = 0U; i < g_static_span_count; i++) {
+    const StaticSpan& span = g_static_spans[i];
+    display->writeFastHLine(span.x, span.y, span.length, STATIC_LAYER_COLORS[span.color_index]);
+  }
+  display->endWrite();
 }
 
-void DrawHeartbeatIndicator(MKRIoTCarrier* carrier, const bool heartbeat_on) {
-  carrier->display.fillCircle(
-      carrier->display.width() - RoomMonitorConfig::DISPLAY_HEARTBEAT_OFFSET_X,
+void DrawHeartbeatIndicator(Adafruit_GFX* display, const bool heartbeat_on) {
+  display->fillCircle(
+      display->width() - RoomMonitorConfig::DISPLAY_HEARTBEAT_OFFSET_X,
       RoomMonitorConfig::DISPLAY_HEARTBEAT_OFFSET_Y,
       RoomMonitorConfig::DISPLAY_HEARTBEAT_RADIUS,
       heartbeat_on ? RoomMonitorConfig::DISPLAY_COLOR_GREEN : RoomMonitorConfig::DISPLAY_COLOR_GRAY);
 }
 
-void DrawGaugeReadout(MKRIoTCarrier* carrier, const DisplayLayout& layout, const DashboardView& gauge) {
-  carrier->display.setTextColor(RoomMonitorConfig::DISPLAY_COLOR_GRAY);
-  carrier->display.setTextSize(1);
-  carrier->display.setCursor(
-      layout.cx - RoomMonitorConfig::DISPLAY_GAUGE_TITLE_OFFSET_X,
-      layout.cy - RoomMonitorConfig::DISPLAY_GAUGE_TITLE_OFFSET_Y);
-  carrier->display.print(gauge.title);
+void SetTextItem(TextItem* item, const int16_t x, const int16_t y, const uint8_t size, const uint16_t color) {
+  item->x = x;
+  item->y = y;
+  item->size = size;
+  item->color = color;
+  item->text[0] = '\0';
+}
 
-  carrier->display.setTextColor(RoomMonitorConfig::DISPLAY_COLOR_WHITE);
-  carrier->display.setTextSize(3);
-  carrier->display.setCursor(
+void BuildGaugeText(const DisplayLayout& layout, const DashboardView& gauge, TextItem* out_text) {
+  SetTextItem(
+      &out_text[GAUGE_TEXT_TITLE],
+      layout.cx - RoomMonitorConfig::DISPLAY_GAUGE_TITLE_OFFSET_X,
+      layout.cy - RoomMonitorConfig::DISPLAY_GAUGE_TITLE_OFFSET_Y,
+      1U,
+      RoomMonitorConfig::DISPLAY_COLOR_GRAY);
+  TextItemWriter title(&out_text[GAUGE_TEXT_TITLE]);
+  title.print(gauge.title);
+
+  SetTextItem(
+      &out_text[GAUGE_TEXT_VALUE],
       layout.cx - RoomMonitorConfig::DISPLAY_GAUGE_VALUE_OFFSET_X,
-      layout.cy - RoomMonitorConfig::DISPLAY_GAUGE_VALUE_OFFSET_Y);
-  carrier->display.print(gauge.value, gauge.decimals);
-
-  carrier->display.setTextColor(RoomMonitorConfig::DISPLAY_COLOR_CYAN);
-  carrier->display.setTextSize(1);
-  carrier->display.setCursor(
+      layout.cy - RoomMonitorConfig::DISPLAY_GAUGE_VALUE_OFFSET_Y,
+      3U,
+      RoomMonitorConfig::DISPLAY_COLOR_WHITE);
+  TextItemWriter value(&out_text[GAUGE_TEXT_VALUE]);
+  value.print(gauge.value, gauge.decimals);
+
+  SetTextItem(
+      &out_text[GAUGE_TEXT_UNIT],
       layout.cx + RoomMonitorConfig::DISPLAY_GAUGE_UNIT_OFFSET_X,
-      layout.cy - RoomMonitorConfig::DISPLAY_GAUGE_UNIT_OFFSET_Y);
-  carrier->display.print(gauge.unit);
+      layout.cy - RoomMonitorConfig::DISPLAY_GAUGE_UNIT_OFFSET_Y,
+      1U,
+      RoomMonitorConfig::DISPLAY_COLOR_CYAN);
+  TextItemWriter unit(&out_text[GAUGE_TEXT_UNIT]);
+  unit.print(gauge.unit);
 
-  carrier->display.setTextColor(RoomMonitorConfig::DISPLAY_COLOR_GRAY);
-  carrier->display.setTextSize(1);
-  carrier->display.setCursor(
+  SetTextItem(
+      &out_text[GAUGE_TEXT_MIN_LABEL],
       layout.cx - RoomMonitorConfig::DISPLAY_GAUGE_MINLABEL_OFFSET_X,
-      layout.cy + RoomMonitorConfig::DISPLAY_GAUGE_MINMAX_OFFSET_Y);
-  carrier->display.print(gauge.min_value, 0);
-  carrier->display.print(gauge.unit);
-  carrier->display.setCursor(
+      layout.cy + RoomMonitorConfig::DISPLAY_GAUGE_MINMAX_OFFSET_Y,
+      1U,
+      RoomMonitorConfig::DISPLAY_COLOR_GRAY);
+  TextItemWriter min_label(&out_text[GAUGE_TEXT_MIN_LABEL]);
+  min_label.print(gauge.min_value, 0);
+  min_label.print(gauge.unit);
+
+  SetTextItem(
+      &out_text[GAUGE_TEXT_MAX_LABEL],
       layout.cx + RoomMonitorConfig::DISPLAY_GAUGE_MAXLABEL_OFFSET_X,
-      layout.cy + RoomMonitorConfig::DISPLAY_GAUGE_MINMAX_OFFSET_Y);
-  carrier->display.print(gauge.max_value, 0);
-  carrier->display.print(gauge.unit);
+      layout.cy + RoomMonitorConfig::DISPLAY_GAUGE_MINMAX_OFFSET_Y,
+      1U,
+      RoomMonitorConfig::DISPLAY_COLOR_GRAY);
+  TextItemWriter max_label(&out_text[GAUGE_TEXT_MAX_LABEL]);
+  max_label.print(gauge.max_value, 0);
+  max_label.print(gauge.unit);
 }
 
-void DrawBottomPanel(MKRIoTCarrier* carrier, const DisplayLayout& layout, const SensorData* data) {
-  carrier->display.fillRoundRect(
-      layout.panel_x,
-      layout.panel_y,
-      layout.panel_w,
-      layout.panel_h,
-      RoomMonitorConfig::DISPLAY_PANEL_CORNER_RADIUS,
-      RoomMonitorConfig::DISPLAY_COLOR_BLACK);
-  carrier->display.drawRoundRect(
-      layout.panel_x,
-      layout.panel_y,
-      layout.panel_w,
-      layout.panel_h,
-      RoomMonitorConfig::DISPLAY_PANEL_CORNER_RADIUS,
-      RoomMonitorConfig::DISPLAY_COLOR_CYAN);
+void BuildPanelText(const DisplayLayout& layout, const SensorData* data, TextItem* out_text) {
+  const int16_t row1_y = layout.panel_y + RoomMonitorConfig::DISPLAY_PANEL_ROW1_OFFSET_Y;
+  const int16_t row2_y = layout.panel_y + RoomMonitorConfig::DISPLAY_PANEL_ROW2_OFFSET_Y;
+
+  SetTextItem(&out_text[PANEL_TEXT_HUMIDITY], layout.left_col_x, row1_y, 1U, RoomMonitorConfig::DISPLAY_COLOR_WHITE);
+  TextItemWriter humidity(&out_text[PANEL_TEXT_HUMIDITY]);
+  humidity.print("H:");
+  humidity.print(data->humidity_pct, 0);
+  humidity.print("%");
+
+  SetTextItem(&out_text[PANEL_TEXT_PRESSURE], layout.right_col_x, row1_y, 1U, RoomMonitorConfig::DISPLAY_COLOR_WHITE);
+  TextItemWriter pressure(&out_text[PANEL_TEXT_PRESSURE]);
+  pressure.print("P:");
+  pressure.print(data->pressure_hpa, 0);
+  pressure.print("hPa");
+
+  SetTextItem(&out_text[PANEL_TEXT_SOIL1], layout.left_col_x, row2_y, 1U, RoomMonitorConfig::DISPLAY_COLOR_WHITE);
+  TextItemWriter soil1(&out_text[PANEL_TEXT_SOIL1]);
+  soil1.print("S1:");
+  soil1.print(data->soil1_pct);
+  soil1.print("%");
+
+  SetTextItem(&out_text[PANEL_TEXT_SOIL2], layout.right_col_x, row2_y, 1U, RoomMonitorConfig::DISPLAY_COLOR_WHITE);
+  TextItemWriter soil2(&out_text[PANEL_TEXT_SOIL2]);
+  soil2.print("S2:");
+  soil2.print(data->soil2_pct);
+  soil2.print("%");
+}
+
+void DrawTextCell(Adafruit_GFX* display, const TextItem& item, const uint8_t index, const uint16_t color) {
+  const char c = item.text[index];
+  const int16_t x = item.x + (index * DISPLAY_CHAR_WIDTH * item.size);
+  if (ReadoutFont_HasGlyph(c)) {
+    ReadoutFont_DrawGlyph(*display, x, item.y, c, color, item.size);
+    return;
+  }
+  display->drawChar(x, item.y, static_cast<unsigned char>(c), color, color, item.size);
+}
+
+void DrawTextItem(Adafruit_GFX* display, const TextItem& item, const uint16_t color) {
+  const uint8_t length = static_cast<uint8_t>(strlen(item.text));
+  for (uint8_t i = 0U; i < length; i++) {
+    DrawTextCell(display, item, i, color);
+  }
+}
 
-  carrier->display.setTextColor(RoomMonitorConfig::DISPLAY_COLOR_WHITE);
-  carrier->display.setTextSize(1);
-  carrier->display.setCursor(layout.left_col_x, layout.panel_y + RoomMonitorConfig::DISPLAY_PANEL_ROW1_OFFSET_Y);
-  carrier->display.print("H:");
-  carrier->display.print(data->humidity_pct, 0);
-  carrier->display.print("%");
+static_assert(DISPLAY_TEXT_CAPACITY <= 17U, "Changed-cell masks are 16 bits wide");
+
+// Bit i is set when character cell i differs between the two items.
+uint16_t GetChangedCells(const TextItem& drawn, const TextItem& next) {
+  const uint8_t drawn_length = static_cast<uint8_t>(strlen(drawn.text));
+  const uint8_t next_length = static_cast<uint8_t>(strlen(next.text));
+  const uint8_t length = (drawn_length > next_length) ? drawn_length : next_length;
+  const bool same_style =
+      (drawn.x == next.x) && (drawn.y == next.y) && (drawn.size == next.size) && (drawn.color == next.color);
+
+  // Bytes past either terminator are stale, so a length change counts as
+  // changed without comparing them.
+  uint16_t changed = 0U;
+  for (uint8_t i = 0U; i < length; i++) {
+    if (!same_style || (i >= drawn_length) || (i >= next_length) || (drawn.text[i] != next.text[i])) {
+      changed |= static_cast<uint16_t>(1U << i);
+    }
+  }
+  return changed;
+}
 
-  carrier->display.setCursor(layout.right_col_x, layout.panel_y + RoomMonitorConfig::DISPLAY_PANEL_ROW1_OFFSET_Y);
-  carrier->display.print("P:");
-  carrier->display.print(data->pressure_hpa, 0);
-  carrier->display.print("hPa");
+bool IsCellChanged(const uint16_t changed, const uint8_t index) {
+  return (changed & static_cast<uint16_t>(1U << index)) != 0U;
+}
 
-  carrier->display.setCursor(layout.left_col_x, layout.panel_y + RoomMonitorConfig::DISPLAY_PANEL_ROW2_OFFSET_Y);
-  carrier->display.print("S1:");
-  carrier->display.print(data->soil1_pct);
-  carrier->display.print("%");
+bool IsSameNeedle(const NeedleState& a, const NeedleState& b) {
+  return (a.tip_x == b.tip_x) && (a.tip_y == b.tip_y) && (a.color == b.color);
+}
 
-  carrier->display.setCursor(layout.right_col_x, layout.panel_y + RoomMonitorConfig::DISPLAY_PANEL_ROW2_OFFSET_Y);
-  carrier->display.print("S2:");
-  carrier->display.print(data->soil2_pct);
-  carrier->display.print("%");
+ScreenRect GetCellBounds(const TextItem& item, const uint8_t index) {
+  const int16_t cell_width = DISPLAY_CHAR_WIDTH * item.size;
+  ScreenRect rect = {};
+  rect.x0 = item.x + (index * cell_width);
+  rect.y0 = item.y;
+  rect.x1 = rect.x0 + cell_width - 1;
+  rect.y1 = item.y + (DISPLAY_CHAR_HEIGHT * item.size) - 1;
+  return rect;
+}
+
+void ExtendRect(ScreenRect* rect, const ScreenRect& other, const bool is_empty) {
+  if (is_empty) {
+    *rect = other;
+    return;
+  }
+  rect->x0 = (other.x0 < rect->x0) ? other.x0 : rect->x0;
+  rect->y0 = (other.y0 < rect->y0) ? other.y0 : rect->y0;
+  rect->x1 = (other.x1 > rect->x1) ? other.x1 : rect->x1;
+  rect->y1 = (other.y1 > rect->y1) ? other.y1 : rect->y1;
+}
+
+ScreenRect GetNeedleBounds(const DisplayLayout& layout, const NeedleState& needle) {
+  const int16_t hub = RoomMonitorConfig::DISPLAY_NEEDLE_CENTER_RADIUS;
+  ScreenRect rect = {};
+  rect.x0 = ((needle.tip_x < layout.cx) ? needle.tip_x : layout.cx) - hub;
+  rect.y0 = ((needle.tip_y < layout.cy) ? needle.tip_y : layout.cy) - hub;
+  rect.x1 = ((needle.tip_x > layout.cx) ? needle.tip_x : layout.cx) + hub;
+  rect.y1 = ((needle.tip_y > layout.cy) ? needle.tip_y : layout.cy) + hub;
+  return rect;
+}
+
+bool RectsOverlap(const ScreenRect& a, const ScreenRect& b) {
+  return (a.x0 <= b.x1) && (b.x0 <= a.x1) && (a.y0 <= b.y1) && (b.y0 <= a.y1);
+}
+
+bool OverlapsAny(const ScreenRect& rect, const ScreenRect* damage, const uint8_t damage_count) {
+  for (uint8_t i = 0U; i < damage_count; i++) {
+    if (RectsOverlap(rect, damage[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void DrawFullDashboard(
+    Adafruit_GFX* display,
+    const DisplayLayout& layout,
+    const NeedleState& needle,
+    const StatsBandState& band,
+    const bool heartbeat_on,
+    const TextItem* gauge_text,
+    const TextItem* panel_text) {
+  DisplayProfiler_SetSection(DISPLAY_SECTION_CLEAR);
+  display->fillScreen(RoomMonitorConfig::DISPLAY_COLOR_BLACK);
+  DisplayProfiler_SetSection(DISPLAY_SECTION_STATIC);
+  if (g_static_layer_ready) {
+    BlitStaticLayer(display);
+  } else {
+    DrawStaticLayer(*display, layout, 0, STATIC_LAYER_TRUE_COLORS);
+  }
+  DisplayProfiler_SetSection(DISPLAY_SECTION_NEEDLE);
+  DrawDashboardNeedle(display, layout.cx, layout.cy, needle, needle.color);
+  DisplayProfiler_SetSection(DISPLAY_SECTION_STATS_BAND);
+  DrawStatsBand(display, band, RoomMonitorConfig::DISPLAY_COLOR_BLUE, RoomMonitorConfig::DISPLAY_COLOR_RED);
+  DisplayProfiler_SetSection(DISPLAY_SECTION_HEARTBEAT);
+  DrawHeartbeatIndicator(display, heartbeat_on);
+  DisplayProfiler_SetSection(DISPLAY_SECTION_GAUGE_TEXT);
+  for (uint8_t i = 0U; i < GAUGE_TEXT_COUNT; i++) {
+    DrawTextItem(display, gauge_text[i], gauge_text[i].color);
+  }
+  DisplayProfiler_SetSection(DISPLAY_SECTION_PANEL_TEXT);
+  for (uint8_t i = 0U; i < PANEL_TEXT_COUNT; i++) {
+    DrawTextItem(display, panel_text[i], panel_text[i].color);
+  }
+}
+
+// The needle runs underneath the readout text, so erasing either one can
+// punch holes into the other. Track erased areas and repaint every character
+// cell they hit; untouched cells are left alone.
+void UpdateGauge(
+    Adafruit_GFX* display,
+    const DisplayLayout& layout,
+    const NeedleState& needle,
+    const TextItem* gauge_text) {
+  ScreenRect damage[GAUGE_TEXT_COUNT + 1U];
+  uint8_t damage_count = 0U;
+  uint16_t changed_cells[GAUGE_TEXT_COUNT];
+
+  const bool needle_changed = !IsSameNeedle(g_drawn.needle, needle);
+  DisplayProfiler_SetSection(DISPLAY_SECTION_NEEDLE);
+  if (needle_changed) {
+    DrawDashboardNeedle(display, layout.cx, layout.cy, g_drawn.needle, RoomMonitorConfig::DISPLAY_COLOR_BLACK);
+    damage[damage_count++] = GetNeedleBounds(layout, g_drawn.needle);
+  }
+
+  DisplayProfiler_SetSection(DISPLAY_SECTION_GAUGE_TEXT);
+  for (uint8_t i = 0U; i < GAUGE_TEXT_COUNT; i++) {
+    const TextItem& drawn = g_drawn.gauge_text[i];
+    changed_cells[i] = GetChangedCells(drawn, gauge_text[i]);
+
+    ScreenRect erased = {};
+    bool has_erased = false;
+    const uint8_t drawn_length = static_cast<uint8_t>(strlen(drawn.text));
+    for (uint8_t cell = 0U; cell < drawn_length; cell++) {
+      if (IsCellChanged(changed_cells[i], cell)) {
+        DrawTextCell(display, drawn, cell, RoomMonitorConfig::DISPLAY_COLOR_BLACK);
+        ExtendRect(&erased, GetCellBounds(drawn, cell), !has_erased);
+        has_erased = true;
+      }
+    }
+    if (has_erased) {
+      damage[damage_count++] = erased;
+    }
+  }
+
+  const ScreenRect needle_bounds = GetNeedleBounds(layout, needle);
+  const bool redraw_needle = needle_changed || OverlapsAny(needle_bounds, damage, damage_count);
+  if (redraw_needle) {
+    DisplayProfiler_SetSection(DISPLAY_SECTION_NEEDLE);
+    DrawDashboardNeedle(display, layout.cx, layout.cy, needle, needle.color);
+  }
+
+  DisplayProfiler_SetSection(DISPLAY_SECTION_GAUGE_TEXT);
+  for (uint8_t i = 0U; i < GAUGE_TEXT_COUNT; i++) {
+    const TextItem& next = gauge_text[i];
+    const uint8_t next_length = static_cast<uint8_t>(strlen(next.text));
+    for (uint8_t cell = 0U; cell < next_length; cell++) {
+      const ScreenRect cell_bounds = GetCellBounds(next, cell);
+      const bool under_needle = redraw_needle && RectsOverlap(cell_bounds, needle_bounds);
+      if (IsCellChanged(changed_cells[i], cell) || under_needle || OverlapsAny(cell_bounds, damage, damage_count)) {
+        DrawTextCell(display, next, cell, next.color);
+      }
+    }
+  }
+}
+
+void UpdatePanel(Adafruit_GFX* display, const TextItem* panel_text) {
+  DisplayProfiler_SetSection(DISPLAY_SECTION_PANEL_TEXT);
+  for (uint8_t i = 0U; i < PANEL_TEXT_COUNT; i++) {
+    const TextItem& drawn = g_drawn.panel_text[i];
+    const TextItem& next = panel_text[i];
+    const uint16_t changed_cells = GetChangedCells(drawn, next);
+    if (changed_cells == 0U) {
+      continue;
+    }
+
+    const uint8_t drawn_length = static_cast<uint8_t>(strlen(drawn.text));
+    for (uint8_t cell = 0U; cell < drawn_length; cell++) {
+      if (IsCellChanged(changed_cells, cell)) {
+        DrawTextCell(display, drawn, cell, RoomMonitorConfig::DISPLAY_COLOR_BLACK);
+      }
+    }
+    const uint8_t next_length = static_cast<uint8_t>(strlen(next.text));
+    for (uint8_t cell = 0U; cell < next_length; cell++) {
+      if (IsCellChanged(changed_cells, cell)) {
+        DrawTextCell(display, next, cell, next.color);
+      }
+    }
+  }
 }
 
 DashboardView BuildDashboardView(const SensorData* data) {
@@ -234,7 +741,8 @@ DashboardView BuildDashboardView(const SensorData* data) {
         RoomMonitorConfig::DISPLAY_TEMP_MIN_C,
         RoomMonitorConfig::DISPLAY_TEMP_MAX_C,
         RoomMonitorConfig::FLOAT_DECIMALS,
-        RoomMonitorConfig::DISPLAY_COLOR_ORANGE};
+        RoomMonitorConfig::DISPLAY_COLOR_ORANGE,
+        SENSOR_FIELD_TEMPERATURE};
     return view;
   }
   if (mode == 1UL) {
@@ -246,7 +754,8 @@ DashboardView BuildDashboardView(const SensorData* data) {
         RoomMonitorConfig::DISPLAY_SOIL_MIN_PCT,
         RoomMonitorConfig::DISPLAY_SOIL_MAX_PCT,
         0U,
-        RoomMonitorConfig::DISPLAY_COLOR_GREEN};
+        RoomMonitorConfig::DISPLAY_COLOR_GREEN,
+        SENSOR_FIELD_COUNT};
     return view;
   }
 
@@ -257,46 +766,74 @@ DashboardView BuildDashboardView(const SensorData* data) {
       RoomMonitorConfig::DISPLAY_PRESSURE_MIN_HPA,
       RoomMonitorConfig::DISPLAY_PRESSURE_MAX_HPA,
       0U,
-      RoomMonitorConfig::DISPLAY_COLOR_CYAN};
+      RoomMonitorConfig::DISPLAY_COLOR_CYAN,
+      SENSOR_FIELD_PRESSURE};
   return view;
 }
 }
 
 void DisplayService_Init() {
   SetDefaultTextStyle();
+
+  Adafruit_GFX* display = Hal_GetDisplay();
+  if (display == nullptr) {
+    return;
+  }
+
+  if (!ReadoutFont_Verify()) {
+    Log<LOG_LEVEL_WARN> warning;
+    warning.println("Readout glyph table does not match GFX font, using drawChar");
+  }
+
+  g_static_layer_ready = BuildStaticLayer(display, BuildLayout(display));
+  Log<LOG_LEVEL_INFO> logger;
+  if (g_static_layer_ready) {
+    logger.print("Static layer cached: ");
+    logger.print(g_static_span_count);
+    logger.print(" spans, ");
+    logger.print(static_cast<uint32_t>(g_static_span_count * sizeof(StaticSpan)));
+    logger.print(" of ");
+    logger.print(static_cast<uint32_t>(sizeof(g_static_spans)));
+    logger.println(" bytes");
+  } else {
+    logger.println("Static layer cache unavailable, drawing frame directly");
+  }
 }
 
 void DisplayService_ShowBootText() {
-  MKRIoTCarrier* carrier = CarrierPlatform_Get();
-  if (carrier == nullptr) {
+  Adafruit_GFX* display = Hal_GetDisplay();
+  if (display == nullptr) {
     return;
   }
 
-  carrier->display.fillScreen(RoomMonitorConfig::DISPLAY_COLOR_WHITE);
-  carrier->display.setTextColor(RoomMonitorConfig::DISPLAY_COLOR_RED);
-  carrier->display.setTextSize(RoomMonitorConfig::DISPLAY_TEXT_SIZE_LARGE);
-  carrier->display.setCursor(RoomMonitorConfig::DISPLAY_BOOT_X, RoomMonitorConfig::DISPLAY_BOOT_Y);
-  carrier->display.print("Hello");
+  display->fillScreen(RoomMonitorConfig::DISPLAY_COLOR_WHITE);
+  display->setTextColor(RoomMonitorConfig::DISPLAY_COLOR_RED);
+  display->setTextSize(RoomMonitorConfig::DISPLAY_TEXT_SIZE_LARGE);
+  display->setCursor(RoomMonitorConfig::DISPLAY_BOOT_X, RoomMonitorConfig::DISPLAY_BOOT_Y);
+  display->print("Hello");
+  g_drawn.valid = false;
 }
 
-void DisplayService_ShowData(const SensorData* data) {
-  if (data == nullptr) {
+void DisplayService_ShowData(const SensorSnapshot* snapshot) {
+  if (snapshot == nullptr) {
     return;
   }
+  const SensorData* data = &snapshot->data;
+  // The gauge still cycles modes and blinks between snapshots; only the
+  // panel, which shows nothing but sensor values, can be skipped outright.
+  const bool panel_current = g_drawn.valid && (snapshot->seq == g_drawn.seq);
 
-  MKRIoTCarrier* carrier = CarrierPlatform_Get();
-  if (carrier == nullptr) {
+  Adafruit_GFX* display = DisplayProfiler_Wrap(Hal_GetDisplay());
+  if (display == nullptr) {
     return;
   }
+  DisplayProfiler_BeginFrame();
 
-  const DisplayLayout layout = BuildLayout(carrier);
+  const DisplayLayout layout = BuildLayout(display);
   const DashboardView gauge = BuildDashboardView(data);
   const bool heartbeat_on = ((millis() / RoomMonitorConfig::DISPLAY_HEARTBEAT_BLINK_MS) % 2UL) == 0UL;
 
-  carrier->display.fillScreen(RoomMonitorConfig::DISPLAY_COLOR_BLACK);
-  DrawDashboardFrame(carrier, layout);
-  DrawDashboardNeedle(
-      carrier,
+  const NeedleState needle = BuildNeedle(
       layout.cx,
       layout.cy,
       layout.radius,
@@ -304,7 +841,39 @@ void DisplayService_ShowData(const SensorData* data) {
       gauge.min_value,
       gauge.max_value,
       gauge.needle_color);
-  DrawHeartbeatIndicator(carrier, heartbeat_on);
-  DrawGaugeReadout(carrier, layout, gauge);
-  DrawBottomPanel(carrier, layout, data);
+  const StatsBandState band = BuildStatsBand(layout, gauge);
+  TextItem gauge_text[GAUGE_TEXT_COUNT];
+  BuildGaugeText(layout, gauge, gauge_text);
+  if (!panel_current) {
+    BuildPanelText(layout, data, g_next_panel_text);
+  }
+
+  if (!g_drawn.valid) {
+    DrawFullDashboard(display, layout, needle, band, heartbeat_on, gauge_text, g_next_panel_text);
+  } else {
+    UpdateGauge(display, layout, needle, gauge_text);
+    if (!IsSameStatsBand(band, g_drawn.band)) {
+      DisplayProfiler_SetSection(DISPLAY_SECTION_STATS_BAND);
+      DrawStatsBand(display, g_drawn.band, RoomMonitorConfig::DISPLAY_COLOR_BLACK, RoomMonitorConfig::DISPLAY_COLOR_BLACK);
+      DrawStatsBand(display, band, RoomMonitorConfig::DISPLAY_COLOR_BLUE, RoomMonitorConfig::DISPLAY_COLOR_RED);
+    }
+    if (heartbeat_on != g_drawn.heartbeat_on) {
+      DisplayProfiler_SetSection(DISPLAY_SECTION_HEARTBEAT);
+      DrawHeartbeatIndicator(display, heartbeat_on);
+    }
+    if (!panel_current) {
+      UpdatePanel(display, g_next_panel_text);
+    }
+  }
+
+  g_drawn.valid = true;
+  g_drawn.heartbeat_on = heartbeat_on;
+  g_drawn.seq = snapshot->seq;
+  g_drawn.needle = needle;
+  g_drawn.band = band;
+  memcpy(g_drawn.gauge_text, gauge_text, sizeof(gauge_text));
+  if (!panel_current) {
+    memcpy(g_drawn.panel_text, g_next_panel_text, sizeof(g_next_panel_text));
+  }
+  DisplayProfiler_EndFrame();
 }
@@ -5,6 +5,6 @@
 
 void DisplayService_Init();
 void DisplayService_ShowBootText();
-void DisplayService_ShowData(const SensorData* data);
+void DisplayService_ShowData(const SensorSnapshot* snapshot);
 
 #endif  // DISPLAY_SERVICE_H
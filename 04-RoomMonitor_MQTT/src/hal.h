@@ -0,0 +1,54 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <Adafruit_GFX.h>
+#include <Arduino.h>
+
+// Board services used by the modules. hal_mkr.cpp binds them to the MKR
+// WiFi 1010 + MKR IoT Carrier; another target links its own implementation
+// of the same functions. The clock stays millis()/micros() from the core.
+
+void Hal_Init();
+
+// Display, drawn through the generic GFX interface.
+Adafruit_GFX* Hal_GetDisplay();
+
+// Panel sleep (display off, controller in sleep-in); content is kept.
+void Hal_SetDisplaySleep(bool sleep);
+
+// True while any of the carrier's capacitive pads is touched.
+bool Hal_ReadTouchAny();
+
+// Waits for the next interrupt. The core's 1 ms SysTick bounds the wait,
+// so millis() keeps running.
+void Hal_IdleSleep();
+
+// Environmental sensors and ADC. Each call is one bus transaction.
+float Hal_ReadTemperatureC();
+float Hal_ReadHumidityPct();
+float Hal_ReadPressureHpa();
+int Hal_ReadAnalog(pin_size_t pin);
+
+// WiFi. Hal_WifiBegin() only starts association and returns at once.
+void Hal_WifiInit();
+void Hal_WifiBegin(const char* ssid, const char* password);
+void Hal_WifiDisconnect();
+void Hal_WifiSetLowPower(bool enabled);
+bool Hal_WifiIsConnected();
+void Hal_WifiGetMacAddress(uint8_t* out_mac);
+bool Hal_ResolveHost(const char* host, IPAddress* out_ip);
+
+// MQTT transport: a TCP socket opened without blocking, polled until it is
+// established, then handed to the MQTT client as a Client.
+enum HalTransportState : uint8_t {
+  HAL_TRANSPORT_CLOSED = 0U,
+  HAL_TRANSPORT_CONNECTING,
+  HAL_TRANSPORT_ESTABLISHED
+};
+
+Client* Hal_GetTransportClient();
+bool Hal_TransportOpen(const IPAddress& ip, uint16_t port);
+HalTransportState Hal_TransportPoll();
+void Hal_TransportClose();
+
+#endif  // HAL_H
@@ -0,0 +1,143 @@
+#include "hal.h"
+
+#include <Arduino_MKRIoTCarrier.h>
+#include <WiFiNINA.h>
+#include <utility/server_drv.h>
+#include <utility/wl_definitions.h>
+
+#include "config.h"
+
+namespace {
+MKRIoTCarrier g_carrier;
+bool g_is_initialized = false;
+
+WiFiClient g_transport_client;
+uint8_t g_transport_socket = NO_SOCKET_AVAIL;
+bool g_transport_wrapped = false;
+}  // namespace
+
+void Hal_Init() {
+  if (!g_is_initialized) {
+    g_carrier.begin();
+    g_is_initialized = true;
+  }
+}
+
+Adafruit_GFX* Hal_GetDisplay() {
+  return &g_carrier.display;
+}
+
+void Hal_SetDisplaySleep(const bool sleep) {
+  g_carrier.display.enableDisplay(!sleep);
+  g_carrier.display.enableSleep(sleep);
+}
+
+bool Hal_ReadTouchAny() {
+  g_carrier.Buttons.update();
+  return g_carrier.Buttons.getTouch(TOUCH0) || g_carrier.Buttons.getTouch(TOUCH1) ||
+         g_carrier.Buttons.getTouch(TOUCH2) || g_carrier.Buttons.getTouch(TOUCH3) ||
+         g_carrier.Buttons.getTouch(TOUCH4);
+}
+
+void Hal_IdleSleep() {
+  __WFI();
+}
+
+float Hal_ReadTemperatureC() {
+  return g_carrier.Env.readTemperature();
+}
+
+float Hal_ReadHumidityPct() {
+  return g_carrier.Env.readHumidity();
+}
+
+float Hal_ReadPressureHpa() {
+  return g_carrier.Pressure.readPressure() * RoomMonitorConfig::KPA_TO_HPA_FACTOR;
+}
+
+int Hal_ReadAnalog(const pin_size_t pin) {
+  return analogRead(pin);
+}
+
+void Hal_WifiInit() {
+  // With a zero timeout WiFi.begin() only hands the credentials to the NINA
+  // module and returns; association progress is polled via WiFi.status().
+  WiFi.setTimeout(0UL);
+  WiFi.disconnect();
+}
+
+void Hal_WifiBegin(const char* ssid, const char* password) {
+  (void)WiFi.begin(ssid, password);
+}
+
+void Hal_WifiDisconnect() {
+  WiFi.disconnect();
+}
+
+// NINA power-save mode: the radio sleeps between beacons (DTIM) while
+// staying associated, so the MQTT session survives.
+void Hal_WifiSetLowPower(const bool enabled) {
+  if (enabled) {
+    WiFi.lowPowerMode();
+  } else {
+    WiFi.noLowPowerMode();
+  }
+}
+
+bool Hal_WifiIsConnected() {
+  return WiFi.status() == WL_CONNECTED;
+}
+
+void Hal_WifiGetMacAddress(uint8_t* out_mac) {
+  WiFi.macAddress(out_mac);
+}
+
+// A dotted IP parses without touching the network; a hostname falls back
+// to a DNS lookup on the NINA module, which can block.
+bool Hal_ResolveHost(const char* host, IPAddress* out_ip) {
+  if (out_ip->fromString(host)) {
+    return true;
+  }
+  return WiFi.hostByName(host, *out_ip) == 1;
+}
+
+Client* Hal_GetTransportClient() {
+  return &g_transport_client;
+}
+
+// Opens the socket through the NINA driver directly: WiFiClient::connect()
+// would spin until the handshake finishes, here the state is polled.
+bool Hal_TransportOpen(const IPAddress& ip, const uint16_t port) {
+  Hal_TransportClose();
+  g_transport_socket = ServerDrv::getSocket();
+  if (g_transport_socket == NO_SOCKET_AVAIL) {
+    return false;
+  }
+  ServerDrv::startClient(static_cast<uint32_t>(ip), port, g_transport_socket);
+  return true;
+}
+
+HalTransportState Hal_TransportPoll() {
+  if (g_transport_socket == NO_SOCKET_AVAIL) {
+    return HAL_TRANSPORT_CLOSED;
+  }
+  if (g_transport_wrapped) {
+    return g_transport_client.connected() ? HAL_TRANSPORT_ESTABLISHED : HAL_TRANSPORT_CLOSED;
+  }
+  if (ServerDrv::getClientState(g_transport_socket) != ESTABLISHED) {
+    return HAL_TRANSPORT_CONNECTING;
+  }
+  g_transport_client = WiFiClient(g_transport_socket);
+  g_transport_wrapped = true;
+  return HAL_TRANSPORT_ESTABLISHED;
+}
+
+void Hal_TransportClose() {
+  if (g_transport_wrapped) {
+    g_transport_client.stop();
+  } else if (g_transport_socket != NO_SOCKET_AVAIL) {
+    ServerDrv::stopClient(g_transport_socket);
+  }
+  g_transport_socket = NO_SOCKET_AVAIL;
+  g_transport_wrapped = false;
+}
@@ -0,0 +1,109 @@
+#include "instrumentation.h"
+
+extern "C" char* sbrk(int increment);
+
+namespace {
+constexpr uint8_t BUCKET_COUNT = RoomMonitorConfig::INSTRUMENT_HISTOGRAM_BUCKETS;
+static_assert((BUCKET_COUNT > 0U) && (BUCKET_COUNT <= 32U), "Buckets are powers of two of a uint32_t");
+
+// Bucket b counts durations in [2^b, 2^(b+1)) us; bucket 0 also holds 0 us
+// and the last bucket everything above its lower bound.
+struct SectionHistogram {
+  uint32_t buckets[BUCKET_COUNT];
+  uint32_t total;
+};
+
+SectionHistogram g_histograms[INSTRUMENT_SECTION_COUNT] = {};
+uint32_t g_loop_max_us = 0UL;
+uint32_t g_loop_count = 0UL;
+uint32_t g_window_start_ms = 0UL;
+uint32_t g_free_ram_min = UINT32_MAX;
+
+uint8_t GetBucket(const uint32_t duration_us) {
+  if (duration_us == 0UL) {
+    return 0U;
+  }
+  const uint8_t log2 = static_cast<uint8_t>(31U - static_cast<uint8_t>(__builtin_clz(duration_us)));
+  return (log2 < BUCKET_COUNT) ? log2 : static_cast<uint8_t>(BUCKET_COUNT - 1U);
+}
+
+uint32_t GetBucketUpperUs(const uint8_t bucket) {
+  return (bucket >= 31U) ? UINT32_MAX : ((2UL << bucket) - 1UL);
+}
+
+// Distance between the stack and the heap break, the usual SAMD free-RAM
+// figure. Only shrinks while the heap or the stack grows.
+uint32_t GetFreeRam() {
+  char stack_top = 0;
+  return static_cast<uint32_t>(&stack_top - sbrk(0));
+}
+}  // namespace
+
+void Instrumentation_Record(const InstrumentSection section, const uint32_t duration_us) {
+  if (!RoomMonitorConfig::INSTRUMENTATION_ENABLED || (section >= INSTRUMENT_SECTION_COUNT)) {
+    return;
+  }
+
+  SectionHistogram* histogram = &g_histograms[section];
+  histogram->buckets[GetBucket(duration_us)]++;
+  histogram->total++;
+  if ((section == INSTRUMENT_SECTION_LOOP) && (duration_us > g_loop_max_us)) {
+    g_loop_max_us = duration_us;
+  }
+}
+
+void Instrumentation_CountLoop() {
+  if (!RoomMonitorConfig::INSTRUMENTATION_ENABLED) {
+    return;
+  }
+
+  g_loop_count++;
+  const uint32_t free_ram = GetFreeRam();
+  if (free_ram < g_free_ram_min) {
+    g_free_ram_min = free_ram;
+  }
+}
+
+uint32_t Instrumentation_PercentileUs(const InstrumentSection section, const uint8_t percentile) {
+  if (section >= INSTRUMENT_SECTION_COUNT) {
+    return 0UL;
+  }
+
+  const SectionHistogram& histogram = g_histograms[section];
+  if (histogram.total == 0UL) {
+    return 0UL;
+  }
+  // Smallest count that covers the percentile, rounded up.
+  const uint64_t needed = ((static_cast<uint64_t>(histogram.total) * percentile) + 99U) / 100U;
+  uint64_t seen = 0U;
+  for (uint8_t b = 0U; b < BUCKET_COUNT; b++) {
+    seen += histogram.buckets[b];
+    if ((seen >= needed) && (seen > 0U)) {
+      return GetBucketUpperUs(b);
+    }
+  }
+  return GetBucketUpperUs(static_cast<uint8_t>(BUCKET_COUNT - 1U));
+}
+
+void Instrumentation_TakeSnapshot(InstrumentSnapshot* out_snapshot) {
+  if (out_snapshot == nullptr) {
+    return;
+  }
+
+  const uint32_t now = millis();
+  const uint32_t elapsed_ms = now - g_window_start_ms;
+  out_snapshot->loop_max_us = g_loop_max_us;
+  out_snapshot->loop_hz =
+      (elapsed_ms > 0UL) ? static_cast<uint32_t>((static_cast<uint64_t>(g_loop_count) * 1000U) / elapsed_ms) : 0UL;
+  out_snapshot->free_ram_min = (g_free_ram_min == UINT32_MAX) ? 0UL : g_free_ram_min;
+  for (uint8_t i = 0U; i < INSTRUMENT_SECTION_COUNT; i++) {
+    out_snapshot->section_p99_us[i] = Instrumentation_PercentileUs(static_cast<InstrumentSection>(i), 99U);
+  }
+
+  g_loop_max_us = 0UL;
+  g_loop_count = 0UL;
+  g_window_start_ms = now;
+  for (uint8_t i = 0U; i < INSTRUMENT_SECTION_COUNT; i++) {
+    g_histograms[i] = SectionHistogram();
+  }
+}
@@ -0,0 +1,57 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <Arduino.h>
+
+#include "config.h"
+
+enum InstrumentSection : uint8_t {
+  INSTRUMENT_SECTION_LOOP = 0U,
+  INSTRUMENT_SECTION_SENSOR,
+  INSTRUMENT_SECTION_DISPLAY,
+  INSTRUMENT_SECTION_PUBLISH,
+  INSTRUMENT_SECTION_MQTT,
+  INSTRUMENT_SECTION_COUNT
+};
+
+struct InstrumentSnapshot {
+  uint32_t loop_max_us;
+  uint32_t loop_hz;
+  uint32_t free_ram_min;
+  uint32_t section_p99_us[INSTRUMENT_SECTION_COUNT];
+};
+
+void Instrumentation_Record(InstrumentSection section, uint32_t duration_us);
+void Instrumentation_CountLoop();
+// Returns the upper bound of the log2 bucket holding the given percentile.
+uint32_t Instrumentation_PercentileUs(InstrumentSection section, uint8_t percentile);
+// Fills the snapshot and starts a new window: loop max, loop rate and the
+// section histograms restart, so each snapshot covers only its interval.
+void Instrumentation_TakeSnapshot(InstrumentSnapshot* out_snapshot);
+
+// Times its enclosing scope into a section's histogram. With
+// INSTRUMENTATION_ENABLED false it is an empty object and costs nothing.
+template <bool Enabled>
+class ScopedTimerT {
+ public:
+  explicit ScopedTimerT(const InstrumentSection section) : section_(section), start_us_(micros()) {}
+  ~ScopedTimerT() {
+    Instrumentation_Record(section_, micros() - start_us_);
+  }
+
+ private:
+  InstrumentSection section_;
+  uint32_t start_us_;
+};
+
+template <>
+class ScopedTimerT<false> {
+ public:
+  explicit ScopedTimerT(const InstrumentSection section) {
+    (void)section;
+  }
+};
+
+typedef ScopedTimerT<RoomMonitorConfig::INSTRUMENTATION_ENABLED> ScopedTimer;
+
+#endif  // INSTRUMENTATION_H
@@ -0,0 +1,69 @@
+#include "logger.h"
+
+namespace {
+char g_ring[RoomMonitorConfig::LOG_RING_CAPACITY];
+size_t g_ring_head = 0U;  // next byte to send
+size_t g_ring_used = 0U;
+char g_line[RoomMonitorConfig::LOG_LINE_CAPACITY];
+size_t g_line_used = 0U;
+uint32_t g_dropped = 0UL;
+LogT<true> g_stream;
+
+// Whole lines or nothing, so a full ring never leaves half a line behind.
+void CommitLine() {
+  if (g_line_used > (sizeof(g_ring) - g_ring_used)) {
+    g_dropped++;
+  } else {
+    size_t tail = (g_ring_head + g_ring_used) % sizeof(g_ring);
+    for (size_t i = 0U; i < g_line_used; i++) {
+      g_ring[tail] = g_line[i];
+      tail = (tail + 1U) % sizeof(g_ring);
+    }
+    g_ring_used += g_line_used;
+  }
+  g_line_used = 0U;
+}
+}  // namespace
+
+size_t Logger_Write(const uint8_t* buffer, const size_t size) {
+  for (size_t i = 0U; i < size; i++) {
+    const char value = static_cast<char>(buffer[i]);
+    if (value == '\n') {
+      // Keep room for the newline even in a truncated line.
+      if (g_line_used == sizeof(g_line)) {
+        g_line_used--;
+      }
+      g_line[g_line_used++] = value;
+      CommitLine();
+    } else if (g_line_used < sizeof(g_line)) {
+      g_line[g_line_used++] = value;
+    }
+  }
+  return size;
+}
+
+void Logger_Drain() {
+  int room = Serial.availableForWrite();
+  while ((room > 0) && (g_ring_used > 0U)) {
+    const size_t contiguous = sizeof(g_ring) - g_ring_head;
+    size_t chunk = (g_ring_used < contiguous) ? g_ring_used : contiguous;
+    if (chunk > static_cast<size_t>(room)) {
+      chunk = static_cast<size_t>(room);
+    }
+    const size_t sent = Serial.write(reinterpret_cast<const uint8_t*>(&g_ring[g_ring_head]), chunk);
+    if (sent == 0U) {
+      return;
+    }
+    g_ring_head = (g_ring_head + sent) % sizeof(g_ring);
+    g_ring_used -= sent;
+    room -= static_cast<int>(sent);
+  }
+}
+
+uint32_t Logger_DroppedCount() {
+  return g_dropped;
+}
+
+Print* Logger_GetStream() {
+  return &g_stream;
+}
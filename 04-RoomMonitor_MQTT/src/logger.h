@@ -0,0 +1,62 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+
+#include "config.h"
+
+enum LogLevel : uint8_t {
+  LOG_LEVEL_NONE = 0U,
+  LOG_LEVEL_ERROR,
+  LOG_LEVEL_WARN,
+  LOG_LEVEL_INFO,
+  LOG_LEVEL_DEBUG
+};
+
+// Non-blocking serial log. Text is staged until '\n' and then queued as a
+// whole line; Logger_Drain() hands Serial only what it can take without
+// blocking. Lines longer than LOG_LINE_CAPACITY are truncated.
+size_t Logger_Write(const uint8_t* buffer, size_t size);
+void Logger_Drain();
+uint32_t Logger_DroppedCount();
+// Level-less stream for explicitly enabled reports (e.g. task stats).
+Print* Logger_GetStream();
+
+// Usage: Log<LOG_LEVEL_INFO> logger; logger.print(...); logger.println();
+// A level above RoomMonitorConfig::LOG_LEVEL selects the empty
+// specialization, so the calls and their string literals compile away.
+template <bool Enabled>
+class LogT : public Print {
+ public:
+  size_t write(uint8_t value) override {
+    return Logger_Write(&value, 1U);
+  }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    return Logger_Write(buffer, size);
+  }
+};
+
+template <>
+class LogT<false> {
+ public:
+  template <typename T>
+  size_t print(const T&, int = 0) const {
+    return 0U;
+  }
+  template <typename T>
+  size_t println(const T&, int = 0) const {
+    return 0U;
+  }
+  size_t println() const {
+    return 0U;
+  }
+};
+
+constexpr bool Logger_IsEnabled(const LogLevel level) {
+  return (level != LOG_LEVEL_NONE) && (static_cast<uint8_t>(level) <= RoomMonitorConfig::LOG_LEVEL);
+}
+
+template <LogLevel Level>
+using Log = LogT<Logger_IsEnabled(Level)>;
+
+#endif  // LOGGER_H
@@ -0,0 +1,688 @@
+#include "mqtt_lite_client.h"
+
+#include <string.h>
+
+namespace {
+// Same values PubSubClient reports from state(), so callers print either.
+constexpr int STATE_CONNECTION_TIMEOUT = -4;
+constexpr int STATE_CONNECTION_LOST = -3;
+constexpr int STATE_CONNECT_FAILED = -2;
+constexpr int STATE_DISCONNECTED = -1;
+constexpr int STATE_CONNECTED = 0;
+
+constexpr uint8_t PACKET_CONNECT = 0x10U;
+constexpr uint8_t PACKET_CONNACK = 0x20U;
+constexpr uint8_t PACKET_PUBLISH = 0x30U;
+constexpr uint8_t PACKET_PUBACK = 0x40U;
+constexpr uint8_t PACKET_PINGREQ = 0xC0U;
+constexpr uint8_t PACKET_PINGRESP = 0xD0U;
+constexpr uint8_t PACKET_DISCONNECT = 0xE0U;
+constexpr uint8_t PACKET_TYPE_MASK = 0xF0U;
+
+constexpr uint8_t PUBLISH_FLAG_RETAIN = 0x01U;
+constexpr uint8_t PUBLISH_FLAG_DUP = 0x08U;
+constexpr uint8_t PUBLISH_QOS_SHIFT = 1U;
+constexpr uint8_t CONNECT_FLAG_USER = 0x80U;
+constexpr uint8_t CONNECT_FLAG_PASSWORD = 0x40U;
+constexpr uint8_t CONNECT_FLAG_CLEAN_START = 0x02U;
+constexpr uint8_t PROTOCOL_LEVEL_5 = 5U;
+constexpr uint8_t REASON_FAILURE_MIN = 0x80U;
+
+constexpr uint8_t PROPERTY_RECEIVE_MAXIMUM = 0x21U;
+constexpr uint8_t PROPERTY_TOPIC_ALIAS_MAXIMUM = 0x22U;
+constexpr uint8_t PROPERTY_TOPIC_ALIAS = 0x23U;
+constexpr uint8_t PROPERTY_MAXIMUM_QOS = 0x24U;
+constexpr uint8_t QOS_DEFAULT_MAXIMUM = 2U;  // no Maximum QoS property
+constexpr uint8_t QOS_AT_LEAST_ONCE = 1U;
+constexpr size_t TOPIC_ALIAS_PROPERTY_BYTES = 3U;
+
+constexpr size_t MAX_FIXED_HEADER_BYTES = 5U;
+constexpr uint32_t MS_PER_SECOND = 1000UL;
+
+size_t GetVarintSize(const uint32_t value) {
+  return (value < 128UL) ? 1U : (value < 16384UL) ? 2U : (value < 2097152UL) ? 3U : 4U;
+}
+
+size_t PutVarint(uint8_t* out, uint32_t value) {
+  size_t length = 0U;
+  do {
+    uint8_t digit = static_cast<uint8_t>(value % 128UL);
+    value /= 128UL;
+    if (value > 0UL) {
+      digit |= 0x80U;
+    }
+    out[length++] = digit;
+  } while (value > 0UL);
+  return length;
+}
+
+size_t PutUint16(uint8_t* out, const uint16_t value) {
+  out[0] = static_cast<uint8_t>(value >> 8U);
+  out[1] = static_cast<uint8_t>(value & 0xFFU);
+  return 2U;
+}
+
+size_t PutString(uint8_t* out, const char* text, const size_t length) {
+  const size_t header = PutUint16(out, static_cast<uint16_t>(length));
+  memcpy(out + header, text, length);
+  return header + length;
+}
+
+uint16_t GetUint16(const uint8_t* data) {
+  return static_cast<uint16_t>((static_cast<uint16_t>(data[0]) << 8U) | data[1]);
+}
+
+bool ReadVarint(const uint8_t* data, const size_t length, size_t* offset, uint32_t* out_value) {
+  uint32_t value = 0UL;
+  for (uint8_t shift = 0U; shift < 28U; shift = static_cast<uint8_t>(shift + 7U)) {
+    if (*offset >= length) {
+      return false;
+    }
+    const uint8_t digit = data[(*offset)++];
+    value |= static_cast<uint32_t>(digit & 0x7FU) << shift;
+    if ((digit & 0x80U) == 0U) {
+      *out_value = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Skips one MQTT 5 property value, whose width depends on the identifier.
+bool SkipPropertyValue(const uint8_t id, const uint8_t* data, const size_t length, size_t* offset) {
+  size_t width = 0U;
+  switch (id) {
+    case 0x01U: case 0x17U: case 0x19U: case 0x24U: case 0x25U: case 0x28U: case 0x29U: case 0x2AU:
+      width = 1U;
+      break;
+    case 0x13U: case 0x21U: case 0x22U: case 0x23U:
+      width = 2U;
+      break;
+    case 0x02U: case 0x11U: case 0x18U: case 0x27U:
+      width = 4U;
+      break;
+    case 0x0BU: {
+      uint32_t ignored = 0UL;
+      return ReadVarint(data, length, offset, &ignored);
+    }
+    case 0x03U: case 0x08U: case 0x09U: case 0x12U: case 0x15U: case 0x16U: case 0x1AU: case 0x1CU: case 0x1FU:
+      if ((*offset + 2U) > length) {
+        return false;
+      }
+      width = 2U + GetUint16(data + *offset);
+      break;
+    case 0x26U:
+      for (uint8_t i = 0U; i < 2U; i++) {
+        if ((*offset + 2U) > length) {
+          return false;
+        }
+        *offset += 2U + GetUint16(data + *offset);
+      }
+      return *offset <= length;
+    default:
+      return false;
+  }
+  *offset += width;
+  return *offset <= length;
+}
+}  // namespace
+
+MqttLiteClient::MqttLiteClient()
+    : client_(nullptr),
+      host_(nullptr),
+      port_(0U),
+      socket_timeout_s_(15U),
+      keepalive_s_(RoomMonitorConfig::MQTT_KEEPALIVE_S),
+      state_(STATE_DISCONNECTED),
+      connecting_(false),
+      tx_(),
+      stream_remaining_(0U),
+      rx_stage_(RX_HEADER),
+      rx_header_(0U),
+      rx_remaining_(0UL),
+      rx_length_(0UL),
+      rx_length_shift_(0U),
+      rx_body_(),
+      rx_used_(0U),
+      in_flight_(),
+      next_packet_id_(1U),
+      receive_max_(UINT16_MAX),
+      max_qos_(QOS_DEFAULT_MAXIMUM),
+      unacked_(0UL),
+      alias_topics_(),
+      alias_count_(0U),
+      alias_max_(0U),
+      last_in_ms_(0UL),
+      last_out_ms_(0UL),
+      ping_sent_ms_(0UL),
+      ping_outstanding_(false) {}
+
+MqttLiteClient& MqttLiteClient::setClient(Client& client) {
+  client_ = &client;
+  return *this;
+}
+
+MqttLiteClient& MqttLiteClient::setServer(const char* host, const uint16_t port) {
+  host_ = host;
+  port_ = port;
+  return *this;
+}
+
+// The buffer is static; this only confirms the request fits.
+bool MqttLiteClient::setBufferSize(const uint16_t size) {
+  return size <= sizeof(tx_);
+}
+
+MqttLiteClient& MqttLiteClient::setSocketTimeout(const uint16_t timeout_s) {
+  socket_timeout_s_ = timeout_s;
+  return *this;
+}
+
+MqttLiteClient& MqttLiteClient::setKeepAlive(const uint16_t keepalive_s) {
+  keepalive_s_ = keepalive_s;
+  return *this;
+}
+
+bool MqttLiteClient::connect(const char* client_id) {
+  return connect(client_id, nullptr, nullptr);
+}
+
+// Like PubSubClient, an already open transport is reused.
+bool MqttLiteClient::beginConnect(const char* client_id, const char* user, const char* password) {
+  connecting_ = false;
+  if (client_ == nullptr) {
+    return false;
+  }
+  if (!client_->connected() && ((host_ == nullptr) || (client_->connect(host_, port_) != 1))) {
+    state_ = STATE_CONNECT_FAILED;
+    return false;
+  }
+
+  DropSession(STATE_DISCONNECTED);
+  rx_stage_ = RX_HEADER;
+  alias_count_ = 0U;
+  alias_max_ = 0U;
+  receive_max_ = UINT16_MAX;
+  max_qos_ = QOS_DEFAULT_MAXIMUM;
+  if (!SendConnect(client_id, user, password)) {
+    state_ = STATE_CONNECT_FAILED;
+    client_->stop();
+    return false;
+  }
+  connecting_ = true;
+  return true;
+}
+
+bool MqttLiteClient::connecting() const {
+  return connecting_;
+}
+
+bool MqttLiteClient::connect(const char* client_id, const char* user, const char* password) {
+  if (!beginConnect(client_id, user, password)) {
+    return false;
+  }
+  const uint32_t start = millis();
+  while (connecting_) {
+    if ((millis() - start) >= (static_cast<uint32_t>(socket_timeout_s_) * MS_PER_SECOND)) {
+      connecting_ = false;
+      state_ = STATE_CONNECTION_TIMEOUT;
+      client_->stop();
+      return false;
+    }
+    (void)loop();
+  }
+  return state_ == STATE_CONNECTED;
+}
+
+bool MqttLiteClient::connected() {
+  if ((client_ == nullptr) || (state_ != STATE_CONNECTED)) {
+    return false;
+  }
+  if (!client_->connected()) {
+    DropSession(STATE_CONNECTION_LOST);
+    client_->stop();
+    return false;
+  }
+  return true;
+}
+
+bool MqttLiteClient::loop() {
+  if (connecting_) {
+    if (!client_->connected()) {
+      connecting_ = false;
+      state_ = STATE_CONNECTION_LOST;
+      return false;
+    }
+    ServiceInput();
+    if (state_ == STATE_DISCONNECTED) {
+      return false;
+    }
+    // CONNACK is in: accepted, or refused with its reason code.
+    connecting_ = false;
+    if (state_ != STATE_CONNECTED) {
+      client_->stop();
+      return false;
+    }
+  }
+  if (!connected()) {
+    return false;
+  }
+  ServiceInput();
+
+  const uint32_t now = millis();
+  ExpireInFlight(now);
+
+  // A PINGREQ gets a whole keep-alive interval for its PINGRESP.
+  const uint32_t keepalive_ms = static_cast<uint32_t>(keepalive_s_) * MS_PER_SECOND;
+  if (keepalive_ms == 0UL) {
+    return connected();
+  }
+  if (ping_outstanding_) {
+    if ((now - ping_sent_ms_) > keepalive_ms) {
+      DropSession(STATE_CONNECTION_TIMEOUT);
+      client_->stop();
+      return false;
+    }
+  } else if (((now - last_in_ms_) > keepalive_ms) || ((now - last_out_ms_) > keepalive_ms)) {
+    tx_[0] = PACKET_PINGREQ;
+    tx_[1] = 0U;
+    ping_outstanding_ = SendBuffer(2U);
+    ping_sent_ms_ = now;
+  }
+  return connected();
+}
+
+int MqttLiteClient::state() const {
+  return state_;
+}
+
+bool MqttLiteClient::publish(const char* topic, const char* payload, const bool retained) {
+  return publish(topic, reinterpret_cast<const uint8_t*>(payload), strlen(payload), retained);
+}
+
+bool MqttLiteClient::publish(
+    const char* topic,
+    const uint8_t* payload,
+    const unsigned int payload_length,
+    const bool retained) {
+  if (!connected()) {
+    return false;
+  }
+
+  const uint8_t qos =
+      (RoomMonitorConfig::MQTT_LITE_PUBLISH_QOS < max_qos_) ? RoomMonitorConfig::MQTT_LITE_PUBLISH_QOS : max_qos_;
+  InFlight* slot = nullptr;
+  if (qos > 0U) {
+    slot = FindFreeSlot();
+    if (slot == nullptr) {
+      ServiceInput();
+      slot = FindFreeSlot();
+    }
+    if (slot == nullptr) {
+      return false;  // window full: the caller keeps the value and retries later
+    }
+  }
+
+  const uint16_t packet_id = (qos > 0U) ? NextPacketId() : 0U;
+  bool alias_known = false;
+  const uint16_t alias = FindAlias(topic, &alias_known);
+  const size_t header_length = BuildPublishHeader(topic, payload_length, retained, qos, packet_id, alias, !alias_known);
+  if ((header_length == 0U) || ((header_length + payload_length) > sizeof(tx_))) {
+    return false;
+  }
+  memcpy(tx_ + header_length, payload, payload_length);
+  if (!SendBuffer(header_length + payload_length)) {
+    return false;
+  }
+  // The broker only learns the alias from a PUBLISH that reached it.
+  if ((alias != 0U) && !alias_known) {
+    alias_topics_[alias_count_++] = topic;
+  }
+
+  if (slot != nullptr) {
+    slot->packet_id = packet_id;
+    slot->sent_ms = millis();
+    slot->topic = topic;
+    slot->retained = retained;
+    slot->resends = 0U;
+    slot->payload_length = 0U;
+    if (payload_length <= sizeof(slot->payload)) {
+      memcpy(slot->payload, payload, payload_length);
+      slot->payload_length = static_cast<uint16_t>(payload_length);
+    } else {
+      slot->resends = RoomMonitorConfig::MQTT_LITE_PUBACK_RESENDS;
+    }
+  }
+  return true;
+}
+
+bool MqttLiteClient::beginPublish(const char* topic, const unsigned int payload_length, const bool retained) {
+  if (!connected()) {
+    return false;
+  }
+  const size_t header_length = BuildPublishHeader(topic, payload_length, retained, 0U, 0U, 0U, true);
+  if ((header_length == 0U) || !SendBuffer(header_length)) {
+    return false;
+  }
+  stream_remaining_ = payload_length;
+  return true;
+}
+
+size_t MqttLiteClient::write(const uint8_t value) {
+  return write(&value, 1U);
+}
+
+size_t MqttLiteClient::write(const uint8_t* buffer, const size_t size) {
+  if ((client_ == nullptr) || (size > stream_remaining_)) {
+    return 0U;
+  }
+  const size_t written = client_->write(buffer, size);
+  stream_remaining_ -= written;
+  last_out_ms_ = millis();
+  return written;
+}
+
+int MqttLiteClient::endPublish() {
+  const bool complete = stream_remaining_ == 0U;
+  stream_remaining_ = 0U;
+  return complete ? 1 : 0;
+}
+
+uint8_t MqttLiteClient::inFlightCount() const {
+  uint8_t count = 0U;
+  for (uint8_t i = 0U; i < RoomMonitorConfig::MQTT_LITE_INFLIGHT_WINDOW; i++) {
+    if (in_flight_[i].packet_id != 0U) {
+      count++;
+    }
+  }
+  return count;
+}
+
+uint32_t MqttLiteClient::unackedCount() const {
+  return unacked_;
+}
+
+bool MqttLiteClient::SendConnect(const char* client_id, const char* user, const char* password) {
+  const bool has_user = (user != nullptr) && (user[0] != '\0');
+  const bool has_password = has_user && (password != nullptr);
+  const size_t id_length = strlen(client_id);
+  const size_t user_length = has_user ? strlen(user) : 0U;
+  const size_t password_length = has_password ? strlen(password) : 0U;
+
+  // "MQTT", level, flags, keep-alive, empty property list.
+  constexpr size_t VARIABLE_HEADER_BYTES = 6U + 1U + 1U + 2U + 1U;
+  const size_t remaining = VARIABLE_HEADER_BYTES + 2U + id_length + (has_user ? (2U + user_length) : 0U) +
+                           (has_password ? (2U + password_length) : 0U);
+  if ((1U + GetVarintSize(remaining) + remaining) > sizeof(tx_)) {
+    return false;
+  }
+
+  uint8_t flags = CONNECT_FLAG_CLEAN_START;
+  flags = static_cast<uint8_t>(flags | (has_user ? CONNECT_FLAG_USER : 0U) | (has_password ? CONNECT_FLAG_PASSWORD : 0U));
+
+  size_t length = 0U;
+  tx_[length++] = PACKET_CONNECT;
+  length += PutVarint(tx_ + length, static_cast<uint32_t>(remaining));
+  length += PutString(tx_ + length, "MQTT", 4U);
+  tx_[length++] = PROTOCOL_LEVEL_5;
+  tx_[length++] = flags;
+  length += PutUint16(tx_ + length, keepalive_s_);
+  tx_[length++] = 0U;
+  length += PutString(tx_ + length, client_id, id_length);
+  if (has_user) {
+    length += PutString(tx_ + length, user, user_length);
+  }
+  if (has_password) {
+    length += PutString(tx_ + length, password, password_length);
+  }
+  return SendBuffer(length);
+}
+
+// Alias for `topic`: its registered one, else the next free slot (which
+// publish() registers once the PUBLISH is sent), else 0 when none is left.
+uint16_t MqttLiteClient::FindAlias(const char* topic, bool* out_known) const {
+  for (uint8_t i = 0U; i < alias_count_; i++) {
+    if (strcmp(alias_topics_[i], topic) == 0) {
+      *out_known = true;
+      return static_cast<uint16_t>(i + 1U);
+    }
+  }
+  *out_known = false;
+  return (alias_count_ < alias_max_) ? static_cast<uint16_t>(alias_count_ + 1U) : 0U;
+}
+
+// Writes fixed header, topic (empty when `send_topic` is false), packet id
+// and properties (the alias, if any) into tx_. Returns the header length,
+// 0 if it does not fit.
+size_t MqttLiteClient::BuildPublishHeader(
+    const char* topic,
+    const size_t payload_length,
+    const bool retained,
+    const uint8_t qos,
+    const uint16_t packet_id,
+    const uint16_t alias,
+    const bool send_topic) {
+  const size_t topic_length = send_topic ? strlen(topic) : 0U;
+  const size_t properties_length = (alias != 0U) ? TOPIC_ALIAS_PROPERTY_BYTES : 0U;
+  const size_t variable_length =
+      2U + topic_length + ((qos > 0U) ? 2U : 0U) + GetVarintSize(properties_length) + properties_length;
+  const size_t remaining = variable_length + payload_length;
+  if ((MAX_FIXED_HEADER_BYTES + variable_length) > sizeof(tx_)) {
+    return 0U;
+  }
+
+  size_t length = 0U;
+  tx_[length++] = static_cast<uint8_t>(
+      PACKET_PUBLISH | (qos << PUBLISH_QOS_SHIFT) | (retained ? PUBLISH_FLAG_RETAIN : 0U));
+  length += PutVarint(tx_ + length, static_cast<uint32_t>(remaining));
+  length += PutString(tx_ + length, topic, topic_length);
+  if (qos > 0U) {
+    length += PutUint16(tx_ + length, packet_id);
+  }
+  length += PutVarint(tx_ + length, static_cast<uint32_t>(properties_length));
+  if (alias != 0U) {
+    tx_[length++] = PROPERTY_TOPIC_ALIAS;
+    length += PutUint16(tx_ + length, alias);
+  }
+  return length;
+}
+
+// Same packet id, DUP set; an alias is only used if already registered.
+bool MqttLiteClient::Resend(const InFlight& slot) {
+  bool alias_known = false;
+  const uint16_t alias = FindAlias(slot.topic, &alias_known);
+  const size_t header_length = BuildPublishHeader(
+      slot.topic, slot.payload_length, slot.retained, QOS_AT_LEAST_ONCE, slot.packet_id, alias_known ? alias : 0U, !alias_known);
+  if ((header_length == 0U) || ((header_length + slot.payload_length) > sizeof(tx_))) {
+    return false;
+  }
+  tx_[0] = static_cast<uint8_t>(tx_[0] | PUBLISH_FLAG_DUP);
+  memcpy(tx_ + header_length, slot.payload, slot.payload_length);
+  return SendBuffer(header_length + slot.payload_length);
+}
+
+bool MqttLiteClient::SendBuffer(const size_t length) {
+  if (client_ == nullptr) {
+    return false;
+  }
+  const bool sent = client_->write(tx_, length) == length;
+  if (sent) {
+    last_out_ms_ = millis();
+  }
+  return sent;
+}
+
+// Consumes whatever the socket has buffered, never waiting for more.
+// Bodies longer than rx_body_ (e.g. inbound PUBLISH) are read and dropped.
+void MqttLiteClient::ServiceInput() {
+  while ((client_ != nullptr) && (client_->available() > 0)) {
+    const int value = client_->read();
+    if (value < 0) {
+      return;
+    }
+    const uint8_t byte = static_cast<uint8_t>(value);
+
+    switch (rx_stage_) {
+      case RX_HEADER:
+        rx_header_ = byte;
+        rx_length_ = 0UL;
+        rx_length_shift_ = 0U;
+        rx_used_ = 0U;
+        rx_stage_ = RX_LENGTH;
+        break;
+      case RX_LENGTH:
+        rx_length_ |= static_cast<uint32_t>(byte & 0x7FU) << rx_length_shift_;
+        rx_length_shift_ = static_cast<uint8_t>(rx_length_shift_ + 7U);
+        if ((byte & 0x80U) == 0U) {
+          rx_remaining_ = rx_length_;
+          rx_stage_ = RX_BODY;
+        }
+        break;
+      case RX_BODY:
+      default:
+        if (rx_used_ < RX_BODY_CAPACITY) {
+          rx_body_[rx_used_++] = byte;
+        }
+        rx_remaining_--;
+        break;
+    }
+
+    if ((rx_stage_ == RX_BODY) && (rx_remaining_ == 0UL)) {
+      HandlePacket();
+      rx_stage_ = RX_HEADER;
+    }
+  }
+}
+
+void MqttLiteClient::HandlePacket() {
+  last_in_ms_ = millis();
+  switch (rx_header_ & PACKET_TYPE_MASK) {
+    case PACKET_CONNACK:
+      HandleConnack();
+      break;
+    case PACKET_PUBACK:
+      HandlePuback();
+      break;
+    case PACKET_PINGRESP:
+      ping_outstanding_ = false;
+      break;
+    case PACKET_DISCONNECT:
+      DropSession(STATE_CONNECTION_LOST);
+      if (client_ != nullptr) {
+        client_->stop();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void MqttLiteClient::HandleConnack() {
+  if (rx_used_ < 2U) {
+    state_ = STATE_CONNECT_FAILED;
+    return;
+  }
+  const uint8_t reason = rx_body_[1];
+  if (reason != 0U) {
+    state_ = reason;
+    return;
+  }
+
+  size_t offset = 2U;
+  uint32_t properties_length = 0UL;
+  if (ReadVarint(rx_body_, rx_used_, &offset, &properties_length)) {
+    const size_t end = offset + properties_length;
+    const size_t limit = (end < rx_used_) ? end : rx_used_;
+    while (offset < limit) {
+      const uint8_t id = rx_body_[offset++];
+      if ((id == PROPERTY_MAXIMUM_QOS) && (offset < limit)) {
+        max_qos_ = rx_body_[offset];
+      }
+      if ((id == PROPERTY_RECEIVE_MAXIMUM || id == PROPERTY_TOPIC_ALIAS_MAXIMUM) && ((offset + 2U) <= limit)) {
+        const uint16_t value = GetUint16(rx_body_ + offset);
+        if (id == PROPERTY_RECEIVE_MAXIMUM) {
+          receive_max_ = value;
+        } else {
+          alias_max_ = (value < RoomMonitorConfig::MQTT_LITE_TOPIC_ALIAS_SLOTS)
+                           ? value
+                           : RoomMonitorConfig::MQTT_LITE_TOPIC_ALIAS_SLOTS;
+        }
+      }
+      if (!SkipPropertyValue(id, rx_body_, limit, &offset)) {
+        break;
+      }
+    }
+  }
+
+  ping_outstanding_ = false;
+  state_ = STATE_CONNECTED;
+}
+
+void MqttLiteClient::HandlePuback() {
+  if (rx_used_ < 2U) {
+    return;
+  }
+  const uint16_t packet_id = GetUint16(rx_body_);
+  const bool failed = (rx_used_ > 2U) && (rx_body_[2] >= REASON_FAILURE_MIN);
+  for (uint8_t i = 0U; i < RoomMonitorConfig::MQTT_LITE_INFLIGHT_WINDOW; i++) {
+    if (in_flight_[i].packet_id == packet_id) {
+      in_flight_[i].packet_id = 0U;
+      if (failed) {
+        unacked_++;
+      }
+      return;
+    }
+  }
+}
+
+void MqttLiteClient::ExpireInFlight(const uint32_t now) {
+  for (uint8_t i = 0U; i < RoomMonitorConfig::MQTT_LITE_INFLIGHT_WINDOW; i++) {
+    InFlight* slot = &in_flight_[i];
+    if ((slot->packet_id == 0U) || ((now - slot->sent_ms) < RoomMonitorConfig::MQTT_LITE_PUBACK_TIMEOUT_MS)) {
+      continue;
+    }
+    if ((slot->resends < RoomMonitorConfig::MQTT_LITE_PUBACK_RESENDS) && Resend(*slot)) {
+      slot->resends++;
+      slot->sent_ms = now;
+      continue;
+    }
+    slot->packet_id = 0U;
+    unacked_++;
+  }
+}
+
+void MqttLiteClient::DropSession(const int reason) {
+  unacked_ += inFlightCount();
+  for (uint8_t i = 0U; i < RoomMonitorConfig::MQTT_LITE_INFLIGHT_WINDOW; i++) {
+    in_flight_[i].packet_id = 0U;
+  }
+  stream_remaining_ = 0U;
+  state_ = reason;
+}
+
+MqttLiteClient::InFlight* MqttLiteClient::FindFreeSlot() {
+  if (inFlightCount() >= GetWindow()) {
+    return nullptr;
+  }
+  for (uint8_t i = 0U; i < RoomMonitorConfig::MQTT_LITE_INFLIGHT_WINDOW; i++) {
+    if (in_flight_[i].packet_id == 0U) {
+      return &in_flight_[i];
+    }
+  }
+  return nullptr;
+}
+
+// The broker's Receive Maximum can shrink the configured window.
+uint8_t MqttLiteClient::GetWindow() const {
+  return (receive_max_ < RoomMonitorConfig::MQTT_LITE_INFLIGHT_WINDOW) ? static_cast<uint8_t>(receive_max_)
+                                                                        : RoomMonitorConfig::MQTT_LITE_INFLIGHT_WINDOW;
+}
+
+uint16_t MqttLiteClient::NextPacketId() {
+  const uint16_t packet_id = next_packet_id_;
+  next_packet_id_ = static_cast<uint16_t>(next_packet_id_ + 1U);
+  if (next_packet_id_ == 0U) {
+    next_packet_id_ = 1U;
+  }
+  return packet_id;
+}
@@ -0,0 +1,127 @@
+#ifndef MQTT_LITE_CLIENT_H
+#define MQTT_LITE_CLIENT_H
+
+#include <Arduino.h>
+
+#include "config.h"
+
+// Static-buffer MQTT 5 client exposing the PubSubClient calls mqtt_manager
+// uses, so either can sit behind it. publish() goes out at
+// MQTT_LITE_PUBLISH_QOS (capped by the broker's Maximum QoS) with up to
+// MQTT_LITE_INFLIGHT_WINDOW unacknowledged messages; PUBACKs are collected
+// in loop() and never waited for, and a message whose PUBACK times out is
+// resent with DUP set up to MQTT_LITE_PUBACK_RESENDS times. Topics
+// sent through publish() get broker-side aliases, so each one crosses the
+// link once per session; topics must outlive the client. Streamed
+// publishes (beginPublish/endPublish) are always QoS 0 and unaliased, so
+// one-off discovery and stats topics leave the slots to the state topics.
+//
+// beginConnect() sends CONNECT on an open transport and returns at once;
+// loop() reads the CONNACK when it arrives, and connecting() stays true
+// until then. The caller owns the deadline. connect() is the blocking
+// PubSubClient-style wrapper, bounded by the socket timeout.
+class MqttLiteClient : public Print {
+ public:
+  MqttLiteClient();
+
+  MqttLiteClient& setClient(Client& client);
+  MqttLiteClient& setServer(const char* host, uint16_t port);
+  bool setBufferSize(uint16_t size);
+  MqttLiteClient& setSocketTimeout(uint16_t timeout_s);
+  MqttLiteClient& setKeepAlive(uint16_t keepalive_s);
+
+  bool beginConnect(const char* client_id, const char* user, const char* password);
+  bool connecting() const;
+  bool connect(const char* client_id);
+  bool connect(const char* client_id, const char* user, const char* password);
+  bool connected();
+  bool loop();
+  int state() const;
+
+  bool publish(const char* topic, const char* payload, bool retained);
+  bool publish(const char* topic, const uint8_t* payload, unsigned int payload_length, bool retained);
+  bool beginPublish(const char* topic, unsigned int payload_length, bool retained);
+  size_t write(uint8_t value) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  int endPublish();
+
+  uint8_t inFlightCount() const;
+  // QoS 1 messages never acknowledged: PUBACK timeout after the last
+  // resend, error reason code or still in flight when the session dropped.
+  uint32_t unackedCount() const;
+
+ private:
+  static constexpr uint8_t RX_BODY_CAPACITY = 64U;
+
+  // Payloads over MQTT_LITE_RESEND_PAYLOAD_BYTES are not kept, so they
+  // are never resent.
+  struct InFlight {
+    uint16_t packet_id;
+    uint32_t sent_ms;
+    const char* topic;
+    bool retained;
+    uint8_t resends;
+    uint16_t payload_length;
+    uint8_t payload[RoomMonitorConfig::MQTT_LITE_RESEND_PAYLOAD_BYTES];
+  };
+
+  enum RxStage : uint8_t { RX_HEADER = 0U, RX_LENGTH, RX_BODY };
+
+  bool SendConnect(const char* client_id, const char* user, const char* password);
+  uint16_t FindAlias(const char* topic, bool* out_known) const;
+  size_t BuildPublishHeader(
+      const char* topic,
+      size_t payload_length,
+      bool retained,
+      uint8_t qos,
+      uint16_t packet_id,
+      uint16_t alias,
+      bool send_topic);
+  bool SendBuffer(size_t length);
+  bool Resend(const InFlight& slot);
+  void ServiceInput();
+  void HandlePacket();
+  void HandleConnack();
+  void HandlePuback();
+  void ExpireInFlight(uint32_t now);
+  void DropSession(int reason);
+  InFlight* FindFreeSlot();
+  uint8_t GetWindow() const;
+  uint16_t NextPacketId();
+
+  Client* client_;
+  const char* host_;
+  uint16_t port_;
+  uint16_t socket_timeout_s_;
+  uint16_t keepalive_s_;
+  int state_;
+  bool connecting_;
+
+  uint8_t tx_[RoomMonitorConfig::MQTT_BUFFER_SIZE_BYTES];
+  size_t stream_remaining_;
+
+  RxStage rx_stage_;
+  uint8_t rx_header_;
+  uint32_t rx_remaining_;
+  uint32_t rx_length_;
+  uint8_t rx_length_shift_;
+  uint8_t rx_body_[RX_BODY_CAPACITY];
+  uint8_t rx_used_;
+
+  InFlight in_flight_[RoomMonitorConfig::MQTT_LITE_INFLIGHT_WINDOW];
+  uint16_t next_packet_id_;
+  uint16_t receive_max_;
+  uint8_t max_qos_;
+  uint32_t unacked_;
+
+  const char* alias_topics_[RoomMonitorConfig::MQTT_LITE_TOPIC_ALIAS_SLOTS];
+  uint8_t alias_count_;
+  uint16_t alias_max_;
+
+  uint32_t last_in_ms_;
+  uint32_t last_out_ms_;
+  uint32_t ping_sent_ms_;
+  bool ping_outstanding_;
+};
+
+#endif  // MQTT_LITE_CLIENT_H
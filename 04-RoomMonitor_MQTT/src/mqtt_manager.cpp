@@ -1,136 +1,916 @@
 #include "mqtt_manager.h"
 
 #include <PubSubClient.h>
-#include <WiFiNINA.h>
 
+#include <type_traits>
+
+#include "boot_profiler.h"
+#include "cbor_writer.h"
 #include "config.h"
+#include "hal.h"
+#include "instrumentation.h"
+#include "logger.h"
+#include "mqtt_lite_client.h"
+#include "power_manager.h"
+#include "rate_controller.h"
+#include "rolling_stats.h"
+#include "telemetry_buffer.h"
+#include "text_format.h"
 #include "wifi_manager.h"
 
 namespace {
-WiFiClient g_wifi_client;
-PubSubClient g_mqtt_client(g_wifi_client);
-bool g_discovery_sent = false;
+typedef std::conditional<RoomMonitorConfig::MQTT_USE_LITE_CLIENT, MqttLiteClient, PubSubClient>::type MqttClient;
+
+MqttClient g_mqtt_client;
 uint32_t g_last_connect_attempt_ms = 0UL;
 uint32_t g_retry_delay_ms = RoomMonitorConfig::MQTT_RETRY_DELAY_MS;
+uint32_t g_retry_jitter_ms = 0UL;
+uint32_t g_last_drain_ms = 0UL;
+bool g_boot_report_sent = false;
+
+constexpr char CLIENT_ID_PREFIX[] = "MKRRoomMon-";
+constexpr size_t CLIENT_ID_CAPACITY = sizeof(CLIENT_ID_PREFIX) + (2U * RoomMonitorConfig::MAC_ADDRESS_LENGTH);
+constexpr size_t STATE_PAYLOAD_CAPACITY = 16U;
+char g_client_id[CLIENT_ID_CAPACITY] = {};
+
+enum StateMetric : uint8_t {
+  METRIC_TEMPERATURE = 0U,
+  METRIC_HUMIDITY,
+  METRIC_PRESSURE,
+  METRIC_SOIL1,
+  METRIC_SOIL2,
+  METRIC_COUNT
+};
+
+// publish() builds the whole packet in MQTT_BUFFER_SIZE_BYTES: fixed
+// header, topic, packet id and (MQTT 5) alias property, then the payload.
+// Anything that cannot be bounded this way is streamed instead.
+constexpr size_t PUBLISH_OVERHEAD_BYTES = 5U + 2U + 2U + 4U;
+
+constexpr size_t ConstLength(const char* text) {
+  return (*text == '\0') ? 0U : (1U + ConstLength(text + 1));
+}
+
+constexpr bool FitsPublishBuffer(const char* topic, const size_t payload_capacity) {
+  return (PUBLISH_OVERHEAD_BYTES + ConstLength(topic) + payload_capacity) <= RoomMonitorConfig::MQTT_BUFFER_SIZE_BYTES;
+}
+
+static_assert(FitsPublishBuffer(RoomMonitorConfig::TOPIC_STATE, RoomMonitorConfig::MQTT_STATE_JSON_CAPACITY),
+              "Batched state JSON does not fit MQTT_BUFFER_SIZE_BYTES");
+static_assert(FitsPublishBuffer(RoomMonitorConfig::TOPIC_BACKLOG, RoomMonitorConfig::MQTT_STATE_JSON_CAPACITY),
+              "Backlog JSON does not fit MQTT_BUFFER_SIZE_BYTES");
+static_assert(FitsPublishBuffer(RoomMonitorConfig::TOPIC_STATE_BIN, RoomMonitorConfig::MQTT_STATE_CBOR_CAPACITY),
+              "CBOR state does not fit MQTT_BUFFER_SIZE_BYTES");
+static_assert(FitsPublishBuffer(RoomMonitorConfig::TOPIC_BOOT, RoomMonitorConfig::MQTT_BOOT_JSON_CAPACITY),
+              "Boot report does not fit MQTT_BUFFER_SIZE_BYTES");
+
+// A full per-topic publish cycle (plus state/bin) must not stall on the
+// QoS 1 window.
+static_assert(RoomMonitorConfig::MQTT_LITE_INFLIGHT_WINDOW >= (METRIC_COUNT + 1U),
+              "MQTT_LITE_INFLIGHT_WINDOW is smaller than one publish cycle");
+
+struct StateMetricInfo {
+  const char* json_key;
+  const char* topic;
+  float deadband;
+  uint32_t max_silence_ms;
+};
+
+const StateMetricInfo STATE_METRICS[METRIC_COUNT] = {
+    {"temperature",
+     RoomMonitorConfig::TOPIC_TEMP_STATE,
+     RoomMonitorConfig::MQTT_DEADBAND_TEMP_C,
+     RoomMonitorConfig::MQTT_MAX_SILENCE_TEMP_MS},
+    {"humidity",
+     RoomMonitorConfig::TOPIC_HUM_STATE,
+     RoomMonitorConfig::MQTT_DEADBAND_HUM_PCT,
+     RoomMonitorConfig::MQTT_MAX_SILENCE_HUM_MS},
+    {"pressure",
+     RoomMonitorConfig::TOPIC_PRESSURE_STATE,
+     RoomMonitorConfig::MQTT_DEADBAND_PRESSURE_HPA,
+     RoomMonitorConfig::MQTT_MAX_SILENCE_PRESSURE_MS},
+    {"soil1",
+     RoomMonitorConfig::TOPIC_SOIL1_STATE,
+     RoomMonitorConfig::MQTT_DEADBAND_SOIL_PCT,
+     RoomMonitorConfig::MQTT_MAX_SILENCE_SOIL_MS},
+    {"soil2",
+     RoomMonitorConfig::TOPIC_SOIL2_STATE,
+     RoomMonitorConfig::MQTT_DEADBAND_SOIL_PCT,
+     RoomMonitorConfig::MQTT_MAX_SILENCE_SOIL_MS}};
+
+// Absorbs float noise so a 0.1 step still counts against a 0.1 deadband.
+constexpr float DEADBAND_EPSILON = 0.001F;
+
+struct PublishedMetric {
+  bool valid;
+  float value;
+  uint32_t published_ms;
+};
+
+PublishedMetric g_published[METRIC_COUNT] = {};
 
-String BuildClientId() {
+// The MAC never changes, so the ID is formatted once and reused.
+const char* GetClientId() {
+  if (g_client_id[0] != '\0') {
+    return g_client_id;
+  }
+
+  byte mac[RoomMonitorConfig::MAC_ADDRESS_LENGTH];
+  Hal_WifiGetMacAddress(mac);
+
+  memcpy(g_client_id, CLIENT_ID_PREFIX, sizeof(CLIENT_ID_PREFIX));
+  char* cursor = g_client_id + (sizeof(CLIENT_ID_PREFIX) - 1U);
+  for (uint8_t i = 0U; i < RoomMonitorConfig::MAC_ADDRESS_LENGTH; i++) {
+    cursor += TextFormat_Hex8(cursor, CLIENT_ID_CAPACITY - static_cast<size_t>(cursor - g_client_id), mac[i]);
+  }
+  return g_client_id;
+}
+
+// FNV-1a over the MAC, so every monitor draws a different jitter sequence.
+uint32_t GetDeviceSeed() {
   byte mac[RoomMonitorConfig::MAC_ADDRESS_LENGTH];
-  WiFi.macAddress(mac);
+  Hal_WifiGetMacAddress(mac);
 
-  String client_id = "MKRRoomMon-";
+  uint32_t hash = 2166136261UL;
   for (uint8_t i = 0U; i < RoomMonitorConfig::MAC_ADDRESS_LENGTH; i++) {
-    if (mac[i] < RoomMonitorConfig::HEX_ZERO_PAD_THRESHOLD) {
-      client_id += "0";
-    }
-    client_id += String(mac[i], HEX);
-  }
-  return client_id;
-}
-
-void SendDiscoveryConfig() {
-  const String device_json = String("{\"identifiers\":[\"") + RoomMonitorConfig::DEVICE_ID +
-                             "\"],\"name\":\"" + RoomMonitorConfig::DEVICE_NAME +
-                             "\",\"model\":\"" + RoomMonitorConfig::DEVICE_MODEL +
-                             "\",\"manufacturer\":\"" + RoomMonitorConfig::DEVICE_MANUFACTURER + "\"}";
-
-  const String temp_config = String("{") +
-                             "\"name\":\"Room Temperature\"," +
-                             "\"state_topic\":\"" + String(RoomMonitorConfig::TOPIC_TEMP_STATE) + "\"," +
-                             "\"unit_of_measurement\":\"°C\"," +
-                             "\"device_class\":\"temperature\"," +
-                             "\"state_class\":\"measurement\"," +
-                             "\"unique_id\":\"room_monitor_temperature\"," +
-                             "\"device\":" + device_json + "}";
-
-  const String hum_config = String("{") +
-                            "\"name\":\"Room Humidity\"," +
-                            "\"state_topic\":\"" + String(RoomMonitorConfig::TOPIC_HUM_STATE) + "\"," +
-                            "\"unit_of_measurement\":\"%\"," +
-                            "\"device_class\":\"humidity\"," +
-                            "\"state_class\":\"measurement\"," +
-                            "\"unique_id\":\"room_monitor_humidity\"," +
-                            "\"device\":" + device_json + "}";
-
-  const String pressure_config = String("{") +
-                                 "\"name\":\"Room Pressure\"," +
-                                 "\"state_topic\":\"" + String(RoomMonitorConfig::TOPIC_PRESSURE_STATE) + "\"," +
-                                 "\"unit_of_measurement\":\"hPa\"," +
-                                 "\"device_class\":\"pressure\"," +
-                                 "\"state_class\":\"measurement\"," +
-                                 "\"unique_id\":\"room_monitor_pressure\"," +
-                                 "\"device\":" + device_json + "}";
-
-  const String soil1_config = String("{") +
-                              "\"name\":\"Soil Moisture 1\"," +
-                              "\"state_topic\":\"" + String(RoomMonitorConfig::TOPIC_SOIL1_STATE) + "\"," +
-                              "\"unit_of_measurement\":\"%\"," +
-                              "\"state_class\":\"measurement\"," +
-                              "\"unique_id\":\"room_monitor_soil1\"," +
-                              "\"device\":" + device_json + "}";
-
-  const String soil2_config = String("{") +
-                              "\"name\":\"Soil Moisture 2\"," +
-                              "\"state_topic\":\"" + String(RoomMonitorConfig::TOPIC_SOIL2_STATE) + "\"," +
-                              "\"unit_of_measurement\":\"%\"," +
-                              "\"state_class\":\"measurement\"," +
-                              "\"unique_id\":\"room_monitor_soil2\"," +
-                              "\"device\":" + device_json + "}";
-
-  const bool ok_temp = g_mqtt_client.publish(RoomMonitorConfig::TOPIC_TEMP_CONFIG, temp_config.c_str(), true);
-  const bool ok_hum = g_mqtt_client.publish(RoomMonitorConfig::TOPIC_HUM_CONFIG, hum_config.c_str(), true);
-  const bool ok_pressure = g_mqtt_client.publish(RoomMonitorConfig::TOPIC_PRESSURE_CONFIG, pressure_config.c_str(), true);
-  const bool ok_soil1 = g_mqtt_client.publish(RoomMonitorConfig::TOPIC_SOIL1_CONFIG, soil1_config.c_str(), true);
-  const bool ok_soil2 = g_mqtt_client.publish(RoomMonitorConfig::TOPIC_SOIL2_CONFIG, soil2_config.c_str(), true);
-
-  const bool all_ok = ok_temp && ok_hum && ok_pressure && ok_soil1 && ok_soil2;
-  Serial.print("Discovery publish ");
-  Serial.println(all_ok ? "OK" : "FAILED");
+    hash = (hash ^ mac[i]) * 16777619UL;
+  }
+  return hash;
+}
+
+// Home Assistant discovery documents are stitched together from string
+// constants that already live in flash and streamed straight to the socket,
+// so neither the JSON nor the MQTT buffer ever holds a whole document.
+struct DiscoveryEntity {
+  const char* config_topic;
+  const char* state_topic;
+  const char* value_key;  // nullptr: the whole payload is the value
+  const char* head;
+  const char* tail;
+};
+
+const char* const DEVICE_JSON_FRAGMENTS[] = {
+    "{\"identifiers\":[\"",
+    RoomMonitorConfig::DEVICE_ID,
+    "\"],\"name\":\"",
+    RoomMonitorConfig::DEVICE_NAME,
+    "\",\"model\":\"",
+    RoomMonitorConfig::DEVICE_MODEL,
+    "\",\"manufacturer\":\"",
+    RoomMonitorConfig::DEVICE_MANUFACTURER,
+    "\"}"};
+
+constexpr char DISCOVERY_CLOSE[] = "}";
+constexpr char VALUE_TEMPLATE_OPEN[] = "\",\"value_template\":\"{{ value_json.";
+constexpr char VALUE_TEMPLATE_CLOSE[] = " }}";
+
+constexpr const char* StateTopicFor(const char* metric_topic) {
+  return RoomMonitorConfig::MQTT_BATCHED_STATE ? RoomMonitorConfig::TOPIC_STATE : metric_topic;
+}
+
+constexpr const char* StateKeyFor(const char* json_key) {
+  return RoomMonitorConfig::MQTT_BATCHED_STATE ? json_key : nullptr;
+}
+
+const DiscoveryEntity DISCOVERY_ENTITIES[] = {
+    {RoomMonitorConfig::TOPIC_TEMP_CONFIG,
+     StateTopicFor(RoomMonitorConfig::TOPIC_TEMP_STATE),
+     StateKeyFor("temperature"),
+     "{\"name\":\"Room Temperature\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"°C\",\"device_class\":\"temperature\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_temperature\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_HUM_CONFIG,
+     StateTopicFor(RoomMonitorConfig::TOPIC_HUM_STATE),
+     StateKeyFor("humidity"),
+     "{\"name\":\"Room Humidity\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"%\",\"device_class\":\"humidity\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_humidity\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_PRESSURE_CONFIG,
+     StateTopicFor(RoomMonitorConfig::TOPIC_PRESSURE_STATE),
+     StateKeyFor("pressure"),
+     "{\"name\":\"Room Pressure\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"hPa\",\"device_class\":\"pressure\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_pressure\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_SOIL1_CONFIG,
+     StateTopicFor(RoomMonitorConfig::TOPIC_SOIL1_STATE),
+     StateKeyFor("soil1"),
+     "{\"name\":\"Soil Moisture 1\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"%\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_soil1\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_SOIL2_CONFIG,
+     StateTopicFor(RoomMonitorConfig::TOPIC_SOIL2_STATE),
+     StateKeyFor("soil2"),
+     "{\"name\":\"Soil Moisture 2\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"%\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_soil2\",\"device\":"}};
+
+// Rolling statistics: one JSON topic per field carries every window; only
+// the 24 h range and the 1 h trends get entities of their own.
+const DiscoveryEntity STATS_ENTITIES[] = {
+    {RoomMonitorConfig::TOPIC_STATS_TEMP_MIN_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_TEMP,
+     "min_24h",
+     "{\"name\":\"Temperature Min 24h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"°C\",\"device_class\":\"temperature\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_temperature_min_24h\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_STATS_TEMP_MAX_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_TEMP,
+     "max_24h",
+     "{\"name\":\"Temperature Max 24h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"°C\",\"device_class\":\"temperature\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_temperature_max_24h\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_STATS_TEMP_TREND_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_TEMP,
+     "trend_1h",
+     "{\"name\":\"Temperature Trend 1h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"°C/h\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_temperature_trend_1h\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_STATS_HUM_MIN_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_HUM,
+     "min_24h",
+     "{\"name\":\"Humidity Min 24h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"%\",\"device_class\":\"humidity\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_humidity_min_24h\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_STATS_HUM_MAX_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_HUM,
+     "max_24h",
+     "{\"name\":\"Humidity Max 24h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"%\",\"device_class\":\"humidity\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_humidity_max_24h\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_STATS_PRESSURE_MIN_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_PRESSURE,
+     "min_24h",
+     "{\"name\":\"Pressure Min 24h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"hPa\",\"device_class\":\"pressure\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_pressure_min_24h\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_STATS_PRESSURE_MAX_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_PRESSURE,
+     "max_24h",
+     "{\"name\":\"Pressure Max 24h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"hPa\",\"device_class\":\"pressure\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_pressure_max_24h\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_STATS_PRESSURE_TREND_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_PRESSURE,
+     "trend_1h",
+     "{\"name\":\"Pressure Trend 1h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"hPa/h\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_pressure_trend_1h\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_STATS_SOIL1_MIN_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_SOIL1,
+     "min_24h",
+     "{\"name\":\"Soil Moisture 1 Min 24h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"%\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_soil1_min_24h\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_STATS_SOIL1_MAX_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_SOIL1,
+     "max_24h",
+     "{\"name\":\"Soil Moisture 1 Max 24h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"%\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_soil1_max_24h\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_STATS_SOIL2_MIN_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_SOIL2,
+     "min_24h",
+     "{\"name\":\"Soil Moisture 2 Min 24h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"%\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_soil2_min_24h\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_STATS_SOIL2_MAX_CONFIG,
+     RoomMonitorConfig::TOPIC_STATS_SOIL2,
+     "max_24h",
+     "{\"name\":\"Soil Moisture 2 Max 24h\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"%\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_soil2_max_24h\",\"device\":"}};
+
+// Diagnostics share one JSON topic; HA lists them under the device's
+// diagnostic section.
+const DiscoveryEntity DIAGNOSTIC_ENTITIES[] = {
+    {RoomMonitorConfig::TOPIC_DIAG_LOOP_MAX_CONFIG,
+     RoomMonitorConfig::TOPIC_DIAGNOSTICS,
+     "loop_max_us",
+     "{\"name\":\"Loop Max Time\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"µs\",\"entity_category\":\"diagnostic\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_loop_max_us\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_DIAG_LOOP_HZ_CONFIG,
+     RoomMonitorConfig::TOPIC_DIAGNOSTICS,
+     "loop_hz",
+     "{\"name\":\"Loop Rate\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"Hz\",\"entity_category\":\"diagnostic\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_loop_hz\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_DIAG_FREE_RAM_CONFIG,
+     RoomMonitorConfig::TOPIC_DIAGNOSTICS,
+     "free_ram_min",
+     "{\"name\":\"Free RAM Low Water\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"B\",\"device_class\":\"data_size\",\"entity_category\":\"diagnostic\","
+     "\"state_class\":\"measurement\",\"unique_id\":\"room_monitor_free_ram_min\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_DIAG_SENSOR_P99_CONFIG,
+     RoomMonitorConfig::TOPIC_DIAGNOSTICS,
+     "sensor_p99_us",
+     "{\"name\":\"Sensor Time p99\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"µs\",\"entity_category\":\"diagnostic\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_sensor_p99_us\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_DIAG_DISPLAY_P99_CONFIG,
+     RoomMonitorConfig::TOPIC_DIAGNOSTICS,
+     "display_p99_us",
+     "{\"name\":\"Display Time p99\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"µs\",\"entity_category\":\"diagnostic\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_display_p99_us\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_DIAG_PUBLISH_P99_CONFIG,
+     RoomMonitorConfig::TOPIC_DIAGNOSTICS,
+     "publish_p99_us",
+     "{\"name\":\"Publish Time p99\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"µs\",\"entity_category\":\"diagnostic\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_publish_p99_us\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_DIAG_MQTT_P99_CONFIG,
+     RoomMonitorConfig::TOPIC_DIAGNOSTICS,
+     "mqtt_p99_us",
+     "{\"name\":\"MQTT Service Time p99\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"µs\",\"entity_category\":\"diagnostic\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_mqtt_p99_us\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_DIAG_AVG_CURRENT_CONFIG,
+     RoomMonitorConfig::TOPIC_DIAGNOSTICS,
+     "avg_current_ua",
+     "{\"name\":\"Average Current (estimate)\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"µA\",\"entity_category\":\"diagnostic\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_avg_current_ua\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_DIAG_LOG_DROPPED_CONFIG,
+     RoomMonitorConfig::TOPIC_DIAGNOSTICS,
+     "log_dropped",
+     "{\"name\":\"Dropped Log Lines\",\"state_topic\":\"",
+     "\",\"entity_category\":\"diagnostic\",\"state_class\":\"total_increasing\","
+     "\"unique_id\":\"room_monitor_log_dropped\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_DIAG_PUBLISH_INTERVAL_CONFIG,
+     RoomMonitorConfig::TOPIC_DIAGNOSTICS,
+     "publish_interval_ms",
+     "{\"name\":\"Publish Interval\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"ms\",\"entity_category\":\"diagnostic\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_publish_interval_ms\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_DIAG_SAMPLE_INTERVAL_CONFIG,
+     RoomMonitorConfig::TOPIC_DIAGNOSTICS,
+     "sample_interval_ms",
+     "{\"name\":\"Sample Interval\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"ms\",\"entity_category\":\"diagnostic\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_sample_interval_ms\",\"device\":"},
+    {RoomMonitorConfig::TOPIC_DIAG_BOOT_PUBLISH_CONFIG,
+     RoomMonitorConfig::TOPIC_BOOT,
+     "first_publish_ms",
+     "{\"name\":\"Boot to First Publish\",\"state_topic\":\"",
+     "\",\"unit_of_measurement\":\"ms\",\"entity_category\":\"diagnostic\",\"state_class\":\"measurement\","
+     "\"unique_id\":\"room_monitor_boot_first_publish_ms\",\"device\":"}};
+
+constexpr uint8_t STATE_ENTITY_COUNT = sizeof(DISCOVERY_ENTITIES) / sizeof(DISCOVERY_ENTITIES[0]);
+constexpr uint8_t STATS_ENTITY_COUNT =
+    RoomMonitorConfig::ROLLING_STATS_ENABLED ? (sizeof(STATS_ENTITIES) / sizeof(STATS_ENTITIES[0])) : 0U;
+constexpr uint8_t DIAGNOSTIC_ENTITY_COUNT = sizeof(DIAGNOSTIC_ENTITIES) / sizeof(DIAGNOSTIC_ENTITIES[0]);
+constexpr uint8_t DISCOVERY_ENTITY_COUNT =
+    STATE_ENTITY_COUNT + STATS_ENTITY_COUNT +
+    (RoomMonitorConfig::INSTRUMENTATION_ENABLED ? DIAGNOSTIC_ENTITY_COUNT : 0U);
+
+// Enabled tables in order: state, rolling stats, diagnostics.
+const DiscoveryEntity& GetDiscoveryEntity(const uint8_t index) {
+  if (index < STATE_ENTITY_COUNT) {
+    return DISCOVERY_ENTITIES[index];
+  }
+  if (index < (STATE_ENTITY_COUNT + STATS_ENTITY_COUNT)) {
+    return STATS_ENTITIES[index - STATE_ENTITY_COUNT];
+  }
+  return DIAGNOSTIC_ENTITIES[index - STATE_ENTITY_COUNT - STATS_ENTITY_COUNT];
+}
+constexpr uint8_t DEVICE_JSON_FRAGMENT_COUNT = sizeof(DEVICE_JSON_FRAGMENTS) / sizeof(DEVICE_JSON_FRAGMENTS[0]);
+
+// Batches small fragments into one socket write per chunk. Without a
+// client it only counts bytes, which gives the length for beginPublish.
+class ChunkWriter {
+ public:
+  explicit ChunkWriter(MqttClient* client) : client_(client), used_(0U), written_(0U) {}
+
+  void Append(const char* text) {
+    while (*text != '\0') {
+      if (used_ == sizeof(chunk_)) {
+        Flush();
+      }
+      chunk_[used_++] = static_cast<uint8_t>(*text++);
+    }
+  }
+
+  size_t Finish() {
+    Flush();
+    return written_;
+  }
+
+ private:
+  void Flush() {
+    if (used_ > 0U) {
+      written_ += (client_ != nullptr) ? client_->write(chunk_, used_) : used_;
+      used_ = 0U;
+    }
+  }
+
+  MqttClient* client_;
+  uint8_t chunk_[RoomMonitorConfig::MQTT_DISCOVERY_CHUNK_BYTES];
+  size_t used_;
+  size_t written_;
+};
+
+void AppendDiscovery(ChunkWriter* writer, const DiscoveryEntity& entity) {
+  writer->Append(entity.head);
+  writer->Append(entity.state_topic);
+  if (entity.value_key != nullptr) {
+    writer->Append(VALUE_TEMPLATE_OPEN);
+    writer->Append(entity.value_key);
+    writer->Append(VALUE_TEMPLATE_CLOSE);
+  }
+  writer->Append(entity.tail);
+  for (uint8_t i = 0U; i < DEVICE_JSON_FRAGMENT_COUNT; i++) {
+    writer->Append(DEVICE_JSON_FRAGMENTS[i]);
+  }
+  writer->Append(DISCOVERY_CLOSE);
+}
+
+size_t GetDiscoveryLength(const DiscoveryEntity& entity) {
+  ChunkWriter counter(nullptr);
+  AppendDiscovery(&counter, entity);
+  return counter.Finish();
+}
+
+bool StreamDiscovery(const DiscoveryEntity& entity) {
+  const size_t length = GetDiscoveryLength(entity);
+  if (!g_mqtt_client.beginPublish(entity.config_topic, length, true)) {
+    return false;
+  }
+
+  ChunkWriter writer(&g_mqtt_client);
+  AppendDiscovery(&writer, entity);
+  const bool complete = writer.Finish() == length;
+  return (g_mqtt_client.endPublish() > 0) && complete;
+}
+
+const char* const STATS_TOPICS[SENSOR_FIELD_COUNT] = {
+    RoomMonitorConfig::TOPIC_STATS_TEMP,
+    RoomMonitorConfig::TOPIC_STATS_HUM,
+    RoomMonitorConfig::TOPIC_STATS_PRESSURE,
+    RoomMonitorConfig::TOPIC_STATS_SOIL1,
+    RoomMonitorConfig::TOPIC_STATS_SOIL2};
+const char* const STATS_WINDOW_SUFFIXES[STATS_WINDOW_COUNT] = {"_1m\":", "_1h\":", "_24h\":"};
+constexpr uint8_t STATS_DECIMALS = 2U;
+
+uint8_t g_next_stats_field = 0U;
+
+// Summaries are taken once, so the counting and the writing pass see the
+// same numbers even if a bucket rolls over in between.
+struct FieldStats {
+  bool valid[STATS_WINDOW_COUNT];
+  StatsSummary summary[STATS_WINDOW_COUNT];
+};
+
+void AppendStatsNumber(ChunkWriter* writer, const float value) {
+  char text[STATE_PAYLOAD_CAPACITY];
+  writer->Append((TextFormat_Float(text, sizeof(text), value, STATS_DECIMALS) > 0U) ? text : "null");
+}
+
+// {"n_1m":60,"min_1m":21.50,...,"trend_24h":-0.12}; empty windows are left out.
+void AppendStatsJson(ChunkWriter* writer, const FieldStats& stats) {
+  bool first = true;
+  for (uint8_t window = 0U; window < STATS_WINDOW_COUNT; window++) {
+    if (!stats.valid[window]) {
+      continue;
+    }
+    const StatsSummary& summary = stats.summary[window];
+    const char* suffix = STATS_WINDOW_SUFFIXES[window];
+    char count[STATE_PAYLOAD_CAPACITY];
+    (void)TextFormat_Unsigned(count, sizeof(count), summary.count);
+
+    writer->Append(first ? "{\"n" : ",\"n");
+    writer->Append(suffix);
+    writer->Append(count);
+    const struct {
+      const char* key;
+      float value;
+    } fields[] = {
+        {",\"min", summary.min},
+        {",\"max", summary.max},
+        {",\"mean", summary.mean},
+        {",\"sd", summary.stddev},
+        {",\"trend", summary.trend_per_hour}};
+    for (uint8_t i = 0U; i < (sizeof(fields) / sizeof(fields[0])); i++) {
+      writer->Append(fields[i].key);
+      writer->Append(suffix);
+      AppendStatsNumber(writer, fields[i].value);
+    }
+    first = false;
+  }
+  writer->Append(first ? "{}" : "}");
+}
+
+struct DiagnosticField {
+  const char* key;
+  uint32_t value;
+};
+
+void AppendDiagnosticsJson(ChunkWriter* writer, const DiagnosticField* fields, const uint8_t count) {
+  for (uint8_t i = 0U; i < count; i++) {
+    char value[STATE_PAYLOAD_CAPACITY];
+    (void)TextFormat_Unsigned(value, sizeof(value), fields[i].value);
+    writer->Append((i == 0U) ? "{\"" : ",\"");
+    writer->Append(fields[i].key);
+    writer->Append("\":");
+    writer->Append(value);
+  }
+  writer->Append("}");
+}
+
+void ReportDiscoveryResult(const bool all_ok) {
+  Log<LOG_LEVEL_INFO> logger;
+  logger.print("Discovery publish ");
+  logger.println(all_ok ? "OK" : "FAILED");
   if (!all_ok) {
-    Serial.print("Discovery payload lengths: ");
-    Serial.print("temp=");
-    Serial.print(temp_config.length());
-    Serial.print(", hum=");
-    Serial.print(hum_config.length());
-    Serial.print(", pressure=");
-    Serial.print(pressure_config.length());
-    Serial.print(", soil1=");
-    Serial.print(soil1_config.length());
-    Serial.print(", soil2=");
-    Serial.println(soil2_config.length());
+    Log<LOG_LEVEL_WARN> warning;
+    warning.print("Discovery payload lengths:");
+    for (uint8_t i = 0U; i < DISCOVERY_ENTITY_COUNT; i++) {
+      warning.print(" ");
+      warning.print(static_cast<uint32_t>(GetDiscoveryLength(GetDiscoveryEntity(i))));
+    }
+    warning.println();
   }
 }
-}  // namespace
 
-// If we dont check wifi and mqtt connection, main loop will be blocked
-namespace {
-void PublishDiscoveryIfNeeded() {
-  if (!g_discovery_sent) {
-    SendDiscoveryConfig();
-    g_discovery_sent = true;
+float GetMetricValue(const SensorData* data, const StateMetric metric) {
+  switch (metric) {
+    case METRIC_TEMPERATURE:
+      return data->temperature_c;
+    case METRIC_HUMIDITY:
+      return data->humidity_pct;
+    case METRIC_PRESSURE:
+      return data->pressure_hpa;
+    case METRIC_SOIL1:
+      return static_cast<float>(data->soil1_pct);
+    default:
+      return static_cast<float>(data->soil2_pct);
+  }
+}
+
+bool IsMetricDue(const SensorData* data, const StateMetric metric, const uint32_t now) {
+  const PublishedMetric& last = g_published[metric];
+  if (!last.valid) {
+    return true;
+  }
+  if ((now - last.published_ms) >= STATE_METRICS[metric].max_silence_ms) {
+    return true;
+  }
+  const float delta = GetMetricValue(data, metric) - last.value;
+  const float magnitude = (delta < 0.0F) ? -delta : delta;
+  return (magnitude + DEADBAND_EPSILON) >= STATE_METRICS[metric].deadband;
+}
+
+void MarkMetricPublished(const SensorData* data, const StateMetric metric, const uint32_t now) {
+  g_published[metric].valid = true;
+  g_published[metric].value = GetMetricValue(data, metric);
+  g_published[metric].published_ms = now;
+}
+
+void ResetPublishedMetrics() {
+  for (uint8_t i = 0U; i < METRIC_COUNT; i++) {
+    g_published[i].valid = false;
+  }
+}
+
+bool FormatStateValues(const SensorData* data, char values[][STATE_PAYLOAD_CAPACITY]) {
+  return (TextFormat_Float(
+              values[METRIC_TEMPERATURE], STATE_PAYLOAD_CAPACITY, data->temperature_c, RoomMonitorConfig::FLOAT_DECIMALS) > 0U) &&
+         (TextFormat_Float(
+              values[METRIC_HUMIDITY], STATE_PAYLOAD_CAPACITY, data->humidity_pct, RoomMonitorConfig::FLOAT_DECIMALS) > 0U) &&
+         (TextFormat_Float(
+              values[METRIC_PRESSURE], STATE_PAYLOAD_CAPACITY, data->pressure_hpa, RoomMonitorConfig::FLOAT_DECIMALS) > 0U) &&
+         (TextFormat_Unsigned(values[METRIC_SOIL1], STATE_PAYLOAD_CAPACITY, data->soil1_pct) > 0U) &&
+         (TextFormat_Unsigned(values[METRIC_SOIL2], STATE_PAYLOAD_CAPACITY, data->soil2_pct) > 0U);
+}
+
+bool PublishPerTopicState(const SensorData* data, const char values[][STATE_PAYLOAD_CAPACITY], const uint32_t now) {
+  bool all_ok = true;
+  for (uint8_t i = 0U; i < METRIC_COUNT; i++) {
+    const StateMetric metric = static_cast<StateMetric>(i);
+    if (!IsMetricDue(data, metric, now)) {
+      continue;
+    }
+    const bool ok = g_mqtt_client.publish(STATE_METRICS[i].topic, values[i], true);
+    if (ok) {
+      MarkMetricPublished(data, metric, now);
+    }
+    all_ok = ok && all_ok;
+  }
+  return all_ok;
+}
+
+// Builds {"temperature":21.4,"humidity":40.2,...,"soil2":41}, optionally
+// led by an "age_s" field. Returns false if the buffer is too small.
+bool BuildStateJson(
+    char* payload,
+    const size_t capacity,
+    const char values[][STATE_PAYLOAD_CAPACITY],
+    const char* age_s) {
+  size_t length = TextFormat_Append(payload, capacity, 0U, "{");
+  if (age_s != nullptr) {
+    length = TextFormat_Append(payload, capacity, length, "\"age_s\":");
+    length = TextFormat_Append(payload, capacity, length, age_s);
+    length = TextFormat_Append(payload, capacity, length, ",");
+  }
+  for (uint8_t i = 0U; i < METRIC_COUNT; i++) {
+    length = TextFormat_Append(payload, capacity, length, (i == 0U) ? "\"" : ",\"");
+    length = TextFormat_Append(payload, capacity, length, STATE_METRICS[i].json_key);
+    length = TextFormat_Append(payload, capacity, length, "\":");
+    length = TextFormat_Append(payload, capacity, length, values[i]);
+  }
+  length = TextFormat_Append(payload, capacity, length, "}");
+  return length < capacity;
+}
+
+bool IsAnyMetricDue(const SensorData* data, const uint32_t now) {
+  for (uint8_t i = 0U; i < METRIC_COUNT; i++) {
+    if (IsMetricDue(data, static_cast<StateMetric>(i), now)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool PublishBatchedState(const SensorData* data, const char values[][STATE_PAYLOAD_CAPACITY], const uint32_t now) {
+  if (!IsAnyMetricDue(data, now)) {
+    return true;
+  }
+
+  char payload[RoomMonitorConfig::MQTT_STATE_JSON_CAPACITY];
+  if (!BuildStateJson(payload, sizeof(payload), values, nullptr)) {
+    return false;
+  }
+  if (!g_mqtt_client.publish(RoomMonitorConfig::TOPIC_STATE, payload, true)) {
+    return false;
+  }
+  for (uint8_t i = 0U; i < METRIC_COUNT; i++) {
+    MarkMetricPublished(data, static_cast<StateMetric>(i), now);
+  }
+  return true;
+}
+
+// Integer map keys of the CBOR payload on TOPIC_STATE_BIN; see README.md.
+enum BinaryStateKey : uint8_t {
+  BINARY_KEY_SEQUENCE = 0U,
+  BINARY_KEY_TEMPERATURE_CENTI_C,
+  BINARY_KEY_HUMIDITY_CENTI_PCT,
+  BINARY_KEY_PRESSURE_DECI_HPA,
+  BINARY_KEY_SOIL1_PCT,
+  BINARY_KEY_SOIL2_PCT,
+  BINARY_KEY_STALE_MASK,
+  BINARY_KEY_COUNT
+};
+
+constexpr float CENTI_SCALE = 100.0F;
+constexpr float DECI_SCALE = 10.0F;
+
+uint32_t g_binary_sequence = 0UL;
+
+int32_t ToFixedPoint(const float value, const float scale) {
+  const float scaled = value * scale;
+  return static_cast<int32_t>(scaled + ((scaled < 0.0F) ? -0.5F : 0.5F));
+}
+
+// Encodes the snapshot as the TOPIC_STATE_BIN map; returns the length, or
+// 0 if it does not fit.
+size_t EncodeBinaryState(const SensorData* data, const uint32_t sequence, uint8_t* payload, const size_t capacity) {
+  CborWriter writer;
+  CborWriter_Init(&writer, payload, capacity);
+  CborWriter_BeginMap(&writer, BINARY_KEY_COUNT);
+  CborWriter_PutUnsigned(&writer, BINARY_KEY_SEQUENCE);
+  CborWriter_PutUnsigned(&writer, sequence);
+  CborWriter_PutUnsigned(&writer, BINARY_KEY_TEMPERATURE_CENTI_C);
+  CborWriter_PutSigned(&writer, ToFixedPoint(data->temperature_c, CENTI_SCALE));
+  CborWriter_PutUnsigned(&writer, BINARY_KEY_HUMIDITY_CENTI_PCT);
+  CborWriter_PutSigned(&writer, ToFixedPoint(data->humidity_pct, CENTI_SCALE));
+  CborWriter_PutUnsigned(&writer, BINARY_KEY_PRESSURE_DECI_HPA);
+  CborWriter_PutSigned(&writer, ToFixedPoint(data->pressure_hpa, DECI_SCALE));
+  CborWriter_PutUnsigned(&writer, BINARY_KEY_SOIL1_PCT);
+  CborWriter_PutUnsigned(&writer, data->soil1_pct);
+  CborWriter_PutUnsigned(&writer, BINARY_KEY_SOIL2_PCT);
+  CborWriter_PutUnsigned(&writer, data->soil2_pct);
+  CborWriter_PutUnsigned(&writer, BINARY_KEY_STALE_MASK);
+  CborWriter_PutUnsigned(&writer, data->stale_mask);
+  return CborWriter_Finish(&writer);
+}
+
+// The counter advances on every publish attempt, failed ones included,
+// so a gap at the subscriber means a message that never arrived. It is
+// not the snapshot's seq: state is only published when a metric is due.
+bool PublishBinaryState(const SensorData* data) {
+  uint8_t payload[RoomMonitorConfig::MQTT_STATE_CBOR_CAPACITY];
+  const size_t length = EncodeBinaryState(data, g_binary_sequence++, payload, sizeof(payload));
+  return (length > 0U) && g_mqtt_client.publish(RoomMonitorConfig::TOPIC_STATE_BIN, payload, length, true);
+}
+
+// Milliseconds since reset per milestone, null for any not reached (a
+// sensor that never read, a display that never drew).
+bool PublishBootReport() {
+  const char* const keys[BOOT_MILESTONE_COUNT] = {
+      "sensor_ready_ms", "first_frame_ms", "wifi_up_ms", "mqtt_connected_ms", "discovery_done_ms", "first_publish_ms"};
+
+  char payload[RoomMonitorConfig::MQTT_BOOT_JSON_CAPACITY];
+  char value[STATE_PAYLOAD_CAPACITY];
+  size_t length = TextFormat_Append(payload, sizeof(payload), 0U, "{");
+  for (uint8_t i = 0U; i < BOOT_MILESTONE_COUNT; i++) {
+    const BootMilestone milestone = static_cast<BootMilestone>(i);
+    if (BootProfiler_IsMarked(milestone)) {
+      (void)TextFormat_Unsigned(value, sizeof(value), BootProfiler_GetMs(milestone));
+    } else {
+      (void)TextFormat_Append(value, sizeof(value), 0U, "null");
+    }
+    length = TextFormat_Append(payload, sizeof(payload), length, (i == 0U) ? "\"" : ",\"");
+    length = TextFormat_Append(payload, sizeof(payload), length, keys[i]);
+    length = TextFormat_Append(payload, sizeof(payload), length, "\":");
+    length = TextFormat_Append(payload, sizeof(payload), length, value);
+  }
+  length = TextFormat_Append(payload, sizeof(payload), length, "}");
+  if (length >= sizeof(payload)) {
+    return false;
   }
+
+  const uint32_t first_publish_ms = BootProfiler_GetMs(BOOT_MILESTONE_FIRST_PUBLISH);
+  if (first_publish_ms > RoomMonitorConfig::BOOT_FIRST_PUBLISH_TARGET_MS) {
+    Log<LOG_LEVEL_WARN> warning;
+    warning.print("Boot to first publish (ms): ");
+    warning.println(first_publish_ms);
+  }
+  return g_mqtt_client.publish(RoomMonitorConfig::TOPIC_BOOT, payload, true);
+}
+
+// Connection state machine. Each step does at most one bounded piece of
+// work so loop() keeps drawing and sampling while the link comes up.
+enum LinkState : uint8_t {
+  LINK_WIFI_ASSOCIATING = 0U,
+  LINK_TCP_CONNECTING,
+  LINK_CONNACK_PENDING,
+  LINK_DISCOVERY_PENDING,
+  LINK_ONLINE
+};
+
+struct LinkContext {
+  LinkState state;
+  bool transport_open;
+  uint32_t state_entered_ms;
+  uint8_t discovery_index;
+  bool discovery_ok;
+  bool was_online;  // reached LINK_ONLINE at least once since boot
+};
+
+LinkContext g_link = {LINK_WIFI_ASSOCIATING, false, 0UL, 0U, true, false};
+
+void EnterLinkState(const LinkState state) {
+  g_link.state = state;
+  g_link.state_entered_ms = millis();
 }
 
 bool IsReconnectWindowOpen() {
   const uint32_t now = millis();
-  if ((now - g_last_connect_attempt_ms) < g_retry_delay_ms) {
+  if ((now - g_last_connect_attempt_ms) < (g_retry_delay_ms + g_retry_jitter_ms)) {
     return false;
   }
   g_last_connect_attempt_ms = now;
   return true;
 }
 
+// Monitors sharing a broker would otherwise all retry on the same backoff
+// steps after a broker restart and arrive as one discovery storm.
+void PickRetryJitter() {
+  g_retry_jitter_ms = RoomMonitorConfig::MQTT_FLEET_JITTER_ENABLED
+                          ? static_cast<uint32_t>(random(static_cast<long>(RoomMonitorConfig::MQTT_RECONNECT_JITTER_MAX_MS)))
+                          : 0UL;
+}
+
+// The transport as PubSubClient sees it. Its connect() sends CONNECT and
+// then spins until CONNACK arrives or the socket timeout runs out, so the
+// link runs it twice: once with a zero socket timeout, which sends CONNECT
+// and gives up at once (the stop() that follows is held back), and again
+// once CONNACK is waiting in the socket, with its CONNECT swallowed so
+// the broker sees only the first. The lite client splits connect itself.
+class ConnectGate : public Client {
+ public:
+  enum Mode : uint8_t { GATE_OPEN = 0U, GATE_HOLD_STOP, GATE_MUTE_WRITES };
+
+  void Attach(Client* transport) {
+    transport_ = transport;
+  }
+  void SetMode(const Mode mode) {
+    mode_ = mode;
+  }
+
+  int connect(IPAddress ip, uint16_t port) override {
+    return transport_->connect(ip, port);
+  }
+  int connect(const char* host, uint16_t port) override {
+    return transport_->connect(host, port);
+  }
+  size_t write(uint8_t value) override {
+    return (mode_ == GATE_MUTE_WRITES) ? 1U : transport_->write(value);
+  }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    return (mode_ == GATE_MUTE_WRITES) ? size : transport_->write(buffer, size);
+  }
+  int available() override {
+    return transport_->available();
+  }
+  int read() override {
+    return transport_->read();
+  }
+  int read(uint8_t* buffer, size_t size) override {
+    return transport_->read(buffer, size);
+  }
+  int peek() override {
+    return transport_->peek();
+  }
+  void flush() override {
+    transport_->flush();
+  }
+  void stop() override {
+    if (mode_ != GATE_HOLD_STOP) {
+      transport_->stop();
+    }
+  }
+  uint8_t connected() override {
+    return transport_->connected();
+  }
+  operator bool() override {
+    return connected() != 0U;
+  }
+
+ private:
+  Client* transport_ = nullptr;
+  Mode mode_ = GATE_OPEN;
+};
+
+ConnectGate g_connect_gate;
+
+enum ConnackResult : uint8_t { CONNACK_WAITING = 0U, CONNACK_ACCEPTED, CONNACK_REFUSED };
+
+// The fixed part of a CONNACK; less than this in the socket is still in
+// flight.
+constexpr int CONNACK_MIN_BYTES = 4;
+
 bool TryConnectMqtt() {
-  const String client_id = BuildClientId();
+  const char* client_id = GetClientId();
   if (strlen(RoomMonitorConfig::MQTT_USER) > 0U) {
     return g_mqtt_client.connect(
-        client_id.c_str(),
+        client_id,
         RoomMonitorConfig::MQTT_USER,
         RoomMonitorConfig::MQTT_PASSWORD);
   }
-  return g_mqtt_client.connect(client_id.c_str());
+  return g_mqtt_client.connect(client_id);
 }
 
+// How the link sends CONNECT and then looks for CONNACK, per client. Send
+// never waits for the answer; Poll only reads it once it is there.
+template <typename MqttClientType>
+struct ConnectSteps;
+
+template <>
+struct ConnectSteps<PubSubClient> {
+  static ConnackResult Send(PubSubClient* client) {
+    g_connect_gate.SetMode(ConnectGate::GATE_HOLD_STOP);
+    client->setSocketTimeout(0U);
+    const bool connected = TryConnectMqtt();
+    client->setSocketTimeout(RoomMonitorConfig::MQTT_SOCKET_TIMEOUT_S);
+    g_connect_gate.SetMode(ConnectGate::GATE_OPEN);
+    if (connected) {
+      return CONNACK_ACCEPTED;
+    }
+    return (client->state() == MQTT_CONNECTION_TIMEOUT) ? CONNACK_WAITING : CONNACK_REFUSED;
+  }
+
+  static ConnackResult Poll(PubSubClient*) {
+    if (Hal_GetTransportClient()->available() < CONNACK_MIN_BYTES) {
+      return CONNACK_WAITING;
+    }
+    g_connect_gate.SetMode(ConnectGate::GATE_MUTE_WRITES);
+    const bool connected = TryConnectMqtt();
+    g_connect_gate.SetMode(ConnectGate::GATE_OPEN);
+    return connected ? CONNACK_ACCEPTED : CONNACK_REFUSED;
+  }
+};
+
+template <>
+struct ConnectSteps<MqttLiteClient> {
+  // An empty MQTT_USER sends no credentials.
+  static ConnackResult Send(MqttLiteClient* client) {
+    const bool sent =
+        client->beginConnect(GetClientId(), RoomMonitorConfig::MQTT_USER, RoomMonitorConfig::MQTT_PASSWORD);
+    return sent ? CONNACK_WAITING : CONNACK_REFUSED;
+  }
+
+  static ConnackResult Poll(MqttLiteClient* client) {
+    (void)client->loop();
+    if (client->connecting()) {
+      return CONNACK_WAITING;
+    }
+    return client->connected() ? CONNACK_ACCEPTED : CONNACK_REFUSED;
+  }
+};
+
 void UpdateRetryDelayAfterConnect(const bool connected) {
+  PickRetryJitter();
   if (connected) {
     g_retry_delay_ms = RoomMonitorConfig::MQTT_RETRY_DELAY_MS;
     return;
@@ -142,84 +922,289 @@ void UpdateRetryDelayAfterConnect(const bool connected) {
     }
   }
 }
+
+void CloseTransport() {
+  Hal_TransportClose();
+  g_link.transport_open = false;
+}
+
+void FailConnectAttempt(const char* reason) {
+  Log<LOG_LEVEL_WARN> warning;
+  warning.print("MQTT connect failed, ");
+  warning.println(reason);
+  CloseTransport();
+  UpdateRetryDelayAfterConnect(false);
+  EnterLinkState(LINK_TCP_CONNECTING);
+}
+
+void HandleConnack(const ConnackResult result) {
+  if (result == CONNACK_WAITING) {
+    if ((millis() - g_link.state_entered_ms) >= RoomMonitorConfig::MQTT_CONNACK_TIMEOUT_MS) {
+      FailConnectAttempt("CONNACK timeout");
+    }
+    return;
+  }
+  if (result == CONNACK_REFUSED) {
+    Log<LOG_LEVEL_WARN> warning;
+    warning.print("MQTT rc=");
+    warning.println(g_mqtt_client.state());
+    FailConnectAttempt("CONNACK refused");
+    return;
+  }
+
+  Log<LOG_LEVEL_INFO> logger;
+  logger.println("MQTT connected");
+  BootProfiler_Mark(BOOT_MILESTONE_MQTT_CONNECTED);
+  ResetPublishedMetrics();
+  UpdateRetryDelayAfterConnect(true);
+  g_link.discovery_index = 0U;
+  g_link.discovery_ok = true;
+  EnterLinkState(LINK_DISCOVERY_PENDING);
+}
+
+void StepTcpConnecting() {
+  if (!g_link.transport_open) {
+    if (!IsReconnectWindowOpen()) {
+      return;
+    }
+
+    Log<LOG_LEVEL_INFO> logger;
+    logger.print("Attempting MQTT connection to ");
+    logger.print(RoomMonitorConfig::MQTT_SERVER);
+    logger.print(":");
+    logger.println(RoomMonitorConfig::MQTT_PORT);
+
+    IPAddress broker_ip;
+    if (!Hal_ResolveHost(RoomMonitorConfig::MQTT_SERVER, &broker_ip)) {
+      FailConnectAttempt("broker address unresolved");
+      return;
+    }
+    if (!Hal_TransportOpen(broker_ip, RoomMonitorConfig::MQTT_PORT)) {
+      FailConnectAttempt("no free socket");
+      return;
+    }
+    g_link.transport_open = true;
+    EnterLinkState(LINK_TCP_CONNECTING);
+    return;
+  }
+
+  if (Hal_TransportPoll() == HAL_TRANSPORT_ESTABLISHED) {
+    EnterLinkState(LINK_CONNACK_PENDING);
+    HandleConnack(ConnectSteps<MqttClient>::Send(&g_mqtt_client));
+    return;
+  }
+  if ((millis() - g_link.state_entered_ms) >= RoomMonitorConfig::MQTT_TCP_CONNECT_TIMEOUT_MS) {
+    FailConnectAttempt("TCP connect timeout");
+  }
+}
+
+// CONNECT went out when the socket came up; each step only looks for the
+// answer, against MQTT_CONNACK_TIMEOUT_MS.
+void StepConnackPending() {
+  HandleConnack(ConnectSteps<MqttClient>::Poll(&g_mqtt_client));
+}
+
+// One discovery config per step keeps each slice to a single publish.
+void StepDiscoveryPending() {
+  g_link.discovery_ok = StreamDiscovery(GetDiscoveryEntity(g_link.discovery_index)) && g_link.discovery_ok;
+  g_link.discovery_index++;
+  if (g_link.discovery_index >= DISCOVERY_ENTITY_COUNT) {
+    ReportDiscoveryResult(g_link.discovery_ok);
+    BootProfiler_Mark(BOOT_MILESTONE_DISCOVERY_DONE);
+    g_link.was_online = true;
+    EnterLinkState(LINK_ONLINE);
+  }
+}
+
+void HandleLinkLost() {
+  Log<LOG_LEVEL_WARN> warning;
+  warning.println("MQTT connection lost");
+  CloseTransport();
+  if (RoomMonitorConfig::MQTT_FLEET_JITTER_ENABLED) {
+    g_last_connect_attempt_ms = millis();
+  }
+  EnterLinkState(LINK_WIFI_ASSOCIATING);
+}
+
+// Replays one buffered sample per drain interval so a long backlog does
+// not stall loop() or flood the NINA socket right after a reconnect.
+void DrainBacklogIfDue() {
+  if ((g_link.state != LINK_ONLINE) || (TelemetryBuffer_Count() == 0U)) {
+    return;
+  }
+  const uint32_t now = millis();
+  if ((now - g_last_drain_ms) < RoomMonitorConfig::TELEMETRY_DRAIN_INTERVAL_MS) {
+    return;
+  }
+  g_last_drain_ms = now;
+
+  BufferedSample sample = {};
+  if (!TelemetryBuffer_PeekOldest(&sample)) {
+    return;
+  }
+
+  char values[METRIC_COUNT][STATE_PAYLOAD_CAPACITY];
+  char age_s[STATE_PAYLOAD_CAPACITY];
+  char payload[RoomMonitorConfig::MQTT_STATE_JSON_CAPACITY];
+  const bool built = FormatStateValues(&sample.data, values) &&
+                     (TextFormat_Unsigned(age_s, sizeof(age_s), TelemetryBuffer_AgeSeconds(&sample, now)) > 0U) &&
+                     BuildStateJson(payload, sizeof(payload), values, age_s);
+  if (!built) {
+    TelemetryBuffer_DropOldest();
+    return;
+  }
+  if (g_mqtt_client.publish(RoomMonitorConfig::TOPIC_BACKLOG, payload, false)) {
+    TelemetryBuffer_DropOldest();
+  }
+}
 }  // namespace
 
 void MqttManager_Init() {
+  randomSeed(GetDeviceSeed());
+  g_connect_gate.Attach(Hal_GetTransportClient());
+  g_mqtt_client.setClient(g_connect_gate);
   g_mqtt_client.setBufferSize(RoomMonitorConfig::MQTT_BUFFER_SIZE_BYTES);
   g_mqtt_client.setServer(RoomMonitorConfig::MQTT_SERVER, RoomMonitorConfig::MQTT_PORT);
-  Serial.print("MQTT buffer size set to ");
-  Serial.println(RoomMonitorConfig::MQTT_BUFFER_SIZE_BYTES);
+  g_mqtt_client.setSocketTimeout(RoomMonitorConfig::MQTT_SOCKET_TIMEOUT_S);
+  g_mqtt_client.setKeepAlive(RoomMonitorConfig::MQTT_KEEPALIVE_S);
+  // Fast boot lets the first attempt go as soon as Wi-Fi is up; backoff and
+  // jitter apply from the first failure on.
+  if (RoomMonitorConfig::FAST_BOOT_ENABLED) {
+    g_last_connect_attempt_ms = millis() - g_retry_delay_ms;
+  }
+  Log<LOG_LEVEL_INFO> logger;
+  logger.println(RoomMonitorConfig::MQTT_USE_LITE_CLIENT ? "MQTT client: lite (MQTT 5, QoS 1)" : "MQTT client: PubSubClient");
+  logger.print("MQTT buffer size set to ");
+  logger.println(RoomMonitorConfig::MQTT_BUFFER_SIZE_BYTES);
 }
 
 void MqttManager_Loop() {
   g_mqtt_client.loop();
+  DrainBacklogIfDue();
 }
 
 bool MqttManager_EnsureConnected() {
-  if (g_mqtt_client.connected()) {
-    UpdateRetryDelayAfterConnect(true);
-    PublishDiscoveryIfNeeded();
-    return true;
+  if ((g_link.state >= LINK_DISCOVERY_PENDING) && !g_mqtt_client.connected()) {
+    HandleLinkLost();
+  }
+  if ((g_link.state != LINK_WIFI_ASSOCIATING) && !WifiManager_EnsureConnected()) {
+    CloseTransport();
+    EnterLinkState(LINK_WIFI_ASSOCIATING);
   }
 
-  if (!WifiManager_EnsureConnected()) {
-    return false;
+  switch (g_link.state) {
+    case LINK_WIFI_ASSOCIATING:
+      if (WifiManager_EnsureConnected()) {
+        EnterLinkState(LINK_TCP_CONNECTING);
+      }
+      break;
+    case LINK_TCP_CONNECTING:
+      StepTcpConnecting();
+      break;
+    case LINK_CONNACK_PENDING:
+      StepConnackPending();
+      break;
+    case LINK_DISCOVERY_PENDING:
+      StepDiscoveryPending();
+      break;
+    case LINK_ONLINE:
+    default:
+      break;
   }
+  return g_link.state == LINK_ONLINE;
+}
 
-  if (!IsReconnectWindowOpen()) {
+bool MqttManager_PublishData(const SensorData* data) {
+  if (data == nullptr) {
+    return false;
+  }
+  // Only an outage is buffered; samples taken before the first connect
+  // would replay as a burst of stale backlog right after boot.
+  if (g_link.state != LINK_ONLINE) {
+    if (g_link.was_online) {
+      TelemetryBuffer_Record(data, millis());
+    }
     return false;
   }
 
-  Serial.print("Attempting MQTT connection to ");
-  Serial.print(RoomMonitorConfig::MQTT_SERVER);
-  Serial.print(":");
-  Serial.print(RoomMonitorConfig::MQTT_PORT);
-  Serial.print(" ... ");
-
-  const bool connected = TryConnectMqtt();
+  // Nothing changed past its deadband and no heartbeat is due: skip the
+  // formatting as well as the publish.
+  const uint32_t now = millis();
+  if (!IsAnyMetricDue(data, now)) {
+    return true;
+  }
+  char values[METRIC_COUNT][STATE_PAYLOAD_CAPACITY];
+  if (!FormatStateValues(data, values)) {
+    return false;
+  }
+  const bool text_ok = RoomMonitorConfig::MQTT_BATCHED_STATE ? PublishBatchedState(data, values, now)
+                                                             : PublishPerTopicState(data, values, now);
+  const bool binary_ok = !RoomMonitorConfig::MQTT_BINARY_STATE || PublishBinaryState(data);
+  if (text_ok) {
+    BootProfiler_Mark(BOOT_MILESTONE_FIRST_PUBLISH);
+    if (!g_boot_report_sent) {
+      g_boot_report_sent = PublishBootReport();
+    }
+  }
+  return binary_ok && text_ok;
+}
 
-  if (connected) {
-    Serial.println("connected");
-    g_discovery_sent = false;
-    UpdateRetryDelayAfterConnect(true);
-    PublishDiscoveryIfNeeded();
-  } else {
-    Serial.print("failed, rc=");
-    Serial.println(g_mqtt_client.state());
-    UpdateRetryDelayAfterConnect(false);
+bool MqttManager_PublishStats() {
+  if (!RoomMonitorConfig::ROLLING_STATS_ENABLED || (g_link.state != LINK_ONLINE)) {
+    return false;
   }
 
-  return connected;
-}
+  const SensorField field = static_cast<SensorField>(g_next_stats_field);
+  g_next_stats_field = static_cast<uint8_t>((g_next_stats_field + 1U) % SENSOR_FIELD_COUNT);
+  FieldStats stats = {};
+  for (uint8_t window = 0U; window < STATS_WINDOW_COUNT; window++) {
+    stats.valid[window] = RollingStats_Get(field, static_cast<StatsWindow>(window), &stats.summary[window]);
+  }
 
-bool MqttManager_PublishData(const SensorData* data) {
-  if (data == nullptr) {
+  ChunkWriter counter(nullptr);
+  AppendStatsJson(&counter, stats);
+  const size_t length = counter.Finish();
+  if (!g_mqtt_client.beginPublish(STATS_TOPICS[field], static_cast<unsigned int>(length), true)) {
     return false;
   }
-  if (!g_mqtt_client.connected()) {
+  ChunkWriter writer(&g_mqtt_client);
+  AppendStatsJson(&writer, stats);
+  const bool complete = writer.Finish() == length;
+  return (g_mqtt_client.endPublish() > 0) && complete;
+}
+
+bool MqttManager_PublishDiagnostics() {
+  if (!RoomMonitorConfig::INSTRUMENTATION_ENABLED || (g_link.state != LINK_ONLINE)) {
     return false;
   }
 
-  const String temp_str = String(data->temperature_c, RoomMonitorConfig::FLOAT_DECIMALS);
-  const String hum_str = String(data->humidity_pct, RoomMonitorConfig::FLOAT_DECIMALS);
-  const String pressure_str = String(data->pressure_hpa, RoomMonitorConfig::FLOAT_DECIMALS);
-  const String soil1_str = String(data->soil1_pct);
-  const String soil2_str = String(data->soil2_pct);
+  InstrumentSnapshot snapshot = {};
+  Instrumentation_TakeSnapshot(&snapshot);
 
-  struct StateMsg {
-    const char* topic;
-    const char* payload;
-  };
-  const StateMsg messages[] = {
-      {RoomMonitorConfig::TOPIC_TEMP_STATE, temp_str.c_str()},
-      {RoomMonitorConfig::TOPIC_HUM_STATE, hum_str.c_str()},
-      {RoomMonitorConfig::TOPIC_PRESSURE_STATE, pressure_str.c_str()},
-      {RoomMonitorConfig::TOPIC_SOIL1_STATE, soil1_str.c_str()},
-      {RoomMonitorConfig::TOPIC_SOIL2_STATE, soil2_str.c_str()}};
+  // Eleven fields outgrow MQTT_BUFFER_SIZE_BYTES, so the JSON is streamed
+  // like the stats; the values are read once for both passes.
+  const DiagnosticField fields[] = {
+      {"loop_max_us", snapshot.loop_max_us},
+      {"loop_hz", snapshot.loop_hz},
+      {"free_ram_min", snapshot.free_ram_min},
+      {"sensor_p99_us", snapshot.section_p99_us[INSTRUMENT_SECTION_SENSOR]},
+      {"display_p99_us", snapshot.section_p99_us[INSTRUMENT_SECTION_DISPLAY]},
+      {"publish_p99_us", snapshot.section_p99_us[INSTRUMENT_SECTION_PUBLISH]},
+      {"mqtt_p99_us", snapshot.section_p99_us[INSTRUMENT_SECTION_MQTT]},
+      {"avg_current_ua", PowerManager_AverageCurrentUa()},
+      {"log_dropped", Logger_DroppedCount()},
+      {"publish_interval_ms", RateController_PublishIntervalMs()},
+      {"sample_interval_ms", RateController_SampleIntervalMs()}};
+  const uint8_t count = static_cast<uint8_t>(sizeof(fields) / sizeof(fields[0]));
 
-  bool all_ok = true;
-  for (uint8_t i = 0U; i < (sizeof(messages) / sizeof(messages[0])); i++) {
-    all_ok = g_mqtt_client.publish(messages[i].topic, messages[i].payload, true) && all_ok;
+  ChunkWriter counter(nullptr);
+  AppendDiagnosticsJson(&counter, fields, count);
+  const size_t length = counter.Finish();
+  if (!g_mqtt_client.beginPublish(RoomMonitorConfig::TOPIC_DIAGNOSTICS, static_cast<unsigned int>(length), true)) {
+    return false;
   }
-  return all_ok;
+  ChunkWriter writer(&g_mqtt_client);
+  AppendDiagnosticsJson(&writer, fields, count);
+  const bool complete = writer.Finish() == length;
+  return (g_mqtt_client.endPublish() > 0) && complete;
 }
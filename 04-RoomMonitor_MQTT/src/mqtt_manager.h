@@ -7,5 +7,8 @@ void MqttManager_Init();
 void MqttManager_Loop();
 bool MqttManager_EnsureConnected();
 bool MqttManager_PublishData(const SensorData* data);
+// Publishes the next field's rolling statistics (round-robin).
+bool MqttManager_PublishStats();
+bool MqttManager_PublishDiagnostics();
 
 #endif  // MQTT_MANAGER_H
@@ -0,0 +1,92 @@
+#include "power_manager.h"
+
+#include "config.h"
+#include "hal.h"
+
+namespace {
+bool g_display_awake = true;
+uint32_t g_last_touch_ms = 0UL;
+uint32_t g_last_account_ms = 0UL;
+uint32_t g_idle_ms = 0UL;
+uint64_t g_charge_ua_ms = 0U;
+uint64_t g_elapsed_ms = 0U;
+uint32_t g_radio_ua = RoomMonitorConfig::POWER_RADIO_JOIN_UA;
+
+void SetDisplayAwake(const bool awake) {
+  if (awake != g_display_awake) {
+    Hal_SetDisplaySleep(!awake);
+    g_display_awake = awake;
+  }
+}
+
+// Radio draw in its current state: joining until associated, then awake
+// or in power-save depending on the mode.
+uint32_t GetRadioUa() {
+  if (!Hal_WifiIsConnected()) {
+    return RoomMonitorConfig::POWER_RADIO_JOIN_UA;
+  }
+  return RoomMonitorConfig::LOW_POWER_ENABLED ? RoomMonitorConfig::POWER_RADIO_SAVE_UA
+                                              : RoomMonitorConfig::POWER_RADIO_ACTIVE_UA;
+}
+
+// Charges the time since the last call at the per-state draw. The display
+// only changes state inside Service(); the radio state is sampled here, so
+// a join or drop is charged from the next call on, at most one
+// POWER_TASK_INTERVAL_MS late. MCU idle time comes from Idle().
+void AccountElapsed(const uint32_t now_ms) {
+  const uint32_t elapsed_ms = now_ms - g_last_account_ms;
+  const uint32_t idle_ms = (g_idle_ms < elapsed_ms) ? g_idle_ms : elapsed_ms;
+  const uint32_t active_ms = elapsed_ms - idle_ms;
+  const uint32_t display_ua =
+      g_display_awake ? RoomMonitorConfig::POWER_DISPLAY_ON_UA : RoomMonitorConfig::POWER_DISPLAY_SLEEP_UA;
+
+  g_charge_ua_ms += static_cast<uint64_t>(active_ms) * RoomMonitorConfig::POWER_MCU_ACTIVE_UA;
+  g_charge_ua_ms += static_cast<uint64_t>(idle_ms) * RoomMonitorConfig::POWER_MCU_IDLE_UA;
+  g_charge_ua_ms += static_cast<uint64_t>(elapsed_ms) * (display_ua + g_radio_ua);
+  g_elapsed_ms += elapsed_ms;
+  g_idle_ms = 0UL;
+  g_last_account_ms = now_ms;
+  g_radio_ua = GetRadioUa();
+}
+}  // namespace
+
+void PowerManager_Init(const uint32_t now_ms) {
+  Hal_WifiSetLowPower(RoomMonitorConfig::LOW_POWER_ENABLED);
+  g_last_touch_ms = now_ms;
+  g_last_account_ms = now_ms;
+  g_radio_ua = GetRadioUa();
+}
+
+void PowerManager_Service(const uint32_t now_ms) {
+  AccountElapsed(now_ms);
+  if (!RoomMonitorConfig::LOW_POWER_ENABLED) {
+    return;
+  }
+
+  if (Hal_ReadTouchAny()) {
+    g_last_touch_ms = now_ms;
+    SetDisplayAwake(true);
+  } else if ((now_ms - g_last_touch_ms) >= RoomMonitorConfig::LOW_POWER_DISPLAY_SLEEP_AFTER_MS) {
+    SetDisplayAwake(false);
+  }
+}
+
+void PowerManager_Idle(const uint32_t idle_ms) {
+  if (!RoomMonitorConfig::LOW_POWER_ENABLED || (idle_ms == 0UL)) {
+    return;
+  }
+
+  const uint32_t start = millis();
+  while ((millis() - start) < idle_ms) {
+    Hal_IdleSleep();
+  }
+  g_idle_ms += millis() - start;
+}
+
+bool PowerManager_IsDisplayAwake() {
+  return g_display_awake;
+}
+
+uint32_t PowerManager_AverageCurrentUa() {
+  return (g_elapsed_ms > 0U) ? static_cast<uint32_t>(g_charge_ua_ms / g_elapsed_ms) : 0UL;
+}
@@ -0,0 +1,18 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+// Low-power policy (see LOW_POWER_ENABLED in config.h) plus an energy
+// estimate that runs in either mode, so configurations can be compared.
+void PowerManager_Init(uint32_t now_ms);
+// Call every POWER_TASK_INTERVAL_MS: polls touch, sleeps or wakes the
+// display and accounts the elapsed time.
+void PowerManager_Service(uint32_t now_ms);
+// Idles the MCU for up to |idle_ms| when low-power mode is on.
+void PowerManager_Idle(uint32_t idle_ms);
+bool PowerManager_IsDisplayAwake();
+// Average estimated supply current since boot.
+uint32_t PowerManager_AverageCurrentUa();
+
+#endif  // POWER_MANAGER_H
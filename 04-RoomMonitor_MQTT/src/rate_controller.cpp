@@ -0,0 +1,111 @@
+#include "rate_controller.h"
+
+#include <math.h>
+
+#include "config.h"
+
+namespace {
+constexpr int8_t FASTEST_LEVEL = -static_cast<int8_t>(RoomMonitorConfig::ADAPTIVE_RATE_FAST_SHIFT);
+constexpr int8_t SLOWEST_LEVEL = static_cast<int8_t>(RoomMonitorConfig::ADAPTIVE_RATE_SLOW_SHIFT);
+
+constexpr uint32_t BASE_PERIOD_MS[SENSOR_FIELD_COUNT] = {
+    RoomMonitorConfig::SENSOR_TEMP_PERIOD_MS,
+    RoomMonitorConfig::SENSOR_HUM_PERIOD_MS,
+    RoomMonitorConfig::SENSOR_PRESSURE_PERIOD_MS,
+    RoomMonitorConfig::SENSOR_SOIL_PERIOD_MS,
+    RoomMonitorConfig::SENSOR_SOIL_PERIOD_MS};
+constexpr float DEADBAND[SENSOR_FIELD_COUNT] = {
+    RoomMonitorConfig::MQTT_DEADBAND_TEMP_C,
+    RoomMonitorConfig::MQTT_DEADBAND_HUM_PCT,
+    RoomMonitorConfig::MQTT_DEADBAND_PRESSURE_HPA,
+    RoomMonitorConfig::MQTT_DEADBAND_SOIL_PCT,
+    RoomMonitorConfig::MQTT_DEADBAND_SOIL_PCT};
+
+struct FieldRate {
+  bool primed;
+  int8_t level;  // < 0 faster than the base period, > 0 slower
+  uint32_t updated_ms;
+  float value;
+};
+
+FieldRate g_fields[SENSOR_FIELD_COUNT] = {};
+
+float GetFieldValue(const SensorData* data, const SensorField field) {
+  switch (field) {
+    case SENSOR_FIELD_TEMPERATURE:
+      return data->temperature_c;
+    case SENSOR_FIELD_HUMIDITY:
+      return data->humidity_pct;
+    case SENSOR_FIELD_PRESSURE:
+      return data->pressure_hpa;
+    case SENSOR_FIELD_SOIL1:
+      return static_cast<float>(data->soil1_pct);
+    case SENSOR_FIELD_SOIL2:
+    default:
+      return static_cast<float>(data->soil2_pct);
+  }
+}
+
+uint32_t ScaleByLevel(const uint32_t base_ms, const int8_t level) {
+  if (!RoomMonitorConfig::ADAPTIVE_RATE_ENABLED) {
+    return base_ms;
+  }
+  return (level < 0) ? (base_ms >> static_cast<uint8_t>(-level)) : (base_ms << static_cast<uint8_t>(level));
+}
+}  // namespace
+
+// The change between two samples is the rate of change times the current
+// period, so a field settles at the slowest level that still sees under
+// half a deadband per sample.
+void RateController_Observe(const SensorData* data) {
+  if (!RoomMonitorConfig::ADAPTIVE_RATE_ENABLED || (data == nullptr)) {
+    return;
+  }
+
+  for (uint8_t i = 0U; i < SENSOR_FIELD_COUNT; i++) {
+    FieldRate* field = &g_fields[i];
+    if (field->primed && (data->updated_ms[i] == field->updated_ms)) {
+      continue;
+    }
+    const float value = GetFieldValue(data, static_cast<SensorField>(i));
+    if (field->primed) {
+      const float change = fabsf(value - field->value);
+      if ((change * 2.0F) >= DEADBAND[i]) {
+        field->level = FASTEST_LEVEL;
+      } else if (((change * 4.0F) < DEADBAND[i]) && (field->level < SLOWEST_LEVEL)) {
+        field->level++;
+      }
+    }
+    field->primed = true;
+    field->updated_ms = data->updated_ms[i];
+    field->value = value;
+  }
+}
+
+uint32_t RateController_ScalePeriod(const SensorField field, const uint32_t base_ms) {
+  if (field >= SENSOR_FIELD_COUNT) {
+    return base_ms;
+  }
+  return ScaleByLevel(base_ms, g_fields[field].level);
+}
+
+uint32_t RateController_PublishIntervalMs() {
+  int8_t fastest = SLOWEST_LEVEL;
+  for (uint8_t i = 0U; i < SENSOR_FIELD_COUNT; i++) {
+    if (g_fields[i].level < fastest) {
+      fastest = g_fields[i].level;
+    }
+  }
+  return ScaleByLevel(RoomMonitorConfig::PUBLISH_INTERVAL_MS, fastest);
+}
+
+uint32_t RateController_SampleIntervalMs() {
+  uint32_t shortest_ms = UINT32_MAX;
+  for (uint8_t i = 0U; i < SENSOR_FIELD_COUNT; i++) {
+    const uint32_t period_ms = ScaleByLevel(BASE_PERIOD_MS[i], g_fields[i].level);
+    if (period_ms < shortest_ms) {
+      shortest_ms = period_ms;
+    }
+  }
+  return shortest_ms;
+}
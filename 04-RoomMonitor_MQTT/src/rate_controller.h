@@ -0,0 +1,19 @@
+#ifndef RATE_CONTROLLER_H
+#define RATE_CONTROLLER_H
+
+#include "data_model.h"
+
+// Adaptive sample and publish rates (ADAPTIVE_RATE_ENABLED). Each field has
+// a rate level: a new sample that moved by at least half the field's MQTT
+// deadband jumps it to the fastest level, one that moved by under a quarter
+// backs it off one level (doubling its period), anything in between holds
+// it. With the controller disabled every period is returned unscaled.
+void RateController_Observe(const SensorData* data);
+// |base_ms| scaled by the field's current level.
+uint32_t RateController_ScalePeriod(SensorField field, uint32_t base_ms);
+// PUBLISH_INTERVAL_MS scaled by the fastest field's level.
+uint32_t RateController_PublishIntervalMs();
+// Shortest current sample period over all channels.
+uint32_t RateController_SampleIntervalMs();
+
+#endif  // RATE_CONTROLLER_H
@@ -0,0 +1,124 @@
+#include "readout_font.h"
+
+namespace {
+constexpr uint8_t GLYPH_COLUMNS = 5U;
+constexpr uint8_t GLYPH_ROWS = 7U;
+constexpr uint8_t FONT_CELL_WIDTH = 6U;
+constexpr uint8_t FONT_CELL_HEIGHT = 8U;
+
+// One bit per column, MSB is the leftmost column. The eighth font row is
+// empty for every glyph here and is not stored.
+struct ReadoutGlyph {
+  char c;
+  uint8_t rows[GLYPH_ROWS];
+};
+
+const ReadoutGlyph READOUT_GLYPHS[] = {
+    {'0', {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}},
+    {'1', {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'2', {0x0E, 0x11, 0x01, 0x0E, 0x10, 0x10, 0x1F}},
+    {'3', {0x1F, 0x01, 0x02, 0x06, 0x01, 0x11, 0x0E}},
+    {'4', {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}},
+    {'5', {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},
+    {'6', {0x07, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}},
+    {'7', {0x1F, 0x01, 0x01, 0x02, 0x04, 0x08, 0x10}},
+    {'8', {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}},
+    {'9', {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x1C}},
+    {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}},
+    {'-', {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},
+};
+constexpr uint8_t READOUT_GLYPH_COUNT = sizeof(READOUT_GLYPHS) / sizeof(READOUT_GLYPHS[0]);
+
+bool g_verified = false;
+
+const ReadoutGlyph* FindGlyph(const char c) {
+  for (uint8_t i = 0U; i < READOUT_GLYPH_COUNT; i++) {
+    if (READOUT_GLYPHS[i].c == c) {
+      return &READOUT_GLYPHS[i];
+    }
+  }
+  return nullptr;
+}
+
+bool IsColumnSet(const uint8_t row_bits, const uint8_t column) {
+  return ((row_bits >> (GLYPH_COLUMNS - 1U - column)) & 0x01U) != 0U;
+}
+}  // namespace
+
+// Checks the table against the library font once, so a font change in
+// Adafruit GFX falls back to drawChar instead of drawing wrong digits.
+bool ReadoutFont_Verify() {
+  GFXcanvas1 canvas(FONT_CELL_WIDTH, FONT_CELL_HEIGHT);
+  if (canvas.getBuffer() == nullptr) {
+    g_verified = false;
+    return false;
+  }
+
+  for (uint8_t i = 0U; i < READOUT_GLYPH_COUNT; i++) {
+    canvas.fillScreen(0U);
+    canvas.drawChar(0, 0, static_cast<unsigned char>(READOUT_GLYPHS[i].c), 1U, 1U, 1U);
+    for (uint8_t y = 0U; y < FONT_CELL_HEIGHT; y++) {
+      for (uint8_t x = 0U; x < FONT_CELL_WIDTH; x++) {
+        const bool expected =
+            (x < GLYPH_COLUMNS) && (y < GLYPH_ROWS) && IsColumnSet(READOUT_GLYPHS[i].rows[y], x);
+        if (canvas.getPixel(x, y) != expected) {
+          g_verified = false;
+          return false;
+        }
+      }
+    }
+  }
+
+  g_verified = true;
+  return true;
+}
+
+bool ReadoutFont_HasGlyph(const char c) {
+  return g_verified && (FindGlyph(c) != nullptr);
+}
+
+// Produces the same pixels as drawChar(x, y, c, color, color, size):
+// identical consecutive rows are merged and each run becomes one rectangle.
+void ReadoutFont_DrawGlyph(
+    Adafruit_GFX& gfx,
+    const int16_t x,
+    const int16_t y,
+    const char c,
+    const uint16_t color,
+    const uint8_t size) {
+  const ReadoutGlyph* glyph = FindGlyph(c);
+  if (glyph == nullptr) {
+    return;
+  }
+
+  gfx.startWrite();
+  uint8_t row = 0U;
+  while (row < GLYPH_ROWS) {
+    const uint8_t bits = glyph->rows[row];
+    uint8_t row_end = row + 1U;
+    while ((row_end < GLYPH_ROWS) && (glyph->rows[row_end] == bits)) {
+      row_end++;
+    }
+
+    uint8_t column = 0U;
+    while (column < GLYPH_COLUMNS) {
+      if (!IsColumnSet(bits, column)) {
+        column++;
+        continue;
+      }
+      uint8_t run_end = column + 1U;
+      while ((run_end < GLYPH_COLUMNS) && IsColumnSet(bits, run_end)) {
+        run_end++;
+      }
+      gfx.writeFillRect(
+          x + (column * size),
+          y + (row * size),
+          (run_end - column) * size,
+          (row_end - row) * size,
+          color);
+      column = run_end;
+    }
+    row = row_end;
+  }
+  gfx.endWrite();
+}
@@ -0,0 +1,13 @@
+#ifndef READOUT_FONT_H
+#define READOUT_FONT_H
+
+#include <Adafruit_GFX.h>
+
+// Flash-resident copy of the GFX built-in font for the characters the gauge
+// readout uses ('0'-'9', '.', '-'). Glyphs are drawn as horizontal runs
+// instead of one scaled rectangle per font pixel.
+bool ReadoutFont_Verify();
+bool ReadoutFont_HasGlyph(char c);
+void ReadoutFont_DrawGlyph(Adafruit_GFX& gfx, int16_t x, int16_t y, char c, uint16_t color, uint8_t size);
+
+#endif  // READOUT_FONT_H
@@ -0,0 +1,240 @@
+#include "rolling_stats.h"
+
+#include <math.h>
+
+#include "config.h"
+
+namespace {
+// Samples are stored as int16 in each field's resolution (0.01 C, 0.01 %,
+// 0.1 hPa, 1 %). A bucket keeps exact integer sums; merged means are Q8 of
+// that unit, so merged M2 is in Q16.
+constexpr int32_t FIELD_SCALE[SENSOR_FIELD_COUNT] = {100L, 100L, 10L, 1L, 1L};
+constexpr uint32_t WINDOW_MS[STATS_WINDOW_COUNT] = {
+    RoomMonitorConfig::ROLLING_STATS_WINDOW_1M_MS,
+    RoomMonitorConfig::ROLLING_STATS_WINDOW_1H_MS,
+    RoomMonitorConfig::ROLLING_STATS_WINDOW_24H_MS};
+constexpr uint8_t BUCKET_COUNT = RoomMonitorConfig::ROLLING_STATS_BUCKETS;
+constexpr uint8_t MEAN_SHIFT = 8U;
+constexpr float MEAN_ONE = 256.0F;
+constexpr float M2_ONE = 65536.0F;
+constexpr float MS_PER_HOUR = 3600000.0F;
+
+// A running Q8 mean stops moving once count exceeds twice the Q8 delta
+// (a 4 h bucket at 1 Hz ignores steps under 28 units), so buckets hold
+// sums instead: at most UINT16_MAX int16 samples fit both exactly.
+struct StatsBucket {
+  int64_t sum_sq;
+  int32_t sum;
+  uint16_t count;
+  int16_t min;
+  int16_t max;
+};
+
+struct WindowRing {
+  uint32_t epoch;  // now_ms / bucket span of the newest bucket
+  StatsBucket buckets[BUCKET_COUNT];
+};
+
+// Running merge of several buckets; wider counters than a single bucket.
+struct StatsAccumulator {
+  int64_t m2_q16;
+  int32_t mean_q8;
+  uint32_t count;
+  int16_t min;
+  int16_t max;
+};
+
+WindowRing g_rings[SENSOR_FIELD_COUNT][STATS_WINDOW_COUNT];
+
+static_assert(
+    sizeof(g_rings) <= RoomMonitorConfig::ROLLING_STATS_MEMORY_BUDGET_BYTES,
+    "Rolling statistics exceed their RAM budget");
+
+uint32_t GetBucketSpanMs(const StatsWindow window) {
+  return WINDOW_MS[window] / BUCKET_COUNT;
+}
+
+int32_t RoundedDivide(const int64_t numerator, const int64_t denominator) {
+  const int64_t half = denominator / 2;
+  return static_cast<int32_t>((numerator >= 0) ? ((numerator + half) / denominator) : ((numerator - half) / denominator));
+}
+
+// Clears the buckets the clock has moved past. A millis() wrap looks like a
+// long jump and simply starts the windows over.
+void AdvanceRing(WindowRing* ring, const uint32_t epoch) {
+  uint32_t steps = epoch - ring->epoch;
+  if (steps > BUCKET_COUNT) {
+    steps = BUCKET_COUNT;
+  }
+  for (uint32_t i = 1U; i <= steps; i++) {
+    ring->buckets[(ring->epoch + i) % BUCKET_COUNT] = {};
+  }
+  ring->epoch = epoch;
+}
+
+void AddToBucket(StatsBucket* bucket, const int16_t value) {
+  if (bucket->count == 0U) {
+    bucket->min = value;
+    bucket->max = value;
+  } else if (bucket->count == UINT16_MAX) {
+    return;
+  }
+
+  bucket->count++;
+  bucket->sum += value;
+  bucket->sum_sq += static_cast<int32_t>(value) * value;
+  if (value < bucket->min) {
+    bucket->min = value;
+  }
+  if (value > bucket->max) {
+    bucket->max = value;
+  }
+}
+
+int32_t GetBucketMeanQ8(const StatsBucket& bucket) {
+  return RoundedDivide(static_cast<int64_t>(bucket.sum) << MEAN_SHIFT, bucket.count);
+}
+
+// Sum of squared deviations in Q16: count * M2 = count * sum_sq - sum^2 is
+// exact in int64 for a full bucket, and the remainder keeps the fraction.
+int64_t GetBucketM2Q16(const StatsBucket& bucket) {
+  const int64_t count = bucket.count;
+  const int64_t scaled_m2 = (count * bucket.sum_sq) - (static_cast<int64_t>(bucket.sum) * bucket.sum);
+  return ((scaled_m2 / count) << (2U * MEAN_SHIFT)) + RoundedDivide((scaled_m2 % count) << (2U * MEAN_SHIFT), count);
+}
+
+// Chan et al. pairwise combination of two Welford states.
+void MergeBucket(StatsAccumulator* acc, const StatsBucket& bucket) {
+  if (bucket.count == 0U) {
+    return;
+  }
+  const int32_t bucket_mean_q8 = GetBucketMeanQ8(bucket);
+  const int64_t bucket_m2_q16 = GetBucketM2Q16(bucket);
+  if (acc->count == 0UL) {
+    acc->count = bucket.count;
+    acc->mean_q8 = bucket_mean_q8;
+    acc->m2_q16 = bucket_m2_q16;
+    acc->min = bucket.min;
+    acc->max = bucket.max;
+    return;
+  }
+
+  const int64_t count_a = acc->count;
+  const int64_t count_b = bucket.count;
+  const int64_t count = count_a + count_b;
+  const int64_t delta = static_cast<int64_t>(bucket_mean_q8) - acc->mean_q8;
+  acc->mean_q8 += RoundedDivide(delta * count_b, count);
+  acc->m2_q16 += bucket_m2_q16 + (((delta * delta * count_a) / count) * count_b);
+  acc->count = static_cast<uint32_t>(count);
+  if (bucket.min < acc->min) {
+    acc->min = bucket.min;
+  }
+  if (bucket.max > acc->max) {
+    acc->max = bucket.max;
+  }
+}
+
+// Least-squares slope of the non-empty bucket means against bucket index,
+// oldest bucket first. Returns Q8 units per bucket span.
+float GetTrendQ8PerBucket(const WindowRing& ring) {
+  int64_t points = 0;
+  int64_t sum_x = 0;
+  int64_t sum_y = 0;
+  int64_t sum_xx = 0;
+  int64_t sum_xy = 0;
+  for (uint8_t age = 0U; age < BUCKET_COUNT; age++) {
+    const int64_t x = BUCKET_COUNT - 1U - age;
+    const StatsBucket& bucket = ring.buckets[(ring.epoch + BUCKET_COUNT - age) % BUCKET_COUNT];
+    if (bucket.count == 0U) {
+      continue;
+    }
+    const int64_t y = GetBucketMeanQ8(bucket);
+    points++;
+    sum_x += x;
+    sum_y += y;
+    sum_xx += x * x;
+    sum_xy += x * y;
+  }
+
+  const int64_t denominator = (points * sum_xx) - (sum_x * sum_x);
+  if ((points < 2) || (denominator == 0)) {
+    return 0.0F;
+  }
+  return static_cast<float>((points * sum_xy) - (sum_x * sum_y)) / static_cast<float>(denominator);
+}
+
+int16_t ToFieldUnits(const float value, const int32_t scale) {
+  const float scaled = (value * static_cast<float>(scale)) + ((value < 0.0F) ? -0.5F : 0.5F);
+  if (scaled <= static_cast<float>(INT16_MIN)) {
+    return INT16_MIN;
+  }
+  if (scaled >= static_cast<float>(INT16_MAX)) {
+    return INT16_MAX;
+  }
+  return static_cast<int16_t>(scaled);
+}
+
+float GetFieldValue(const SensorData* data, const SensorField field) {
+  switch (field) {
+    case SENSOR_FIELD_TEMPERATURE:
+      return data->temperature_c;
+    case SENSOR_FIELD_HUMIDITY:
+      return data->humidity_pct;
+    case SENSOR_FIELD_PRESSURE:
+      return data->pressure_hpa;
+    case SENSOR_FIELD_SOIL1:
+      return static_cast<float>(data->soil1_pct);
+    case SENSOR_FIELD_SOIL2:
+    default:
+      return static_cast<float>(data->soil2_pct);
+  }
+}
+}  // namespace
+
+void RollingStats_Add(const SensorData* data, const uint32_t now_ms) {
+  if (data == nullptr) {
+    return;
+  }
+
+  for (uint8_t field = 0U; field < SENSOR_FIELD_COUNT; field++) {
+    if ((data->stale_mask & (1U << field)) != 0U) {
+      continue;
+    }
+    const int16_t value = ToFieldUnits(GetFieldValue(data, static_cast<SensorField>(field)), FIELD_SCALE[field]);
+    for (uint8_t window = 0U; window < STATS_WINDOW_COUNT; window++) {
+      WindowRing* ring = &g_rings[field][window];
+      AdvanceRing(ring, now_ms / GetBucketSpanMs(static_cast<StatsWindow>(window)));
+      AddToBucket(&ring->buckets[ring->epoch % BUCKET_COUNT], value);
+    }
+  }
+}
+
+bool RollingStats_Get(const SensorField field, const StatsWindow window, StatsSummary* out_summary) {
+  if ((out_summary == nullptr) || (field >= SENSOR_FIELD_COUNT) || (window >= STATS_WINDOW_COUNT)) {
+    return false;
+  }
+
+  WindowRing* ring = &g_rings[field][window];
+  AdvanceRing(ring, millis() / GetBucketSpanMs(window));
+  StatsAccumulator acc = {};
+  for (uint8_t i = 0U; i < BUCKET_COUNT; i++) {
+    MergeBucket(&acc, ring->buckets[i]);
+  }
+  if (acc.count == 0UL) {
+    return false;
+  }
+
+  const float scale = static_cast<float>(FIELD_SCALE[field]);
+  const float variance_q16 = (acc.count > 1UL) ? (static_cast<float>(acc.m2_q16 > 0 ? acc.m2_q16 : 0) /
+                                                  static_cast<float>(acc.count - 1UL))
+                                               : 0.0F;
+  const float buckets_per_hour = MS_PER_HOUR / static_cast<float>(GetBucketSpanMs(window));
+
+  out_summary->count = acc.count;
+  out_summary->min = static_cast<float>(acc.min) / scale;
+  out_summary->max = static_cast<float>(acc.max) / scale;
+  out_summary->mean = (static_cast<float>(acc.mean_q8) / MEAN_ONE) / scale;
+  out_summary->stddev = sqrtf(variance_q16 / M2_ONE) / scale;
+  out_summary->trend_per_hour = ((GetTrendQ8PerBucket(*ring) / MEAN_ONE) / scale) * buckets_per_hour;
+  return true;
+}
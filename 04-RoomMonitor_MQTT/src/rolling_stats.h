@@ -0,0 +1,31 @@
+#ifndef ROLLING_STATS_H
+#define ROLLING_STATS_H
+
+#include "data_model.h"
+
+enum StatsWindow : uint8_t {
+  STATS_WINDOW_1M = 0U,
+  STATS_WINDOW_1H,
+  STATS_WINDOW_24H,
+  STATS_WINDOW_COUNT
+};
+
+struct StatsSummary {
+  uint32_t count;
+  float min;
+  float max;
+  float mean;
+  float stddev;
+  float trend_per_hour;  // least-squares slope of the bucket means
+};
+
+// Per-field min/max/mean/stddev/trend over three windows. Each window is a
+// ring of ROLLING_STATS_BUCKETS exact integer sums: a sample updates one
+// bucket per window in O(1), a query merges the buckets as fixed-point
+// Welford states, so a window covers between (N-1)/N and all of its
+// nominal span. Stale fields are not added.
+void RollingStats_Add(const SensorData* data, uint32_t now_ms);
+// Returns false while the window holds no samples.
+bool RollingStats_Get(SensorField field, StatsWindow window, StatsSummary* out_summary);
+
+#endif  // ROLLING_STATS_H
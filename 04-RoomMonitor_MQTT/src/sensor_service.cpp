@@ -1,9 +1,202 @@
 #include "sensor_service.h"
 
-#include "carrier_platform.h"
 #include "config.h"
+#include "hal.h"
+#include "rate_controller.h"
 
 namespace {
+// Environment values are filtered in hundredths of their unit, soil values
+// as the oversampled ADC sum. EMA state carries EMA_FRACTION_BITS extra bits.
+constexpr float ENV_FIXED_SCALE = 100.0F;
+constexpr uint8_t EMA_FRACTION_BITS = 8U;
+constexpr uint8_t MEDIAN_WINDOW = RoomMonitorConfig::SENSOR_MEDIAN_WINDOW;
+static_assert((MEDIAN_WINDOW % 2U) == 1U, "Median window must be odd");
+static_assert(MEDIAN_WINDOW <= 9U, "Median window is sorted in place, keep it small");
+static_assert(RoomMonitorConfig::SENSOR_ADC_OVERSAMPLE_COUNT > 0U, "Need at least one ADC sample per burst");
+
+struct ChannelFilter {
+  int32_t window[MEDIAN_WINDOW];
+  uint8_t next;
+  uint8_t filled;
+  bool primed;
+  int32_t ema_q;
+};
+
+typedef bool (*ChannelReadFn)(int32_t* out_value);
+
+// One entry per SensorField. Each driver performs a single bus (or ADC
+// burst) transaction.
+struct ChannelDriver {
+  ChannelReadFn read;
+  uint32_t period_ms;
+  uint32_t stale_after_ms;
+  uint8_t median_window;
+  uint8_t ema_shift;
+};
+
+// Filter lag budget in samples at `period_ms`, at least one sample.
+constexpr uint32_t GetDelayBudget(const uint32_t period_ms) {
+  return ((RoomMonitorConfig::SENSOR_FILTER_MAX_DELAY_MS / period_ms) > 0UL)
+             ? (RoomMonitorConfig::SENSOR_FILTER_MAX_DELAY_MS / period_ms)
+             : 1UL;
+}
+
+// Largest odd window up to `window` whose median lags at most the budget.
+constexpr uint8_t GetMedianWindow(const uint32_t period_ms, const uint8_t window = MEDIAN_WINDOW) {
+  return ((window <= 1U) || (((window - 1U) / 2U) <= GetDelayBudget(period_ms)))
+             ? window
+             : GetMedianWindow(period_ms, static_cast<uint8_t>(window - 2U));
+}
+
+// Largest shift up to `shift` whose EMA lag (2^shift - 1 samples) fits
+// what the median left of the budget.
+constexpr uint8_t GetEmaShift(const uint32_t period_ms, const uint8_t shift) {
+  return ((shift == 0U) ||
+          ((((GetMedianWindow(period_ms) - 1U) / 2U) + (1UL << shift) - 1UL) <= GetDelayBudget(period_ms)))
+             ? shift
+             : GetEmaShift(period_ms, static_cast<uint8_t>(shift - 1U));
+}
+
+struct ChannelState {
+  ChannelFilter filter;
+  uint32_t next_due_ms;
+  uint32_t updated_ms;
+};
+
+int32_t GetMedian(const ChannelFilter* filter) {
+  int32_t sorted[MEDIAN_WINDOW];
+  for (uint8_t i = 0U; i < filter->filled; i++) {
+    const int32_t value = filter->window[i];
+    uint8_t j = i;
+    while ((j > 0U) && (sorted[j - 1U] > value)) {
+      sorted[j] = sorted[j - 1U];
+      j--;
+    }
+    sorted[j] = value;
+  }
+  return sorted[filter->filled / 2U];
+}
+
+void PushSample(ChannelFilter* filter, const int32_t value, const uint8_t median_window, const uint8_t ema_shift) {
+  filter->window[filter->next] = value;
+  filter->next = static_cast<uint8_t>((filter->next + 1U) % median_window);
+  if (filter->filled < median_window) {
+    filter->filled++;
+  }
+
+  const int32_t median_q = GetMedian(filter) * (1L << EMA_FRACTION_BITS);
+  if (!filter->primed) {
+    filter->ema_q = median_q;
+    filter->primed = true;
+    return;
+  }
+  filter->ema_q += (median_q - filter->ema_q) / (1L << ema_shift);
+}
+
+int32_t GetFiltered(const ChannelFilter* filter) {
+  const int32_t ema_q = filter->ema_q;
+  const int32_t half = 1L << (EMA_FRACTION_BITS - 1U);
+  return (ema_q + ((ema_q < 0L) ? -half : half)) / (1L << EMA_FRACTION_BITS);
+}
+
+int32_t ToEnvFixed(const float value) {
+  const float scaled = value * ENV_FIXED_SCALE;
+  return static_cast<int32_t>((scaled < 0.0F) ? (scaled - 0.5F) : (scaled + 0.5F));
+}
+
+float FromEnvFixed(const int32_t value) {
+  return static_cast<float>(value) / ENV_FIXED_SCALE;
+}
+
+int32_t ReadOversampled(const pin_size_t pin) {
+  int32_t sum = 0L;
+  for (uint8_t i = 0U; i < RoomMonitorConfig::SENSOR_ADC_OVERSAMPLE_COUNT; i++) {
+    sum += Hal_ReadAnalog(pin);
+  }
+  return sum;
+}
+
+bool ReadTemperature(int32_t* out_value) {
+  *out_value = ToEnvFixed(Hal_ReadTemperatureC());
+  return true;
+}
+
+bool ReadHumidity(int32_t* out_value) {
+  *out_value = ToEnvFixed(Hal_ReadHumidityPct());
+  return true;
+}
+
+bool ReadPressure(int32_t* out_value) {
+  *out_value = ToEnvFixed(Hal_ReadPressureHpa());
+  return true;
+}
+
+bool ReadSoil1(int32_t* out_value) {
+  *out_value = ReadOversampled(RoomMonitorConfig::SOIL1_PIN);
+  return true;
+}
+
+bool ReadSoil2(int32_t* out_value) {
+  *out_value = ReadOversampled(RoomMonitorConfig::SOIL2_PIN);
+  return true;
+}
+
+const ChannelDriver CHANNEL_DRIVERS[SENSOR_FIELD_COUNT] = {
+    {ReadTemperature,
+     RoomMonitorConfig::SENSOR_TEMP_PERIOD_MS,
+     RoomMonitorConfig::SENSOR_TEMP_STALE_MS,
+     GetMedianWindow(RoomMonitorConfig::SENSOR_TEMP_PERIOD_MS),
+     GetEmaShift(RoomMonitorConfig::SENSOR_TEMP_PERIOD_MS, RoomMonitorConfig::SENSOR_EMA_SHIFT_ENV)},
+    {ReadHumidity,
+     RoomMonitorConfig::SENSOR_HUM_PERIOD_MS,
+     RoomMonitorConfig::SENSOR_HUM_STALE_MS,
+     GetMedianWindow(RoomMonitorConfig::SENSOR_HUM_PERIOD_MS),
+     GetEmaShift(RoomMonitorConfig::SENSOR_HUM_PERIOD_MS, RoomMonitorConfig::SENSOR_EMA_SHIFT_ENV)},
+    {ReadPressure,
+     RoomMonitorConfig::SENSOR_PRESSURE_PERIOD_MS,
+     RoomMonitorConfig::SENSOR_PRESSURE_STALE_MS,
+     GetMedianWindow(RoomMonitorConfig::SENSOR_PRESSURE_PERIOD_MS),
+     GetEmaShift(RoomMonitorConfig::SENSOR_PRESSURE_PERIOD_MS, RoomMonitorConfig::SENSOR_EMA_SHIFT_ENV)},
+    {ReadSoil1,
+     RoomMonitorConfig::SENSOR_SOIL_PERIOD_MS,
+     RoomMonitorConfig::SENSOR_SOIL_STALE_MS,
+     GetMedianWindow(RoomMonitorConfig::SENSOR_SOIL_PERIOD_MS),
+     GetEmaShift(RoomMonitorConfig::SENSOR_SOIL_PERIOD_MS, RoomMonitorConfig::SENSOR_EMA_SHIFT_SOIL)},
+    {ReadSoil2,
+     RoomMonitorConfig::SENSOR_SOIL_PERIOD_MS,
+     RoomMonitorConfig::SENSOR_SOIL_STALE_MS,
+     GetMedianWindow(RoomMonitorConfig::SENSOR_SOIL_PERIOD_MS),
+     GetEmaShift(RoomMonitorConfig::SENSOR_SOIL_PERIOD_MS, RoomMonitorConfig::SENSOR_EMA_SHIFT_SOIL)}};
+
+ChannelState g_channels[SENSOR_FIELD_COUNT] = {};
+SensorSnapshot g_snapshots[2] = {};
+uint8_t g_front = 0U;
+
+bool SampleChannel(const SensorField field, const uint32_t now) {
+  const ChannelDriver& driver = CHANNEL_DRIVERS[field];
+  ChannelState* channel = &g_channels[field];
+
+  // Advance by whole periods so a late sample keeps the channel's cadence.
+  const uint32_t period_ms = RateController_ScalePeriod(field, driver.period_ms);
+  channel->next_due_ms += period_ms;
+  if (static_cast<int32_t>(now - channel->next_due_ms) >= 0L) {
+    channel->next_due_ms = now + period_ms;
+  }
+
+  int32_t value = 0L;
+  if (!driver.read(&value)) {
+    return false;
+  }
+  PushSample(&channel->filter, value, driver.median_window, driver.ema_shift);
+  channel->updated_ms = now;
+  return true;
+}
+
+int SoilSumToRaw(const int32_t sum) {
+  constexpr int32_t count = RoomMonitorConfig::SENSOR_ADC_OVERSAMPLE_COUNT;
+  return static_cast<int>((sum + (count / 2L)) / count);
+}
+
 uint8_t SoilRawToPercent(const int raw_value) {
   const long mapped = map(
       raw_value,
@@ -20,28 +213,112 @@ uint8_t SoilRawToPercent(const int raw_value) {
   }
   return static_cast<uint8_t>(mapped);
 }
-}  // namespace
 
-void SensorService_Init() {
-  CarrierPlatform_Init();
+uint8_t SoilFilteredPercent(const SensorField field) {
+  return SoilRawToPercent(SoilSumToRaw(GetFiltered(&g_channels[field].filter)));
 }
 
-bool SensorService_Read(SensorData* out_data) {
-  if (out_data == nullptr) {
-    return false;
+void FillSensorData(SensorData* out_data, uint8_t* out_valid_mask, const uint32_t now) {
+  out_data->temperature_c = FromEnvFixed(GetFiltered(&g_channels[SENSOR_FIELD_TEMPERATURE].filter));
+  out_data->humidity_pct = FromEnvFixed(GetFiltered(&g_channels[SENSOR_FIELD_HUMIDITY].filter));
+  out_data->pressure_hpa = FromEnvFixed(GetFiltered(&g_channels[SENSOR_FIELD_PRESSURE].filter));
+  out_data->soil1_pct = SoilFilteredPercent(SENSOR_FIELD_SOIL1);
+  out_data->soil2_pct = SoilFilteredPercent(SENSOR_FIELD_SOIL2);
+
+  out_data->stale_mask = 0U;
+  *out_valid_mask = 0U;
+  for (uint8_t i = 0U; i < SENSOR_FIELD_COUNT; i++) {
+    const ChannelState& channel = g_channels[i];
+    const uint8_t bit = static_cast<uint8_t>(1U << i);
+    // A backed-off channel's stale limit stretches with its period; a
+    // sped-up one keeps the base limit.
+    const uint32_t base_stale_ms = CHANNEL_DRIVERS[i].stale_after_ms;
+    const uint32_t scaled_stale_ms = RateController_ScalePeriod(static_cast<SensorField>(i), base_stale_ms);
+    const uint32_t stale_after_ms = (scaled_stale_ms > base_stale_ms) ? scaled_stale_ms : base_stale_ms;
+    out_data->updated_ms[i] = channel.updated_ms;
+    if (channel.filter.primed) {
+      *out_valid_mask = static_cast<uint8_t>(*out_valid_mask | bit);
+    }
+    if (!channel.filter.primed || ((now - channel.updated_ms) > stale_after_ms)) {
+      out_data->stale_mask = static_cast<uint8_t>(out_data->stale_mask | bit);
+    }
   }
+}
 
-  MKRIoTCarrier* carrier = CarrierPlatform_Get();
-  if (carrier == nullptr) {
-    return false;
+bool IsSameReading(const SensorSnapshot& a, const SensorSnapshot& b) {
+  return (a.valid_mask == b.valid_mask) && (a.data.stale_mask == b.data.stale_mask) &&
+         (a.data.temperature_c == b.data.temperature_c) && (a.data.humidity_pct == b.data.humidity_pct) &&
+         (a.data.pressure_hpa == b.data.pressure_hpa) && (a.data.soil1_pct == b.data.soil1_pct) &&
+         (a.data.soil2_pct == b.data.soil2_pct);
+}
+
+// Builds the next snapshot in the back buffer and flips only if a reading
+// changed, so consumers can key all their work off the sequence number.
+// The published front buffer is never written; the rate controller sees
+// every sample time through the back buffer.
+void UpdateSnapshot(const uint32_t now) {
+  const SensorSnapshot* front = &g_snapshots[g_front];
+  SensorSnapshot* back = &g_snapshots[g_front ^ 1U];
+  FillSensorData(&back->data, &back->valid_mask, now);
+  RateController_Observe(&back->data);
+  if ((front->seq != 0UL) && IsSameReading(*front, *back)) {
+    return;
   }
+  back->seq = front->seq + 1UL;
+  g_front ^= 1U;
+}
 
-  const float pressure_kpa = carrier->Pressure.readPressure();
+// Index of the channel whose release is furthest overdue, or
+// SENSOR_FIELD_COUNT when none is due.
+uint8_t FindMostOverdueChannel(const uint32_t now) {
+  uint8_t next = SENSOR_FIELD_COUNT;
+  int32_t next_lateness = 0L;
+  for (uint8_t i = 0U; i < SENSOR_FIELD_COUNT; i++) {
+    const int32_t lateness = static_cast<int32_t>(now - g_channels[i].next_due_ms);
+    if ((lateness >= 0L) && ((next == SENSOR_FIELD_COUNT) || (lateness > next_lateness))) {
+      next = i;
+      next_lateness = lateness;
+    }
+  }
+  return next;
+}
+}  // namespace
 
-  out_data->temperature_c = carrier->Env.readTemperature();
-  out_data->humidity_pct = carrier->Env.readHumidity();
-  out_data->pressure_hpa = pressure_kpa * RoomMonitorConfig::KPA_TO_HPA_FACTOR;
-  out_data->soil1_pct = SoilRawToPercent(analogRead(RoomMonitorConfig::SOIL1_PIN));
-  out_data->soil2_pct = SoilRawToPercent(analogRead(RoomMonitorConfig::SOIL2_PIN));
-  return true;
+// Every channel is read once so the first dashboard has real values; after
+// that each channel follows its own period from SensorService_Sample().
+void SensorService_Init() {
+  Hal_Init();
+
+  const uint32_t now = millis();
+  for (uint8_t i = 0U; i < SENSOR_FIELD_COUNT; i++) {
+    g_channels[i].next_due_ms = now;
+    (void)SampleChannel(static_cast<SensorField>(i), now);
+  }
+  UpdateSnapshot(now);
+}
+
+// Reads at most one channel: the one whose release is furthest overdue.
+bool SensorService_Sample() {
+  const uint32_t now = millis();
+  const uint8_t next = FindMostOverdueChannel(now);
+  const bool sampled = (next != SENSOR_FIELD_COUNT) && SampleChannel(static_cast<SensorField>(next), now);
+  UpdateSnapshot(now);
+  return sampled;
+}
+
+uint8_t SensorService_SampleAllDue() {
+  const uint32_t now = millis();
+  uint8_t sampled = 0U;
+  for (uint8_t i = 0U; i < SENSOR_FIELD_COUNT; i++) {
+    if ((static_cast<int32_t>(now - g_channels[i].next_due_ms) >= 0L) &&
+        SampleChannel(static_cast<SensorField>(i), now)) {
+      sampled++;
+    }
+  }
+  UpdateSnapshot(now);
+  return sampled;
+}
+
+const SensorSnapshot* SensorService_GetSnapshot() {
+  return &g_snapshots[g_front];
 }
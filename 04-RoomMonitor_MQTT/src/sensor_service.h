@@ -4,6 +4,14 @@
 #include "data_model.h"
 
 void SensorService_Init();
-bool SensorService_Read(SensorData* out_data);
+// Samples at most one due channel; call every SENSOR_SAMPLE_INTERVAL_MS.
+bool SensorService_Sample();
+// Samples every due channel in one pass (low-power mode batches reads
+// around a single wake). Returns the number of channels read.
+uint8_t SensorService_SampleAllDue();
+// Latest published snapshot; never touches the sensors. The pointee stays
+// unchanged through the sample pass that publishes the next one and is
+// reused by the pass after it; seq is 0 before the first.
+const SensorSnapshot* SensorService_GetSnapshot();
 
 #endif  // SENSOR_SERVICE_H
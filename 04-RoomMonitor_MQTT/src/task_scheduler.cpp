@@ -0,0 +1,165 @@
+#include "task_scheduler.h"
+
+#include "config.h"
+
+namespace {
+struct Task {
+  const char* name;
+  TaskScheduler_Callback callback;
+  uint32_t period_ms;
+  uint32_t phase_ms;
+  uint32_t deadline_ms;
+  uint32_t next_due_ms;
+  uint32_t runs;
+  uint32_t max_us;
+  uint64_t total_us;
+  uint32_t missed;
+};
+
+Task g_tasks[RoomMonitorConfig::TASK_SCHEDULER_CAPACITY];
+uint8_t g_task_count = 0U;
+
+// Wrap-safe "a is at or after b" for millis() timestamps.
+bool IsAtOrAfter(const uint32_t a, const uint32_t b) {
+  return static_cast<int32_t>(a - b) >= 0L;
+}
+
+// Advances the release time by whole periods so a late run does not shift
+// the task's phase. Returns whether any period was skipped entirely.
+bool AdvanceRelease(Task* task, const uint32_t now_ms) {
+  task->next_due_ms += task->period_ms;
+  bool skipped = false;
+  while (IsAtOrAfter(now_ms, task->next_due_ms)) {
+    task->next_due_ms += task->period_ms;
+    skipped = true;
+  }
+  return skipped;
+}
+
+void RunTask(Task* task, const uint32_t now_ms) {
+  const uint32_t release_ms = task->next_due_ms;
+  const uint32_t start_us = micros();
+  task->callback();
+  const uint32_t duration_us = micros() - start_us;
+
+  task->runs++;
+  task->total_us += duration_us;
+  if (duration_us > task->max_us) {
+    task->max_us = duration_us;
+  }
+
+  // One late release is one miss, however many periods it swallowed.
+  const uint32_t finish_ms = now_ms + (duration_us / 1000UL);
+  const bool late = (task->deadline_ms > 0UL) && ((finish_ms - release_ms) > task->deadline_ms);
+  const bool skipped = AdvanceRelease(task, finish_ms);
+  if (late || skipped) {
+    task->missed++;
+  }
+}
+}  // namespace
+
+uint8_t TaskScheduler_Add(
+    const char* name,
+    TaskScheduler_Callback callback,
+    const uint32_t period_ms,
+    const uint32_t phase_ms,
+    const uint32_t deadline_ms) {
+  if ((callback == nullptr) || (period_ms == 0UL) || (g_task_count >= RoomMonitorConfig::TASK_SCHEDULER_CAPACITY)) {
+    return TASK_SCHEDULER_INVALID_ID;
+  }
+
+  Task* task = &g_tasks[g_task_count];
+  *task = {};
+  task->name = name;
+  task->callback = callback;
+  task->period_ms = period_ms;
+  task->phase_ms = phase_ms;
+  task->deadline_ms = deadline_ms;
+  return g_task_count++;
+}
+
+void TaskScheduler_Start(const uint32_t now_ms) {
+  for (uint8_t i = 0U; i < g_task_count; i++) {
+    g_tasks[i].next_due_ms = now_ms + g_tasks[i].phase_ms;
+  }
+}
+
+bool TaskScheduler_SetPeriod(const uint8_t task_id, const uint32_t period_ms, const uint32_t now_ms) {
+  if ((task_id >= g_task_count) || (period_ms == 0UL)) {
+    return false;
+  }
+  Task* task = &g_tasks[task_id];
+  task->period_ms = period_ms;
+  if (!IsAtOrAfter(now_ms + period_ms, task->next_due_ms)) {
+    task->next_due_ms = now_ms + period_ms;
+  }
+  return true;
+}
+
+bool TaskScheduler_RunOnce(const uint32_t now_ms) {
+  // Earliest release first; ties go to the lower id (registration order).
+  Task* next = nullptr;
+  for (uint8_t i = 0U; i < g_task_count; i++) {
+    Task* task = &g_tasks[i];
+    if (!IsAtOrAfter(now_ms, task->next_due_ms)) {
+      continue;
+    }
+    if ((next == nullptr) || !IsAtOrAfter(task->next_due_ms, next->next_due_ms)) {
+      next = task;
+    }
+  }
+
+  if (next == nullptr) {
+    return false;
+  }
+  RunTask(next, now_ms);
+  return true;
+}
+
+uint32_t TaskScheduler_MsUntilNextRelease(const uint32_t now_ms) {
+  uint32_t wait_ms = UINT32_MAX;
+  for (uint8_t i = 0U; i < g_task_count; i++) {
+    const uint32_t due_ms = g_tasks[i].next_due_ms;
+    if (IsAtOrAfter(now_ms, due_ms)) {
+      return 0UL;
+    }
+    if ((due_ms - now_ms) < wait_ms) {
+      wait_ms = due_ms - now_ms;
+    }
+  }
+  return (g_task_count > 0U) ? wait_ms : 0UL;
+}
+
+bool TaskScheduler_GetStats(const uint8_t task_id, TaskStats* out_stats) {
+  if ((out_stats == nullptr) || (task_id >= g_task_count)) {
+    return false;
+  }
+
+  const Task* task = &g_tasks[task_id];
+  out_stats->runs = task->runs;
+  out_stats->max_us = task->max_us;
+  out_stats->avg_us = (task->runs > 0UL) ? static_cast<uint32_t>(task->total_us / task->runs) : 0UL;
+  out_stats->missed = task->missed;
+  return true;
+}
+
+void TaskScheduler_PrintStats(Print* out) {
+  if (out == nullptr) {
+    return;
+  }
+
+  out->println("task\truns\tavg_us\tmax_us\tmissed");
+  for (uint8_t i = 0U; i < g_task_count; i++) {
+    TaskStats stats = {};
+    (void)TaskScheduler_GetStats(i, &stats);
+    out->print(g_tasks[i].name);
+    out->print('\t');
+    out->print(stats.runs);
+    out->print('\t');
+    out->print(stats.avg_us);
+    out->print('\t');
+    out->print(stats.max_us);
+    out->print('\t');
+    out->println(stats.missed);
+  }
+}
@@ -0,0 +1,37 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+typedef void (*TaskScheduler_Callback)();
+
+struct TaskStats {
+  uint32_t runs;
+  uint32_t max_us;
+  uint32_t avg_us;
+  uint32_t missed;
+};
+
+constexpr uint8_t TASK_SCHEDULER_INVALID_ID = 0xFFU;
+
+// Cooperative scheduler over a fixed task table. Each RunOnce() call runs
+// at most one due task, so work registered on the same period but with
+// different phases lands in different loop() passes. A deadline of 0
+// means the task only counts as missed when it slips a whole period.
+uint8_t TaskScheduler_Add(
+    const char* name,
+    TaskScheduler_Callback callback,
+    uint32_t period_ms,
+    uint32_t phase_ms,
+    uint32_t deadline_ms);
+void TaskScheduler_Start(uint32_t now_ms);
+// Changes a task's period at run time. A release further out than the new
+// period is pulled in, so speeding a task up takes effect at once.
+bool TaskScheduler_SetPeriod(uint8_t task_id, uint32_t period_ms, uint32_t now_ms);
+bool TaskScheduler_RunOnce(uint32_t now_ms);
+// Milliseconds until the next release, 0 when a task is already due.
+uint32_t TaskScheduler_MsUntilNextRelease(uint32_t now_ms);
+bool TaskScheduler_GetStats(uint8_t task_id, TaskStats* out_stats);
+void TaskScheduler_PrintStats(Print* out);
+
+#endif  // TASK_SCHEDULER_H
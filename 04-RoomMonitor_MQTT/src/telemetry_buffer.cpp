@@ -0,0 +1,187 @@
+#include "telemetry_buffer.h"
+
+#include "config.h"
+
+namespace {
+// Bit layout of a packed sample, LSB first:
+//   timestamp  20 bits  seconds on the buffer clock, wraps after ~12 days
+//   temp       11 bits  0.1 C steps from -40.0 C
+//   humidity    7 bits  1 % steps
+//   pressure   12 bits  0.1 hPa steps from 800.0 hPa
+//   soil1       7 bits  1 % steps
+//   soil2       7 bits  1 % steps
+constexpr uint8_t TIMESTAMP_BITS = 20U;
+constexpr uint8_t TEMP_BITS = 11U;
+constexpr uint8_t HUMIDITY_BITS = 7U;
+constexpr uint8_t PRESSURE_BITS = 12U;
+constexpr uint8_t SOIL_BITS = 7U;
+static_assert(
+    (TIMESTAMP_BITS + TEMP_BITS + HUMIDITY_BITS + PRESSURE_BITS + (2U * SOIL_BITS)) == 64U,
+    "Packed sample must fill exactly 64 bits");
+
+constexpr uint32_t TIMESTAMP_MASK = (1UL << TIMESTAMP_BITS) - 1UL;
+constexpr float TEMP_OFFSET_C = -40.0F;
+constexpr float TEMP_STEP_C = 0.1F;
+constexpr float PRESSURE_OFFSET_HPA = 800.0F;
+constexpr float PRESSURE_STEP_HPA = 0.1F;
+constexpr uint32_t MS_PER_SECOND = 1000UL;
+
+uint64_t g_samples[RoomMonitorConfig::TELEMETRY_BUFFER_CAPACITY];
+uint16_t g_head = 0U;
+uint16_t g_count = 0U;
+uint32_t g_dropped = 0UL;
+uint16_t g_record_stride = 1U;
+uint16_t g_stride_skip = 0U;
+
+// Seconds on a clock that keeps counting across the millis() wrap (every
+// ~49.7 days), which now_ms / 1000 does not. It is rebased whenever the
+// buffer is empty, so it only has to span the samples held.
+uint32_t g_clock_s = 0UL;
+uint32_t g_clock_ms = 0UL;  // millis() at the start of second g_clock_s
+
+uint32_t ClockSeconds(const uint32_t now_ms) {
+  return g_clock_s + ((now_ms - g_clock_ms) / MS_PER_SECOND);
+}
+
+void AdvanceClock(const uint32_t now_ms) {
+  if (g_count == 0U) {
+    g_clock_s = now_ms / MS_PER_SECOND;
+    g_clock_ms = now_ms - (now_ms % MS_PER_SECOND);
+    return;
+  }
+  const uint32_t elapsed_s = (now_ms - g_clock_ms) / MS_PER_SECOND;
+  g_clock_s += elapsed_s;
+  g_clock_ms += elapsed_s * MS_PER_SECOND;
+}
+
+uint32_t QuantizeFloat(const float value, const float offset, const float step, const uint8_t bits) {
+  const float steps = ((value - offset) / step) + 0.5F;
+  const uint32_t max_steps = (1UL << bits) - 1UL;
+  if (!(steps > 0.0F)) {
+    return 0UL;
+  }
+  if (steps >= static_cast<float>(max_steps)) {
+    return max_steps;
+  }
+  return static_cast<uint32_t>(steps);
+}
+
+uint32_t QuantizePercent(const float value, const uint8_t bits) {
+  return QuantizeFloat(value, 0.0F, 1.0F, bits);
+}
+
+uint64_t PackSample(const SensorData* data, const uint32_t timestamp_s) {
+  uint64_t packed = 0U;
+  uint8_t shift = 0U;
+  packed |= static_cast<uint64_t>(timestamp_s & TIMESTAMP_MASK) << shift;
+  shift += TIMESTAMP_BITS;
+  packed |= static_cast<uint64_t>(QuantizeFloat(data->temperature_c, TEMP_OFFSET_C, TEMP_STEP_C, TEMP_BITS)) << shift;
+  shift += TEMP_BITS;
+  packed |= static_cast<uint64_t>(QuantizePercent(data->humidity_pct, HUMIDITY_BITS)) << shift;
+  shift += HUMIDITY_BITS;
+  packed |= static_cast<uint64_t>(
+                QuantizeFloat(data->pressure_hpa, PRESSURE_OFFSET_HPA, PRESSURE_STEP_HPA, PRESSURE_BITS))
+            << shift;
+  shift += PRESSURE_BITS;
+  packed |= static_cast<uint64_t>(QuantizePercent(static_cast<float>(data->soil1_pct), SOIL_BITS)) << shift;
+  shift += SOIL_BITS;
+  packed |= static_cast<uint64_t>(QuantizePercent(static_cast<float>(data->soil2_pct), SOIL_BITS)) << shift;
+  return packed;
+}
+
+uint32_t TakeBits(uint64_t* packed, const uint8_t bits) {
+  const uint32_t value = static_cast<uint32_t>(*packed & ((1ULL << bits) - 1ULL));
+  *packed >>= bits;
+  return value;
+}
+
+void UnpackSample(uint64_t packed, BufferedSample* out_sample) {
+  out_sample->timestamp_s = TakeBits(&packed, TIMESTAMP_BITS);
+  out_sample->data.temperature_c = TEMP_OFFSET_C + (static_cast<float>(TakeBits(&packed, TEMP_BITS)) * TEMP_STEP_C);
+  out_sample->data.humidity_pct = static_cast<float>(TakeBits(&packed, HUMIDITY_BITS));
+  out_sample->data.pressure_hpa =
+      PRESSURE_OFFSET_HPA + (static_cast<float>(TakeBits(&packed, PRESSURE_BITS)) * PRESSURE_STEP_HPA);
+  out_sample->data.soil1_pct = static_cast<uint8_t>(TakeBits(&packed, SOIL_BITS));
+  out_sample->data.soil2_pct = static_cast<uint8_t>(TakeBits(&packed, SOIL_BITS));
+}
+
+uint16_t SlotAt(const uint16_t offset) {
+  return static_cast<uint16_t>((g_head + offset) % RoomMonitorConfig::TELEMETRY_BUFFER_CAPACITY);
+}
+
+// Keeps every other stored sample and halves the recording rate, so a long
+// outage is covered end to end at a coarser resolution.
+void Decimate() {
+  const uint16_t kept = static_cast<uint16_t>((g_count + 1U) / 2U);
+  for (uint16_t i = 0U; i < kept; i++) {
+    g_samples[SlotAt(i)] = g_samples[SlotAt(static_cast<uint16_t>(i * 2U))];
+  }
+  g_dropped += static_cast<uint32_t>(g_count - kept);
+  g_count = kept;
+  g_record_stride = static_cast<uint16_t>(g_record_stride * 2U);
+  g_stride_skip = 0U;
+}
+}  // namespace
+
+void TelemetryBuffer_Record(const SensorData* data, const uint32_t now_ms) {
+  if (data == nullptr) {
+    return;
+  }
+  AdvanceClock(now_ms);
+
+  // Skipped by decimation: as lost as an overwritten sample.
+  if (g_stride_skip > 0U) {
+    g_stride_skip--;
+    g_dropped++;
+    return;
+  }
+  g_stride_skip = static_cast<uint16_t>(g_record_stride - 1U);
+
+  if (g_count == RoomMonitorConfig::TELEMETRY_BUFFER_CAPACITY) {
+    if (RoomMonitorConfig::TELEMETRY_OVERFLOW_POLICY == RoomMonitorConfig::TelemetryOverflowPolicy::DECIMATE) {
+      Decimate();
+    } else {
+      g_head = SlotAt(1U);
+      g_count--;
+      g_dropped++;
+    }
+  }
+
+  g_samples[SlotAt(g_count)] = PackSample(data, g_clock_s);
+  g_count++;
+}
+
+bool TelemetryBuffer_PeekOldest(BufferedSample* out_sample) {
+  if ((out_sample == nullptr) || (g_count == 0U)) {
+    return false;
+  }
+  UnpackSample(g_samples[g_head], out_sample);
+  return true;
+}
+
+void TelemetryBuffer_DropOldest() {
+  if (g_count == 0U) {
+    return;
+  }
+  g_head = SlotAt(1U);
+  g_count--;
+  if (g_count == 0U) {
+    g_record_stride = 1U;
+    g_stride_skip = 0U;
+  }
+}
+
+uint16_t TelemetryBuffer_Count() {
+  return g_count;
+}
+
+uint32_t TelemetryBuffer_DroppedCount() {
+  return g_dropped;
+}
+
+uint32_t TelemetryBuffer_AgeSeconds(const BufferedSample* sample, const uint32_t now_ms) {
+  if (sample == nullptr) {
+    return 0UL;
+  }
+  return (ClockSeconds(now_ms) - sample->timestamp_s) & TIMESTAMP_MASK;
+}
@@ -0,0 +1,21 @@
+#ifndef TELEMETRY_BUFFER_H
+#define TELEMETRY_BUFFER_H
+
+#include "data_model.h"
+
+struct BufferedSample {
+  uint32_t timestamp_s;
+  SensorData data;
+};
+
+// Fixed-size store for samples taken while the broker is unreachable.
+// Samples are packed into 8 bytes each; see telemetry_buffer.cpp.
+void TelemetryBuffer_Record(const SensorData* data, uint32_t now_ms);
+bool TelemetryBuffer_PeekOldest(BufferedSample* out_sample);
+void TelemetryBuffer_DropOldest();
+uint16_t TelemetryBuffer_Count();
+uint32_t TelemetryBuffer_DroppedCount();
+// Exact across the millis() wrap for samples up to ~12 days old.
+uint32_t TelemetryBuffer_AgeSeconds(const BufferedSample* sample, uint32_t now_ms);
+
+#endif  // TELEMETRY_BUFFER_H
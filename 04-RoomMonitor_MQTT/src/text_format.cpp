@@ -0,0 +1,157 @@
+#include "text_format.h"
+
+#include <math.h>
+#include <string.h>
+
+namespace {
+constexpr uint8_t MAX_FLOAT_DECIMALS = 6U;
+constexpr uint32_t FLOAT_SIGN_BIT = 0x80000000UL;
+constexpr uint32_t FLOAT_MANTISSA_MASK = 0x007FFFFFUL;
+constexpr uint32_t FLOAT_IMPLICIT_ONE = 0x00800000UL;
+constexpr uint8_t FLOAT_MANTISSA_BITS = 23U;
+// Unbiases the exponent field for a mantissa read as an integer.
+constexpr int16_t FLOAT_EXPONENT_BIAS = 127 + FLOAT_MANTISSA_BITS;
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+size_t CopyLiteral(char* out, const size_t capacity, const char* text) {
+  const size_t length = strlen(text);
+  if ((length + 1U) > capacity) {
+    return 0U;
+  }
+  memcpy(out, text, length + 1U);
+  return length;
+}
+
+// Writes exactly |width| digits, zero padded on the left.
+void WriteDigits(char* out, uint32_t value, const uint8_t width) {
+  for (uint8_t i = width; i > 0U; i--) {
+    out[i - 1U] = static_cast<char>('0' + (value % 10UL));
+    value /= 10UL;
+  }
+}
+
+// |magnitude_bits| (a finite float without its sign) times |scale|,
+// rounded half away from zero. The float is mantissa * 2^exponent, so
+// this is an integer multiply and a rounding shift: exact, and no float or
+// double arithmetic on an FPU-less core. False when it does not fit below
+// UINT32_MAX.
+bool ScaleToFixed(const uint32_t magnitude_bits, const uint32_t scale, uint32_t* out_fixed) {
+  const uint32_t exponent_field = magnitude_bits >> FLOAT_MANTISSA_BITS;
+  // Subnormals have no implicit one and share the smallest normal exponent.
+  const bool normal = exponent_field > 0UL;
+  const uint32_t mantissa = (magnitude_bits & FLOAT_MANTISSA_MASK) | (normal ? FLOAT_IMPLICIT_ONE : 0UL);
+  const int16_t exponent = static_cast<int16_t>(normal ? exponent_field : 1UL) - FLOAT_EXPONENT_BIAS;
+  const uint64_t product = static_cast<uint64_t>(mantissa) * scale;
+
+  uint64_t fixed = 0U;
+  if (exponent >= 0) {
+    if ((exponent >= 32) || (product > (static_cast<uint64_t>(UINT32_MAX) >> exponent))) {
+      return false;
+    }
+    fixed = product << exponent;
+  } else if (exponent > -64) {
+    const uint8_t shift = static_cast<uint8_t>(-exponent);
+    fixed = (product >> shift) + ((product >> (shift - 1U)) & 1U);
+  }
+  if (fixed >= UINT32_MAX) {
+    return false;
+  }
+  *out_fixed = static_cast<uint32_t>(fixed);
+  return true;
+}
+
+uint8_t CountDigits(uint32_t value) {
+  uint8_t digits = 1U;
+  while (value >= 10UL) {
+    value /= 10UL;
+    digits++;
+  }
+  return digits;
+}
+}  // namespace
+
+size_t TextFormat_Unsigned(char* out, const size_t capacity, const uint32_t value) {
+  if (out == nullptr) {
+    return 0U;
+  }
+  const uint8_t digits = CountDigits(value);
+  if ((static_cast<size_t>(digits) + 1U) > capacity) {
+    return 0U;
+  }
+  WriteDigits(out, value, digits);
+  out[digits] = '\0';
+  return digits;
+}
+
+// Matches String(value, decimals) except on exact binary ties such as
+// 17.125, which round away from zero here instead of to even.
+size_t TextFormat_Float(char* out, const size_t capacity, const float value, const uint8_t decimals) {
+  if ((out == nullptr) || (decimals > MAX_FLOAT_DECIMALS)) {
+    return 0U;
+  }
+  if (isnan(value)) {
+    return CopyLiteral(out, capacity, "nan");
+  }
+  if (isinf(value)) {
+    return CopyLiteral(out, capacity, (value < 0.0F) ? "-inf" : "inf");
+  }
+
+  uint32_t scale = 1UL;
+  for (uint8_t i = 0U; i < decimals; i++) {
+    scale *= 10UL;
+  }
+
+  // Rounds the float's exact value, so 267.835F (just below the tie) gives
+  // 267.83 as printf does.
+  uint32_t bits = 0UL;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint32_t magnitude_bits = bits & ~FLOAT_SIGN_BIT;
+  const bool negative = ((bits & FLOAT_SIGN_BIT) != 0UL) && (magnitude_bits != 0UL);
+  uint32_t fixed = 0UL;
+  if (!ScaleToFixed(magnitude_bits, scale, &fixed)) {
+    return 0U;
+  }
+
+  const uint32_t integer_part = fixed / scale;
+  const uint8_t integer_digits = CountDigits(integer_part);
+  const size_t length =
+      (negative ? 1U : 0U) + integer_digits + ((decimals > 0U) ? (1U + decimals) : 0U);
+  if ((length + 1U) > capacity) {
+    return 0U;
+  }
+
+  char* cursor = out;
+  if (negative) {
+    *cursor++ = '-';
+  }
+  WriteDigits(cursor, integer_part, integer_digits);
+  cursor += integer_digits;
+  if (decimals > 0U) {
+    *cursor++ = '.';
+    WriteDigits(cursor, fixed % scale, decimals);
+    cursor += decimals;
+  }
+  *cursor = '\0';
+  return length;
+}
+
+size_t TextFormat_Hex8(char* out, const size_t capacity, const uint8_t value) {
+  if ((out == nullptr) || (capacity < 3U)) {
+    return 0U;
+  }
+  out[0] = HEX_DIGITS[value >> 4U];
+  out[1] = HEX_DIGITS[value & 0x0FU];
+  out[2] = '\0';
+  return 2U;
+}
+
+size_t TextFormat_Append(char* out, const size_t capacity, const size_t length, const char* text) {
+  if ((out == nullptr) || (text == nullptr) || (length >= capacity)) {
+    return capacity;
+  }
+  const size_t written = CopyLiteral(out + length, capacity - length, text);
+  if ((written == 0U) && (text[0] != '\0')) {
+    return capacity;
+  }
+  return length + written;
+}
@@ -0,0 +1,17 @@
+#ifndef TEXT_FORMAT_H
+#define TEXT_FORMAT_H
+
+#include <Arduino.h>
+
+// Allocation-free number formatting into caller-provided buffers.
+// Each function NUL-terminates and returns the text length, or 0 when the
+// value does not fit into |capacity|.
+size_t TextFormat_Unsigned(char* out, size_t capacity, uint32_t value);
+size_t TextFormat_Float(char* out, size_t capacity, float value, uint8_t decimals);
+size_t TextFormat_Hex8(char* out, size_t capacity, uint8_t value);
+
+// Appends |text| at |length| and returns the new length. Once the text no
+// longer fits the result is |capacity|, and further appends keep it there.
+size_t TextFormat_Append(char* out, size_t capacity, size_t length, const char* text);
+
+#endif  // TEXT_FORMAT_H
@@ -0,0 +1,57 @@
+#ifndef TRIG_TABLE_H
+#define TRIG_TABLE_H
+
+#include <Arduino.h>
+
+// Fixed-point trigonometry for the gauge. The SAMD21 has no FPU, so all
+// angles are whole degrees and results are Q15 (32767 == 1.0).
+namespace TrigTable {
+
+constexpr int32_t Q15_ONE = 32767L;
+constexpr int32_t Q15_HALF = 16384L;
+constexpr int32_t Q15_DIVISOR = 32768L;
+
+// sin(i degrees) * 32767, rounded, for i = 0..90.
+constexpr int16_t SINE_QUARTER_Q15[91] = {
+    0, 572, 1144, 1715, 2286, 2856, 3425, 3993,
+    4560, 5126, 5690, 6252, 6813, 7371, 7927, 8481,
+    9032, 9580, 10126, 10668, 11207, 11743, 12275, 12803,
+    13328, 13848, 14364, 14876, 15383, 15886, 16383, 16876,
+    17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+    21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964,
+    24351, 24730, 25101, 25465, 25821, 26169, 26509, 26841,
+    27165, 27481, 27788, 28087, 28377, 28659, 28932, 29196,
+    29451, 29697, 29934, 30162, 30381, 30591, 30791, 30982,
+    31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+    32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722,
+    32747, 32762, 32767,
+};
+
+constexpr int32_t NormalizeDegrees(const int32_t degrees) {
+  return ((degrees % 360L) + 360L) % 360L;
+}
+
+constexpr int16_t SinNormalizedQ15(const int32_t degrees) {
+  return (degrees <= 90L)    ? SINE_QUARTER_Q15[degrees]
+         : (degrees <= 180L) ? SINE_QUARTER_Q15[180L - degrees]
+         : (degrees <= 270L) ? static_cast<int16_t>(-SINE_QUARTER_Q15[degrees - 180L])
+                             : static_cast<int16_t>(-SINE_QUARTER_Q15[360L - degrees]);
+}
+
+constexpr int16_t SinQ15(const int32_t degrees) {
+  return SinNormalizedQ15(NormalizeDegrees(degrees));
+}
+
+constexpr int16_t CosQ15(const int32_t degrees) {
+  return SinNormalizedQ15(NormalizeDegrees(degrees + 90L));
+}
+
+// Scales a Q15 factor by a pixel length, rounding half away from zero.
+constexpr int16_t ScaleQ15(const int16_t factor_q15, const int16_t length) {
+  return static_cast<int16_t>(
+      ((static_cast<int32_t>(factor_q15) * length) + ((factor_q15 < 0) ? -Q15_HALF : Q15_HALF)) / Q15_DIVISOR);
+}
+
+}  // namespace TrigTable
+
+#endif  // TRIG_TABLE_H
@@ -1,33 +1,54 @@
 #include "wifi_manager.h"
 
-#include <WiFiNINA.h>
-
+#include "boot_profiler.h"
 #include "config.h"
+#include "hal.h"
+#include "logger.h"
 
 namespace {
 uint32_t g_last_wifi_attempt_ms = 0UL;
+bool g_association_pending = false;
+
+void StartAssociation(const uint32_t now) {
+  g_last_wifi_attempt_ms = now;
+
+  Log<LOG_LEVEL_INFO> logger;
+  logger.print("Connecting to WiFi SSID: ");
+  logger.println(RoomMonitorConfig::WIFI_SSID);
+
+  Hal_WifiDisconnect();
+  Hal_WifiBegin(RoomMonitorConfig::WIFI_SSID, RoomMonitorConfig::WIFI_PASSWORD);
+  g_association_pending = true;
+}
 }  // namespace
 
 void WifiManager_Init() {
-  WiFi.disconnect();
+  Hal_WifiInit();
   g_last_wifi_attempt_ms = 0UL;
+  g_association_pending = false;
+}
+
+void WifiManager_Begin() {
+  StartAssociation(millis());
 }
 
 bool WifiManager_EnsureConnected() {
-  if (WiFi.status() == WL_CONNECTED) {
+  if (Hal_WifiIsConnected()) {
+    if (g_association_pending) {
+      Log<LOG_LEVEL_INFO> logger;
+      logger.println("WiFi connected");
+      g_association_pending = false;
+    }
+    BootProfiler_Mark(BOOT_MILESTONE_WIFI_UP);
     return true;
   }
 
   const uint32_t now = millis();
-  if ((now - g_last_wifi_attempt_ms) < RoomMonitorConfig::WIFI_RETRY_DELAY_MS) {
+  const uint32_t wait_ms =
+      g_association_pending ? RoomMonitorConfig::WIFI_ASSOCIATE_TIMEOUT_MS : RoomMonitorConfig::WIFI_RETRY_DELAY_MS;
+  if ((now - g_last_wifi_attempt_ms) < wait_ms) {
     return false;
   }
-  g_last_wifi_attempt_ms = now;
-
-  Serial.print("Connecting to WiFi SSID: ");
-  Serial.println(RoomMonitorConfig::WIFI_SSID);
-
-  WiFi.disconnect();
-  WiFi.begin(RoomMonitorConfig::WIFI_SSID, RoomMonitorConfig::WIFI_PASSWORD);
+  StartAssociation(now);
   return false;
 }
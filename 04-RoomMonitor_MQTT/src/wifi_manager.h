@@ -2,6 +2,9 @@
 #define WIFI_MANAGER_H
 
 void WifiManager_Init();
+// Hands the credentials to the NINA module right away instead of at the
+// first EnsureConnected() retry slot.
+void WifiManager_Begin();
 bool WifiManager_EnsureConnected();
 
 #endif  // WIFI_MANAGER_H